@@ -56,10 +56,8 @@ private:
                         break;
                     }
                     
-                    // Convert bytes to string and display
-                    std::string message = NetworkUtils::BytesToString(buffer);
-                    
-                    std::cout << message;
+                    // Display the received bytes without copying them into a string
+                    std::cout << NetworkUtils::AsStringView(buffer);
                     
                     // Add a prompt after each message for better UX, including username
                     std::cout << username << "> " << std::flush;
@@ -98,8 +96,8 @@ public:
                 return false;
             }
             
-            // Send username as the first message
-            std::vector<std::byte> usernameData = NetworkUtils::StringToBytes(username);
+            // Send username as the first line (the chat protocol is newline-delimited)
+            std::vector<std::byte> usernameData = NetworkUtils::StringToBytes(username + "\n");
             if (!socket->Send(usernameData)) {
                 std::cerr << "Failed to send username to server" << std::endl;
                 return false;
@@ -142,7 +140,7 @@ public:
             if (message == "/quit") {
                 // Send quit command to server before disconnecting
                 try {
-                    std::vector<std::byte> quitMsg = NetworkUtils::StringToBytes(message);
+                    std::vector<std::byte> quitMsg = NetworkUtils::StringToBytes(message + "\n");
                     socket->Send(quitMsg);
                 } catch (...) {}
                 
@@ -151,8 +149,8 @@ public:
             }
             
             try {
-                // Convert string message to byte vector
-                std::vector<std::byte> msgData = NetworkUtils::StringToBytes(message);
+                // Convert string message to a newline-terminated byte vector
+                std::vector<std::byte> msgData = NetworkUtils::StringToBytes(message + "\n");
                 
                 // Send the message
                 if (!socket->Send(msgData)) {
@@ -10,6 +10,7 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -19,376 +20,878 @@
 #include "network/tcp_socket.h"
 #include "network/platform_factory.h"
 #include "network/byte_utils.h"  // Added byte utils header
+#include "network/buffer_pool.h"
+#include "network/line_framer.h"
+#include "network/buffered_writer.h"
+#include "network/outbound_queue.h"
+#include "network/socket_options.h"
+#include "network/cached_timestamp.h"
+#include "network/socket_poller.h"
+#include "network/sharded_registry.h"
+#include "network/timing_wheel.h"
+#include "network/metrics.h"
+#include "network/metrics_endpoint.h"
 
 // Platform-specific headers
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <signal.h>
+#include <sys/resource.h>
 #endif
 
 // Default port for the chat server
 constexpr int DEFAULT_PORT = 8084;
 constexpr int DEFAULT_BUFFER_SIZE = 1024;
+constexpr size_t MAX_LINE_LENGTH = 4096;
+// Outgoing messages wait in a bounded per-client queue that the client's writer thread
+// drains, so a client that stops reading never blocks broadcasts to everyone else
+constexpr size_t MAX_QUEUED_MESSAGES = 1024;
+constexpr size_t MAX_QUEUED_BYTES = 1024 * 1024;
+constexpr std::chrono::milliseconds BACKPRESSURE_TIMEOUT(50);
+// Bounds how long a writer thread can sit in a blocked send before rechecking its queue
+constexpr std::chrono::milliseconds SEND_TIMEOUT(1000);
+// Each drained batch is coalesced and written with one gather-write, or earlier once this much is pending
+constexpr size_t FLUSH_THRESHOLD = 16 * 1024;
+// Event-loop mode: replies to a worker's own readers go out at the end of the tick that made
+// them. Output queued from other threads waits this long for more to share its send; the
+// worker's poll timeout has millisecond resolution, so in practice that is at least 1 ms.
+constexpr std::chrono::microseconds FLUSH_DELAY(200);
+// Pending connections the kernel may hold while the accept loop catches up
+constexpr int LISTEN_BACKLOG = SOMAXCONN;
+// Event-loop mode: how long the accept loop stops listening after accept fails for lack of
+// descriptors or buffers, instead of spinning on the connection still queued
+constexpr std::chrono::milliseconds ACCEPT_BACKOFF(100);
+// Event-loop mode: bytes read per receive call and readiness events handled per wait
+constexpr size_t RECEIVE_CHUNK_SIZE = 64 * 1024;
+constexpr size_t MAX_READY_EVENTS = 256;
+// Clients silent for this long are disconnected; checked by per-client timers, not a periodic scan
+constexpr std::chrono::seconds IDLE_TIMEOUT(300);
+constexpr std::chrono::seconds REPORT_INTERVAL(30);
+// Prometheus metrics are served over HTTP on their own port; 0 turns the endpoint off
+constexpr int DEFAULT_METRICS_PORT = 9084;
+// How often the timer thread samples outbound queue depths for the metrics
+constexpr std::chrono::seconds QUEUE_SAMPLE_INTERVAL(1);
 
 // Signal handler for graceful termination
 std::atomic<bool> running(true);
 
-// Structure to represent a connected client
+struct EventWorker;
+
+// Outbound side of a client: the bounded queue and the write buffer its writer thread
+// (or, in event-loop mode, its worker) drains it into
+struct ClientOutput {
+    const int clientId;
+    OutboundQueue queue;
+    BufferedWriter writer;                      // Only used by the writer thread or worker
+    EventWorker* worker = nullptr;              // Owning worker in event-loop mode
+    std::atomic<bool> flushRequested{false};    // Set while the client waits in its worker's flush list
+    
+    ClientOutput(int id, ITcpSocket& socket, BufferPool& pool, OutboundQueue::OverflowPolicy policy,
+                 std::chrono::microseconds flushDelay = std::chrono::microseconds::zero())
+        : clientId(id),
+          queue(policy, MAX_QUEUED_MESSAGES, MAX_QUEUED_BYTES, BACKPRESSURE_TIMEOUT),
+          writer(socket, pool, FLUSH_THRESHOLD, flushDelay) {}
+};
+
+// A connected client, shared by the registry and the threads (or worker) serving it.
+// Message handling reads and updates it without taking any registry lock.
 struct Client {
-    std::unique_ptr<ITcpSocket> socket;
-    std::string username;
+    const int id;
+    const std::shared_ptr<ITcpSocket> socket;
+    const std::shared_ptr<ClientOutput> output;
+    std::string username;                       // Written once, before authenticated is set
+    std::atomic<bool> authenticated{false};
+    std::atomic<std::time_t> lastActivity;
+    std::atomic<TimingWheel::TimerId> idleTimer{TimingWheel::INVALID_TIMER};
+    
+    // Thread-per-client mode: the client's handler and writer threads, guarded while they start and stop
+    std::mutex threadsMutex;
     std::unique_ptr<std::thread> handler;
-    bool authenticated;
-    std::time_t lastActivity;
-    std::atomic<bool> running;
+    std::unique_ptr<std::thread> writer;
+    
+    Client(int clientId, std::shared_ptr<ITcpSocket> clientSocket, std::shared_ptr<ClientOutput> clientOutput)
+        : id(clientId),
+          socket(std::move(clientSocket)),
+          output(std::move(clientOutput)),
+          lastActivity(std::time(nullptr)) {}
+    
+    bool isAuthenticated() const {
+        return authenticated.load(std::memory_order_acquire);
+    }
+    
+    void touch() {
+        lastActivity.store(std::time(nullptr), std::memory_order_relaxed);
+    }
+};
+
+// Line-protocol state of one connection
+struct ClientSession {
+    LineFramer framer{MAX_LINE_LENGTH};
+    bool active = true;
+};
+
+// Connection owned by an event-loop worker
+struct EventConnection {
+    std::shared_ptr<Client> client;
+    ClientSession session;
+    bool writeInterest = false;  // Registered for Writable because a flush left data pending
+    bool flushTimer = false;     // Listed in the worker's flushTimers
+};
+
+// One event-loop thread and the connections assigned to it. Other threads hand it new
+// connections and flush requests through its inbox and wake its poller; everything
+// else, including the connection map, is only touched by the worker thread.
+struct EventWorker {
+    std::unique_ptr<ISocketPoller> poller;
+    std::unordered_map<int, EventConnection> connections;
+    std::vector<int> flushTimers;           // Clients whose writer holds output until its flush deadline
+    std::vector<int> touched;               // Clients read this tick, flushed when it ends
+    std::thread thread;
+    
+    std::mutex inboxMutex;
+    std::vector<EventConnection> adopted;   // New connections to register
+    std::vector<int> flushRequests;         // Clients with newly queued output
+    bool stopped = false;                   // The worker left its loop and takes no more connections
+    
+    // Hand a new connection to the worker; returns false if the worker has stopped
+    bool adopt(EventConnection connection) {
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            if (stopped) {
+                return false;
+            }
+            wake = adopted.empty();
+            adopted.push_back(std::move(connection));
+        }
+        if (wake) {
+            poller->Wakeup();
+        }
+        return true;
+    }
     
-    Client() : authenticated(false), lastActivity(0), running(true) {}
-    
-    // Move constructor
-    Client(Client&& other) noexcept 
-        : socket(std::move(other.socket)), 
-          username(std::move(other.username)),
-          handler(std::move(other.handler)),
-          authenticated(other.authenticated),
-          lastActivity(other.lastActivity),
-          running(other.running.load()) {}
-    
-    // Move assignment operator
-    Client& operator=(Client&& other) noexcept {
-        if (this != &other) {
-            socket = std::move(other.socket);
-            username = std::move(other.username);
-            handler = std::move(other.handler);
-            authenticated = other.authenticated;
-            lastActivity = other.lastActivity;
-            running = other.running.load();
-        }
-        return *this;
-    }
-    
-    // Delete copy constructor and assignment
-    Client(const Client&) = delete;
-    Client& operator=(const Client&) = delete;
+    // Ask the worker to drain a client's queue; a client is listed at most once until the worker takes it
+    void requestFlush(ClientOutput& output) {
+        if (output.flushRequested.exchange(true)) {
+            return;
+        }
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            wake = flushRequests.empty();
+            flushRequests.push_back(output.clientId);
+        }
+        // A non-empty list means a wakeup is already on its way
+        if (wake) {
+            poller->Wakeup();
+        }
+    }
+};
+
+// Metrics served on the metrics port. Message handling only bumps relaxed atomics here and the
+// timer thread samples the queue depths, so a scrape never walks the clients or takes their locks.
+struct ChatMetrics {
+    MetricsRegistry registry;
+    MetricsRegistry::Counter& messagesReceived = registry.AddCounter(
+        "chat_messages_received_total", "Chat lines received from authenticated clients");
+    MetricsRegistry::Counter& messagesSent = registry.AddCounter(
+        "chat_messages_sent_total", "Messages queued for delivery to clients");
+    MetricsRegistry::Counter& messagesDropped = registry.AddCounter(
+        "chat_messages_dropped_total", "Messages refused, or older ones evicted, because a client's outbound queue was full");
+    MetricsRegistry::Counter& slowClientEvictions = registry.AddCounter(
+        "chat_client_evictions_total", "Clients disconnected by the server", "reason=\"slow\"");
+    MetricsRegistry::Counter& idleClientEvictions = registry.AddCounter(
+        "chat_client_evictions_total", "Clients disconnected by the server", "reason=\"idle\"");
+    MetricsRegistry::Histogram& broadcastSeconds = registry.AddHistogram(
+        "chat_broadcast_fanout_seconds", "Time to format a broadcast and queue it for every recipient",
+        MetricsRegistry::ExponentialBuckets(1e-6, 4, 12));
+    MetricsRegistry::Histogram& broadcastRecipients = registry.AddHistogram(
+        "chat_broadcast_recipients", "Recipients per broadcast", MetricsRegistry::ExponentialBuckets(1, 4, 8));
+    MetricsRegistry::Gauge& queuedMessages = registry.AddGauge(
+        "chat_outbound_queued_messages", "Messages waiting in client outbound queues, sampled every second");
+    MetricsRegistry::Gauge& maxQueueDepth = registry.AddGauge(
+        "chat_outbound_queue_max_depth", "Deepest client outbound queue, sampled every second");
 };
 
 class TCPLiveChatServer {
 private:
     std::unique_ptr<ITcpListener> server;
-    std::mutex clientsMutex;
-    std::unordered_map<int, Client> clients;
+    std::unique_ptr<ISocketPoller> acceptPoller;
+    // Sharded so that joins and leaves on different shards do not contend; broadcasts walk
+    // per-shard snapshots without holding a lock
+    ShardedRegistry<int, Client> clients;
+    // Authenticated clients by username, for /msg delivery and unique names
+    ShardedRegistry<std::string, Client> usernames;
+    // Idle deadlines and periodic reports, advanced by the timer thread
+    TimingWheel timers;
     std::atomic<bool> running;
     NetworkAddress serverAddress;
+    BufferPool bufferPool;
+    OutboundQueue::OverflowPolicy overflowPolicy;
+    CachedTimestamp timestamps;
+    // Zero selects thread-per-client mode
+    size_t workerCount;
+    std::vector<std::unique_ptr<EventWorker>> eventWorkers;
+    int nextClientId = 1;
+    ChatMetrics metrics;
+    int metricsPort;
+    std::unique_ptr<MetricsEndpoint> metricsEndpoint;
+    
+    // Queue text for one client; this never waits on the client's socket
+    void sendText(ClientOutput& output, std::string_view text) {
+        sendMessage(output, bufferPool.AcquireCopy({NetworkUtils::AsBytes(text)}));
+    }
+    
+    // Queue an already formatted message; broadcasts hand the same buffer to every recipient
+    void sendMessage(ClientOutput& output, const PooledBuffer& message) {
+        switch (output.queue.Push(message)) {
+        case OutboundQueue::PushResult::Overflowed:
+            std::cout << "Client " << output.clientId << " is not reading its messages, disconnecting" << std::endl;
+            metrics.messagesDropped.Increment();
+            metrics.slowClientEvictions.Increment();
+            break;
+        case OutboundQueue::PushResult::Rejected:
+            std::cerr << "Client " << output.clientId << " outbound queue full, message dropped" << std::endl;
+            metrics.messagesDropped.Increment();
+            return;
+        case OutboundQueue::PushResult::Closed:
+            return;
+        case OutboundQueue::PushResult::DroppedOldest:
+            metrics.messagesDropped.Increment();
+            metrics.messagesSent.Increment();
+            break;
+        default:
+            metrics.messagesSent.Increment();
+            break;
+        }
+        
+        // Writer threads wait on the queue themselves; a worker has to be told
+        if (output.worker) {
+            output.worker->requestFlush(output);
+        }
+    }
+    
+    // Writer thread: drains the client's queue and writes each batch with one flush
+    static void drainOutput(std::shared_ptr<ClientOutput> output, std::shared_ptr<ITcpSocket> socket) {
+        while (socket->IsValid() && !output->queue.IsClosed()) {
+            // A timed-out send leaves the rest pending and the queue untouched, so a stalled
+            // reader backs up into the queue, where the overflow policy applies
+            if (output->writer.DrainFrom(output->queue, std::chrono::milliseconds(100)) < 0 &&
+                !ISocketPoller::LastCallWouldBlock()) {
+                return;
+            }
+        }
+        flushRemaining(*output);
+    }
+    
+    // Send what is still queued for a departing client (e.g. a rejection notice) as far as
+    // the socket takes it
+    static void flushRemaining(ClientOutput& output) {
+        std::vector<PooledBuffer> remaining;
+        output.queue.PopAll(remaining, std::chrono::milliseconds(0));
+        for (const PooledBuffer& message : remaining) {
+            output.writer.Write(message);
+        }
+        output.writer.Flush();
+    }
     
     // Helper function to get current timestamp as string
     std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        std::time_t time_t_now = std::chrono::system_clock::to_time_t(now);
-        
-        // Use ctime_s instead of ctime for safer string handling on Windows
-        char timestamp[26];
-#ifdef _WIN32
-        ctime_s(timestamp, sizeof(timestamp), &time_t_now);
-#else
-        // Standard ctime on non-Windows platforms (less safe but more portable)
-        std::string temp = std::ctime(&time_t_now);
-        std::strncpy(timestamp, temp.c_str(), sizeof(timestamp) - 1);
-        timestamp[sizeof(timestamp) - 1] = '\0';
-#endif
-        
-        // Remove newline from timestamp
-        size_t len = std::strlen(timestamp);
-        if (len > 0 && (timestamp[len-1] == '\n' || timestamp[len-1] == '\r'))
-            timestamp[len-1] = '\0';
-            
-        return "[" + std::string(timestamp) + "] ";
+        return std::string(timestamps.Now().View());
     }
     
     // Helper function to broadcast message to all clients
     void broadcastMessage(const std::string& message, int senderId = -1) {
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        
-        for (auto& [id, client] : clients) {
-            if (id != senderId && client.authenticated && client.socket && client.socket->IsValid()) {
-                try {
-                    std::string formattedMessage = getTimestamp() + message + "\n";
-                    std::vector<std::byte> data = NetworkUtils::StringToBytes(formattedMessage);
-                    client.socket->Send(data);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error sending to client " << id << ": " << e.what() << std::endl;
-                }
+        const auto start = std::chrono::steady_clock::now();
+        size_t recipients = 0;
+        
+        // Format once into a shared buffer; each recipient's queue only takes a reference
+        PooledBuffer formattedMessage = bufferPool.AcquireCopy({NetworkUtils::AsBytes(timestamps.Now().View()),
+                                                                 NetworkUtils::AsBytes(message),
+                                                                 NetworkUtils::AsBytes("\n")});
+        
+        // The registry snapshot is walked without a lock, so joins and leaves carry on meanwhile
+        clients.ForEach([&](int id, const std::shared_ptr<Client>& client) {
+            if (id != senderId && client->isAuthenticated()) {
+                sendMessage(*client->output, formattedMessage);
+                ++recipients;
             }
-        }
+        });
+        
+        metrics.broadcastSeconds.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        metrics.broadcastRecipients.Observe(static_cast<double>(recipients));
     }
 
     // Helper function to send a private message to a specific user
-    bool sendPrivateMessage(const std::string& targetUsername, const std::string& message, int senderId) {
-        bool userFound = false;
-        std::string senderUsername;
-        
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        
-        // Get sender's username
-        if (clients.find(senderId) != clients.end()) {
-            senderUsername = clients[senderId].username;
-        } else {
-            return false; // Sender not found
+    bool sendPrivateMessage(const std::string& targetUsername, const std::string& message, Client& sender) {
+        std::shared_ptr<Client> target = usernames.Find(targetUsername);
+        if (!target) {
+            return false;
         }
         
-        // Find the target client by username
-        for (auto& [id, client] : clients) {
-            if (client.authenticated && client.username == targetUsername && client.socket && client.socket->IsValid()) {
-                try {
-                    std::string formattedMessage = getTimestamp() + "[Private from " + senderUsername + "]: " + message + "\n";
-                    std::vector<std::byte> data = NetworkUtils::StringToBytes(formattedMessage);
-                    client.socket->Send(data);
-                    userFound = true;
-                    break;
-                } catch (const std::exception& e) {
-                    std::cerr << "Error sending private message to " << targetUsername << ": " << e.what() << std::endl;
-                    return false;
-                }
-            }
-        }
+        sendText(*target->output, getTimestamp() + "[Private from " + sender.username + "]: " + message + "\n");
         
         // Also send confirmation to the sender
-        if (userFound && clients.find(senderId) != clients.end() && 
-            clients[senderId].socket && clients[senderId].socket->IsValid()) {
-            try {
-                std::string confirmation = getTimestamp() + "[Private to " + targetUsername + "]: " + message + "\n";
-                std::vector<std::byte> data = NetworkUtils::StringToBytes(confirmation);
-                clients[senderId].socket->Send(data);
-            } catch (const std::exception& e) {
-                std::cerr << "Error sending confirmation to sender: " << e.what() << std::endl;
-            }
-        }
+        sendText(*sender.output, getTimestamp() + "[Private to " + targetUsername + "]: " + message + "\n");
         
-        return userFound;
+        return true;
+    }
+    
+    // Stop a removed client's threads; what is already queued is written before the socket closes
+    static void shutdownClient(Client& client) {
+        client.output->queue.Close();
+        
+        std::lock_guard<std::mutex> lock(client.threadsMutex);
+        if (client.writer && client.writer->joinable()) {
+            client.writer->join();
+        }
+        client.socket->Close();
+        // The handler exits on its own once the socket is closed
+        if (client.handler && client.handler->joinable()) {
+            client.handler->detach();
+        }
     }
     
     // Remove disconnected client
     void removeClient(int clientId) {
-        std::lock_guard<std::mutex> lock(clientsMutex);
+        // Only the caller that actually removes the entry shuts the client down
+        std::shared_ptr<Client> client = clients.Remove(clientId);
+        if (!client) {
+            return;
+        }
         
-        if (clients.find(clientId) != clients.end()) {
-            std::string username = clients[clientId].username;
-            
-            // Broadcast that user has left if they were authenticated
-            if (clients[clientId].authenticated && !username.empty()) {
-                broadcastMessage(username + " has left the chat", clientId);
-            }
-            
-            // Signal the thread to terminate
-            clients[clientId].running = false;
-            
-            // Join the client handler thread if joinable, with a timeout
-            if (clients[clientId].handler && clients[clientId].handler->joinable()) {
-                // Set a timeout for the join using a detached thread
-                std::thread joinThread([this, clientId]() {
-                    if (clients[clientId].handler->joinable()) {
-                        clients[clientId].handler->join();
-                    }
-                });
-                joinThread.detach(); // Detach the join thread itself
-            }
-            
-            // Close the socket and remove from clients map
-            if (clients[clientId].socket) {
-                clients[clientId].socket->Close();
-            }
-            clients.erase(clientId);
-            
-            std::cout << "Client " << clientId;
-            if (!username.empty()) {
-                std::cout << " (" << username << ")";
-            }
-            std::cout << " disconnected. Total clients: " << clients.size() << std::endl;
+        std::cout << "Client " << clientId;
+        if (client->isAuthenticated()) {
+            std::cout << " (" << client->username << ")";
+        }
+        std::cout << " disconnected. Total clients: " << clients.Size() << std::endl;
+        timers.Cancel(client->idleTimer.load());
+        
+        // Joining the writer may wait for one send timeout
+        shutdownClient(*client);
+        
+        OutboundQueue::Stats stats = client->output->queue.GetStats();
+        if (stats.dropped > 0 || stats.rejected > 0) {
+            std::cout << "Client " << clientId << " outbound queue: " << stats.dropped << " dropped, "
+                      << stats.rejected << " rejected, high-water " << stats.highWater << " messages" << std::endl;
+        }
+        
+        // Broadcast that user has left if they were authenticated
+        if (client->isAuthenticated()) {
+            usernames.Remove(client->username, client);
+            broadcastMessage(client->username + " has left the chat", clientId);
         }
     }
     
-    // Handle client messages
-    void handleClient(int clientId) {
-        if (clients.find(clientId) == clients.end() || !clients[clientId].socket) {
-            return;
+    // Register the client under the name from its first line; returns false if the name is taken
+    bool authenticateClient(const std::shared_ptr<Client>& clientPtr, std::string_view line) {
+        Client& client = *clientPtr;
+        
+        // Remove leading and trailing whitespace
+        std::string username;
+        size_t start = line.find_first_not_of(" \t");
+        size_t end = line.find_last_not_of(" \t");
+        if (start != std::string_view::npos && end != std::string_view::npos) {
+            username = line.substr(start, end - start + 1);
         }
         
-        std::vector<std::byte> buffer;  // Changed to std::byte buffer
+        if (username.empty()) {
+            username = "Guest" + std::to_string(client.id);
+        }
         
-        try {
-            // First message from client should be their username
-            buffer.clear();  // Ensure buffer is empty before receiving
-            int bytesRead = clients[clientId].socket->Receive(buffer);
-            if (bytesRead <= 0) {
-                throw std::runtime_error("Client disconnected during authentication");
-            }
-            
-            // Convert received bytes to string
-            std::string username = NetworkUtils::BytesToString(buffer);
-            
-            // Trim any trailing newlines or whitespace from username
-            auto removeSpecialChars = [](std::string& str, const std::string& chars) {
-                for (char c : chars) {
-                    str.erase(std::remove(str.begin(), str.end(), c), str.end());
+        if (!usernames.Insert(username, clientPtr)) {
+            std::cout << "Client " << client.id << " rejected: username '" << username << "' is taken" << std::endl;
+            sendText(*client.output, getTimestamp() + "Username " + username + " is already taken.\n");
+            return false;
+        }
+        
+        // Readers only look at the username once they see the flag
+        client.username = std::move(username);
+        client.touch();
+        client.authenticated.store(true, std::memory_order_release);
+        
+        // A removal that ran before the flag was set did not see the name, so drop it here
+        if (clients.Find(client.id) != clientPtr) {
+            usernames.Remove(client.username, clientPtr);
+            return false;
+        }
+        std::cout << "Client " << client.id << " authenticated as: '" << client.username << "'" << std::endl;
+        
+        // Inform all clients about the new user
+        broadcastMessage(client.username + " has joined the chat", client.id);
+        
+        // Send welcome message to the client
+        std::string welcomeMsg = getTimestamp() + "Welcome to the chat, " + client.username + "!\n";
+        sendText(*client.output, welcomeMsg);
+        return true;
+    }
+    
+    // Handle one chat line from an authenticated client; returns false when the client quits
+    bool processMessage(Client& client, std::string_view message) {
+        // Update last activity time; a relaxed store on the client's own entry, no lock
+        client.touch();
+        
+        ClientOutput& output = *client.output;
+        const std::string& username = client.username;
+        
+        if (message.empty()) {
+            return true;
+        }
+        
+        // Check for command messages
+        if (message == "/quit") {
+            std::cout << "Client " << client.id << " (" << username << ") quit the chat." << std::endl;
+            return false;
+        } else if (message == "/users") {
+            // Send list of connected users
+            std::string userList = "Connected users:\n";
+            clients.ForEach([&](int, const std::shared_ptr<Client>& other) {
+                if (other->isAuthenticated()) {
+                    userList += "- " + other->username + "\n";
+                }
+            });
+            sendText(output, userList);
+        } else if (message.rfind("/msg ", 0) == 0) {
+            // Private message command
+            size_t spacePos = message.find(' ', 5);
+            if (spacePos != std::string_view::npos) {
+                std::string targetUsername(message.substr(5, spacePos - 5));
+                std::string privateMessage(message.substr(spacePos + 1));
+                if (!sendPrivateMessage(targetUsername, privateMessage, client)) {
+                    std::string errorMsg = getTimestamp() + "User " + targetUsername + " not found.\n";
+                    sendText(output, errorMsg);
                 }
-            };
-            removeSpecialChars(username, "\n\r\0");
-            
-            // Remove leading and trailing whitespace
-            size_t start = username.find_first_not_of(" \t");
-            size_t end = username.find_last_not_of(" \t");
-            if (start != std::string::npos && end != std::string::npos) {
-                username = username.substr(start, end - start + 1);
             } else {
-                username.clear(); // All whitespace or empty
+                std::string errorMsg = getTimestamp() + "Invalid private message format. Use /msg <username> <message>\n";
+                sendText(output, errorMsg);
             }
-            
-            if (username.empty()) {
-                username = "Guest" + std::to_string(clientId);
+        } else {
+            // Broadcast the message to all clients
+            metrics.messagesReceived.Increment();
+            std::string text(message);
+            broadcastMessage(username + ": " + text, client.id);
+            std::cout << "Message from " << username << ": " << text << std::endl;
+        }
+        return true;
+    }
+    
+    // Frame received bytes into lines and handle them; returns false once the session has ended
+    bool handleReceived(const std::shared_ptr<Client>& clientPtr, ClientSession& session, std::span<const std::byte> data) {
+        Client& client = *clientPtr;
+        // Several lines may arrive in one segment and one line may span segments
+        auto onLine = [&](std::string_view line) {
+            if (!session.active) {
+                return;
             }
-            
-            {
-                std::lock_guard<std::mutex> lock(clientsMutex);
-                clients[clientId].username = username;
-                clients[clientId].authenticated = true;
-                clients[clientId].lastActivity = std::time(nullptr);
-                
-                std::cout << "Client " << clientId << " authenticated as: '" << username << "'" << std::endl;
+            // First line from client should be their username
+            if (!client.isAuthenticated()) {
+                session.active = authenticateClient(clientPtr, line);
+                return;
             }
-            
-            // Inform all clients about the new user
-            broadcastMessage(username + " has joined the chat", clientId);
-            
-            // Send welcome message to the client
-            std::string welcomeMsg = getTimestamp() + "Welcome to the chat, " + username + "!\n";
-            std::vector<std::byte> welcomeData = NetworkUtils::StringToBytes(welcomeMsg);
-            clients[clientId].socket->Send(welcomeData);
-            
-            // Main message processing loop
-            while (running && clients[clientId].running && clients[clientId].socket->IsValid()) {
+            session.active = processMessage(client, line);
+        };
+        
+        if (!session.framer.Feed(data, onLine)) {
+            std::string errorMsg = getTimestamp() + "Message too long (limit is " +
+                                   std::to_string(MAX_LINE_LENGTH) + " bytes)\n";
+            sendText(*client.output, errorMsg);
+        }
+        return session.active;
+    }
+    
+    // Handle client messages (thread-per-client mode)
+    void handleClient(std::shared_ptr<Client> client) {
+        ClientSession session;
+        ITcpSocket& socket = *client->socket;
+        const OutboundQueue& queue = client->output->queue;
+        
+        try {
+            // Main message processing loop; a closed queue means the client was removed or overflowed
+            while (session.active && running && socket.IsValid() && !queue.IsClosed()) {
                 // Wait for data with a short timeout to allow checking running status
-                if (!clients[clientId].socket->WaitForDataWithTimeout(100)) {
+                if (!socket.WaitForDataWithTimeout(100)) {
                     continue; // Timeout, check running status
                 }
                 
-                try {
-                    buffer.clear();  // Clear the buffer before receiving new data
-                    int bytesRead = clients[clientId].socket->Receive(buffer);
-                    if (bytesRead <= 0) {
-                        break;  // Client disconnected
-                    }
-                    
-                    // Convert received bytes to string
-                    std::string message = NetworkUtils::BytesToString(buffer);
-                    
-                    // Trim any trailing newlines or whitespace from message
-                    message.erase(std::remove(message.begin(), message.end(), '\n'), message.end());
-                    message.erase(std::remove(message.begin(), message.end(), '\r'), message.end());
-                    message.erase(std::remove(message.begin(), message.end(), '\0'), message.end());
-                    
-                    // Update last activity time
-                    {
-                        std::lock_guard<std::mutex> lock(clientsMutex);
-                        clients[clientId].lastActivity = std::time(nullptr);
+                // Receive directly into a pooled block
+                PooledBuffer buffer = bufferPool.Acquire();
+                int bytesRead = socket.Receive(buffer.WritableSpan());
+                if (bytesRead <= 0) {
+                    if (!client->isAuthenticated()) {
+                        throw std::runtime_error("Client disconnected during authentication");
                     }
-                    
-                    // Check for command messages
-                    if (message == "/quit") {
-                        std::string username;
-                        {
-                            std::lock_guard<std::mutex> lock(clientsMutex);
-                            if (clients.find(clientId) != clients.end()) {
-                                username = clients[clientId].username;
-                            }
-                        }
-                        std::cout << "Client " << clientId << " (" << username << ") quit the chat." << std::endl;
-                        break;
-                    } else if (message == "/users") {
-                        // Send list of connected users
-                        std::string userList = "Connected users:\n";
-                        {
-                            std::lock_guard<std::mutex> lock(clientsMutex);
-                            for (const auto& [_, client] : clients) {
-                                if (client.authenticated) {
-                                    userList += "- " + client.username + "\n";
-                                }
-                            }
-                        }
-                        std::vector<std::byte> listData = NetworkUtils::StringToBytes(userList);
-                        clients[clientId].socket->Send(listData);
-                    } else if (message.rfind("/msg ", 0) == 0) {
-                        // Private message command
-                        size_t spacePos = message.find(' ', 5);
-                        if (spacePos != std::string::npos) {
-                            std::string targetUsername = message.substr(5, spacePos - 5);
-                            std::string privateMessage = message.substr(spacePos + 1);
-                            if (!sendPrivateMessage(targetUsername, privateMessage, clientId)) {
-                                std::string errorMsg = getTimestamp() + "User " + targetUsername + " not found.\n";
-                                std::vector<std::byte> errorData = NetworkUtils::StringToBytes(errorMsg);
-                                clients[clientId].socket->Send(errorData);
-                            }
-                        } else {
-                            std::string errorMsg = getTimestamp() + "Invalid private message format. Use /msg <username> <message>\n";
-                            std::vector<std::byte> errorData = NetworkUtils::StringToBytes(errorMsg);
-                            clients[clientId].socket->Send(errorData);
-                        }
-                    } else {
-                        // Broadcast the message to all clients
-                        broadcastMessage(username + ": " + message, clientId);
-                        std::cout << "Message from " << username << ": " << message << std::endl;
-                    }
-                } catch (const std::exception& e) {
-                    std::cerr << "Error handling client " << clientId << ": " << e.what() << std::endl;
-                    break;
+                    break;  // Client disconnected
                 }
+                buffer.Resize(bytesRead);
+                
+                handleReceived(client, session, buffer.Span());
             }
         } catch (const std::exception& e) {
-            std::cerr << "Error handling client " << clientId << ": " << e.what() << std::endl;
+            std::cerr << "Error handling client " << client->id << ": " << e.what() << std::endl;
         }
         
         // Client disconnected or error occurred, remove the client
-        removeClient(clientId);
+        removeClient(client->id);
     }
     
-    // Thread to monitor inactive clients and remove them
-    void monitorInactiveClients() {
+    // Event-loop worker: waits on its poller and serves every connection assigned to it
+    void runEventWorker(EventWorker& worker) {
+        std::vector<ISocketPoller::Ready> ready(MAX_READY_EVENTS);
+        std::vector<std::byte> receiveBuffer(RECEIVE_CHUNK_SIZE);
+        std::vector<EventConnection> adopted;
+        std::vector<int> flushRequests;
+        
         while (running) {
-            std::this_thread::sleep_for(std::chrono::seconds(30));
-            
-            std::vector<int> inactiveClients;
-            std::time_t currentTime = std::time(nullptr);
+            int count = worker.poller->Wait(std::span<ISocketPoller::Ready>(ready), nextFlushTimeout(worker));
+            if (count < 0) {
+                std::cerr << "Event worker wait failed, stopping worker" << std::endl;
+                break;
+            }
             
             {
-                std::lock_guard<std::mutex> lock(clientsMutex);
-                for (const auto& [id, client] : clients) {
-                    // If client has been inactive for more than 5 minutes, disconnect them
-                    if (difftime(currentTime, client.lastActivity) > 300) {
-                        inactiveClients.push_back(id);
-                    }
+                std::lock_guard<std::mutex> lock(worker.inboxMutex);
+                adopted.swap(worker.adopted);
+                flushRequests.swap(worker.flushRequests);
+            }
+            
+            for (EventConnection& connection : adopted) {
+                int clientId = connection.client->id;
+                if (!worker.poller->Add(*connection.client->socket, ISocketPoller::Readable, static_cast<uint64_t>(clientId))) {
+                    std::cerr << "Failed to register client " << clientId << " with its event worker" << std::endl;
+                    removeClient(clientId);
+                    continue;
                 }
+                worker.connections.emplace(clientId, std::move(connection));
             }
+            adopted.clear();
             
-            for (int id : inactiveClients) {
-                std::string username;
-                {
-                    std::lock_guard<std::mutex> lock(clientsMutex);
-                    if (clients.find(id) != clients.end()) {
-                        username = clients[id].username;
+            for (int i = 0; i < count; ++i) {
+                int clientId = static_cast<int>(ready[i].token);
+                auto it = worker.connections.find(clientId);
+                if (it == worker.connections.end()) {
+                    continue;
+                }
+                
+                EventConnection& connection = it->second;
+                bool open = true;
+                if (ready[i].events & ISocketPoller::Readable) {
+                    open = receiveEvent(connection, receiveBuffer);
+                    if (open) {
+                        worker.touched.push_back(clientId);
                     }
+                } else if (ready[i].events & ISocketPoller::Closed) {
+                    open = false;
+                }
+                if (open && (ready[i].events & ISocketPoller::Writable)) {
+                    open = flushEvent(worker, clientId, connection);
+                }
+                if (!open) {
+                    closeEventConnection(worker, clientId);
                 }
-                std::cout << "Removed inactive client: " << id;
-                if (!username.empty()) {
-                    std::cout << " (" << username << ")";
+            }
+            
+            for (int clientId : flushRequests) {
+                auto it = worker.connections.find(clientId);
+                if (it == worker.connections.end()) {
+                    continue;
+                }
+                // Cleared before draining, so output queued from now on gets a new request
+                it->second.client->output->flushRequested = false;
+                if (!flushEvent(worker, clientId, it->second)) {
+                    closeEventConnection(worker, clientId);
+                }
+            }
+            flushRequests.clear();
+            
+            flushDueOutput(worker);
+            flushTouched(worker);
+        }
+        
+        // A worker that failed while the server runs closes its clients itself, since
+        // stop() will not come for them
+        if (running) {
+            abandonEventConnections(worker);
+        }
+        
+        // The sockets close once stop() has released the clients as well
+        worker.connections.clear();
+    }
+    
+    // Close every connection of a failed worker, including ones it has not registered yet,
+    // and refuse further ones
+    void abandonEventConnections(EventWorker& worker) {
+        std::vector<EventConnection> adopted;
+        {
+            std::lock_guard<std::mutex> lock(worker.inboxMutex);
+            worker.stopped = true;
+            adopted.swap(worker.adopted);
+        }
+        for (EventConnection& connection : adopted) {
+            removeClient(connection.client->id);
+        }
+        
+        std::vector<int> clientIds;
+        clientIds.reserve(worker.connections.size());
+        for (const auto& [clientId, connection] : worker.connections) {
+            clientIds.push_back(clientId);
+        }
+        for (int clientId : clientIds) {
+            closeEventConnection(worker, clientId);
+        }
+    }
+    
+    // Read what a readable connection has; returns false when the connection should close
+    bool receiveEvent(EventConnection& connection, std::vector<std::byte>& buffer) {
+        int bytesRead = connection.client->socket->Receive(std::span<std::byte>(buffer));
+        if (bytesRead < 0) {
+            return ISocketPoller::LastCallWouldBlock();
+        }
+        if (bytesRead == 0) {
+            return false;  // Client disconnected
+        }
+        return handleReceived(connection.client, connection.session,
+                              std::span<const std::byte>(buffer.data(), static_cast<size_t>(bytesRead)));
+    }
+    
+    // Send as much as the socket takes, taking more from the client's queue only once the
+    // writer is no longer stalled. Small output is held for its flush deadline unless flushNow
+    // is set; write interest stays registered while a stalled flush has data pending. Returns
+    // false when the connection should close.
+    bool flushEvent(EventWorker& worker, int clientId, EventConnection& connection, bool flushNow = false) {
+        ClientOutput& output = *connection.client->output;
+        int result = output.writer.DrainFrom(output.queue);
+        if (flushNow && result >= 0 && !output.writer.IsStalled()) {
+            result = output.writer.Flush();
+        }
+        if (result < 0 && !ISocketPoller::LastCallWouldBlock()) {
+            return false;
+        }
+        // A closed queue means the client was removed or overflowed; what fit has been sent
+        if (output.queue.IsClosed()) {
+            return false;
+        }
+        
+        if (!connection.flushTimer && output.writer.GetFlushDeadline() != BufferedWriter::Clock::time_point::max()) {
+            worker.flushTimers.push_back(clientId);
+            connection.flushTimer = true;
+        }
+        
+        // Output held for the timer needs no write interest; only a stalled flush waits for the socket
+        bool pending = output.writer.IsStalled();
+        if (pending != connection.writeInterest) {
+            uint32_t events = ISocketPoller::Readable | (pending ? ISocketPoller::Writable : 0u);
+            if (!worker.poller->Modify(*connection.client->socket, events, static_cast<uint64_t>(clientId))) {
+                return false;
+            }
+            connection.writeInterest = pending;
+        }
+        return true;
+    }
+    
+    // Poll timeout until the earliest flush deadline, rounded up to whole milliseconds; -1 if none
+    static int nextFlushTimeout(const EventWorker& worker) {
+        auto deadline = BufferedWriter::Clock::time_point::max();
+        for (int clientId : worker.flushTimers) {
+            auto it = worker.connections.find(clientId);
+            if (it != worker.connections.end()) {
+                deadline = std::min(deadline, it->second.client->output->writer.GetFlushDeadline());
+            }
+        }
+        if (deadline == BufferedWriter::Clock::time_point::max()) {
+            return -1;
+        }
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline - BufferedWriter::Clock::now());
+        return static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count(), 0));
+    }
+    
+    // Send the output whose flush deadline has passed; the rest stays listed
+    void flushDueOutput(EventWorker& worker) {
+        if (worker.flushTimers.empty()) {
+            return;
+        }
+        std::vector<int> timers;
+        timers.swap(worker.flushTimers);
+        
+        const auto now = BufferedWriter::Clock::now();
+        for (int clientId : timers) {
+            auto it = worker.connections.find(clientId);
+            if (it == worker.connections.end()) {
+                continue;
+            }
+            EventConnection& connection = it->second;
+            connection.flushTimer = false;
+            const auto deadline = connection.client->output->writer.GetFlushDeadline();
+            if (deadline == BufferedWriter::Clock::time_point::max()) {
+                continue;   // Sent meanwhile, or stalled and waiting for the socket instead
+            }
+            if (deadline > now) {
+                worker.flushTimers.push_back(clientId);
+                connection.flushTimer = true;
+            } else if (!flushEvent(worker, clientId, connection)) {
+                closeEventConnection(worker, clientId);
+            }
+        }
+    }
+    
+    // End of a tick: send what the connections read in it have queued, without the flush delay.
+    // Their replies then share one send per tick and never wait for the poll timeout.
+    void flushTouched(EventWorker& worker) {
+        for (int clientId : worker.touched) {
+            auto it = worker.connections.find(clientId);
+            if (it != worker.connections.end() && !flushEvent(worker, clientId, it->second, true)) {
+                closeEventConnection(worker, clientId);
+            }
+        }
+        worker.touched.clear();
+    }
+    
+    // Unregister a connection from its worker and remove the client
+    void closeEventConnection(EventWorker& worker, int clientId) {
+        auto it = worker.connections.find(clientId);
+        if (it == worker.connections.end()) {
+            return;
+        }
+        EventConnection connection = std::move(it->second);
+        worker.connections.erase(it);
+        
+        flushRemaining(*connection.client->output);
+        
+        // Deregister before removeClient closes the socket
+        worker.poller->Remove(*connection.client->socket);
+        removeClient(clientId);
+    }
+    
+    // Ask a client to disconnect without waiting for it, so timer callbacks can call this. A
+    // worker-owned connection is closed by its worker, which is the only thread allowed to touch
+    // the socket. Otherwise the socket is shut down, which ends the client's blocked sends and
+    // reads, and its handler thread sees the closed queue and removes it.
+    void disconnectClient(int clientId) {
+        std::shared_ptr<Client> client = clients.Find(clientId);
+        if (!client) {
+            return;
+        }
+        
+        ClientOutput& output = *client->output;
+        output.queue.Close();
+        if (output.worker) {
+            output.worker->requestFlush(output);
+        } else {
+            client->socket->Shutdown();
+        }
+    }
+    
+    // Timer thread: advances the timing wheel once per tick, which runs the idle checks and reports
+    void runTimers() {
+        while (running) {
+            std::this_thread::sleep_for(timers.GetTick());
+            timers.Advance();
+        }
+    }
+    
+    // Arm a client's idle deadline. Activity only refreshes the client's timestamp without touching
+    // the wheel; the check re-arms itself for whatever is left of the timeout.
+    void scheduleIdleCheck(const std::shared_ptr<Client>& client, std::chrono::seconds delay) {
+        std::weak_ptr<Client> weakClient = client;
+        client->idleTimer = timers.Schedule(delay, [this, weakClient]() { checkIdle(weakClient); });
+    }
+    
+    void checkIdle(const std::weak_ptr<Client>& weakClient) {
+        std::shared_ptr<Client> client = weakClient.lock();
+        if (!client || clients.Find(client->id) != client) {
+            return;  // Already removed
+        }
+        
+        std::time_t idleSeconds = std::time(nullptr) - client->lastActivity.load(std::memory_order_relaxed);
+        if (idleSeconds < IDLE_TIMEOUT.count()) {
+            scheduleIdleCheck(client, IDLE_TIMEOUT - std::chrono::seconds(std::max<std::time_t>(idleSeconds, 0)));
+            return;
+        }
+        
+        std::string username = client->isAuthenticated() ? client->username : std::string();
+        std::cout << "Removed inactive client: " << client->id;
+        if (!username.empty()) {
+            std::cout << " (" << username << ")";
+        }
+        std::cout << " (timeout after 5 minutes of inactivity)" << std::endl;
+        metrics.idleClientEvictions.Increment();
+        broadcastMessage(username + " has timed out");
+        disconnectClient(client->id);
+    }
+    
+    // Periodic queue and registry report; re-schedules itself
+    void scheduleReport() {
+        timers.Schedule(REPORT_INTERVAL, [this]() {
+            printOutboundQueues();
+            printRegistryStats();
+            scheduleReport();
+        });
+    }
+    
+    // Sample the outbound queue depths into the metrics; re-schedules itself
+    void scheduleQueueSample() {
+        timers.Schedule(QUEUE_SAMPLE_INTERVAL, [this]() {
+            size_t queued = 0;
+            size_t deepest = 0;
+            clients.ForEach([&](int, const std::shared_ptr<Client>& client) {
+                size_t depth = client->output->queue.GetDepth();
+                queued += depth;
+                deepest = std::max(deepest, depth);
+            });
+            metrics.queuedMessages.Set(static_cast<double>(queued));
+            metrics.maxQueueDepth.Set(static_cast<double>(deepest));
+            scheduleQueueSample();
+        });
+    }
+    
+    // Report the per-client outbound queue depth of clients that are falling behind, with the
+    // kernel's view of their connection to tell a slow network from a client that stopped reading
+    void printOutboundQueues() {
+        for (const ClientQueueInfo& info : getOutboundQueueInfo()) {
+            if (info.stats.depth > 0 || info.stats.dropped > 0 || info.stats.rejected > 0) {
+                std::cout << "Client " << info.clientId << " (" << info.username << ") outbound queue: "
+                          << info.stats.depth << " messages / " << info.stats.depthBytes << " bytes queued, "
+                          << info.stats.dropped << " dropped, " << info.stats.rejected << " rejected" << std::endl;
+                if (info.hasTcpInfo) {
+                    const TcpInfo& tcp = info.tcp;
+                    std::cout << "    rtt " << tcp.rtt.count() << " us (+/- " << tcp.rttVariance.count() << "), cwnd "
+                              << tcp.congestionWindow << ", peer window " << tcp.peerReceiveWindow << " bytes, "
+                              << tcp.bytesInFlight << " bytes in flight, " << tcp.notSentBytes << " unsent, "
+                              << tcp.retransmits << " retransmits, delivery " << tcp.deliveryRate << " B/s, "
+                              << "peer-window-limited " << tcp.receiveWindowLimitedTime.count() / 1000 << " ms" << std::endl;
                 }
-                std::cout << " (timeout after 5 minutes of inactivity)" << std::endl;
-                broadcastMessage(username + " has timed out");
-                removeClient(id);
             }
         }
     }
 
+    // Report registry size and how often its shard locks had to wait
+    void printRegistryStats() {
+        ShardedRegistry<int, Client>::Stats stats = clients.GetStats();
+        std::cout << "Client registry: " << stats.size << " clients in " << clients.GetShardCount() << " shards, "
+                  << stats.writes << " joins/leaves, " << stats.snapshotRebuilds << " snapshot rebuilds, "
+                  << stats.contendedLocks << " contended locks" << std::endl;
+    }
+
 public:
-    TCPLiveChatServer(int port = DEFAULT_PORT) : running(false) {
+    // Outbound queue snapshot of one client
+    struct ClientQueueInfo {
+        int clientId;
+        std::string username;
+        OutboundQueue::Stats stats;
+        bool hasTcpInfo = false;    // Only read for clients that are falling behind
+        TcpInfo tcp{};
+    };
+    
+    // workers is the number of event-loop threads; zero keeps the thread-per-client model
+    TCPLiveChatServer(int port = DEFAULT_PORT,
+                      OutboundQueue::OverflowPolicy policy = OutboundQueue::OverflowPolicy::DropOldest,
+                      size_t workers = 0,
+                      int metricsPortNumber = DEFAULT_METRICS_PORT)
+        : running(false), overflowPolicy(policy), workerCount(workers), metricsPort(metricsPortNumber) {
         serverAddress.port = port;
+        // The registry's size is a relaxed atomic, so this is safe to read during a scrape
+        metrics.registry.AddGaugeFunction("chat_connected_clients", "Clients currently connected",
+                                          [this]() { return static_cast<double>(clients.Size()); });
         // We'll create the actual server in start()
     }
     
@@ -410,17 +913,36 @@ public:
         }
         
         // Start listening for connections
-        if (!server->Listen(5)) {
+        if (!server->Listen(LISTEN_BACKLOG)) {
             throw std::runtime_error("Failed to start listening for connections");
         }
         
         running = true;
         
-        // Start the inactive client monitor
-        std::thread monitorThread(&TCPLiveChatServer::monitorInactiveClients, this);
+        if (workerCount > 0) {
+            startEventWorkers();
+        }
+        startMetricsEndpoint();
+        
+        // Start the timer thread that disconnects idle clients
+        scheduleReport();
+        scheduleQueueSample();
+        std::thread timerThread(&TCPLiveChatServer::runTimers, this);
+        
+        if (workerCount > 0) {
+            acceptEventConnections();
+        } else {
+            runThreadPerClient();
+        }
         
-        // Main server loop - accept connections and create handler threads
-        int nextClientId = 1;
+        // Wait for the timer thread to finish
+        if (timerThread.joinable()) {
+            timerThread.join();
+        }
+    }
+    
+    // Accept loop of the thread-per-client model: each client gets a handler and a writer thread
+    void runThreadPerClient() {
         while (running) {
             try {
                 if (!server->WaitForDataWithTimeout(100)) {
@@ -437,54 +959,176 @@ public:
                 std::cout << "New client connected: " << clientId << std::endl;
                 
                 // Create a new client and add to the map
-                Client newClient;
-                newClient.socket = std::move(clientSocket);
-                newClient.authenticated = false;
-                newClient.lastActivity = std::time(nullptr);
+                std::shared_ptr<ITcpSocket> socket = std::move(clientSocket);
+                SocketOptions::SetSendTimeout(socket.get(), SEND_TIMEOUT);
                 
-                {
-                    std::lock_guard<std::mutex> lock(clientsMutex);
-                    clients.emplace(clientId, std::move(newClient));
-                }
+                auto output = std::make_shared<ClientOutput>(clientId, *socket, bufferPool, overflowPolicy);
+                auto client = std::make_shared<Client>(clientId, socket, output);
+                
+                // Held until both threads exist, so a quick disconnect cannot shut the client down half-started
+                std::lock_guard<std::mutex> lock(client->threadsMutex);
+                clients.Insert(clientId, client);
+                scheduleIdleCheck(client, IDLE_TIMEOUT);
                 
-                // Create a thread to handle this client
-                clients[clientId].handler = std::make_unique<std::thread>(
-                    &TCPLiveChatServer::handleClient, this, clientId);
+                // One thread reads and handles the client's lines, another writes its queued messages
+                client->writer = std::make_unique<std::thread>(&TCPLiveChatServer::drainOutput, output, socket);
+                client->handler = std::make_unique<std::thread>(&TCPLiveChatServer::handleClient, this, client);
                 
-                std::cout << "Total clients connected: " << clients.size() << std::endl;
+                std::cout << "Total clients connected: " << clients.Size() << std::endl;
             } catch (const std::exception& e) {
                 if (running) {
                     std::cerr << "Error accepting connection: " << e.what() << std::endl;
                 }
             }
         }
+    }
+    
+    // The endpoint serves scrapes from its own thread; the chat keeps running without it
+    void startMetricsEndpoint() {
+        if (metricsPort <= 0) {
+            return;
+        }
+        metricsEndpoint = std::make_unique<MetricsEndpoint>(NetworkFactorySingleton::GetInstance(), metrics.registry);
+        if (metricsEndpoint->Start(NetworkAddress("0.0.0.0", static_cast<unsigned short>(metricsPort)))) {
+            std::cout << "Serving Prometheus metrics at http://localhost:" << metricsPort << "/metrics" << std::endl;
+        } else {
+            std::cerr << "Failed to start the metrics endpoint on port " << metricsPort << std::endl;
+            metricsEndpoint.reset();
+        }
+    }
+    
+    // Event-loop model: a fixed set of workers serves all connections with non-blocking I/O,
+    // and the accept loop only accepts and hands each connection to a worker
+    void startEventWorkers() {
+        auto& factory = NetworkFactorySingleton::GetInstance();
+        acceptPoller = factory.CreateSocketPoller();
+        if (!acceptPoller) {
+            // A factory without pollers can still serve every client from threads of its own
+            std::cout << "No socket poller available, falling back to a thread per client" << std::endl;
+            workerCount = 0;
+            return;
+        }
+        if (!server->SetNonBlocking(true) || !acceptPoller->Add(*server, ISocketPoller::Readable, 0)) {
+            throw std::runtime_error("Failed to set up the event loop");
+        }
         
-        // Wait for the monitor thread to finish
-        if (monitorThread.joinable()) {
-            monitorThread.join();
+        for (size_t i = 0; i < workerCount; ++i) {
+            auto worker = std::make_unique<EventWorker>();
+            worker->poller = factory.CreateSocketPoller();
+            if (!worker->poller) {
+                throw std::runtime_error("Failed to create event worker poller");
+            }
+            eventWorkers.push_back(std::move(worker));
+        }
+        for (auto& worker : eventWorkers) {
+            worker->thread = std::thread(&TCPLiveChatServer::runEventWorker, this, std::ref(*worker));
+        }
+        std::cout << "Serving clients with " << workerCount << " event worker threads" << std::endl;
+    }
+    
+    // Accept loop of the event-loop model
+    void acceptEventConnections() {
+        ISocketPoller::Ready ready[1];
+        while (running) {
+            // Sleeps until a connection arrives or stop() wakes the poller
+            if (acceptPoller->Wait(std::span<ISocketPoller::Ready>(ready), -1) <= 0) {
+                continue;
+            }
+            
+            // Accept everything that is pending; the non-blocking listener then reports would-block
+            bool backOff = false;
+            while (running) {
+                auto clientSocket = server->AcceptTcp();
+                if (!clientSocket) {
+                    if (!ISocketPoller::LastCallWouldBlock()) {
+                        std::cerr << "Failed to accept client connection, pausing accepts for "
+                                  << ACCEPT_BACKOFF.count() << " ms" << std::endl;
+                        backOff = true;
+                    }
+                    break;
+                }
+                adoptClient(std::move(clientSocket));
+            }
+            if (backOff) {
+                pauseAccepting();
+            }
+        }
+    }
+    
+    // The listener stays readable while the failed connection is queued, so it leaves the
+    // poller for the backoff; stop() still wakes the wait
+    void pauseAccepting() {
+        if (!acceptPoller->Remove(*server)) {
+            std::this_thread::sleep_for(ACCEPT_BACKOFF);
+            return;
+        }
+        ISocketPoller::Ready ready[1];
+        do {
+            acceptPoller->Wait(std::span<ISocketPoller::Ready>(ready), static_cast<int>(ACCEPT_BACKOFF.count()));
+        } while (running && !acceptPoller->Add(*server, ISocketPoller::Readable, 0));
+    }
+    
+    // Register an accepted connection and hand it to a worker (round robin)
+    void adoptClient(std::unique_ptr<ITcpSocket> clientSocket) {
+        int clientId = nextClientId++;
+        std::cout << "New client connected: " << clientId << std::endl;
+        
+        std::shared_ptr<ITcpSocket> socket = std::move(clientSocket);
+        if (!socket->SetNonBlocking(true)) {
+            std::cerr << "Failed to make client " << clientId << " non-blocking" << std::endl;
+            return;
+        }
+        
+        EventWorker& worker = *eventWorkers[static_cast<size_t>(clientId) % eventWorkers.size()];
+        auto output = std::make_shared<ClientOutput>(clientId, *socket, bufferPool, overflowPolicy, FLUSH_DELAY);
+        output->worker = &worker;
+        
+        auto client = std::make_shared<Client>(clientId, socket, output);
+        clients.Insert(clientId, client);
+        scheduleIdleCheck(client, IDLE_TIMEOUT);
+        std::cout << "Total clients connected: " << clients.Size() << std::endl;
+        
+        EventConnection connection;
+        connection.client = std::move(client);
+        if (!worker.adopt(std::move(connection))) {
+            std::cerr << "Event worker for client " << clientId << " has stopped" << std::endl;
+            removeClient(clientId);
         }
     }
     
     void stop() {
         running = false;
         
-        // Close all client connections
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        for (auto& [id, client] : clients) {
-            client.running = false;
-            if (client.handler && client.handler->joinable()) {
-                client.handler->detach();
-            }
-            if (client.socket) {
-                client.socket->Close();
+        // Event workers own their sockets, so they stop before the clients are released
+        if (acceptPoller) {
+            acceptPoller->Wakeup();
+        }
+        for (auto& worker : eventWorkers) {
+            worker->poller->Wakeup();
+        }
+        for (auto& worker : eventWorkers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
             }
         }
-        clients.clear();
+        
+        // Close all client connections
+        usernames.RemoveAll();
+        for (auto& [id, client] : clients.RemoveAll()) {
+            shutdownClient(*client);
+        }
         
         // Stop the server
         if (server) {
             server->Close();
         }
+        if (metricsEndpoint) {
+            metricsEndpoint->Stop();
+        }
+        
+        BufferPool::Stats poolStats = bufferPool.GetStats();
+        std::cout << "Buffer pool: " << poolStats.hits << " hits, " << poolStats.misses << " misses, "
+                  << "high-water " << poolStats.highWater << " blocks" << std::endl;
         std::cout << "Chat server stopped" << std::endl;
     }
 
@@ -496,6 +1140,20 @@ public:
     int getPort() const {
         return serverAddress.port;
     }
+    
+    // Outbound queue depth and drop counters of every connected client
+    std::vector<ClientQueueInfo> getOutboundQueueInfo() {
+        std::vector<ClientQueueInfo> result;
+        clients.ForEach([&](int id, const std::shared_ptr<Client>& client) {
+            std::string username = client->isAuthenticated() ? client->username : std::string();
+            ClientQueueInfo info{id, std::move(username), client->output->queue.GetStats()};
+            if (info.stats.depth > 0 || info.stats.dropped > 0 || info.stats.rejected > 0) {
+                info.hasTcpInfo = client->socket->GetTcpInfo(info.tcp);
+            }
+            result.push_back(std::move(info));
+        });
+        return result;
+    }
 };
 
 // Global pointer to access server from signal handler
@@ -527,13 +1185,43 @@ void signalHandler(int signal) {
 
 int main(int argc, char* argv[]) {
     int port = DEFAULT_PORT;
+    OutboundQueue::OverflowPolicy policy = OutboundQueue::OverflowPolicy::DropOldest;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    int metricsPort = DEFAULT_METRICS_PORT;
     
-    // Parse command line arguments for port
+    // Parse command line arguments for port, slow-client policy, event worker count and metrics port
     if (argc > 1) {
         port = std::atoi(argv[1]);
     }
+    if (argc > 2) {
+        std::string policyName = argv[2];
+        if (policyName == "disconnect") {
+            policy = OutboundQueue::OverflowPolicy::Disconnect;
+        } else if (policyName == "backpressure") {
+            policy = OutboundQueue::OverflowPolicy::Backpressure;
+        } else if (policyName != "drop-oldest") {
+            std::cerr << "Usage: " << argv[0] << " [port] [drop-oldest|disconnect|backpressure] [workers] [metrics-port]" << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 3) {
+        // 0 selects the thread-per-client model
+        workers = static_cast<size_t>(std::max(0, std::atoi(argv[3])));
+    } else if (policy == OutboundQueue::OverflowPolicy::Backpressure) {
+        // Backpressure only works thread-per-client, so keep that model unless workers were asked for
+        workers = 0;
+    }
+    if (argc > 4) {
+        // 0 turns the metrics endpoint off
+        metricsPort = std::atoi(argv[4]);
+    }
+    // A blocked producer is usually an event worker, which would stall every connection it serves
+    if (policy == OutboundQueue::OverflowPolicy::Backpressure && workers > 0) {
+        std::cerr << "The backpressure policy needs the thread-per-client model (workers = 0)" << std::endl;
+        return 1;
+    }
     
-    TCPLiveChatServer chatServer(port);
+    TCPLiveChatServer chatServer(port, policy, workers, metricsPort);
     gServerPtr = &chatServer;
 
     // Register signal handler
@@ -545,6 +1233,17 @@ int main(int argc, char* argv[]) {
     sigemptyset(&sa.sa_mask);
     sa.sa_flags = 0;
     sigaction(SIGINT, &sa, nullptr);
+    
+    // A peer that disconnects mid-write must surface as a send error, not terminate the server
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, nullptr);
+    
+    // Every connection holds a descriptor; raise the soft limit as far as the hard limit allows
+    struct rlimit fileLimit;
+    if (getrlimit(RLIMIT_NOFILE, &fileLimit) == 0 && fileLimit.rlim_cur < fileLimit.rlim_max) {
+        fileLimit.rlim_cur = fileLimit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &fileLimit);
+    }
 #endif
     
     try {
@@ -13,6 +13,7 @@
 #include "network/udp_socket.h"
 #include "network/platform_factory.h"
 #include "network/byte_utils.h"  // Added byte utils header
+#include "network/reliable_channel.h"
 
 // Platform-specific headers
 #ifdef _WIN32
@@ -24,7 +25,8 @@
 // Default server settings
 constexpr int DEFAULT_PORT = 8085;  // Match UDP chat server port
 constexpr int HEARTBEAT_INTERVAL_S = 30;  // Seconds between heartbeat messages
-constexpr int RECEIVE_TIMEOUT_MS = 1000;  // 1000ms timeout for receive operations
+// How long disconnecting waits for the server to acknowledge what is still unacknowledged
+constexpr std::chrono::milliseconds QUIT_LINGER(500);
 constexpr const char* DEFAULT_SERVER = "127.0.0.1"; 
 constexpr int DEFAULT_BUFFER_SIZE = 4096; // Default buffer size for receiving data
 
@@ -36,44 +38,49 @@ std::mutex terminationMutex;
 class UdpLiveChatClient {
 private:
     std::unique_ptr<IUdpSocket> socket;
+    // Every line to and from the server goes through a reliable, ordered channel over the socket
+    std::unique_ptr<ReliableChannel> channel;
     NetworkAddress serverAddress;
     std::string username;
     std::thread receiveThread;
     std::thread heartbeatThread;
     bool initialized;
 
+    // Send one line to the server through the channel
+    void sendLine(const std::string& line) {
+        channel->Send(NetworkUtils::AsBytes(line));
+    }
+    
+    // Receive one datagram if one arrives within the timeout and hand it to the channel, which
+    // passes on every message it completes
+    void pumpChannel(int timeoutMs, const ReliableChannel::MessageCallback& onMessage) {
+        if (socket->WaitForDataWithTimeout(timeoutMs)) {
+            std::vector<std::byte> buffer(DEFAULT_BUFFER_SIZE);
+            NetworkAddress sender;
+            int bytesRead = socket->ReceiveFrom(std::span<std::byte>(buffer), sender);
+            if (bytesRead > 0) {
+                channel->Receive(std::span<const std::byte>(buffer.data(), bytesRead), onMessage);
+            }
+        }
+        
+        // Retransmissions and delayed acks
+        channel->Update();
+    }
+    
     // Function to receive and display messages from the server
     void receiveMessages() {
-        std::vector<std::byte> buffer(DEFAULT_BUFFER_SIZE); // Changed to std::byte buffer
+        auto printMessage = [this](std::span<const std::byte> message) {
+            // Print the message straight from the channel
+            std::cout << NetworkUtils::AsStringView(message);
+            
+            // Add a prompt after each message for better UX, including username
+            std::cout << username << "> " << std::flush;
+        };
         
         while (running) {
             try {
-                // Use WaitForDataWithTimeout to avoid blocking indefinitely
-                if (socket->WaitForDataWithTimeout(RECEIVE_TIMEOUT_MS)) {
-                    // Clear buffer before receiving new data
-                    buffer.clear();
-                    buffer.resize(DEFAULT_BUFFER_SIZE);
-                    
-                    NetworkAddress sender;
-                    int bytesRead = socket->ReceiveFrom(buffer, sender);
-                    
-                    if (bytesRead <= 0) {
-                        // No data, just continue checking the running flag
-                        continue;
-                    }
-                    
-                    // Resize buffer to actual data received
-                    buffer.resize(bytesRead);
-                    
-                    // Convert bytes to string for display
-                    std::string message = NetworkUtils::BytesToString(buffer);
-                    
-                    // Print the message
-                    std::cout << message;
-                    
-                    // Add a prompt after each message for better UX, including username
-                    std::cout << username << "> " << std::flush;
-                }
+                // Wake up at least once per channel update interval for its timers
+                pumpChannel(static_cast<int>(ReliableChannel::UPDATE_INTERVAL.count()), printMessage);
             } catch (const std::exception& e) {
                 if (running) {
                     std::cerr << "Error receiving data: " << e.what() << std::endl;
@@ -90,8 +97,7 @@ private:
         
         while (running) {
             try {
-                std::vector<std::byte> data = NetworkUtils::StringToBytes(heartbeatMsg);
-                socket->SendTo(data, serverAddress);
+                channel->Send(NetworkUtils::AsBytes(heartbeatMsg), ReliableChannel::Delivery::Unordered);
             } catch (const std::exception& e) {
                 if (running) {
                     std::cerr << "Error sending heartbeat: " << e.what() << std::endl;
@@ -122,12 +128,16 @@ public:
                 throw std::runtime_error("Failed to create UDP socket");
             }
             
+            IUdpSocket* channelSocket = socket.get();
+            NetworkAddress server = serverAddress;
+            channel = std::make_unique<ReliableChannel>([channelSocket, server](std::span<const std::byte> data) {
+                return channelSocket->SendTo(data, server) >= 0;
+            });
+            
             initialized = true;
             
             // Send registration message with username
-            std::string registerMsg = "REGISTER:" + username;
-            std::vector<std::byte> data = NetworkUtils::StringToBytes(registerMsg);
-            socket->SendTo(data, serverAddress);
+            sendLine("REGISTER:" + username);
             
             // Start the message receiving thread
             receiveThread = std::thread(&UdpLiveChatClient::receiveMessages, this);
@@ -160,18 +170,17 @@ public:
             if (message == "/quit") {
                 // Send quit command to server before disconnecting
                 try {
-                    std::vector<std::byte> data = NetworkUtils::StringToBytes(message);
-                    socket->SendTo(data, serverAddress);
+                    sendLine(message);
                 } catch (...) {}
-                
+
                 running = false;
+                terminationCv.notify_all();
                 break;
             }
             
             if (!message.empty()) {
                 try {
-                    std::vector<std::byte> data = NetworkUtils::StringToBytes(message);
-                    socket->SendTo(data, serverAddress);
+                    sendLine(message);
                     
                     // Don't print prompt if the command will yield a server response
                     if (message != "/users" && message.rfind("/msg ", 0) != 0) {
@@ -193,18 +202,6 @@ public:
         // Notify all waiting threads about termination
         terminationCv.notify_all();
         
-        // Try to send a quit message to the server
-        try {            
-            std::string quitMsg = "/quit";
-            std::vector<std::byte> data = NetworkUtils::StringToBytes(quitMsg);
-            socket->SendTo(data, serverAddress);
-        } catch (...) {}
-        
-        // Close the client socket
-        if (initialized && socket) {
-            socket->Close();
-        }
-        
         // Wait for threads to finish
         if (receiveThread.joinable()) {
             receiveThread.join();
@@ -214,6 +211,24 @@ public:
             heartbeatThread.join();
         }
         
+        // Try to send a quit message to the server, and give the channel a moment to get it
+        // and anything else still unacknowledged through
+        if (initialized && channel) {
+            try {
+                sendLine("/quit");
+                auto deadline = std::chrono::steady_clock::now() + QUIT_LINGER;
+                while (channel->GetUnackedCount() > 0 && std::chrono::steady_clock::now() < deadline) {
+                    pumpChannel(static_cast<int>(ReliableChannel::UPDATE_INTERVAL.count()),
+                                [](std::span<const std::byte>) {});
+                }
+            } catch (...) {}
+        }
+        
+        // Close the client socket
+        if (initialized && socket) {
+            socket->Close();
+        }
+        
         std::cout << "Disconnected from chat server." << std::endl;
     }
 
@@ -225,9 +240,7 @@ public:
         if (initialized && socket) {
             // Send a quick disconnect message if possible
             try {
-                std::string quitMsg = "/quit";
-                std::vector<std::byte> data = NetworkUtils::StringToBytes(quitMsg);
-                socket->SendTo(data, serverAddress);
+                sendLine("/quit");
             } catch (...) {} // Ignore errors
             
             socket->Close();
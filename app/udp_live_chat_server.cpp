@@ -10,6 +10,7 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -18,7 +19,17 @@
 #include "network/network.h"
 #include "network/udp_socket.h"
 #include "network/platform_factory.h"
+#include "network/socket_options.h"
 #include "network/byte_utils.h"  // Added byte utils header
+#include "network/buffer_pool.h"
+#include "network/line_framer.h"
+#include "network/cached_timestamp.h"
+#include "network/sharded_registry.h"
+#include "network/flat_hash_map.h"
+#include "network/timing_wheel.h"
+#include "network/reliable_channel.h"
+#include "network/metrics.h"
+#include "network/metrics_endpoint.h"
 
 // Platform-specific headers
 #ifdef _WIN32
@@ -29,260 +40,381 @@
 
 // Default port for the chat server
 constexpr int DEFAULT_PORT = 8085;
-constexpr int CLIENT_TIMEOUT_SECONDS = 120;
+// We use a shorter timeout for UDP since it's connectionless
+constexpr std::chrono::seconds CLIENT_TIMEOUT(120);
+constexpr std::chrono::seconds REPORT_INTERVAL(30);
 constexpr size_t DEFAULT_BUFFER_SIZE = 4096;
+// Reliable channels of peers that left stay this long so late retransmissions are still acked
+constexpr std::chrono::seconds CHANNEL_LINGER(10);
+// Prometheus metrics are served over HTTP on their own port; 0 turns the endpoint off
+constexpr int DEFAULT_METRICS_PORT = 9085;
+// How often the timer thread samples the reliable channels' queues for the metrics
+constexpr std::chrono::seconds QUEUE_SAMPLE_INTERVAL(1);
 
 // Structure to represent a connected client
 struct UdpClient {
-    NetworkAddress address; // Using NetworkAddress instead of sockaddr_in
-    std::string username;
-    std::time_t lastActivity;
-};
-
-// Custom hash function for NetworkAddress
-struct NetworkAddressHash {
-    std::size_t operator()(const NetworkAddress& addr) const {
-        // Hash combination of IP and port
-        return std::hash<std::string>()(addr.ipAddress) ^ std::hash<unsigned short>()(addr.port);
-    }
-};
-
-// Custom equality function for NetworkAddress
-struct NetworkAddressEqual {
-    bool operator()(const NetworkAddress& a, const NetworkAddress& b) const {
-        return (a.ipAddress == b.ipAddress && a.port == b.port);
-    }
+    const AddressKey key;   // Packed IPv4:port the client sends from
+    const std::string username;
+    std::atomic<std::time_t> lastActivity;  // Refreshed by every datagram without taking a lock
+    std::atomic<TimingWheel::TimerId> idleTimer{TimingWheel::INVALID_TIMER};
+    const std::shared_ptr<ReliableChannel> channel;    // Null for clients that send plain datagrams
+    
+    UdpClient(const AddressKey& clientKey, const std::string& clientUsername,
+              std::shared_ptr<ReliableChannel> clientChannel)
+        : key(clientKey), username(clientUsername), lastActivity(std::time(nullptr)),
+          channel(std::move(clientChannel)) {}
 };
 
 // Signal handler for graceful termination
 std::atomic<bool> running(true);
 
 // Helper function to print address information
-void printAddressInfo(const NetworkAddress& addr) {
+void printAddressInfo(const AddressKey& key) {
+    NetworkAddress addr = key.ToNetworkAddress();
     std::cout << addr.ipAddress << ":" << addr.port;
 }
 
+// Metrics served on the metrics port. Message handling only bumps relaxed atomics here and the
+// timer thread samples the channel queues, so a scrape never walks the clients or takes their locks.
+struct ChatMetrics {
+    MetricsRegistry registry;
+    MetricsRegistry::Counter& messagesReceived = registry.AddCounter(
+        "chat_messages_received_total", "Chat lines received from registered clients");
+    MetricsRegistry::Counter& messagesSent = registry.AddCounter(
+        "chat_messages_sent_total", "Broadcast copies sent to clients, as datagrams or over reliable channels");
+    MetricsRegistry::Counter& messagesDropped = registry.AddCounter(
+        "chat_messages_dropped_total", "Broadcast copies that failed to send or that a reliable channel refused");
+    MetricsRegistry::Counter& idleClientEvictions = registry.AddCounter(
+        "chat_client_evictions_total", "Clients removed by the server", "reason=\"idle\"");
+    MetricsRegistry::Histogram& broadcastSeconds = registry.AddHistogram(
+        "chat_broadcast_fanout_seconds", "Time to format a broadcast and send it to every recipient",
+        MetricsRegistry::ExponentialBuckets(1e-6, 4, 12));
+    MetricsRegistry::Histogram& broadcastRecipients = registry.AddHistogram(
+        "chat_broadcast_recipients", "Recipients per broadcast", MetricsRegistry::ExponentialBuckets(1, 4, 8));
+    MetricsRegistry::Gauge& channelQueuedPackets = registry.AddGauge(
+        "chat_channel_queued_packets", "Packets waiting for a reliable channel's congestion window, sampled every second");
+    MetricsRegistry::Gauge& channelMaxQueuedPackets = registry.AddGauge(
+        "chat_channel_max_queued_packets", "Most packets queued on one reliable channel, sampled every second");
+    MetricsRegistry::Gauge& channelPacketsInFlight = registry.AddGauge(
+        "chat_channel_packets_in_flight", "Reliable channel packets sent and not yet acknowledged, sampled every second");
+};
+
 class UdpLiveChatServer {
 private:
-    std::unique_ptr<IUdpSocket> socket; // Replace UdpServer with IUdpSocket
+    // One receive socket and thread per worker. With several workers every socket binds the server
+    // port with SO_REUSEPORT, and Linux hashes each datagram's source address to one of them, so all
+    // datagrams of a client are handled by the same worker, in order. Other platforms do not spread
+    // unicast datagrams across such sockets, so there the server uses a single worker.
+    struct ReceiveWorker {
+        std::unique_ptr<IUdpSocket> socket;
+        std::thread thread;
+    };
+    
     int serverPort;
-    std::mutex clientsMutex;
-    std::unordered_map<NetworkAddress, UdpClient, NetworkAddressHash, NetworkAddressEqual> clients;
-    std::thread receiveThread;
-    std::thread inactivityThread;
+    size_t workerCount;
+    std::vector<ReceiveWorker> workers;
+    // Sharded, read-mostly registry; broadcasts walk its snapshots without holding a lock
+    // Keyed by packed address in flat per-shard tables: a per-datagram lookup is an integer hash
+    // and a probe of adjacent slots, with no string hashing or node chasing
+    using ClientRegistry = ShardedRegistry<AddressKey, UdpClient, AddressKeyHash, std::equal_to<AddressKey>,
+                                           FlatHashMap<AddressKey, std::shared_ptr<UdpClient>, AddressKeyHash>>;
+    ClientRegistry clients;
+    // The same clients by username, for /msg delivery and unique names
+    ShardedRegistry<std::string, UdpClient> usernames;
+    // Reliable channels of peers that speak the channel protocol, from their first datagram until
+    // they have been gone for CHANNEL_LINGER; updated by the timer thread
+    using ChannelRegistry = ShardedRegistry<AddressKey, ReliableChannel, AddressKeyHash, std::equal_to<AddressKey>,
+                                            FlatHashMap<AddressKey, std::shared_ptr<ReliableChannel>, AddressKeyHash>>;
+    ChannelRegistry channels;
+    // Idle deadlines and periodic reports, advanced by the timer thread
+    TimingWheel timers;
+    std::thread timerThread;
     std::atomic<bool> isRunning{false};
+    BufferPool bufferPool{DEFAULT_BUFFER_SIZE};
+    CachedTimestamp timestamps;
+    ChatMetrics metrics;
+    int metricsPort;
+    std::unique_ptr<MetricsEndpoint> metricsEndpoint;
     
     // Helper function to get current timestamp as string
     std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        std::time_t time = std::chrono::system_clock::to_time_t(now);
-        
-        // Use safer ctime_s instead of ctime
-        char timeBuffer[26];
-#ifdef _WIN32
-        ctime_s(timeBuffer, sizeof(timeBuffer), &time);
-#else
-        // For non-Windows platforms that don't have ctime_s
-        std::strncpy(timeBuffer, std::ctime(&time), sizeof(timeBuffer));
-        timeBuffer[sizeof(timeBuffer) - 1] = '\0'; // Ensure null termination
-#endif
-        std::string timestamp(timeBuffer);
-        
-        // Remove newline from timestamp
-        if (!timestamp.empty() && timestamp.back() == '\n') {
-            timestamp.pop_back();
-        }
-        return "[" + timestamp + "] ";
+        return std::string(timestamps.Now().View());
     }
     
-    // Check if client exists in our map
-    bool clientExists(const NetworkAddress& addr) {
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        return clients.find(addr) != clients.end();
-    }
-    
-    // Register a new client
-    void registerClient(const NetworkAddress& addr, const std::string& username) {
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        
-        UdpClient client;
-        client.address = addr;
-        client.username = username;
-        client.lastActivity = std::time(nullptr);
-        
-        clients[addr] = client;
+    // Register a new client; returns false if the username is taken or the address is already registered
+    bool registerClient(const AddressKey& addr, const std::string& username) {
+        auto client = std::make_shared<UdpClient>(addr, username, channels.Find(addr));
+        if (!usernames.Insert(username, client)) {
+            return false;
+        }
+        if (!clients.Insert(addr, client)) {
+            usernames.Remove(username, client);
+            return false;
+        }
         
         std::cout << "New client registered: " << username << " at ";
         printAddressInfo(addr);
-        std::cout << "\nTotal clients: " << clients.size() << std::endl;
+        std::cout << "\nTotal clients: " << clients.Size() << std::endl;
+        scheduleIdleCheck(client, CLIENT_TIMEOUT);
+        return true;
     }
     
-    // Send message to a specific client
-    void sendToClient(const NetworkAddress& addr, const std::string& message) {
+    // Send message to a specific client; replies go out through the socket of the worker handling
+    // the request, which is bound to the same port as every other worker's
+    void sendToClient(IUdpSocket& socket, const AddressKey& addr, const std::string& message) {
         try {
-            std::vector<std::byte> data = NetworkUtils::StringToBytes(message);
-            socket->SendTo(data, addr);
+            if (std::shared_ptr<ReliableChannel> channel = channels.Find(addr)) {
+                channel->Send(NetworkUtils::AsBytes(message));
+                return;
+            }
+            socket.SendTo(NetworkUtils::AsBytes(message), addr);
         } catch (const std::exception& e) {
             std::cerr << "Error sending to client: " << e.what() << std::endl;
         }
     }
     
     // Broadcast message to all clients except sender
-    void broadcastMessage(const std::string& message, const NetworkAddress* sender = nullptr) {
-        // Lock access to clients map to ensure thread safety
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        
-        // Add timestamp to the message and append a newline character
-        std::string formattedMessage = getTimestamp() + message + "\n";
-        
-        // Iterate through all connected clients
-        for (auto& [addr, client] : clients) {
+    void broadcastMessage(IUdpSocket& socket, const std::string& message, const AddressKey* sender = nullptr) {
+        const auto start = std::chrono::steady_clock::now();
+        size_t channelCopies = 0;
+        size_t refused = 0;
+        
+        // Add timestamp to the message and append a newline character, once for all recipients
+        PooledBuffer formattedMessage = bufferPool.AcquireCopy({NetworkUtils::AsBytes(timestamps.Now().View()),
+                                                                 NetworkUtils::AsBytes(message),
+                                                                 NetworkUtils::AsBytes("\n")});
+        std::span<const std::byte> data = formattedMessage.Span();
+        
+        // Collect the recipients from the registry snapshots; no lock is held while sending.
+        // Clients with a reliable channel get their own copy through it.
+        std::vector<AddressKey> recipients;
+        recipients.reserve(clients.Size());
+        clients.ForEach([&](const AddressKey& addr, const std::shared_ptr<UdpClient>& client) {
             // Skip the sender if provided (don't send message back to originator)
-            if (sender == nullptr || 
-                addr.ipAddress != sender->ipAddress || 
-                addr.port != sender->port) {
-                
-                try {
-                    // Send the formatted message to this client
-                    std::vector<std::byte> data = NetworkUtils::StringToBytes(formattedMessage);
-                    socket->SendTo(data, addr);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error broadcasting to client: " << e.what() << std::endl;
+            if (sender != nullptr && addr == *sender) {
+                return;
+            }
+            if (client->channel) {
+                ++channelCopies;
+                refused += client->channel->Send(data) ? 0 : 1;
+            } else {
+                recipients.push_back(addr);
+            }
+        });
+        
+        // One batched fan-out of the shared payload instead of a send call per client. Entries start
+        // out failed, so recipients a failing or throwing call never reached are reported too.
+        std::vector<int> results(recipients.size(), -1);
+        size_t delivered = 0;
+        try {
+            delivered = socket.SendToMany(data, recipients, results);
+        } catch (const std::exception& e) {
+            std::cerr << "Error broadcasting message: " << e.what() << std::endl;
+        }
+        if (delivered < recipients.size()) {
+            for (size_t i = 0; i < recipients.size(); ++i) {
+                if (results[i] < 0) {
+                    NetworkAddress addr = recipients[i].ToNetworkAddress();
+                    std::cerr << "Error broadcasting to client " << addr.ipAddress << ":" << addr.port << std::endl;
                 }
             }
         }
+        
+        metrics.messagesSent.Increment(delivered + channelCopies - refused);
+        metrics.messagesDropped.Increment(recipients.size() - delivered + refused);
+        metrics.broadcastSeconds.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        metrics.broadcastRecipients.Observe(static_cast<double>(recipients.size() + channelCopies));
     }
 
     // Send a private message to a specific user
-    bool sendPrivateMessage(const std::string& targetUsername, const std::string& message, 
-                             const NetworkAddress* sender) {
-        bool userFound = false;
-        std::string senderUsername;
-        
-        // Lock access to clients map for thread safety
-        std::lock_guard<std::mutex> lock(clientsMutex);
-        
-        // Identify the sender by matching address
-        for (const auto& [addr, client] : clients) {
-            if (addr.ipAddress == sender->ipAddress && 
-                addr.port == sender->port) {
-                senderUsername = client.username;
-                break;
-            }
+    bool sendPrivateMessage(IUdpSocket& socket, const std::string& targetUsername, const std::string& message, 
+                             const UdpClient& sender) {
+        std::shared_ptr<UdpClient> target = usernames.Find(targetUsername);
+        if (!target) {
+            return false;
         }
         
-        if (senderUsername.empty()) {
-            return false; // Sender not found in clients map
+        try {
+            // Format the private message with the sender's name for the recipient
+            std::string formattedMessage = getTimestamp() + "[Private from " + 
+                                          sender.username + "]: " + message + "\n";
+                                          
+            // Send the message to the recipient
+            sendToClient(socket, target->key, formattedMessage);
+            
+            // Send a confirmation copy to the sender
+            std::string confirmation = getTimestamp() + "[Private to " + 
+                                     targetUsername + "]: " + message + "\n";
+            sendToClient(socket, sender.key, confirmation);
+        } catch (const std::exception& e) {
+            std::cerr << "Error sending private message: " << e.what() << std::endl;
+            return false;
         }
         
-        // Search for the target user by username
-        for (auto& [addr, client] : clients) {
-            if (client.username == targetUsername) {
-                try {
-                    // Format the private message with the sender's name for the recipient
-                    std::string formattedMessage = getTimestamp() + "[Private from " + 
-                                                  senderUsername + "]: " + message + "\n";
-                                                  
-                    // Send the message to the recipient using byte conversion
-                    std::vector<std::byte> data = NetworkUtils::StringToBytes(formattedMessage);
-                    socket->SendTo(data, addr);
-                    userFound = true;
-                    
-                    // Send a confirmation copy to the sender
-                    if (sender != nullptr) {
-                        std::string confirmation = getTimestamp() + "[Private to " + 
-                                                 targetUsername + "]: " + message + "\n";
-                                                 
-                        std::vector<std::byte> confirmData = NetworkUtils::StringToBytes(confirmation);
-                        socket->SendTo(confirmData, *sender);
-                    }
-                    break;
-                } catch (const std::exception& e) {
-                    std::cerr << "Error sending private message: " << e.what() << std::endl;
-                    return false;
+        return true;
+    }
+    
+    // Advance the timing wheel, which runs the idle checks and reports, and drive the reliable
+    // channels' retransmission timers and delayed acks
+    void runTimers() {
+        while (isRunning.load() && running.load()) {
+            std::this_thread::sleep_for(ReliableChannel::UPDATE_INTERVAL);
+            timers.Advance();
+            
+            ReliableChannel::Clock::time_point now = ReliableChannel::Clock::now();
+            channels.ForEach([&](const AddressKey& addr, const std::shared_ptr<ReliableChannel>& channel) {
+                channel->Update(now);
+                if (now - channel->GetLastReceiveTime() > CHANNEL_LINGER && !clients.Find(addr)) {
+                    channels.Remove(addr, channel);
                 }
-            }
+            });
+        }
+    }
+    
+    // Arm a client's idle deadline. Datagrams only refresh the client's timestamp without touching
+    // the wheel; the check re-arms itself for whatever is left of the timeout.
+    void scheduleIdleCheck(const std::shared_ptr<UdpClient>& client, std::chrono::seconds delay) {
+        std::weak_ptr<UdpClient> weakClient = client;
+        client->idleTimer = timers.Schedule(delay, [this, weakClient]() { checkIdle(weakClient); });
+    }
+    
+    void checkIdle(const std::weak_ptr<UdpClient>& weakClient) {
+        std::shared_ptr<UdpClient> client = weakClient.lock();
+        if (!client) {
+            return;
         }
         
-        // Return true if target user was found, false otherwise
-        return userFound;
+        std::time_t idleSeconds = std::time(nullptr) - client->lastActivity.load(std::memory_order_relaxed);
+        if (idleSeconds < CLIENT_TIMEOUT.count()) {
+            scheduleIdleCheck(client, CLIENT_TIMEOUT - std::chrono::seconds(std::max<std::time_t>(idleSeconds, 0)));
+            return;
+        }
+        
+        // Whoever removes the entry (here or /quit) announces the departure
+        if (clients.Remove(client->key, client)) {
+            usernames.Remove(client->username, client);
+            std::cout << "Removed inactive client: " << client->username << " (timeout after 2 minutes of inactivity)" << std::endl;
+            metrics.idleClientEvictions.Increment();
+            broadcastMessage(*workers.front().socket, client->username + " has timed out");
+        }
     }
     
-    // Remove inactive clients
-    void removeInactiveClients() {
-        while (isRunning.load() && running.load()) {
-            std::this_thread::sleep_for(std::chrono::seconds(30));
-            
-            std::vector<NetworkAddress> toRemove;
-            std::time_t currentTime = std::time(nullptr);
+    // Periodic registry report; re-schedules itself
+    void scheduleReport() {
+        timers.Schedule(REPORT_INTERVAL, [this]() {
+            ClientRegistry::Stats stats = clients.GetStats();
+            std::cout << "Client registry: " << stats.size << " clients, " << stats.writes << " joins/leaves, "
+                      << stats.contendedLocks << " contended locks" << std::endl;
             
-            {
-                std::lock_guard<std::mutex> lock(clientsMutex);
-                for (const auto& [addr, client] : clients) {
-                    // If client has been inactive for more than 2 minutes, remove them
-                    // We use a shorter timeout for UDP since it's connectionless
-                    if (difftime(currentTime, client.lastActivity) > CLIENT_TIMEOUT_SECONDS) {
-                        toRemove.push_back(addr);
-                    }
-                }
+            uint64_t retransmissions = 0;
+            channels.ForEach([&](const AddressKey&, const std::shared_ptr<ReliableChannel>& channel) {
+                retransmissions += channel->GetStats().retransmissions;
+            });
+            std::cout << "Reliable channels: " << channels.Size() << " open, "
+                      << retransmissions << " retransmissions" << std::endl;
+            scheduleReport();
+        });
+    }
+    
+    // Sample the reliable channels' queues into the metrics; re-schedules itself
+    void scheduleQueueSample() {
+        timers.Schedule(QUEUE_SAMPLE_INTERVAL, [this]() {
+            size_t queued = 0;
+            size_t deepest = 0;
+            size_t inFlight = 0;
+            channels.ForEach([&](const AddressKey&, const std::shared_ptr<ReliableChannel>& channel) {
+                ReliableChannel::Stats stats = channel->GetStats();
+                queued += stats.packetsQueued;
+                deepest = std::max(deepest, stats.packetsQueued);
+                inFlight += stats.packetsInFlight;
+            });
+            metrics.channelQueuedPackets.Set(static_cast<double>(queued));
+            metrics.channelMaxQueuedPackets.Set(static_cast<double>(deepest));
+            metrics.channelPacketsInFlight.Set(static_cast<double>(inFlight));
+            scheduleQueueSample();
+        });
+    }
+    
+    // Remove a registered client and tell everyone else; returns the removed client, if any
+    std::shared_ptr<UdpClient> unregisterClient(IUdpSocket& socket, const AddressKey& clientAddr) {
+        std::shared_ptr<UdpClient> removed = clients.Remove(clientAddr);
+        
+        // Notify other clients if a registered user has left
+        if (removed) {
+            usernames.Remove(removed->username, removed);
+            timers.Cancel(removed->idleTimer.load());
+            broadcastMessage(socket, removed->username + " has left the chat", &clientAddr);
+        }
+        return removed;
+    }
+    
+    // Handle a datagram of the reliable channel protocol: every message it completes is one chat line
+    void handleChannelDatagram(IUdpSocket& socket, std::span<const std::byte> datagram, const AddressKey& clientAddr) {
+        std::shared_ptr<ReliableChannel> channel = channels.Find(clientAddr);
+        if (!channel) {
+            auto created = std::make_shared<ReliableChannel>([&socket, clientAddr](std::span<const std::byte> data) {
+                return socket.SendTo(data, clientAddr) >= 0;
+            });
+            channel = channels.Insert(clientAddr, created) ? created : channels.Find(clientAddr);
+            if (!channel) {
+                return;
             }
-            
-            for (const auto& addr : toRemove) {
-                std::string username;
-                
-                {
-                    std::lock_guard<std::mutex> lock(clientsMutex);
-                    if (clients.find(addr) != clients.end()) {
-                        username = clients[addr].username;
-                        clients.erase(addr);
-                    }
-                }
-                
-                if (!username.empty()) {
-                    std::cout << "Removed inactive client: " << username << " (timeout after 2 minutes of inactivity)" << std::endl;
-                    broadcastMessage(username + " has timed out");
-                }
+        }
+        
+        std::vector<std::string> lines;
+        ReliableChannel::ReceiveResult result = channel->Receive(datagram, [&](std::span<const std::byte> message) {
+            lines.emplace_back(NetworkUtils::AsStringView(message));
+        });
+        
+        // A restarted client starts over, so its earlier registration ends before its new lines count
+        if (result == ReliableChannel::ReceiveResult::PeerRestarted) {
+            if (std::shared_ptr<UdpClient> removed = unregisterClient(socket, clientAddr)) {
+                std::cout << "Client " << removed->username << " restarted its session" << std::endl;
             }
         }
+        for (const std::string& line : lines) {
+            handleMessage(socket, line, clientAddr);
+        }
     }
     
-    // Handle client messages
-    void handleMessage(const std::string& message, const NetworkAddress& clientAddr) {
+    // Handle one chat line from a client
+    void handleMessage(IUdpSocket& socket, std::string_view message, const AddressKey& clientAddr) {
+        // One shared-lock lookup per line; everything below works on the client entry itself
+        std::shared_ptr<UdpClient> client = clients.Find(clientAddr);
+        
         // Update client's last activity timestamp to prevent timeout
-        {
-            std::lock_guard<std::mutex> lock(clientsMutex);
-            if (clients.find(clientAddr) != clients.end()) {
-                clients[clientAddr].lastActivity = std::time(nullptr);
-            }
+        if (client) {
+            client->lastActivity.store(std::time(nullptr), std::memory_order_relaxed);
         }
         
         // Handle registration protocol: "REGISTER:username"
         if (message.substr(0, 9) == "REGISTER:") {
-            std::string username = message.substr(9);  // Extract username after "REGISTER:"
+            std::string username(message.substr(9));  // Extract username after "REGISTER:"
             
-            // Sanitize username by removing special characters
-            auto removeSpecialChars = [](std::string& str, const std::string& chars) {
-                for (char c : chars) {
-                    str.erase(std::remove(str.begin(), str.end(), c), str.end());
-                }
-            };
-            removeSpecialChars(username, "\n\r\0");
+            if (client) {
+                return;  // Already registered from this address
+            }
+            if (username.empty()) {
+                sendToClient(socket, clientAddr, "Please register first with REGISTER:<username>");
+                return;
+            }
             
-            if (!clientExists(clientAddr)) {
-                // Add new client to active clients list with the provided username
-                registerClient(clientAddr, username);
-                
-                // Send personalized welcome message to the new client
-                std::string welcome = getTimestamp() + "Welcome to the chat, " + username + "!\n";
-                sendToClient(clientAddr, welcome);
-                
-                // Send instructions for private messaging
-                std::string info = getTimestamp() + "To send a private message, use: /msg <username> <message>\n";
-                sendToClient(clientAddr, info);
-                
-                // Notify other clients that a new user has joined
-                broadcastMessage(username + " has joined the chat", &clientAddr);
+            // Add new client to active clients list with the provided username
+            if (!registerClient(clientAddr, username)) {
+                sendToClient(socket, clientAddr, getTimestamp() + "Username " + username + " is already taken.\n");
+                return;
             }
+            
+            // Send personalized welcome message to the new client
+            std::string welcome = getTimestamp() + "Welcome to the chat, " + username + "!\n";
+            sendToClient(socket, clientAddr, welcome);
+            
+            // Send instructions for private messaging
+            std::string info = getTimestamp() + "To send a private message, use: /msg <username> <message>\n";
+            sendToClient(socket, clientAddr, info);
+            
+            // Notify other clients that a new user has joined
+            broadcastMessage(socket, username + " has joined the chat", &clientAddr);
             return;
         }
         
@@ -293,21 +425,12 @@ private:
         
         // Handle quit command
         if (message == "/quit") {
-            std::string username;
-            
             // Remove client from active clients list
-            {
-                std::lock_guard<std::mutex> lock(clientsMutex);
-                if (clients.find(clientAddr) != clients.end()) {
-                    username = clients[clientAddr].username;
-                    clients.erase(clientAddr);
-                }
-            }
-            
-            // Notify other clients if a registered user has left
-            if (!username.empty()) {
-                std::cout << "Client " << clientAddr.ipAddress << ":" << clientAddr.port << " (" << username << ") quit the chat." << std::endl;
-                broadcastMessage(username + " has left the chat", &clientAddr);
+            std::shared_ptr<UdpClient> removed = unregisterClient(socket, clientAddr);
+            if (removed) {
+                std::cout << "Client ";
+                printAddressInfo(clientAddr);
+                std::cout << " (" << removed->username << ") quit the chat." << std::endl;
             }
             return;
         }
@@ -317,99 +440,90 @@ private:
             std::string userList = "Connected users:\n";
             
             // Build list of currently connected users
-            {
-                std::lock_guard<std::mutex> lock(clientsMutex);
-                for (const auto& [_, client] : clients) {
-                    userList += "- " + client.username + "\n";
-                }
-            }
+            clients.ForEach([&](const AddressKey&, const std::shared_ptr<UdpClient>& other) {
+                userList += "- " + other->username + "\n";
+            });
             
             // Send the user list only to the requesting client
-            sendToClient(clientAddr, userList);
+            sendToClient(socket, clientAddr, userList);
             return;
         }
         
         // Handle private messaging: "/msg username message"
         if (message.rfind("/msg ", 0) == 0 && message.length() > 5) {
             size_t spacePos = message.find(' ', 5);  // Find space after username
-            if (spacePos != std::string::npos) {
+            if (spacePos != std::string_view::npos) {
                 // Extract recipient username and message content
-                std::string targetUsername = message.substr(5, spacePos - 5);
-                std::string privateMessage = message.substr(spacePos + 1);
-                std::string username;
-                
-                // Get sender's username
-                {
-                    std::lock_guard<std::mutex> lock(clientsMutex);
-                    if (clients.find(clientAddr) != clients.end()) {
-                        username = clients[clientAddr].username;
-                    }
-                }
+                std::string targetUsername(message.substr(5, spacePos - 5));
+                std::string privateMessage(message.substr(spacePos + 1));
                 
-                if (!username.empty()) {
+                if (client) {
                     // Send private message to target user
-                    if (!sendPrivateMessage(targetUsername, privateMessage, &clientAddr)) {
+                    if (!sendPrivateMessage(socket, targetUsername, privateMessage, *client)) {
                         // Notify sender if target user not found
                         std::string errorMsg = getTimestamp() + "User " + targetUsername + " not found.\n";
-                        sendToClient(clientAddr, errorMsg);
+                        sendToClient(socket, clientAddr, errorMsg);
                     }
                 }
             } else {
                 // Error message for invalid private message format
                 std::string errorMsg = getTimestamp() + "Invalid private message format. Use /msg <username> <message>\n";
-                sendToClient(clientAddr, errorMsg);
+                sendToClient(socket, clientAddr, errorMsg);
             }
             return;
         }
         
         // Handle regular chat messages
-        std::string username;
-        
-        // Get the sender's username
-        {
-            std::lock_guard<std::mutex> lock(clientsMutex);
-            if (clients.find(clientAddr) != clients.end()) {
-                username = clients[clientAddr].username;
+        if (client) {
+            const std::string& username = client->username;
+            if (message.empty()) {
+                return;
             }
-        }
-        
-        if (!username.empty()) {
+            metrics.messagesReceived.Increment();
+            std::string text(message);
             // Log message to server console
-            std::cout << "Message from " << username << ": " << message << std::endl;
+            std::cout << "Message from " << username << ": " << text << std::endl;
             // Broadcast message to all clients except sender
-            broadcastMessage(username + ": " + message, &clientAddr);
+            broadcastMessage(socket, username + ": " + text, &clientAddr);
         } else {
             // Unregistered client attempted to send a message - prompt to register
             std::string registerMsg = "Please register first with REGISTER:<username>";
-            sendToClient(clientAddr, registerMsg);
+            sendToClient(socket, clientAddr, registerMsg);
         }
     }
     
-    // Continuously receive incoming data
-    void receiveMessages() {
-        // Buffer for incoming data
-        std::vector<std::byte> buffer;
+    // Continuously receive incoming data on one worker's socket. Workers share the registries,
+    // whose updates are atomic per entry, so no further locking is needed here.
+    void receiveMessages(IUdpSocket& socket) {
+        // A datagram may carry several newline-separated lines; the end of the
+        // datagram also ends its last line
+        LineFramer framer(DEFAULT_BUFFER_SIZE);
         
         while (isRunning.load() && running.load()) {
             try {
-                if (socket->WaitForDataWithTimeout(100)) {
-                    // Clear the buffer before receiving new data
-                    buffer.clear();
-                    buffer.resize(DEFAULT_BUFFER_SIZE);
+                if (socket.WaitForDataWithTimeout(100)) {
+                    // Receive directly into a pooled block
+                    PooledBuffer buffer = bufferPool.Acquire();
                     
                     // Only try to receive if data is available
-                    NetworkAddress clientAddress;
-                    int bytesReceived = socket->ReceiveFrom(buffer, clientAddress);
+                    AddressKey clientAddress;
+                    int bytesReceived = socket.ReceiveFrom(buffer.WritableSpan(), clientAddress);
                     
                     if (bytesReceived > 0) {
                         // Resize buffer to actual received data size
-                        buffer.resize(bytesReceived);
+                        buffer.Resize(bytesReceived);
                         
-                        // Convert std::byte buffer to string
-                        std::string message = NetworkUtils::BytesToString(buffer);
+                        if (ReliableChannel::IsChannelDatagram(buffer.Span())) {
+                            handleChannelDatagram(socket, buffer.Span(), clientAddress);
+                            continue;
+                        }
                         
-                        // Handle the received message
-                        handleMessage(message, clientAddress);
+                        // Handle each line of the datagram
+                        auto onLine = [&](std::string_view line) {
+                            handleMessage(socket, line, clientAddress);
+                        };
+                        framer.Feed(buffer.Span(), onLine);
+                        framer.Finish(onLine);
                     }
                 }
             } catch (const std::exception& e) {
@@ -421,34 +535,69 @@ private:
     }
 
 public:
-    UdpLiveChatServer(int port = DEFAULT_PORT) : serverPort(port) {}
+    // receiveWorkers is the number of receive threads, each with its own socket
+    UdpLiveChatServer(int port = DEFAULT_PORT, size_t receiveWorkers = 1, int metricsPortNumber = DEFAULT_METRICS_PORT)
+        : serverPort(port), workerCount(std::max<size_t>(1, receiveWorkers)), metricsPort(metricsPortNumber) {
+        // The registries' sizes are relaxed atomics, so these are safe to read during a scrape
+        metrics.registry.AddGaugeFunction("chat_connected_clients", "Clients currently registered",
+                                          [this]() { return static_cast<double>(clients.Size()); });
+        metrics.registry.AddGaugeFunction("chat_reliable_channels", "Reliable channels open",
+                                          [this]() { return static_cast<double>(channels.Size()); });
+    }
     
     void start() {
-        // Create UDP socket using NetworkFactorySingleton
         auto& factory = NetworkFactorySingleton::GetInstance();
-        socket = factory.CreateUdpSocket();
-        
-        if (!socket || !socket->IsValid()) {
-            throw std::runtime_error("Failed to create UDP socket");
+        size_t socketCount = workerCount;
+#ifndef __linux__
+        // Only Linux spreads unicast datagrams across SO_REUSEPORT sockets; elsewhere one socket
+        // would get them all and the other workers would sit idle
+        if (socketCount > 1) {
+            std::cout << "Receive workers need Linux SO_REUSEPORT load balancing; using one" << std::endl;
         }
+        socketCount = 1;
+#endif
         
-        // Bind the socket to the server port
-        NetworkAddress serverAddress("0.0.0.0", serverPort);
-        if (!socket->Bind(serverAddress)) {
-            throw std::runtime_error("Failed to bind UDP socket to port " + std::to_string(serverPort));
+        for (size_t i = 0; i < socketCount; ++i) {
+            // Create UDP socket using NetworkFactorySingleton
+            std::unique_ptr<IUdpSocket> socket = factory.CreateUdpSocket();
+            if (!socket || !socket->IsValid()) {
+                throw std::runtime_error("Failed to create UDP socket");
+            }
+            if (socketCount > 1) {
+                // Without it the next bind fails and the server runs with the workers it has
+                SocketOptions::SetReusePort(socket.get(), true);
+            }
+            
+            // Bind the socket to the server port; later sockets join the port the first one got
+            int port = workers.empty() ? serverPort : workers.front().socket->GetLocalAddress().port;
+            if (!socket->Bind(NetworkAddress("0.0.0.0", port))) {
+                if (workers.empty()) {
+                    throw std::runtime_error("Failed to bind UDP socket to port " + std::to_string(serverPort));
+                }
+                std::cerr << "Could not share port " << port << " between receive workers; using "
+                          << workers.size() << std::endl;
+                break;
+            }
+            workers.push_back(ReceiveWorker{std::move(socket), std::thread()});
         }
         
-        NetworkAddress boundAddr = socket->GetLocalAddress();
-        std::cout << "Starting UDP Chat Server on port " << boundAddr.port << std::endl;
+        NetworkAddress boundAddr = workers.front().socket->GetLocalAddress();
+        std::cout << "Starting UDP Chat Server on port " << boundAddr.port << " with "
+                  << workers.size() << " receive worker(s)" << std::endl;
         
         // Set running flag and start worker threads
         isRunning.store(true);
+        startMetricsEndpoint();
         
-        // Start background thread to monitor and remove inactive clients
-        inactivityThread = std::thread(&UdpLiveChatServer::removeInactiveClients, this);
+        // Start background thread that times out inactive clients
+        scheduleReport();
+        scheduleQueueSample();
+        timerThread = std::thread(&UdpLiveChatServer::runTimers, this);
         
-        // Start receiver thread
-        receiveThread = std::thread(&UdpLiveChatServer::receiveMessages, this);
+        // Start receiver threads
+        for (ReceiveWorker& worker : workers) {
+            worker.thread = std::thread(&UdpLiveChatServer::receiveMessages, this, std::ref(*worker.socket));
+        }
         
         // Keep main thread alive until interrupted
         while (isRunning.load() && running.load()) {
@@ -456,28 +605,52 @@ public:
         }
     }
     
+    // The endpoint serves scrapes from its own thread; the chat keeps running without it
+    void startMetricsEndpoint() {
+        if (metricsPort <= 0) {
+            return;
+        }
+        metricsEndpoint = std::make_unique<MetricsEndpoint>(NetworkFactorySingleton::GetInstance(), metrics.registry);
+        if (metricsEndpoint->Start(NetworkAddress("0.0.0.0", static_cast<unsigned short>(metricsPort)))) {
+            std::cout << "Serving Prometheus metrics at http://localhost:" << metricsPort << "/metrics" << std::endl;
+        } else {
+            std::cerr << "Failed to start the metrics endpoint on port " << metricsPort << std::endl;
+            metricsEndpoint.reset();
+        }
+    }
+    
     void stop() {
-        // Set running flag to false, which will cause receive thread to exit
+        // Set running flag to false, which will cause receive threads to exit
         isRunning.store(false);
+        if (metricsEndpoint) {
+            metricsEndpoint->Stop();
+        }
         
-        // Close the socket
-        if (socket) {
-            socket->Close();
+        // Close the sockets
+        for (ReceiveWorker& worker : workers) {
+            worker.socket->Close();
         }
         
-        // Wait for the receiver thread to complete
-        if (receiveThread.joinable()) {
-            receiveThread.join();
+        // Wait for the receiver threads to complete
+        for (ReceiveWorker& worker : workers) {
+            if (worker.thread.joinable()) {
+                worker.thread.join();
+            }
         }
         
-        // Wait for the inactivity monitoring thread to complete
-        if (inactivityThread.joinable()) {
-            inactivityThread.join();
+        // Wait for the timer thread to complete
+        if (timerThread.joinable()) {
+            timerThread.join();
         }
         
         // Remove all clients from the map
-        clients.clear();
+        usernames.RemoveAll();
+        clients.RemoveAll();
+        channels.RemoveAll();
         
+        BufferPool::Stats poolStats = bufferPool.GetStats();
+        std::cout << "Buffer pool: " << poolStats.hits << " hits, " << poolStats.misses << " misses, "
+                  << "high-water " << poolStats.highWater << " blocks" << std::endl;
         std::cout << "UDP Chat server stopped" << std::endl;
     }
 
@@ -485,19 +658,21 @@ public:
         // Set running to false to signal threads to terminate
         isRunning.store(false);
         
-        // Close the socket
-        if (socket) {
-            socket->Close();
+        // Close the sockets
+        for (ReceiveWorker& worker : workers) {
+            worker.socket->Close();
         }
         
         // Detach the threads instead of joining them
         // This allows immediate termination without waiting for thread completion
-        if (receiveThread.joinable()) {
-            receiveThread.detach();
+        for (ReceiveWorker& worker : workers) {
+            if (worker.thread.joinable()) {
+                worker.thread.detach();
+            }
         }
 
-        if (inactivityThread.joinable()) {
-            inactivityThread.detach();
+        if (timerThread.joinable()) {
+            timerThread.detach();
         }
         
         std::cout << "UDP Chat server forcefully terminated" << std::endl;
@@ -505,8 +680,8 @@ public:
     }
     
     int getPort() const {
-        if (socket && socket->IsValid()) {
-            return socket->GetLocalAddress().port;
+        if (!workers.empty() && workers.front().socket->IsValid()) {
+            return workers.front().socket->GetLocalAddress().port;
         }
         return serverPort;
     }
@@ -560,14 +735,22 @@ int main(int argc, char* argv[]) {
 #endif
     
     int port = DEFAULT_PORT;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    int metricsPort = DEFAULT_METRICS_PORT;
     
-    // Allow overriding default port via command line argument
+    // Allow overriding default port, receive worker count and metrics port (0 for none) via command line arguments
     if (argc > 1) {
         port = std::atoi(argv[1]);  // Convert port argument to integer
     }
+    if (argc > 2) {
+        workers = static_cast<size_t>(std::max(1, std::atoi(argv[2])));
+    }
+    if (argc > 3) {
+        metricsPort = std::atoi(argv[3]);
+    }
     
-    // Create chat server instance with specified port
-    UdpLiveChatServer chatServer(port);
+    // Create chat server instance with specified port, receive workers and metrics port
+    UdpLiveChatServer chatServer(port, workers, metricsPort);
     // Store global pointer for signal handler to access
     gServerPtr = &chatServer;
     
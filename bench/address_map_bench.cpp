@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "network/flat_hash_map.h"
+#include "network/network.h"
+
+// Peer lookup as the UDP chat server does it per datagram, over one million registered peers:
+// the old text-keyed std::unordered_map against packed AddressKey keys in std::unordered_map
+// and in FlatHashMap. Also the conversions between NetworkAddress and AddressKey.
+
+// Helper functions
+namespace {
+    constexpr size_t PEERS = 1000000;
+    constexpr size_t LOOKUPS = 4096;
+
+    // Hash and equality the UDP server used for NetworkAddress keys
+    struct NetworkAddressHash {
+        size_t operator()(const NetworkAddress& addr) const {
+            return std::hash<std::string>()(addr.ipAddress) ^ std::hash<unsigned short>()(addr.port);
+        }
+    };
+
+    struct NetworkAddressEqual {
+        bool operator()(const NetworkAddress& a, const NetworkAddress& b) const {
+            return a.ipAddress == b.ipAddress && a.port == b.port;
+        }
+    };
+
+    // Peers spread over a /12 with random ports, as NAT-ed clients would appear
+    const std::vector<AddressKey>& Peers() {
+        static const std::vector<AddressKey> peers = []() {
+            std::mt19937_64 random(7);
+            std::vector<AddressKey> result;
+            result.reserve(PEERS);
+            for (size_t i = 0; i < PEERS; ++i) {
+                result.emplace_back(0x0A000000 | static_cast<uint32_t>(i & 0xFFFFF),
+                                    static_cast<unsigned short>(1024 + random() % 60000));
+            }
+            return result;
+        }();
+        return peers;
+    }
+
+    // Random subset of the peers to look up, in the text form datagrams used to arrive with
+    std::vector<size_t> LookupOrder() {
+        std::mt19937_64 random(11);
+        std::vector<size_t> order(LOOKUPS);
+        for (size_t& index : order) {
+            index = random() % PEERS;
+        }
+        return order;
+    }
+
+    using Value = std::shared_ptr<int>;
+}
+
+static void BM_PeerLookup_TextKeyUnorderedMap(benchmark::State& state) {
+    std::unordered_map<NetworkAddress, Value, NetworkAddressHash, NetworkAddressEqual> peers;
+    peers.reserve(PEERS);
+    for (const AddressKey& key : Peers()) {
+        peers.emplace(key.ToNetworkAddress(), std::make_shared<int>(0));
+    }
+    std::vector<NetworkAddress> lookups;
+    for (size_t index : LookupOrder()) {
+        lookups.push_back(Peers()[index].ToNetworkAddress());
+    }
+
+    for (auto _ : state) {
+        for (const NetworkAddress& address : lookups) {
+            benchmark::DoNotOptimize(peers.find(address));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * LOOKUPS);
+}
+BENCHMARK(BM_PeerLookup_TextKeyUnorderedMap)->Unit(benchmark::kMicrosecond);
+
+static void BM_PeerLookup_PackedKeyUnorderedMap(benchmark::State& state) {
+    std::unordered_map<AddressKey, Value, AddressKeyHash> peers;
+    peers.reserve(PEERS);
+    for (const AddressKey& key : Peers()) {
+        peers.emplace(key, std::make_shared<int>(0));
+    }
+    std::vector<AddressKey> lookups;
+    for (size_t index : LookupOrder()) {
+        lookups.push_back(Peers()[index]);
+    }
+
+    for (auto _ : state) {
+        for (const AddressKey& key : lookups) {
+            benchmark::DoNotOptimize(peers.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * LOOKUPS);
+}
+BENCHMARK(BM_PeerLookup_PackedKeyUnorderedMap)->Unit(benchmark::kMicrosecond);
+
+static void BM_PeerLookup_PackedKeyFlatMap(benchmark::State& state) {
+    FlatHashMap<AddressKey, Value, AddressKeyHash> peers(PEERS);
+    for (const AddressKey& key : Peers()) {
+        peers.emplace(key, std::make_shared<int>(0));
+    }
+    std::vector<AddressKey> lookups;
+    for (size_t index : LookupOrder()) {
+        lookups.push_back(Peers()[index]);
+    }
+
+    for (auto _ : state) {
+        for (const AddressKey& key : lookups) {
+            benchmark::DoNotOptimize(peers.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * LOOKUPS);
+}
+BENCHMARK(BM_PeerLookup_PackedKeyFlatMap)->Unit(benchmark::kMicrosecond);
+
+// Building the table: one join per peer
+static void BM_PeerInsert_TextKeyUnorderedMap(benchmark::State& state) {
+    std::vector<NetworkAddress> addresses;
+    addresses.reserve(PEERS);
+    for (const AddressKey& key : Peers()) {
+        addresses.push_back(key.ToNetworkAddress());
+    }
+    for (auto _ : state) {
+        std::unordered_map<NetworkAddress, int, NetworkAddressHash, NetworkAddressEqual> peers;
+        for (const NetworkAddress& address : addresses) {
+            peers.emplace(address, 0);
+        }
+        benchmark::DoNotOptimize(peers.size());
+    }
+    state.SetItemsProcessed(state.iterations() * PEERS);
+}
+BENCHMARK(BM_PeerInsert_TextKeyUnorderedMap)->Unit(benchmark::kMillisecond);
+
+static void BM_PeerInsert_PackedKeyFlatMap(benchmark::State& state) {
+    for (auto _ : state) {
+        FlatHashMap<AddressKey, int, AddressKeyHash> peers;
+        for (const AddressKey& key : Peers()) {
+            peers.emplace(key, 0);
+        }
+        benchmark::DoNotOptimize(peers.size());
+    }
+    state.SetItemsProcessed(state.iterations() * PEERS);
+}
+BENCHMARK(BM_PeerInsert_PackedKeyFlatMap)->Unit(benchmark::kMillisecond);
+
+// Conversions between the text and packed forms, as done at the socket boundary
+static void BM_AddressKey_FromNetworkAddress(benchmark::State& state) {
+    std::vector<NetworkAddress> addresses;
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        addresses.push_back(Peers()[i].ToNetworkAddress());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        AddressKey key;
+        benchmark::DoNotOptimize(AddressKey::FromNetworkAddress(addresses[i++ % LOOKUPS], key));
+        benchmark::DoNotOptimize(key);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddressKey_FromNetworkAddress);
+
+static void BM_AddressKey_ToNetworkAddress(benchmark::State& state) {
+    const std::vector<AddressKey>& peers = Peers();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(peers[i++ % LOOKUPS].ToNetworkAddress());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddressKey_ToNetworkAddress);
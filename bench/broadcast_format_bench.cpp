@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "network/buffer_pool.h"
+#include "network/byte_utils.h"
+#include "network/cached_timestamp.h"
+
+// Helper functions
+namespace {
+    // Timestamp the way the chat servers used to build it, through ctime
+    std::string CtimeTimestamp() {
+        std::time_t now = std::time(nullptr);
+        char timestamp[26];
+        std::strncpy(timestamp, std::ctime(&now), sizeof(timestamp) - 1);
+        timestamp[sizeof(timestamp) - 1] = '\0';
+        size_t len = std::strlen(timestamp);
+        if (len > 0 && timestamp[len - 1] == '\n')
+            timestamp[len - 1] = '\0';
+        std::string result;
+        result.reserve(std::strlen(timestamp) + 3);
+        result.append("[").append(timestamp).append("] ");
+        return result;
+    }
+
+    const std::string MESSAGE = "alice: the quick brown fox jumps over the lazy dog";
+}
+
+// Per-recipient formatting: one ctime call, one string and one byte vector per recipient
+static void BM_BroadcastFormat_PerRecipient(benchmark::State& state) {
+    const int recipients = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        for (int i = 0; i < recipients; ++i) {
+            std::string formatted = CtimeTimestamp() + MESSAGE + "\n";
+            std::vector<std::byte> bytes = NetworkUtils::StringToBytes(formatted);
+            benchmark::DoNotOptimize(bytes.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * recipients);
+}
+BENCHMARK(BM_BroadcastFormat_PerRecipient)->RangeMultiplier(10)->Range(10, 1000);
+
+// Format once into a pooled buffer; every recipient takes a reference
+static void BM_BroadcastFormat_Once(benchmark::State& state) {
+    const int recipients = static_cast<int>(state.range(0));
+    BufferPool pool;
+    CachedTimestamp timestamps;
+    std::vector<PooledBuffer> queued;
+    queued.reserve(recipients);
+
+    for (auto _ : state) {
+        PooledBuffer message = pool.AcquireCopy({NetworkUtils::AsBytes(timestamps.Now().View()),
+                                                 NetworkUtils::AsBytes(MESSAGE),
+                                                 NetworkUtils::AsBytes("\n")});
+        for (int i = 0; i < recipients; ++i) {
+            queued.push_back(message);
+        }
+        benchmark::DoNotOptimize(queued.data());
+        queued.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * recipients);
+}
+BENCHMARK(BM_BroadcastFormat_Once)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_Timestamp_Ctime(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CtimeTimestamp());
+    }
+}
+BENCHMARK(BM_Timestamp_Ctime);
+
+static void BM_Timestamp_Cached(benchmark::State& state) {
+    CachedTimestamp timestamps;
+    for (auto _ : state) {
+        CachedTimestamp::Text text = timestamps.Now();
+        benchmark::DoNotOptimize(text.size);
+    }
+}
+BENCHMARK(BM_Timestamp_Cached);
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "network/byte_utils.h"
+
+// Helper functions
+namespace {
+    // The original element-by-element conversions, kept as the baseline
+    std::vector<std::byte> StringToBytesPerByte(const std::string& str) {
+        std::vector<std::byte> bytes;
+        bytes.reserve(str.size());
+        for (char c : str) {
+            bytes.push_back(std::byte(c));
+        }
+        return bytes;
+    }
+
+    std::string BytesToStringPerByte(const std::vector<std::byte>& bytes) {
+        std::string str;
+        str.reserve(bytes.size());
+        for (std::byte b : bytes) {
+            str.push_back(static_cast<char>(std::to_integer<int>(b)));
+        }
+        return str;
+    }
+
+    void PayloadSizes(benchmark::internal::Benchmark* bench) {
+        bench->RangeMultiplier(4)->Range(64, 64 * 1024);
+    }
+}
+
+static void BM_StringToBytes_PerByte(benchmark::State& state) {
+    std::string payload(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(StringToBytesPerByte(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringToBytes_PerByte)->Apply(PayloadSizes);
+
+static void BM_StringToBytes(benchmark::State& state) {
+    std::string payload(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(NetworkUtils::StringToBytes(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringToBytes)->Apply(PayloadSizes);
+
+static void BM_AsBytes(benchmark::State& state) {
+    std::string payload(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        std::span<const std::byte> view = NetworkUtils::AsBytes(payload);
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AsBytes)->Apply(PayloadSizes);
+
+static void BM_BytesToString_PerByte(benchmark::State& state) {
+    std::vector<std::byte> payload(static_cast<size_t>(state.range(0)), std::byte{'x'});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BytesToStringPerByte(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BytesToString_PerByte)->Apply(PayloadSizes);
+
+static void BM_BytesToString(benchmark::State& state) {
+    std::vector<std::byte> payload(static_cast<size_t>(state.range(0)), std::byte{'x'});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(NetworkUtils::BytesToString(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BytesToString)->Apply(PayloadSizes);
+
+static void BM_AsStringView(benchmark::State& state) {
+    std::vector<std::byte> payload(static_cast<size_t>(state.range(0)), std::byte{'x'});
+    for (auto _ : state) {
+        std::string_view view = NetworkUtils::AsStringView(payload);
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AsStringView)->Apply(PayloadSizes);
@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "network/sharded_registry.h"
+
+// Chat-server style workload against the client registry: every operation is a client's
+// activity update, every 16th a broadcast walk and every 256th a leave followed by a join.
+// Compares the single mutex-guarded map the servers used to have with ShardedRegistry.
+
+// Helper functions
+namespace {
+    constexpr int CLIENTS = 1000;
+    constexpr int BROADCAST_EVERY = 16;
+    constexpr int CHURN_EVERY = 256;
+
+    struct MutexClient {
+        std::time_t lastActivity = 0;
+        bool authenticated = true;
+    };
+
+    struct ShardedClient {
+        std::atomic<std::time_t> lastActivity{0};
+        std::atomic<bool> authenticated{true};
+    };
+
+    // Baseline: one lock for everything, as in the servers before the registry
+    struct MutexRegistry {
+        std::mutex mutex;
+        std::unordered_map<int, MutexClient> clients;
+        std::atomic<uint64_t> contendedLocks{0};
+
+        std::unique_lock<std::mutex> Lock() {
+            std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                contendedLocks.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+            return lock;
+        }
+    };
+
+    MutexRegistry* gMutexRegistry = nullptr;
+    ShardedRegistry<int, ShardedClient>* gShardedRegistry = nullptr;
+}
+
+static void BM_ClientRegistry_SingleMutex(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        gMutexRegistry = new MutexRegistry();
+        for (int id = 0; id < CLIENTS; ++id) {
+            gMutexRegistry->clients.emplace(id, MutexClient());
+        }
+    }
+
+    uint64_t operation = 0;
+    int id = state.thread_index();
+    for (auto _ : state) {
+        MutexRegistry& registry = *gMutexRegistry;
+        id = (id + 7) % CLIENTS;
+        ++operation;
+        {
+            std::unique_lock<std::mutex> lock = registry.Lock();
+            registry.clients[id].lastActivity = static_cast<std::time_t>(operation);
+        }
+        if (operation % BROADCAST_EVERY == 0) {
+            // Recipients are collected under the lock
+            size_t recipients = 0;
+            std::unique_lock<std::mutex> lock = registry.Lock();
+            for (const auto& [clientId, client] : registry.clients) {
+                recipients += client.authenticated ? 1 : 0;
+            }
+            benchmark::DoNotOptimize(recipients);
+        }
+        if (operation % CHURN_EVERY == 0) {
+            std::unique_lock<std::mutex> lock = registry.Lock();
+            registry.clients.erase(id);
+            registry.clients.emplace(id, MutexClient());
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        state.counters["contended_locks"] = static_cast<double>(gMutexRegistry->contendedLocks.load());
+        delete gMutexRegistry;
+        gMutexRegistry = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClientRegistry_SingleMutex)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ClientRegistry_Sharded(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        gShardedRegistry = new ShardedRegistry<int, ShardedClient>();
+        for (int id = 0; id < CLIENTS; ++id) {
+            gShardedRegistry->Insert(id, std::make_shared<ShardedClient>());
+        }
+    }
+
+    uint64_t operation = 0;
+    int id = state.thread_index();
+    for (auto _ : state) {
+        ShardedRegistry<int, ShardedClient>& registry = *gShardedRegistry;
+        id = (id + 7) % CLIENTS;
+        ++operation;
+        // Connection threads hold their client; an activity update is a relaxed store
+        std::shared_ptr<ShardedClient> client = registry.Find(id);
+        if (client) {
+            client->lastActivity.store(static_cast<std::time_t>(operation), std::memory_order_relaxed);
+        }
+        if (operation % BROADCAST_EVERY == 0) {
+            size_t recipients = 0;
+            registry.ForEach([&](int, const std::shared_ptr<ShardedClient>& entry) {
+                recipients += entry->authenticated.load(std::memory_order_acquire) ? 1 : 0;
+            });
+            benchmark::DoNotOptimize(recipients);
+        }
+        if (operation % CHURN_EVERY == 0) {
+            registry.Remove(id);
+            registry.Insert(id, std::make_shared<ShardedClient>());
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        state.counters["contended_locks"] = static_cast<double>(gShardedRegistry->GetStats().contendedLocks);
+        delete gShardedRegistry;
+        gShardedRegistry = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClientRegistry_Sharded)->ThreadRange(1, 8)->UseRealTime();
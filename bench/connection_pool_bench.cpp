@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/connection_pool.h"
+#include "network/platform_factory.h"
+
+// A short call's connection cost over loopback: a fresh connect and close per call, as services
+// without a pool do, against a checkout and return from ConnectionPool. The backend accepts on
+// its own thread and closes what it accepts only when the benchmark ends.
+
+// Helper functions
+namespace {
+    struct Backend {
+        std::unique_ptr<ITcpListener> listener = NetworkFactorySingleton::GetInstance().CreateTcpListener();
+        NetworkAddress address;
+        std::atomic<bool> running{true};
+        std::thread acceptor;
+
+        Backend() {
+            listener->Bind(NetworkAddress("127.0.0.1", 0));
+            listener->Listen(1024);
+            address = NetworkAddress("127.0.0.1", listener->GetLocalAddress().port);
+            acceptor = std::thread([this] {
+                std::vector<std::unique_ptr<ITcpSocket>> accepted;
+                while (running) {
+                    if (listener->WaitForDataWithTimeout(10)) {
+                        accepted.push_back(listener->AcceptTcp());
+                    }
+                }
+            });
+        }
+
+        ~Backend() {
+            running = false;
+            acceptor.join();
+        }
+    };
+
+    Backend* gBackend = nullptr;
+    ConnectionPool* gPool = nullptr;
+}
+
+// Each iteration leaves a client port in TIME_WAIT, so the run is kept short
+static void BM_ConnectPerCall(benchmark::State& state) {
+    Backend backend;
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    for (auto _ : state) {
+        auto socket = factory.CreateTcpSocket();
+        if (!socket->Connect(backend.address)) {
+            state.SkipWithError("connect failed");
+            break;
+        }
+        socket->Close();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConnectPerCall)->Iterations(2000)->UseRealTime();
+
+// Checkout includes the liveness check, two system calls on the idle connection
+static void BM_PooledCheckout(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        gBackend = new Backend();
+        gPool = new ConnectionPool(NetworkFactorySingleton::GetInstance());
+    }
+    for (auto _ : state) {
+        ConnectionPool::Lease lease = gPool->Checkout(gBackend->address);
+        benchmark::DoNotOptimize(lease.Get());
+    }
+    if (state.thread_index() == 0) {
+        state.counters["connected"] = static_cast<double>(gPool->GetStats().connected);
+        delete gPool;
+        delete gBackend;
+        gPool = nullptr;
+        gBackend = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PooledCheckout)->Threads(1)->Threads(4)->UseRealTime();
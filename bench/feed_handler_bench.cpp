@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "network/feed_handler.h"
+
+// A/B arbitration throughput on one core: every packet arrives on line A and again, one packet
+// later, on line B, as on a redundant market-data feed. Items are unique messages delivered per second.
+
+// Helper functions
+namespace {
+    constexpr size_t MESSAGES_PER_PACKET = 32;
+    constexpr size_t MESSAGE_SIZE = 40;
+    constexpr size_t PACKETS = 4096;
+
+    std::vector<std::vector<std::byte>> MakePackets() {
+        std::vector<std::byte> message(MESSAGE_SIZE, std::byte{'q'});
+        std::vector<std::span<const std::byte>> messages(MESSAGES_PER_PACKET, std::span<const std::byte>(message));
+        std::vector<std::vector<std::byte>> packets(PACKETS);
+        for (size_t i = 0; i < PACKETS; ++i) {
+            FeedArbiter::EncodePacket(packets[i], "BENCH00001", 1 + i * MESSAGES_PER_PACKET, messages);
+        }
+        return packets;
+    }
+
+    // Replays the packets on both lines; line A drops one packet in every `lossInterval` (0: none)
+    void Replay(benchmark::State& state, size_t lossInterval) {
+        const auto packets = MakePackets();
+        size_t bytes = 0;
+        for (auto _ : state) {
+            FeedArbiter arbiter([&bytes](uint64_t, std::span<const std::byte> message) { bytes += message.size(); });
+            auto now = FeedArbiter::Clock::now();
+            for (size_t i = 0; i <= PACKETS; ++i) {
+                if (i < PACKETS && (lossInterval == 0 || i % lossInterval != 1)) {
+                    arbiter.Process(packets[i], FeedArbiter::Line::A, now);
+                }
+                if (i > 0) {
+                    arbiter.Process(packets[i - 1], FeedArbiter::Line::B, now);
+                }
+            }
+            benchmark::DoNotOptimize(bytes);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * PACKETS * MESSAGES_PER_PACKET));
+    }
+}
+
+static void BM_FeedArbiter_NoLoss(benchmark::State& state) {
+    Replay(state, 0);
+}
+BENCHMARK(BM_FeedArbiter_NoLoss);
+
+// Each loss on A opens a gap: A's next packet is held until B's copy of the lost one arrives
+static void BM_FeedArbiter_OnePercentLossOnA(benchmark::State& state) {
+    Replay(state, 100);
+}
+BENCHMARK(BM_FeedArbiter_OnePercentLossOnA);
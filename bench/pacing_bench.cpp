@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/network.h"
+#include "network/platform_factory.h"
+#include "network/socket_options.h"
+#include "network/token_bucket.h"
+#include "network/udp_socket.h"
+
+// Bursts of datagrams into a receiver with a small SO_RCVBUF over loopback, sent back to back
+// and paced, reporting the share the receiver's kernel buffer dropped as loss_pct. Pacing trades
+// send time for loss: the paced runs take longer per burst but lose (almost) nothing.
+
+// Helper functions
+namespace {
+    constexpr size_t BURST = 1000;
+    constexpr size_t DATAGRAM_SIZE = 1200;
+    constexpr int RECEIVE_BUFFER = 16 * 1024;   // The kernel doubles it for bookkeeping
+
+    enum class Pacing { None, TokenBucket, KernelRate };
+
+    // Receiver socket drained as fast as a thread can read it, counting every datagram
+    class Sink {
+    public:
+        Sink() {
+            auto& factory = NetworkFactorySingleton::GetInstance();
+            m_socket = factory.CreateUdpSocket();
+            m_socket->Bind(NetworkAddress("127.0.0.1", 0));
+            SocketOptions::SetReceiveBufferSize(m_socket.get(), RECEIVE_BUFFER);
+            SocketOptions::SetReceiveTimeout(m_socket.get(), std::chrono::milliseconds(20));
+            AddressKey::FromNetworkAddress(m_socket->GetLocalAddress(), m_key);
+            m_thread = std::thread([this] { Drain(); });
+        }
+
+        ~Sink() {
+            m_running = false;
+            m_thread.join();
+        }
+
+        const AddressKey& GetKey() const { return m_key; }
+
+        // Waits until nothing has arrived for a while and returns the count so far
+        size_t Settle() {
+            size_t previous = SIZE_MAX;
+            while (previous != m_received) {
+                previous = m_received;
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            }
+            return previous;
+        }
+
+    private:
+        void Drain() {
+            std::vector<std::byte> buffer(DATAGRAM_SIZE);
+            AddressKey from;
+            while (m_running) {
+                if (m_socket->ReceiveFrom(std::span<std::byte>(buffer), from) > 0) {
+                    ++m_received;
+                }
+            }
+        }
+
+        std::unique_ptr<IUdpSocket> m_socket;
+        AddressKey m_key;
+        std::atomic<size_t> m_received{0};
+        std::atomic<bool> m_running{true};
+        std::thread m_thread;
+    };
+
+    void RunBursts(benchmark::State& state, Pacing pacing) {
+        const uint64_t bytesPerSecond = static_cast<uint64_t>(state.range(0)) * 1000 * 1000;
+        Sink sink;
+        auto sender = NetworkFactorySingleton::GetInstance().CreateUdpSocket();
+        std::vector<std::byte> datagram(DATAGRAM_SIZE, std::byte{'p'});
+
+        TokenBucket pacer({.bytesPerSecond = pacing == Pacing::TokenBucket ? bytesPerSecond : 0,
+                           .burstBytes = 4 * DATAGRAM_SIZE});
+        if (pacing == Pacing::KernelRate && !SocketOptions::SetMaxPacingRate(sender.get(), bytesPerSecond)) {
+            state.SkipWithError("SO_MAX_PACING_RATE is not available");
+            return;
+        }
+
+        size_t sent = 0;
+        size_t received = 0;
+        for (auto _ : state) {
+            for (size_t i = 0; i < BURST; ++i) {
+                sent += sender->SendToAt(datagram, sink.GetKey(), pacer.Reserve(datagram.size())) > 0 ? 1 : 0;
+            }
+
+            state.PauseTiming();
+            size_t total = sink.Settle();
+            state.ResumeTiming();
+            received = total;
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(sent));
+        state.counters["loss_pct"] = sent > 0 ? 100.0 * static_cast<double>(sent - received) / static_cast<double>(sent) : 0;
+    }
+}
+
+// Back to back: every datagram the receiver has not read by the time its buffer is full is lost
+static void BM_Pacing_Unpaced(benchmark::State& state) {
+    RunBursts(state, Pacing::None);
+}
+BENCHMARK(BM_Pacing_Unpaced)->Arg(0)->Iterations(10)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Userspace token bucket at N MB/s, sleeping between sends
+static void BM_Pacing_TokenBucket(benchmark::State& state) {
+    RunBursts(state, Pacing::TokenBucket);
+}
+BENCHMARK(BM_Pacing_TokenBucket)->Arg(10)->Arg(50)->Arg(200)->Iterations(10)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// SO_MAX_PACING_RATE at N MB/s. Loopback usually has no fq qdisc, in which case UDP is not
+// paced and this matches the unpaced run.
+static void BM_Pacing_KernelRate(benchmark::State& state) {
+    RunBursts(state, Pacing::KernelRate);
+}
+BENCHMARK(BM_Pacing_KernelRate)->Arg(10)->Iterations(10)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "network/reliable_multicast.h"
+
+// Sender cost of NACK-based reliable multicast as the group grows: every receiver independently
+// loses 1% of the group's datagrams, so with many receivers nearly every message is lost by
+// someone. The time reported is the sender's alone (manual timing around its calls); the
+// simulated receivers and network are not counted. `datagrams/msg` is what the sender transmits
+// per message, where unicasting to each receiver would cost at least N. `delivered` falls just
+// short of 1 because a receiver that misses the very first message joins at the next one.
+
+// Helper functions
+namespace {
+    using Clock = ReliableMulticast::Clock;
+    using Datagram = std::vector<std::byte>;
+
+    constexpr size_t MESSAGES = 1000;
+    constexpr size_t MESSAGES_PER_TICK = 10;
+    constexpr size_t MESSAGE_SIZE = 200;
+    constexpr double LOSS = 0.01;
+
+    struct Simulation {
+        std::deque<Datagram> toGroup;
+        std::deque<Datagram> toSender;
+        std::vector<std::unique_ptr<MulticastReceiver>> receivers;
+        std::unique_ptr<MulticastSender> sender;
+        std::mt19937 random{7};
+        std::bernoulli_distribution lost{LOSS};
+        Clock::time_point now = Clock::now();
+        Clock::duration senderTime{0};
+        uint64_t groupDatagrams = 0;
+        uint64_t delivered = 0;
+
+        explicit Simulation(size_t size) {
+            sender = std::make_unique<MulticastSender>([this](std::span<const std::byte> datagram) {
+                toGroup.emplace_back(datagram.begin(), datagram.end());
+                ++groupDatagrams;
+                return true;
+            }, ReliableMulticast::DEFAULT_WINDOW, ReliableMulticast::DEFAULT_MTU, now);
+            for (size_t i = 0; i < size; ++i) {
+                receivers.push_back(std::make_unique<MulticastReceiver>([this](std::span<const std::byte> datagram) {
+                    toSender.emplace_back(datagram.begin(), datagram.end());
+                    return true;
+                }, static_cast<uint32_t>(i + 1)));
+            }
+        }
+
+        template <typename Call>
+        void TimeSender(Call call) {
+            auto start = std::chrono::steady_clock::now();
+            call();
+            senderTime += std::chrono::steady_clock::now() - start;
+        }
+
+        void Tick() {
+            auto count = [this](uint64_t, std::span<const std::byte>) { ++delivered; };
+            while (!toGroup.empty() || !toSender.empty()) {
+                while (!toGroup.empty()) {
+                    for (auto& receiver : receivers) {
+                        if (!lost(random)) {
+                            receiver->Receive(toGroup.front(), count, now);
+                        }
+                    }
+                    toGroup.pop_front();
+                }
+                while (!toSender.empty()) {
+                    TimeSender([this] { sender->Receive(toSender.front(), now); });
+                    toSender.pop_front();
+                }
+            }
+            now += std::chrono::milliseconds(1);
+            TimeSender([this] { sender->Update(now); });
+            for (auto& receiver : receivers) {
+                receiver->Update(count, now);
+            }
+        }
+    };
+}
+
+static void BM_ReliableMulticast_LossyGroup(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::vector<std::byte> message(MESSAGE_SIZE, std::byte{'s'});
+    uint64_t datagrams = 0;
+    uint64_t nacks = 0;
+    uint64_t delivered = 0;
+
+    for (auto _ : state) {
+        Simulation simulation(size);
+        for (size_t sent = 0; sent < MESSAGES; sent += MESSAGES_PER_TICK) {
+            simulation.TimeSender([&] {
+                for (size_t i = 0; i < MESSAGES_PER_TICK; ++i) {
+                    simulation.sender->Send(message, simulation.now);
+                }
+            });
+            simulation.Tick();
+        }
+        // Long enough for every repair to land
+        for (int i = 0; i < 300; ++i) {
+            simulation.Tick();
+        }
+        state.SetIterationTime(std::chrono::duration<double>(simulation.senderTime).count());
+        datagrams += simulation.groupDatagrams;
+        nacks += simulation.sender->GetStats().nacksReceived;
+        delivered += simulation.delivered;
+    }
+
+    const double messages = static_cast<double>(state.iterations() * MESSAGES);
+    state.SetItemsProcessed(static_cast<int64_t>(messages));
+    state.counters["datagrams/msg"] = static_cast<double>(datagrams) / messages;
+    state.counters["nacks/msg"] = static_cast<double>(nacks) / messages;
+    state.counters["delivered"] = static_cast<double>(delivered) / (messages * static_cast<double>(size));
+}
+BENCHMARK(BM_ReliableMulticast_LossyGroup)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->UseManualTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+#include "network/socket_observer.h"
+
+// What an observer decorator costs on a loopback UDP send + receive: the bare platform socket,
+// a decorator calling a virtual ISocketObserver with no-op hooks, and a decorator with an inline
+// compile-time policy. Sockets that are not wrapped pay nothing, so the first is also the
+// "no observer" case.
+
+namespace {
+    struct NoOpPolicy {
+        bool BeforeIo(const ISocketBase&, SocketIoEvent&) { return true; }
+        void AfterIo(const ISocketBase&, const SocketIoEvent&) {}
+    };
+
+    void RunSendReceive(benchmark::State& state, IUdpSocket& sender, IUdpSocket& receiver) {
+        const AddressKey destination(0x7F000001, receiver.GetLocalAddress().port);
+        std::vector<std::byte> datagram(512, std::byte{'o'});
+        std::vector<std::byte> buffer(2048);
+        AddressKey from;
+        for (auto _ : state) {
+            sender.SendTo(std::span<const std::byte>(datagram), destination);
+            if (receiver.ReceiveFrom(std::span<std::byte>(buffer), from) <= 0) {
+                state.SkipWithError("receive failed");
+                break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <typename Observer>
+    std::unique_ptr<IUdpSocket> Wrap(std::unique_ptr<IUdpSocket> socket, const std::shared_ptr<Observer>& observer) {
+        socket->Bind(NetworkAddress("127.0.0.1", 0));
+        if (!observer)
+            return socket;
+        return std::make_unique<ObservedUdpSocket<Observer>>(std::move(socket), observer);
+    }
+}
+
+static void BM_SocketObserver_UdpSendReceive_Bare(benchmark::State& state) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto sender = Wrap<ISocketObserver>(factory.CreateUdpSocket(), nullptr);
+    auto receiver = Wrap<ISocketObserver>(factory.CreateUdpSocket(), nullptr);
+    RunSendReceive(state, *sender, *receiver);
+}
+BENCHMARK(BM_SocketObserver_UdpSendReceive_Bare);
+
+static void BM_SocketObserver_UdpSendReceive_Virtual(benchmark::State& state) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto observer = std::make_shared<ISocketObserver>();
+    auto sender = Wrap(factory.CreateUdpSocket(), observer);
+    auto receiver = Wrap(factory.CreateUdpSocket(), observer);
+    RunSendReceive(state, *sender, *receiver);
+}
+BENCHMARK(BM_SocketObserver_UdpSendReceive_Virtual);
+
+static void BM_SocketObserver_UdpSendReceive_Policy(benchmark::State& state) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto observer = std::make_shared<NoOpPolicy>();
+    auto sender = Wrap(factory.CreateUdpSocket(), observer);
+    auto receiver = Wrap(factory.CreateUdpSocket(), observer);
+    RunSendReceive(state, *sender, *receiver);
+}
+BENCHMARK(BM_SocketObserver_UdpSendReceive_Policy);
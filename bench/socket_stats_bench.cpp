@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "network/platform_factory.h"
+#include "network/socket_stats.h"
+
+// What per-socket stats cost: SocketStats::Record alone, from one thread or several sharing a
+// socket's stats, and a loopback UDP send + receive with stats off and on (arg 0/1). The
+// difference between the last two is the price of leaving stats on in production.
+
+static void BM_SocketStats_Record(benchmark::State& state) {
+    static SocketStats stats;
+    const auto direction = state.thread_index() % 2 ? SocketStats::Direction::Send : SocketStats::Direction::Receive;
+    for (auto _ : state) {
+        stats.Record(direction, 1400, 1400, false, std::chrono::nanoseconds(800));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SocketStats_Record)->Threads(1)->Threads(2)->Threads(4);
+
+static void BM_SocketStats_UdpSendReceive(benchmark::State& state) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto sender = factory.CreateUdpSocket();
+    auto receiver = factory.CreateUdpSocket();
+    sender->Bind(NetworkAddress("127.0.0.1", 0));
+    receiver->Bind(NetworkAddress("127.0.0.1", 0));
+    if (state.range(0) != 0) {
+        sender->EnableStats(std::make_shared<SocketStats>());
+        receiver->EnableStats(std::make_shared<SocketStats>());
+    }
+    const AddressKey destination(0x7F000001, receiver->GetLocalAddress().port);
+
+    std::vector<std::byte> datagram(512, std::byte{'s'});
+    std::vector<std::byte> buffer(2048);
+    AddressKey from;
+    for (auto _ : state) {
+        sender->SendTo(std::span<const std::byte>(datagram), destination);
+        if (receiver->ReceiveFrom(std::span<std::byte>(buffer), from) <= 0) {
+            state.SkipWithError("receive failed");
+            break;
+        }
+    }
+    state.SetLabel(state.range(0) != 0 ? "stats on" : "stats off");
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SocketStats_UdpSendReceive)->Arg(0)->Arg(1);
@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/platform_factory.h"
+#include "network/tcp_socket.h"
+
+// TCP over loopback through ITcpSocket: round-trip latency with an echo thread, one-way streaming
+// throughput, the connect + accept rate, and the cost of WaitForDataWithTimeout. Results include
+// the kernel's loopback stack and, on few cores, the thread switches between the two ends.
+
+// Helper functions
+namespace {
+    void MessageSizes(benchmark::internal::Benchmark* bench) {
+        bench->RangeMultiplier(16)->Range(64, 64 * 1024);
+    }
+
+    bool SendAll(ITcpSocket& socket, std::span<const std::byte> data) {
+        while (!data.empty()) {
+            int sent = socket.Send(data);
+            if (sent <= 0)
+                return false;
+            data = data.subspan(static_cast<size_t>(sent));
+        }
+        return true;
+    }
+
+    bool ReceiveAll(ITcpSocket& socket, std::span<std::byte> buffer) {
+        while (!buffer.empty()) {
+            int received = socket.Receive(buffer);
+            if (received <= 0)
+                return false;
+            buffer = buffer.subspan(static_cast<size_t>(received));
+        }
+        return true;
+    }
+
+    // A connected client and server over loopback, both with Nagle's algorithm off
+    struct TcpPair {
+        std::unique_ptr<ITcpListener> listener;
+        std::unique_ptr<ITcpSocket> client;
+        std::unique_ptr<ITcpSocket> server;
+
+        TcpPair() {
+            auto& factory = NetworkFactorySingleton::GetInstance();
+            listener = factory.CreateTcpListener();
+            listener->Bind(NetworkAddress("127.0.0.1", 0));
+            listener->Listen(16);
+            client = factory.CreateTcpSocket();
+            client->Connect(NetworkAddress("127.0.0.1", listener->GetLocalAddress().port));
+            server = listener->AcceptTcp();
+            if (server) {
+                client->SetNoDelay(true);
+                server->SetNoDelay(true);
+            }
+        }
+
+        bool IsValid() const { return server != nullptr; }
+    };
+}
+
+// One request of the given size out and the same size back; the time per iteration is the round trip
+static void BM_TcpPingPong(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    TcpPair pair;
+    if (!pair.IsValid()) {
+        state.SkipWithError("loopback connection failed");
+        return;
+    }
+
+    std::thread echo([&pair, size] {
+        std::vector<std::byte> buffer(size);
+        while (ReceiveAll(*pair.server, buffer) && SendAll(*pair.server, buffer)) {
+        }
+    });
+
+    std::vector<std::byte> message(size, std::byte{'p'});
+    std::vector<std::byte> reply(size);
+    for (auto _ : state) {
+        if (!SendAll(*pair.client, message) || !ReceiveAll(*pair.client, reply)) {
+            state.SkipWithError("echo failed");
+            break;
+        }
+    }
+
+    pair.client->Close();
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_TcpPingPong)->Apply(MessageSizes)->UseRealTime();
+
+// Back-to-back sends of the given size to a reader thread that discards them
+static void BM_TcpStream(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    TcpPair pair;
+    if (!pair.IsValid()) {
+        state.SkipWithError("loopback connection failed");
+        return;
+    }
+
+    std::thread reader([&pair] {
+        std::vector<std::byte> buffer(256 * 1024);
+        while (pair.server->Receive(std::span<std::byte>(buffer)) > 0) {
+        }
+    });
+
+    std::vector<std::byte> chunk(size, std::byte{'s'});
+    for (auto _ : state) {
+        if (!SendAll(*pair.client, chunk)) {
+            state.SkipWithError("send failed");
+            break;
+        }
+    }
+
+    pair.client->Close();
+    reader.join();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TcpStream)->Apply(MessageSizes)->UseRealTime();
+
+// A connection set up and torn down per iteration. Each one leaves a TIME_WAIT entry, so the
+// run is kept short.
+static void BM_TcpConnectAccept(benchmark::State& state) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto listener = factory.CreateTcpListener();
+    listener->Bind(NetworkAddress("127.0.0.1", 0));
+    listener->Listen(128);
+    const NetworkAddress address("127.0.0.1", listener->GetLocalAddress().port);
+
+    for (auto _ : state) {
+        auto client = factory.CreateTcpSocket();
+        if (!client->Connect(address)) {
+            state.SkipWithError("connect failed");
+            break;
+        }
+        auto server = listener->AcceptTcp();
+        if (!server) {
+            state.SkipWithError("accept failed");
+            break;
+        }
+        server->Close();
+        client->Close();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TcpConnectAccept)->Iterations(2000)->UseRealTime();
+
+// WaitForDataWithTimeout(0) as a readiness probe: on an idle connection, and with data pending
+static void BM_WaitForDataWithTimeout(benchmark::State& state) {
+    const bool pending = state.range(0) != 0;
+    TcpPair pair;
+    if (!pair.IsValid()) {
+        state.SkipWithError("loopback connection failed");
+        return;
+    }
+    if (pending) {
+        std::byte one{1};
+        pair.client->Send(std::span<const std::byte>(&one, 1));
+        pair.server->WaitForDataWithTimeout(1000);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pair.server->WaitForDataWithTimeout(0));
+    }
+    state.SetLabel(pending ? "data pending" : "idle");
+}
+BENCHMARK(BM_WaitForDataWithTimeout)->Arg(0)->Arg(1);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+#include "network/platform_factory.h"
+#include "network/udp_socket.h"
+
+// One chat line fanned out to a room of N clients over loopback: a SendTo call per recipient,
+// as the UDP chat server used to broadcast, against one batched SendToMany.
+
+// Helper functions
+namespace {
+    constexpr size_t RECEIVERS = 8;
+    constexpr size_t MESSAGE_SIZE = 96;
+
+    // Loopback sockets standing in for the room; recipients cycle over them. Datagrams that
+    // overflow their receive buffers are dropped by the kernel, which the sender never sees.
+    struct Room {
+        std::unique_ptr<IUdpSocket> sender;
+        std::vector<std::unique_ptr<IUdpSocket>> receivers;
+        std::vector<AddressKey> recipients;
+        std::vector<std::byte> message = std::vector<std::byte>(MESSAGE_SIZE, std::byte{'m'});
+
+        explicit Room(size_t size) {
+            auto& factory = NetworkFactorySingleton::GetInstance();
+            sender = factory.CreateUdpSocket();
+            sender->Bind(NetworkAddress("127.0.0.1", 0));
+            for (size_t i = 0; i < RECEIVERS; ++i) {
+                receivers.push_back(factory.CreateUdpSocket());
+                receivers.back()->Bind(NetworkAddress("127.0.0.1", 0));
+            }
+            for (size_t i = 0; i < size; ++i) {
+                AddressKey key;
+                AddressKey::FromNetworkAddress(receivers[i % RECEIVERS]->GetLocalAddress(), key);
+                recipients.push_back(key);
+            }
+        }
+    };
+}
+
+static void BM_UdpFanOut_SendToPerRecipient(benchmark::State& state) {
+    Room room(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (const AddressKey& recipient : room.recipients) {
+            benchmark::DoNotOptimize(room.sender->SendTo(std::span<const std::byte>(room.message), recipient));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UdpFanOut_SendToPerRecipient)->Arg(64)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+static void BM_UdpFanOut_SendToMany(benchmark::State& state) {
+    Room room(static_cast<size_t>(state.range(0)));
+    std::vector<int> results(room.recipients.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(room.sender->SendToMany(room.message, room.recipients, results));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UdpFanOut_SendToMany)->Arg(64)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+#include "network/platform_factory.h"
+#include "network/udp_socket.h"
+
+// UDP datagrams per second over loopback through IUdpSocket: each iteration sends one datagram
+// and receives it on the same thread, so the receive buffer never overflows. The AddressKey
+// overloads skip the text conversion that the NetworkAddress ones do on every call.
+
+// Helper functions
+namespace {
+    void DatagramSizes(benchmark::internal::Benchmark* bench) {
+        bench->Arg(64)->Arg(512)->Arg(1400);
+    }
+
+    struct UdpPair {
+        std::unique_ptr<IUdpSocket> sender;
+        std::unique_ptr<IUdpSocket> receiver;
+        NetworkAddress destination;
+        AddressKey destinationKey;
+
+        UdpPair() {
+            auto& factory = NetworkFactorySingleton::GetInstance();
+            sender = factory.CreateUdpSocket();
+            receiver = factory.CreateUdpSocket();
+            sender->Bind(NetworkAddress("127.0.0.1", 0));
+            receiver->Bind(NetworkAddress("127.0.0.1", 0));
+            destination = NetworkAddress("127.0.0.1", receiver->GetLocalAddress().port);
+            AddressKey::FromNetworkAddress(destination, destinationKey);
+        }
+    };
+}
+
+static void BM_UdpSendReceive_AddressKey(benchmark::State& state) {
+    UdpPair pair;
+    std::vector<std::byte> datagram(static_cast<size_t>(state.range(0)), std::byte{'u'});
+    std::vector<std::byte> buffer(2048);
+    AddressKey from;
+    for (auto _ : state) {
+        pair.sender->SendTo(std::span<const std::byte>(datagram), pair.destinationKey);
+        if (pair.receiver->ReceiveFrom(std::span<std::byte>(buffer), from) <= 0) {
+            state.SkipWithError("receive failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UdpSendReceive_AddressKey)->Apply(DatagramSizes);
+
+static void BM_UdpSendReceive_NetworkAddress(benchmark::State& state) {
+    UdpPair pair;
+    std::vector<std::byte> datagram(static_cast<size_t>(state.range(0)), std::byte{'u'});
+    std::vector<std::byte> buffer(2048);
+    NetworkAddress from;
+    for (auto _ : state) {
+        pair.sender->SendTo(std::span<const std::byte>(datagram), pair.destination);
+        if (pair.receiver->ReceiveFrom(std::span<std::byte>(buffer), from) <= 0) {
+            state.SkipWithError("receive failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UdpSendReceive_NetworkAddress)->Apply(DatagramSizes);
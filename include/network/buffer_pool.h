@@ -0,0 +1,129 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+
+class BufferPool;
+
+namespace BufferPoolDetail {
+    struct PoolCore;
+
+    // Header stored in front of every pooled block; the payload follows it in the same allocation
+    struct alignas(std::max_align_t) BlockHeader {
+        std::atomic<uint32_t> refCount;
+        PoolCore* core;
+        size_t capacity;
+
+        std::byte* Payload() noexcept {
+            return reinterpret_cast<std::byte*>(this + 1);
+        }
+    };
+}
+
+// Reference-counted handle to (a slice of) a pooled block.
+// Copies and slices share the underlying block; it goes back to its pool when the last handle is released.
+// Shared blocks should be treated as immutable, since every handle sees the same bytes. A slice can
+// never grow past its own range, so writing through it cannot reach bytes that belong to its parent.
+class PooledBuffer {
+public:
+    PooledBuffer() noexcept = default;
+    PooledBuffer(const PooledBuffer& other) noexcept;
+    PooledBuffer(PooledBuffer&& other) noexcept;
+    PooledBuffer& operator=(const PooledBuffer& other) noexcept;
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+    ~PooledBuffer();
+
+    // Logical contents of this handle
+    std::byte* Data() noexcept { return m_block ? m_block->Payload() + m_offset : nullptr; }
+    const std::byte* Data() const noexcept { return m_block ? m_block->Payload() + m_offset : nullptr; }
+    size_t Size() const noexcept { return m_size; }
+    bool Empty() const noexcept { return m_size == 0; }
+    std::span<std::byte> Span() noexcept { return {Data(), m_size}; }
+    std::span<const std::byte> Span() const noexcept { return {Data(), m_size}; }
+
+    // Room available from the start of this handle: the rest of the block, or the slice's own length
+    size_t Capacity() const noexcept { return m_capacity; }
+
+    // Whole writable region, used as the target of a receive before calling Resize
+    std::span<std::byte> WritableSpan() noexcept { return {Data(), Capacity()}; }
+
+    // Sets the logical size (clamped to Capacity)
+    void Resize(size_t size) noexcept;
+
+    // Returns a handle to a sub-range sharing the same block, without copying
+    PooledBuffer Slice(size_t offset, size_t length) const noexcept;
+
+    // Drops this handle's reference
+    void Reset() noexcept;
+
+    uint32_t UseCount() const noexcept {
+        return m_block ? m_block->refCount.load(std::memory_order_relaxed) : 0;
+    }
+
+    explicit operator bool() const noexcept { return m_block != nullptr; }
+
+private:
+    friend class BufferPool;
+    explicit PooledBuffer(BufferPoolDetail::BlockHeader* block) noexcept
+        : m_block(block), m_offset(0), m_size(0), m_capacity(block->capacity) {}
+
+    BufferPoolDetail::BlockHeader* m_block = nullptr;
+    size_t m_offset = 0;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+};
+
+// Pool of fixed-size blocks with a per-thread slab cache in front of a shared free list.
+// Acquire/release on the same thread never touches the shared list or the allocator once warm.
+// The pool must outlive every PooledBuffer it hands out.
+class BufferPool {
+public:
+    // Pool hit/miss/high-water counters (snapshots of relaxed atomics)
+    struct Stats {
+        uint64_t hits = 0;        // Acquires served from a free list
+        uint64_t misses = 0;      // Acquires that had to allocate a new block
+        uint64_t inUse = 0;       // Blocks currently held by PooledBuffer handles
+        uint64_t highWater = 0;   // Maximum value inUse has reached
+        uint64_t allocated = 0;   // Blocks currently allocated (in use + cached)
+    };
+
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+    static constexpr size_t DEFAULT_THREAD_CACHE_BLOCKS = 64;
+
+    explicit BufferPool(size_t blockSize = DEFAULT_BLOCK_SIZE,
+                        size_t threadCacheBlocks = DEFAULT_THREAD_CACHE_BLOCKS);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Returns an empty buffer (Size() == 0) with Capacity() == GetBlockSize()
+    PooledBuffer Acquire();
+
+    // Returns an empty buffer with at least minCapacity bytes. Requests above the block size
+    // get a dedicated block that is freed on release instead of being cached.
+    PooledBuffer Acquire(size_t minCapacity);
+
+    // Returns a buffer holding the parts copied back to back, e.g. a formatted message that
+    // is then shared by reference between several recipients
+    PooledBuffer AcquireCopy(std::initializer_list<std::span<const std::byte>> parts);
+
+    // Pre-allocates blocks into the shared free list so the first acquires don't allocate
+    void Reserve(size_t blockCount);
+
+    size_t GetBlockSize() const;
+    Stats GetStats() const;
+
+private:
+    // Hands out a block with one reference and updates the in-use counters
+    PooledBuffer Track(BufferPoolDetail::BlockHeader* block);
+
+    std::shared_ptr<BufferPoolDetail::PoolCore> m_core;
+};
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,98 @@
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include "tcp_socket.h"
+#include "buffer_pool.h"
+#include "outbound_queue.h"
+
+// Coalescing write buffer in front of an ITcpSocket.
+// Small writes are copied into pooled blocks and shared buffers are queued by reference;
+// everything pending goes out with one gather-write (SendVectored) per Flush. A flush
+// happens when the pending bytes reach the threshold, when Flush is called (e.g. at the
+// end of an event-loop tick), or from FlushIfDue once the oldest pending byte has waited
+// longer than the configured delay. Partial writes leave the remainder queued.
+// The writer is not thread-safe and does not own the socket, which must outlive it.
+class BufferedWriter {
+public:
+    struct Stats {
+        uint64_t bytesQueued = 0;   // Bytes passed to Write
+        uint64_t bytesSent = 0;     // Bytes accepted by the socket
+        uint64_t flushes = 0;       // Flushes that had something to send
+        uint64_t sendCalls = 0;     // SendVectored calls made
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 16 * 1024;
+
+    // maxDelay of zero disables the timer; data then waits for the threshold or an explicit Flush
+    explicit BufferedWriter(ITcpSocket& socket,
+                            BufferPool& pool,
+                            size_t flushThreshold = DEFAULT_FLUSH_THRESHOLD,
+                            std::chrono::microseconds maxDelay = std::chrono::microseconds::zero());
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    // Copies data into the pending batch. Returns false if the threshold flush this
+    // triggered failed (the data stays queued).
+    bool Write(std::span<const std::byte> data);
+
+    // Queues a shared buffer without copying; the writer keeps a reference until it is sent
+    bool Write(const PooledBuffer& buffer);
+
+    // Sends everything pending, stopping at the first send that fails or would block.
+    // Returns the bytes sent (0 if nothing was pending), or -1 if the first send failed;
+    // whatever was not sent stays queued for the next Flush.
+    int Flush();
+
+    // Flushes if the timer delay has expired for the oldest pending byte
+    int FlushIfDue(Clock::time_point now = Clock::now());
+
+    // When FlushIfDue will next flush; Clock::time_point::max() if nothing is waiting on the timer
+    Clock::time_point GetFlushDeadline() const;
+
+    // True while the last flush stopped short because the socket took no more. The rest
+    // waits for the socket to become writable, not for the timer.
+    bool IsStalled() const { return m_stalled; }
+
+    // Retries a stalled flush and, once that is all out, moves the queue's messages in,
+    // waiting up to `timeout` for them. Nothing is taken from the queue while earlier data
+    // is stuck, so a stalled reader backs up into the queue, where its overflow policy
+    // applies. The new data is sent at once, or with a timer under the threshold left for
+    // FlushIfDue. Returns as Flush: the bytes sent, or, if nothing went out, -1 when any
+    // flush along the way failed (errno is that failure's), else 0.
+    int DrainFrom(OutboundQueue& queue, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    size_t GetPendingBytes() const { return m_pendingBytes; }
+    size_t GetFlushThreshold() const { return m_flushThreshold; }
+    Stats GetStats() const { return m_stats; }
+
+private:
+    bool FlushIfOverThreshold();
+    void NotePending(size_t bytes);
+
+    ITcpSocket& m_socket;
+    BufferPool& m_pool;
+    size_t m_flushThreshold;
+    std::chrono::microseconds m_maxDelay;
+
+    std::deque<PooledBuffer> m_segments;
+    size_t m_headOffset = 0;        // Bytes of the first segment already sent
+    bool m_tailAppendable = false;  // Last segment is our own block and may take more copies
+    size_t m_pendingBytes = 0;
+    bool m_stalled = false;
+    Clock::time_point m_oldestPending;
+    std::vector<PooledBuffer> m_drained;   // Reused by DrainFrom
+
+    Stats m_stats;
+};
+
+#endif // BUFFERED_WRITER_H
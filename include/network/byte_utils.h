@@ -2,29 +2,37 @@
 #define BYTE_UTILS_H
 
 #include <string>
+#include <string_view>
+#include <span>
 #include <vector>
+#include <cstring>
 #include <cstddef> // For std::byte
 
 namespace NetworkUtils {
+    // Zero-copy view of a string's characters as bytes, for the span-based Send/SendTo.
+    // The view is only valid while the string is alive and unmodified.
+    inline std::span<const std::byte> AsBytes(std::string_view str) {
+        return std::as_bytes(std::span<const char>(str.data(), str.size()));
+    }
+
+    // Zero-copy view of received bytes as text, valid while the bytes are
+    inline std::string_view AsStringView(std::span<const std::byte> bytes) {
+        return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
     // Helper function to convert string to vector of bytes
-    inline std::vector<std::byte> StringToBytes(const std::string& str) {
-        std::vector<std::byte> bytes;
-        bytes.reserve(str.size());
-        for (char c : str) {
-            bytes.push_back(std::byte(c));
+    inline std::vector<std::byte> StringToBytes(std::string_view str) {
+        std::vector<std::byte> bytes(str.size());
+        if (!str.empty()) {
+            std::memcpy(bytes.data(), str.data(), str.size());
         }
         return bytes;
     }
 
     // Helper function to convert vector of bytes to string
-    inline std::string BytesToString(const std::vector<std::byte>& bytes) {
-        std::string str;
-        str.reserve(bytes.size());
-        for (std::byte b : bytes) {
-            str.push_back(static_cast<char>(std::to_integer<int>(b)));
-        }
-        return str;
+    inline std::string BytesToString(std::span<const std::byte> bytes) {
+        return std::string(AsStringView(bytes));
     }
 }
 
-#endif // BYTE_UTILS_H
\ No newline at end of file
+#endif // BYTE_UTILS_H
@@ -0,0 +1,54 @@
+#ifndef CACHED_TIMESTAMP_H
+#define CACHED_TIMESTAMP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// Wall-clock timestamp text that is formatted at most once per second.
+// Every caller within the same second gets a copy of the cached text, so stamping a
+// message costs a short memcpy instead of a localtime/strftime call.
+class CachedTimestamp {
+public:
+    static constexpr size_t MAX_LENGTH = 64;
+
+    // ctime-style text in brackets followed by a space, e.g. "[Tue Nov 14 22:13:20 2023] "
+    static constexpr const char* DEFAULT_FORMAT = "[%a %b %e %H:%M:%S %Y] ";
+
+    // Formatted text returned by value; holds no allocation and no reference to the cache
+    struct Text {
+        char data[MAX_LENGTH];
+        size_t size = 0;
+
+        std::string_view View() const { return std::string_view(data, size); }
+    };
+
+    // strftime format in local time; a result longer than MAX_LENGTH - 1 characters comes out empty
+    explicit CachedTimestamp(std::string format = DEFAULT_FORMAT);
+
+    CachedTimestamp(const CachedTimestamp&) = delete;
+    CachedTimestamp& operator=(const CachedTimestamp&) = delete;
+
+    // Text for the current second
+    Text Now();
+
+    // Text for a given second (cached if it is the second most recently requested)
+    Text At(std::time_t second);
+
+    // Number of times the text actually had to be formatted
+    uint64_t GetFormatCount() const { return m_formatCount.load(std::memory_order_relaxed); }
+
+private:
+    const std::string m_format;
+
+    std::mutex m_mutex;
+    std::time_t m_cachedSecond = -1;
+    Text m_cached;
+    std::atomic<uint64_t> m_formatCount{0};
+};
+
+#endif // CACHED_TIMESTAMP_H
@@ -0,0 +1,155 @@
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "platform_factory.h"
+
+// Pool of connected TCP client sockets, kept per endpoint so that short calls to the same
+// backend reuse a connection instead of paying the handshake (and leaving a TIME_WAIT) each time.
+//
+// Checkout hands out the most recently returned idle connection for the endpoint, after checking
+// that it is still usable: no pending socket error, and nothing readable, since an idle
+// connection that reads as ready was closed by the peer or holds a stray reply. Without a usable
+// idle connection it connects a new one, unless the endpoint already has maxPerHost connections
+// open (idle or checked out), in which case it returns an empty lease. The lease goes back to the
+// pool when destroyed; call Discard on it after an I/O error or a protocol violation so the
+// connection is closed instead. Idle connections older than idleTimeout are never handed out
+// and are closed by EvictIdle.
+//
+// Endpoints are spread over independently locked shards. A shard's lock is held only to move a
+// socket in or out of an idle list; connecting and the liveness check happen outside it. The
+// pool must outlive its leases.
+class ConnectionPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        size_t maxPerHost = 16;                 // Open connections per endpoint, idle or in use
+        size_t maxIdlePerHost = 16;             // Returned connections beyond this are closed
+        Clock::duration idleTimeout = std::chrono::seconds(30);
+        int connectTimeoutMs = 1000;
+        bool noDelay = true;                    // TCP_NODELAY on new connections
+        size_t shardCount = 16;
+    };
+
+    // Counters summed over all endpoints (snapshots of relaxed atomics)
+    struct Stats {
+        uint64_t reused = 0;            // Checkouts served from an idle connection
+        uint64_t connected = 0;         // New connections made by Checkout or WarmUp
+        uint64_t connectFailures = 0;
+        uint64_t limitReached = 0;      // Checkouts refused at maxPerHost
+        uint64_t staleClosed = 0;       // Idle connections found dead or expired at checkout
+        uint64_t evicted = 0;           // Idle connections closed by EvictIdle
+        uint64_t discarded = 0;         // Leases discarded by their holder
+        size_t open = 0;                // Connections currently open, idle or in use
+        size_t idle = 0;
+    };
+
+    // A checked-out connection; returns it to the pool when destroyed
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ITcpSocket* Get() const { return m_socket.get(); }
+        ITcpSocket* operator->() const { return m_socket.get(); }
+        ITcpSocket& operator*() const { return *m_socket; }
+        explicit operator bool() const { return m_socket != nullptr; }
+
+        // Closes the connection instead of returning it to the pool
+        void Discard();
+
+        // Returns the connection to the pool now
+        void Release();
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool* pool, AddressKey endpoint, std::unique_ptr<ITcpSocket> socket)
+            : m_pool(pool), m_endpoint(endpoint), m_socket(std::move(socket)) {}
+
+        ConnectionPool* m_pool = nullptr;
+        AddressKey m_endpoint;
+        std::unique_ptr<ITcpSocket> m_socket;
+    };
+
+    explicit ConnectionPool(INetworkSocketFactory& factory);
+    ConnectionPool(INetworkSocketFactory& factory, Config config);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // A connection to the endpoint (a dotted-quad address), or an empty lease if none could be
+    // made or the endpoint is at maxPerHost
+    Lease Checkout(const NetworkAddress& endpoint);
+
+    // Connects until the endpoint has `count` idle connections (within the limits) and returns
+    // how many it has
+    size_t WarmUp(const NetworkAddress& endpoint, size_t count);
+
+    // Closes idle connections unused for longer than idleTimeout; returns how many
+    size_t EvictIdle(Clock::time_point now = Clock::now());
+
+    // Closes every idle connection; leased ones still come back when released
+    void Clear();
+
+    size_t GetIdleCount(const NetworkAddress& endpoint) const;
+    Stats GetStats() const;
+    const Config& GetConfig() const { return m_config; }
+
+private:
+    struct Idle {
+        std::unique_ptr<ITcpSocket> socket;
+        Clock::time_point since;
+    };
+
+    struct Host {
+        std::vector<Idle> idle;         // Most recently returned last
+        size_t open = 0;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<AddressKey, Host, AddressKeyHash> hosts;
+    };
+
+    Shard& ShardFor(const AddressKey& endpoint) const {
+        return m_shards[AddressKeyHash()(endpoint) % m_shardCount];
+    }
+
+    std::unique_ptr<ITcpSocket> Connect(const AddressKey& endpoint);
+    void Return(const AddressKey& endpoint, std::unique_ptr<ITcpSocket> socket, bool reusable);
+    void Forget(const AddressKey& endpoint);
+    size_t CloseIdle(Clock::time_point olderThan);
+    static bool IsUsable(ITcpSocket& socket);
+
+    INetworkSocketFactory& m_factory;
+    const Config m_config;
+    const size_t m_shardCount;
+    std::unique_ptr<Shard[]> m_shards;
+
+    std::atomic<uint64_t> m_reused{0};
+    std::atomic<uint64_t> m_connected{0};
+    std::atomic<uint64_t> m_connectFailures{0};
+    std::atomic<uint64_t> m_limitReached{0};
+    std::atomic<uint64_t> m_staleClosed{0};
+    std::atomic<uint64_t> m_evicted{0};
+    std::atomic<uint64_t> m_discarded{0};
+    std::atomic<size_t> m_open{0};
+    std::atomic<size_t> m_idle{0};
+};
+
+#endif // CONNECTION_POOL_H
@@ -0,0 +1,180 @@
+#ifndef FEED_HANDLER_H
+#define FEED_HANDLER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "platform_factory.h"
+
+// Arbitration for a sequenced message feed published twice, on lines A and B, in MoldUDP64
+// framing: a 20-byte header (10-byte session, first sequence number as u64 and message count
+// as u16, big-endian) followed by that many messages, each prefixed with its u16 length. A
+// packet without messages is a heartbeat that carries the next sequence number.
+//
+// The first copy of each message to arrive wins and is passed on, in sequence order; later
+// copies are dropped. A message arriving beyond the next expected one opens a gap. Messages
+// after it are held (copied) until the other line fills the gap or the gap timeout expires,
+// after which the missing messages are reported lost and delivery moves on. Either way the gap
+// is reported with how long it was open. In-order messages, the usual case, are handed on as
+// views into the datagram without being copied, and a packet that only repeats what was
+// already delivered is skipped after reading its header.
+//
+// The arbiter locks onto the session of the first packet it sees. It is not thread-safe: it
+// belongs to the one thread that reads both lines. Callbacks must not call back into it.
+class FeedArbiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Line : uint8_t { A = 0, B = 1 };
+
+    // Once per unique message, in sequence order. The view is only valid during the call.
+    using MessageCallback = std::function<void(uint64_t sequence, std::span<const std::byte> message)>;
+
+    enum class GapResolution {
+        Recovered,  // The other line supplied the missing messages
+        Lost        // Neither line did before the gap timeout
+    };
+
+    struct Gap {
+        uint64_t firstSequence = 0;
+        uint64_t count = 0;
+        Clock::duration latency{0};     // From detection until recovered or given up
+        GapResolution resolution = GapResolution::Recovered;
+    };
+
+    using GapCallback = std::function<void(const Gap&)>;
+
+    struct Stats {
+        uint64_t packets[2] = {};       // Per line
+        uint64_t messagesWon[2] = {};   // Unique messages that arrived first on each line
+        uint64_t messagesDelivered = 0;
+        uint64_t duplicates = 0;
+        uint64_t gapsRecovered = 0;
+        uint64_t gapsLost = 0;
+        uint64_t messagesLost = 0;
+        uint64_t malformed = 0;         // Including packets of another session
+    };
+
+    static constexpr size_t SESSION_SIZE = 10;
+    static constexpr size_t HEADER_SIZE = 20;
+    static constexpr uint16_t END_OF_SESSION = 0xFFFF;
+    static constexpr std::chrono::milliseconds DEFAULT_GAP_TIMEOUT{5};
+    // Held messages beyond this give up on the oldest gap early
+    static constexpr size_t MAX_HELD_MESSAGES = 65536;
+
+    explicit FeedArbiter(MessageCallback onMessage, GapCallback onGap = nullptr,
+                         Clock::duration gapTimeout = DEFAULT_GAP_TIMEOUT);
+
+    FeedArbiter(const FeedArbiter&) = delete;
+    FeedArbiter& operator=(const FeedArbiter&) = delete;
+
+    // Processes one datagram from a line. Returns false if it is malformed or from another session.
+    bool Process(std::span<const std::byte> packet, Line line, Clock::time_point now = Clock::now());
+
+    // Gives up on a gap that has outlived the timeout; call this when the lines may go quiet
+    void Update(Clock::time_point now = Clock::now());
+
+    // Forgets the session and sequence, e.g. for the next trading day
+    void Reset();
+
+    uint64_t GetNextSequence() const { return m_expected; }
+    bool HasGap() const { return m_gapOpen; }
+    size_t GetHeldCount() const { return m_held.size(); }
+    const Stats& GetStats() const { return m_stats; }
+
+    // Appends one packet; without messages it is a heartbeat announcing firstSequence as next
+    static void EncodePacket(std::vector<std::byte>& out, std::string_view session, uint64_t firstSequence,
+                             std::span<const std::span<const std::byte>> messages = {});
+
+private:
+    struct Held {
+        std::vector<std::byte> message;
+        Clock::time_point arrived;
+    };
+
+    void OnMessage(uint64_t sequence, std::span<const std::byte> message, Line line, Clock::time_point now);
+    void Deliver(uint64_t sequence, std::span<const std::byte> message);
+    void Announce(uint64_t next, Clock::time_point now);
+    void OpenGap(Clock::time_point opened);
+    void AfterAdvance(Clock::time_point now);
+    void DeliverHeld();
+    void GiveUp(Clock::time_point now);
+    void ReopenIfMissing(Clock::time_point now);
+
+    const MessageCallback m_onMessage;
+    const GapCallback m_onGap;
+    const Clock::duration m_gapTimeout;
+
+    Stats m_stats;
+    bool m_hasSession = false;
+    char m_session[SESSION_SIZE] = {};
+    uint64_t m_expected = 0;            // Next sequence number to deliver
+    uint64_t m_horizon = 0;             // One past the highest sequence number announced
+    std::map<uint64_t, Held> m_held;    // Arrived beyond a gap
+
+    bool m_gapOpen = false;
+    uint64_t m_gapFirst = 0;
+    Clock::time_point m_gapOpened;
+};
+
+// Receives an A/B feed from two multicast groups, each joined on its own interface, and passes
+// it through a FeedArbiter. One thread calls Poll (or Run), which waits on both sockets and
+// drains everything they have queued, so the arbiter and the callbacks all run on that thread.
+// A line whose address is not a multicast group is bound as a plain unicast endpoint.
+class FeedHandler {
+public:
+    using Clock = FeedArbiter::Clock;
+    using Line = FeedArbiter::Line;
+
+    struct LineConfig {
+        NetworkAddress group;           // Multicast group (or unicast address) and port
+        std::string interfaceAddress;   // Interface to join on; empty lets the system choose
+    };
+
+    static constexpr size_t MAX_DATAGRAM_SIZE = 65536;
+
+    explicit FeedHandler(FeedArbiter::MessageCallback onMessage, FeedArbiter::GapCallback onGap = nullptr,
+                         Clock::duration gapTimeout = FeedArbiter::DEFAULT_GAP_TIMEOUT);
+    ~FeedHandler();
+
+    FeedHandler(const FeedHandler&) = delete;
+    FeedHandler& operator=(const FeedHandler&) = delete;
+
+    // Binds and joins both lines; a line B without an address makes a single-line feed.
+    // Returns false if a socket could not be set up, in which case nothing stays open.
+    bool Open(INetworkSocketFactory& factory, const LineConfig& lineA, const LineConfig& lineB);
+
+    // Waits up to timeoutMs for either line and processes every datagram queued on both.
+    // Returns the number of datagrams processed, or -1 if the handler is not open.
+    int Poll(int timeoutMs);
+
+    // Polls until Stop is called from another thread, which may happen before Run starts;
+    // Open arms it again
+    void Run(int pollTimeoutMs = 100);
+    void Stop();
+    void Close();
+
+    // The address a line is bound to (its port, when opened with port 0)
+    NetworkAddress GetLocalAddress(Line line) const;
+    const FeedArbiter& GetArbiter() const { return m_arbiter; }
+
+private:
+    size_t Drain(Line line);
+
+    FeedArbiter m_arbiter;
+    std::unique_ptr<IUdpSocket> m_sockets[2];
+    std::unique_ptr<ISocketPoller> m_poller;
+    std::vector<std::byte> m_buffer;
+    std::atomic<bool> m_running{false};
+};
+
+#endif // FEED_HANDLER_H
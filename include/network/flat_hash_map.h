@@ -0,0 +1,268 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// Open-addressing hash map with linear probing that keeps every entry inline in one array.
+// A lookup hashes once and then walks adjacent slots, so for small keys such as AddressKey it
+// touches one or two cache lines instead of chasing the per-node pointers of std::unordered_map.
+// Erase shifts the following entries back instead of leaving tombstones, so probe sequences
+// stay short under churn. The capacity is a power of two and grows at 3/4 load. Home slots come
+// from the high bits of a multiplicative (Fibonacci) scramble of the hash, so weak hashes and
+// keys that share their low hash bits (e.g. one shard of a ShardedRegistry) still spread out.
+// Key and Value must be default-constructible and movable. Any insert or erase invalidates
+// iterators and references. The interface follows the std::unordered_map subset it covers, so
+// it can stand in for one in templates such as ShardedRegistry.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+    struct Slot;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+        Iterator() = default;
+
+        // A mutable iterator converts to a const one
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : m_slot(other.m_slot), m_end(other.m_end) {}
+
+        reference operator*() const { return m_slot->entry; }
+        pointer operator->() const { return &m_slot->entry; }
+
+        Iterator& operator++() {
+            ++m_slot;
+            SkipEmpty();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const { return m_slot == other.m_slot; }
+        bool operator!=(const Iterator& other) const { return m_slot != other.m_slot; }
+
+    private:
+        friend class FlatHashMap;
+        template <bool>
+        friend class Iterator;
+        using SlotPointer = std::conditional_t<IsConst, const Slot*, Slot*>;
+
+        Iterator(SlotPointer slot, SlotPointer end) : m_slot(slot), m_end(end) { SkipEmpty(); }
+
+        void SkipEmpty() {
+            while (m_slot != m_end && !m_slot->occupied) {
+                ++m_slot;
+            }
+        }
+
+        SlotPointer m_slot = nullptr;
+        SlotPointer m_end = nullptr;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    explicit FlatHashMap(size_t expectedSize = 0, Hash hash = Hash(), KeyEqual equal = KeyEqual())
+        : m_hash(hash), m_equal(equal) {
+        reserve(expectedSize);
+    }
+
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+    FlatHashMap(FlatHashMap&& other) noexcept { Swap(other); }
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        if (this != &other) {
+            FlatHashMap moved(std::move(other));
+            Swap(moved);
+        }
+        return *this;
+    }
+
+    iterator begin() { return iterator(m_slots.get(), m_slots.get() + m_capacity); }
+    iterator end() { return iterator(m_slots.get() + m_capacity, m_slots.get() + m_capacity); }
+    const_iterator begin() const { return const_iterator(m_slots.get(), m_slots.get() + m_capacity); }
+    const_iterator end() const { return const_iterator(m_slots.get() + m_capacity, m_slots.get() + m_capacity); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_capacity; }
+
+    iterator find(const Key& key) {
+        size_t index = FindIndex(key);
+        return index == NOT_FOUND ? end() : iterator(m_slots.get() + index, m_slots.get() + m_capacity);
+    }
+
+    const_iterator find(const Key& key) const {
+        size_t index = FindIndex(key);
+        return index == NOT_FOUND ? end() : const_iterator(m_slots.get() + index, m_slots.get() + m_capacity);
+    }
+
+    size_t count(const Key& key) const { return FindIndex(key) == NOT_FOUND ? 0 : 1; }
+
+    // Inserts the entry unless the key is present; returns the entry and whether it was inserted
+    template <typename V>
+    std::pair<iterator, bool> emplace(const Key& key, V&& value) {
+        if ((m_size + 1) * 4 > m_capacity * 3) {
+            Rehash(m_capacity == 0 ? MIN_CAPACITY : m_capacity * 2);
+        }
+
+        size_t index = Home(key);
+        while (m_slots[index].occupied) {
+            if (m_equal(m_slots[index].entry.first, key))
+                return {iterator(m_slots.get() + index, m_slots.get() + m_capacity), false};
+            index = (index + 1) & (m_capacity - 1);
+        }
+
+        Slot& slot = m_slots[index];
+        slot.entry.first = key;
+        slot.entry.second = std::forward<V>(value);
+        slot.occupied = true;
+        ++m_size;
+        return {iterator(m_slots.get() + index, m_slots.get() + m_capacity), true};
+    }
+
+    std::pair<iterator, bool> insert(value_type entry) {
+        return emplace(entry.first, std::move(entry.second));
+    }
+
+    Value& operator[](const Key& key) {
+        return emplace(key, Value()).first->second;
+    }
+
+    // Removes the entry; iterators are invalidated, so unlike std::unordered_map nothing is returned
+    void erase(const_iterator position) {
+        EraseIndex(static_cast<size_t>(position.m_slot - m_slots.get()));
+    }
+
+    size_t erase(const Key& key) {
+        size_t index = FindIndex(key);
+        if (index == NOT_FOUND)
+            return 0;
+        EraseIndex(index);
+        return 1;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_slots[i].occupied) {
+                m_slots[i] = Slot();
+            }
+        }
+        m_size = 0;
+    }
+
+    // Grows the table so that `count` entries fit without another rehash
+    void reserve(size_t count) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * 3 < count * 4) {
+            capacity *= 2;
+        }
+        if (count > 0 && capacity > m_capacity) {
+            Rehash(capacity);
+        }
+    }
+
+private:
+    static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+    struct Slot {
+        value_type entry{};
+        bool occupied = false;
+    };
+
+    size_t Home(const Key& key) const {
+        return static_cast<size_t>((static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ULL) >> m_shift);
+    }
+
+    size_t FindIndex(const Key& key) const {
+        if (m_size == 0)
+            return NOT_FOUND;
+
+        size_t index = Home(key);
+        while (m_slots[index].occupied) {
+            if (m_equal(m_slots[index].entry.first, key))
+                return index;
+            index = (index + 1) & (m_capacity - 1);
+        }
+        return NOT_FOUND;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the hole while that
+    // moves them no further from their home slot, so no lookup ever needs a tombstone
+    void EraseIndex(size_t hole) {
+        const size_t mask = m_capacity - 1;
+        size_t next = (hole + 1) & mask;
+        while (m_slots[next].occupied) {
+            size_t home = Home(m_slots[next].entry.first);
+            // The entry may fill the hole unless its home lies cyclically in (hole, next]
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                m_slots[hole] = std::move(m_slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+        m_slots[hole] = Slot();
+        --m_size;
+    }
+
+    void Rehash(size_t capacity) {
+        std::unique_ptr<Slot[]> old = std::move(m_slots);
+        const size_t oldCapacity = m_capacity;
+
+        m_slots = std::make_unique<Slot[]>(capacity);
+        m_capacity = capacity;
+        m_shift = 64;
+        for (size_t bits = capacity; bits > 1; bits >>= 1) {
+            --m_shift;
+        }
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (!old[i].occupied)
+                continue;
+            size_t index = Home(old[i].entry.first);
+            while (m_slots[index].occupied) {
+                index = (index + 1) & (m_capacity - 1);
+            }
+            m_slots[index] = std::move(old[i]);
+        }
+    }
+
+    void Swap(FlatHashMap& other) noexcept {
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_equal, other.m_equal);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_shift, other.m_shift);
+    }
+
+    Hash m_hash;
+    KeyEqual m_equal;
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    unsigned m_shift = 64;   // 64 - log2(capacity)
+};
+
+#endif // FLAT_HASH_MAP_H
@@ -0,0 +1,79 @@
+#ifndef FRAMED_CONNECTION_H
+#define FRAMED_CONNECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "tcp_socket.h"
+#include "mirrored_ring_buffer.h"
+
+// Length-prefixed message framing over a TCP byte stream.
+// Incoming bytes are parsed incrementally from a reusable ring buffer, so frames split
+// across several reads or coalesced into one read are both handled; complete frames are
+// returned as views into that buffer. Outgoing frames are queued and written with a
+// single Send per Flush.
+// The connection does not own the socket, which must outlive it.
+class FramedConnection {
+public:
+    // Encoding of the length prefix in front of each frame
+    enum class PrefixFormat {
+        FixedU32,   // 4-byte unsigned length in network byte order
+        Varint      // LEB128 varint, 1-5 bytes
+    };
+
+    enum class ReadStatus {
+        Frame,          // A complete frame was returned
+        NeedMoreData,   // No complete frame is buffered yet
+        Closed,         // The peer closed the connection
+        Error,          // The socket reported an error
+        FrameTooLarge   // The peer announced a frame above the limit (or a malformed prefix)
+    };
+
+    static constexpr size_t DEFAULT_MAX_FRAME_SIZE = 1024 * 1024;
+    static constexpr size_t MAX_PREFIX_SIZE = 5;
+
+    explicit FramedConnection(ITcpSocket& socket,
+                              PrefixFormat format = PrefixFormat::FixedU32,
+                              size_t maxFrameSize = DEFAULT_MAX_FRAME_SIZE);
+
+    // False if the receive buffer could not be created
+    bool IsValid() const { return m_receiveBuffer.IsValid(); }
+
+    // Returns the next complete frame already buffered, without touching the socket.
+    // The view stays valid until the next call to NextFrame or ReadFrame.
+    ReadStatus NextFrame(std::span<const std::byte>& frame);
+
+    // Returns a buffered frame if there is one, otherwise performs a single Receive
+    // into the buffer and tries again. Blocks only as long as that one Receive does.
+    ReadStatus ReadFrame(std::span<const std::byte>& frame);
+
+    // Appends a frame to the outgoing batch; returns false if it exceeds the frame limit
+    bool QueueFrame(std::span<const std::byte> payload);
+
+    // Writes every queued frame with as few Send calls as the socket allows (one in the
+    // common case), stopping at the first send that fails or would block. Returns the bytes
+    // written, or the failed Send's result if nothing went out (check
+    // ISocketPoller::LastCallWouldBlock); unsent bytes stay queued for the next Flush.
+    int Flush();
+
+    // Convenience for QueueFrame followed by Flush
+    int SendFrame(std::span<const std::byte> payload);
+
+    size_t GetPendingBytes() const { return m_outgoing.size() - m_outgoingSent; }
+    size_t GetMaxFrameSize() const { return m_maxFrameSize; }
+
+private:
+    ITcpSocket& m_socket;
+    PrefixFormat m_format;
+    size_t m_maxFrameSize;
+
+    MirroredRingBuffer m_receiveBuffer;
+    size_t m_pendingConsume = 0;   // Bytes of the last returned frame, released on the next read
+
+    std::vector<std::byte> m_outgoing;
+    size_t m_outgoingSent = 0;
+};
+
+#endif // FRAMED_CONNECTION_H
@@ -0,0 +1,114 @@
+#ifndef LINE_FRAMER_H
+#define LINE_FRAMER_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Splits a byte stream into newline-delimited text lines.
+// Delimiters are located with SSE2/AVX2 where available (scalar fallback elsewhere).
+// Complete lines are handed out as string views with a trailing '\r' removed; a line
+// that is not yet terminated is carried over to the next Feed call.
+class LineFramer {
+public:
+    static constexpr size_t DEFAULT_MAX_LINE_LENGTH = 4096;
+
+    explicit LineFramer(size_t maxLineLength = DEFAULT_MAX_LINE_LENGTH)
+        : m_maxLineLength(maxLineLength) {}
+
+    // Calls onLine(std::string_view) for each complete line in data (the view is only valid
+    // during the call). Lines longer than the limit are discarded up to their newline;
+    // returns false if that happened during this call.
+    template<typename LineHandler>
+    bool Feed(std::span<const std::byte> data, LineHandler&& onLine);
+
+    // Emits a carried, unterminated line as a final line; used where the end of the input
+    // also ends the line (e.g. a datagram)
+    template<typename LineHandler>
+    void Finish(LineHandler&& onLine);
+
+    void Reset() {
+        m_partial.clear();
+        m_discarding = false;
+    }
+
+    // Bytes of an unterminated line waiting for its newline
+    size_t GetBufferedBytes() const { return m_partial.size(); }
+    size_t GetMaxLineLength() const { return m_maxLineLength; }
+
+    // Offset of the first '\n' in [data, data + size), or size if there is none
+    static size_t FindNewline(const char* data, size_t size);
+
+private:
+    static std::string_view StripCarriageReturn(std::string_view line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    size_t m_maxLineLength;
+    std::string m_partial;      // Unterminated line carried between Feed calls
+    bool m_discarding = false;  // Skipping the rest of an oversized line
+};
+
+template<typename LineHandler>
+bool LineFramer::Feed(std::span<const std::byte> data, LineHandler&& onLine) {
+    const char* bytes = reinterpret_cast<const char*>(data.data());
+    const size_t size = data.size();
+    bool withinLimit = true;
+
+    size_t pos = 0;
+    while (pos < size) {
+        size_t newline = pos + FindNewline(bytes + pos, size - pos);
+
+        if (newline == size) {
+            // No terminator in the rest of the input: carry it over
+            if (!m_discarding) {
+                if (m_partial.size() + (size - pos) > m_maxLineLength) {
+                    m_partial.clear();
+                    m_discarding = true;
+                    withinLimit = false;
+                } else {
+                    m_partial.append(bytes + pos, size - pos);
+                }
+            }
+            break;
+        }
+
+        std::string_view line(bytes + pos, newline - pos);
+        if (m_discarding) {
+            // This newline ends an oversized line
+            m_discarding = false;
+        } else if (m_partial.empty()) {
+            // Fast path: the whole line is inside this input, no copy needed
+            if (line.size() > m_maxLineLength) {
+                withinLimit = false;
+            } else {
+                onLine(StripCarriageReturn(line));
+            }
+        } else {
+            if (m_partial.size() + line.size() > m_maxLineLength) {
+                withinLimit = false;
+            } else {
+                m_partial.append(line);
+                onLine(StripCarriageReturn(m_partial));
+            }
+            m_partial.clear();
+        }
+        pos = newline + 1;
+    }
+
+    return withinLimit;
+}
+
+template<typename LineHandler>
+void LineFramer::Finish(LineHandler&& onLine) {
+    if (!m_discarding && !m_partial.empty()) {
+        onLine(StripCarriageReturn(m_partial));
+    }
+    Reset();
+}
+
+#endif // LINE_FRAMER_H
@@ -0,0 +1,110 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Counters, gauges and histograms describing a running process, rendered in the Prometheus text
+// exposition format (version 0.0.4) for MetricsEndpoint to serve. Updating a metric is a relaxed
+// atomic operation without a lock, so hot paths record freely and a scrape that reads the values
+// never stalls them.
+//
+// Metrics are registered up front; the returned references stay valid for the registry's
+// lifetime. A name may be registered more than once with different labels (e.g. `reason="idle"`);
+// the series then share one HELP and TYPE line. Names and labels are written out as given.
+// All methods are thread-safe.
+class MetricsRegistry {
+public:
+    // Monotonic count, e.g. messages received. Rates come from Prometheus' rate().
+    class Counter {
+    public:
+        void Increment(uint64_t count = 1) { m_value.fetch_add(count, std::memory_order_relaxed); }
+        uint64_t Get() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> m_value{0};
+    };
+
+    // Value that goes up and down, e.g. queued messages
+    class Gauge {
+    public:
+        void Set(double value) { m_value.store(value, std::memory_order_relaxed); }
+        void Add(double delta) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+        double Get() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> m_value{0};
+    };
+
+    // Distribution over fixed buckets, given by their inclusive upper bounds in increasing order;
+    // a final +Inf bucket catches the rest. Observe is a short scan and two atomic adds.
+    class Histogram {
+    public:
+        explicit Histogram(std::vector<double> upperBounds);
+
+        void Observe(double value);
+
+        const std::vector<double>& GetUpperBounds() const { return m_upperBounds; }
+        // Observations in each bucket (not cumulative), +Inf last
+        std::vector<uint64_t> GetBucketCounts() const;
+        uint64_t GetCount() const;
+        double GetSum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    private:
+        const std::vector<double> m_upperBounds;
+        std::unique_ptr<std::atomic<uint64_t>[]> m_counts;
+        std::atomic<double> m_sum{0};
+    };
+
+    // Evaluated during each scrape on the endpoint's thread, so it must be cheap and must not block
+    using GaugeFunction = std::function<double()>;
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    Counter& AddCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& AddGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    void AddGaugeFunction(const std::string& name, const std::string& help, GaugeFunction function,
+                          const std::string& labels = "");
+    Histogram& AddHistogram(const std::string& name, const std::string& help, std::vector<double> upperBounds,
+                            const std::string& labels = "");
+
+    // Appends every metric in the text exposition format
+    void Render(std::string& out) const;
+
+    // `count` bounds starting at `start`, each `factor` times the previous one
+    static std::vector<double> ExponentialBuckets(double start, double factor, size_t count);
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series {
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        GaugeFunction function;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<Series> series;
+    };
+
+    Series& AddSeries(const std::string& name, const std::string& help, Type type, const std::string& labels);
+
+    // Guards the family list only; it is never held while a metric is updated
+    mutable std::mutex m_mutex;
+    std::vector<Family> m_families;
+};
+
+#endif // METRICS_H
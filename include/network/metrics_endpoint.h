@@ -0,0 +1,85 @@
+#ifndef METRICS_ENDPOINT_H
+#define METRICS_ENDPOINT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "metrics.h"
+#include "platform_factory.h"
+
+// Embedded HTTP endpoint that serves a MetricsRegistry to Prometheus on a port of its own.
+// `GET /metrics` is answered with the registry in the text format and the connection is closed;
+// other paths get 404. One thread serves every scrape through non-blocking sockets and a poller,
+// so a scraper that stalls holds one of MAX_CONNECTIONS slots until REQUEST_TIMEOUT, never a
+// thread. The scrape reads the metrics' atomics and takes no lock the recording code uses.
+class MetricsEndpoint {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_CONNECTIONS = 16;
+    static constexpr size_t MAX_REQUEST_SIZE = 8192;
+    static constexpr std::chrono::milliseconds REQUEST_TIMEOUT{5000};
+    // How long accepting pauses after an accept error such as running out of descriptors
+    static constexpr std::chrono::milliseconds ACCEPT_BACKOFF{100};
+
+    MetricsEndpoint(INetworkSocketFactory& factory, const MetricsRegistry& registry);
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    // Binds, listens and starts the serving thread; port 0 picks a free port.
+    // Returns false if the endpoint is already running or the socket setup fails.
+    bool Start(const NetworkAddress& address);
+    // Closes the listener and any scrape in progress and joins the thread
+    void Stop();
+
+    bool IsRunning() const { return m_running.load(std::memory_order_relaxed); }
+    NetworkAddress GetLocalAddress() const;
+    // Requests answered with the metrics
+    uint64_t GetScrapeCount() const { return m_scrapes.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        std::unique_ptr<ITcpSocket> socket;
+        std::string request;
+        std::string response;
+        size_t sent = 0;
+        Clock::time_point deadline;
+    };
+
+    void Run();
+    void AcceptPending();
+    void ResumeAccepting(Clock::time_point now);
+    // Each returns false once the connection should be closed
+    bool ReadRequest(uint64_t token, Connection& connection);
+    bool WriteResponse(Connection& connection);
+    void BuildResponse(Connection& connection);
+    void CloseConnection(uint64_t token);
+    void CloseExpired(Clock::time_point now);
+
+    INetworkSocketFactory& m_factory;
+    const MetricsRegistry& m_registry;
+    std::unique_ptr<ITcpListener> m_listener;
+    std::unique_ptr<ISocketPoller> m_poller;
+    NetworkAddress m_localAddress;
+
+    // Only touched by the serving thread
+    std::unordered_map<uint64_t, Connection> m_connections;
+    uint64_t m_nextToken = 1;
+    bool m_acceptPaused = false;        // The listener is out of the poller until m_acceptResume
+    Clock::time_point m_acceptResume;
+    size_t m_lastBodySize = 0;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_scrapes{0};
+};
+
+#endif // METRICS_ENDPOINT_H
@@ -0,0 +1,58 @@
+#ifndef MIRRORED_RING_BUFFER_H
+#define MIRRORED_RING_BUFFER_H
+
+#include <cstddef>
+#include <span>
+
+// Byte ring buffer whose storage is mapped twice back-to-back in virtual memory.
+// Because the second mapping aliases the first, both the readable and the writable
+// region are always contiguous: a recv() can fill the free space and a parser can
+// read a message that straddles the wrap point without any copying.
+class MirroredRingBuffer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    // Capacity is rounded up to the platform's mapping granularity (the page size on Unix,
+    // the allocation granularity on Windows). Check IsValid() before use.
+    explicit MirroredRingBuffer(size_t minCapacity = DEFAULT_CAPACITY);
+    ~MirroredRingBuffer();
+
+    MirroredRingBuffer(const MirroredRingBuffer&) = delete;
+    MirroredRingBuffer& operator=(const MirroredRingBuffer&) = delete;
+    MirroredRingBuffer(MirroredRingBuffer&& other) noexcept;
+    MirroredRingBuffer& operator=(MirroredRingBuffer&& other) noexcept;
+
+    bool IsValid() const { return m_base != nullptr; }
+    size_t Capacity() const { return m_capacity; }
+
+    // Number of bytes available to read / free space available to write
+    size_t Size() const { return m_tail - m_head; }
+    size_t Available() const { return m_capacity - Size(); }
+    bool Empty() const { return m_tail == m_head; }
+
+    // Contiguous view of all readable bytes
+    std::span<const std::byte> ReadableSpan() const { return {m_base + m_head, Size()}; }
+    // Contiguous view of all free space; call Commit() with the number of bytes written
+    std::span<std::byte> WritableSpan() { return {m_base + m_tail, Available()}; }
+
+    // Marks bytes written into WritableSpan() as readable
+    void Commit(size_t bytes);
+    // Discards bytes from the front of the readable region
+    void Consume(size_t bytes);
+    // Copies data in; returns false (and writes nothing) if there is not enough space
+    bool Write(std::span<const std::byte> data);
+    void Clear() { m_head = m_tail = 0; }
+
+private:
+    void Release();
+
+    std::byte* m_base = nullptr;
+    size_t m_capacity = 0;
+    size_t m_head = 0;  // Offset of the first readable byte, always < m_capacity
+    size_t m_tail = 0;  // m_head + Size(), may run into the mirrored half
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#endif
+};
+
+#endif // MIRRORED_RING_BUFFER_H
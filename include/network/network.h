@@ -11,7 +11,15 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <span>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <cstddef> // For std::byte
+#include <cstdint>
+
+class SocketStats;
+class SocketStatsGroup;
 
 // Structure to hold network address information (IP and port)
 struct NetworkAddress {
@@ -23,6 +31,40 @@ struct NetworkAddress {
         : ipAddress(ip), port(p) {}
 };
 
+// IPv4 endpoint packed into 48 bits: the address (host byte order) in bits 16-47 and the port
+// in bits 0-15. Hashing and comparing it is a single integer operation, unlike the text form
+// in NetworkAddress, which makes it the better key for per-datagram peer lookups.
+struct AddressKey {
+    uint64_t packed = 0;
+
+    AddressKey() = default;
+    AddressKey(uint32_t ipv4, unsigned short port)
+        : packed((static_cast<uint64_t>(ipv4) << 16) | port) {}
+
+    uint32_t GetIPv4() const { return static_cast<uint32_t>(packed >> 16); }
+    unsigned short GetPort() const { return static_cast<unsigned short>(packed & 0xFFFF); }
+
+    // Parses a dotted-quad address; returns false for anything else (host names, IPv6)
+    static bool FromNetworkAddress(const NetworkAddress& address, AddressKey& key);
+    NetworkAddress ToNetworkAddress() const;
+
+    bool operator==(const AddressKey& other) const { return packed == other.packed; }
+    bool operator!=(const AddressKey& other) const { return packed != other.packed; }
+};
+
+// Mixes all 48 bits so that hash tables indexing by the low bits see neighbouring ports spread out
+struct AddressKeyHash {
+    size_t operator()(const AddressKey& key) const {
+        uint64_t h = key.packed;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+};
+
 // Base interface for all socket types with common functionality
 class ISocketBase {
 public:
@@ -39,7 +81,20 @@ public:
     virtual bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) = 0;
     // Generic socket option interface - allows getting any socket option
     virtual bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const = 0;
-    
+
+    // Switches between blocking and non-blocking mode. In non-blocking mode calls that cannot
+    // make progress fail at once (see ISocketPoller::LastCallWouldBlock). Returns false if unsupported.
+    virtual bool SetNonBlocking(bool /*enable*/) { return false; }
+
+    // Counts this socket's sends and receives into `stats` (see socket_stats.h); null turns
+    // counting off. Set it before the socket is shared between threads. Returns false if the
+    // implementation keeps no stats.
+    virtual bool EnableStats(std::shared_ptr<SocketStats> /*stats*/) { return false; }
+    virtual std::shared_ptr<SocketStats> GetStats() const { return nullptr; }
+
+    // The platform socket underneath any decorators (see socket_observer.h), for code such as
+    // pollers that needs the implementation's own handle
+    virtual const ISocketBase& GetUnderlyingSocket() const { return *this; }
 };
 
 // Include socket utility functions after ISocketBase is defined
@@ -54,6 +109,25 @@ public:
     virtual int Receive(std::vector<std::byte>& buffer) = 0;
     virtual NetworkAddress GetRemoteAddress() const = 0;
     virtual bool SetConnectTimeout(int timeoutMs) = 0;
+
+    // Shuts the connection down in both directions but keeps the descriptor, so calls blocked
+    // on it in other threads return while only Close releases it. Returns false if unsupported.
+    virtual bool Shutdown() { return false; }
+
+    // Span-based overloads send from / receive into caller-owned memory (e.g. pooled buffers)
+    // Platform sockets override these to avoid the intermediate vector used by the defaults
+    virtual int Send(std::span<const std::byte> data) {
+        return Send(std::vector<std::byte>(data.begin(), data.end()));
+    }
+    virtual int Receive(std::span<std::byte> buffer) {
+        std::vector<std::byte> temp(buffer.size());
+        int bytesRead = Receive(temp);
+        if (bytesRead > 0) {
+            bytesRead = static_cast<int>((std::min)(static_cast<size_t>(bytesRead), buffer.size()));
+            std::copy_n(temp.begin(), bytesRead, buffer.begin());
+        }
+        return bytesRead;
+    }
 };
 
 // Interface for server-side of connection-oriented sockets
@@ -62,6 +136,10 @@ public:
     // Server operations for connection-oriented protocols
     virtual bool Listen(int backlog) = 0;
     virtual std::unique_ptr<IConnectionOrientedSocket> Accept() = 0;
+
+    // Connections accepted from now on count their I/O into new stats from `group`, so the
+    // group totals the listener's traffic; null turns that off. Returns false if unsupported.
+    virtual bool SetStatsGroup(std::shared_ptr<SocketStatsGroup> /*group*/) { return false; }
 };
 
 // Interface for connectionless sockets (like UDP)
@@ -70,6 +148,62 @@ public:
     // Operations specific to connectionless sockets
     virtual int SendTo(const std::vector<std::byte>& data, const NetworkAddress& remoteAddress) = 0;
     virtual int ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress& remoteAddress) = 0;
+
+    // Span-based overloads send from / receive into caller-owned memory (e.g. pooled buffers)
+    // Platform sockets override these to avoid the intermediate vector used by the defaults
+    virtual int SendTo(std::span<const std::byte> data, const NetworkAddress& remoteAddress) {
+        return SendTo(std::vector<std::byte>(data.begin(), data.end()), remoteAddress);
+    }
+    virtual int ReceiveFrom(std::span<std::byte> buffer, NetworkAddress& remoteAddress) {
+        std::vector<std::byte> temp(buffer.size());
+        int bytesRead = ReceiveFrom(temp, remoteAddress);
+        if (bytesRead > 0) {
+            bytesRead = static_cast<int>((std::min)(static_cast<size_t>(bytesRead), buffer.size()));
+            std::copy_n(temp.begin(), bytesRead, buffer.begin());
+        }
+        return bytesRead;
+    }
+
+    // Overloads taking the peer as a packed AddressKey, for servers that key their peers by it.
+    // Platform sockets convert straight from and to the socket address without going through text.
+    virtual int SendTo(std::span<const std::byte> data, const AddressKey& remoteKey) {
+        return SendTo(data, remoteKey.ToNetworkAddress());
+    }
+    virtual int ReceiveFrom(std::span<std::byte> buffer, AddressKey& remoteKey) {
+        NetworkAddress remoteAddress;
+        int bytesRead = ReceiveFrom(buffer, remoteAddress);
+        if (bytesRead > 0 && !AddressKey::FromNetworkAddress(remoteAddress, remoteKey)) {
+            return -1;
+        }
+        return bytesRead;
+    }
+
+    // Fan-out: sends the same datagram to every destination. results, if not empty, must hold one
+    // entry per destination and receives the bytes sent to it or -1. Returns the number of
+    // destinations the datagram went to. Platform sockets batch the sends (sendmmsg on Linux).
+    virtual size_t SendToMany(std::span<const std::byte> data, std::span<const AddressKey> destinations,
+                              std::span<int> results = {}) {
+        size_t delivered = 0;
+        for (size_t i = 0; i < destinations.size(); ++i) {
+            int sent = SendTo(data, destinations[i]);
+            if (!results.empty()) {
+                results[i] = sent;
+            }
+            delivered += sent >= 0 ? 1 : 0;
+        }
+        return delivered;
+    }
+
+    // Paced send: the datagram should leave no earlier than launchTime (see TokenBucket::Reserve).
+    // On Linux, once SO_TXTIME is enabled (SocketOptions::EnableTxTime), the launch time goes to the
+    // kernel with the datagram and the call returns at once. Otherwise it sleeps until then.
+    virtual int SendToAt(std::span<const std::byte> data, const AddressKey& remoteKey,
+                         std::chrono::steady_clock::time_point launchTime) {
+        if (launchTime > std::chrono::steady_clock::now()) {
+            std::this_thread::sleep_until(launchTime);
+        }
+        return SendTo(data, remoteKey);
+    }
 };
 
 #endif // NETWORK_H
\ No newline at end of file
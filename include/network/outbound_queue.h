@@ -0,0 +1,91 @@
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "buffer_pool.h"
+
+// Bounded queue of outgoing messages for one connection.
+// Any number of producers may push; a single consumer (the connection's writer thread or
+// event loop) drains it. Limits apply to both the message count and the queued bytes, and
+// the overflow policy decides what a push does when they are reached. One message is always
+// accepted into an empty queue, however large.
+class OutboundQueue {
+public:
+    enum class OverflowPolicy {
+        DropOldest,     // Evict the oldest messages to make room
+        Disconnect,     // Refuse the message and close the queue; the owner should drop the connection
+        Backpressure    // Block the producer until there is room or the timeout expires
+    };
+
+    enum class PushResult {
+        Queued,         // Message queued
+        DroppedOldest,  // Message queued after evicting older ones
+        Rejected,       // Backpressure timed out; the message was not queued
+        Overflowed,     // Disconnect policy hit the limit; the queue is now closed
+        Closed          // The queue was already closed
+    };
+
+    // Snapshot of the queue counters
+    struct Stats {
+        size_t depth = 0;           // Messages currently queued
+        size_t depthBytes = 0;      // Bytes currently queued
+        size_t highWater = 0;       // Maximum depth reached
+        uint64_t enqueued = 0;      // Messages accepted
+        uint64_t dropped = 0;       // Messages evicted by DropOldest
+        uint64_t rejected = 0;      // Messages refused (Rejected or Overflowed)
+    };
+
+    static constexpr size_t DEFAULT_MAX_MESSAGES = 1024;
+    static constexpr size_t DEFAULT_MAX_BYTES = 1024 * 1024;
+    static constexpr std::chrono::milliseconds DEFAULT_BACKPRESSURE_TIMEOUT{50};
+
+    explicit OutboundQueue(OverflowPolicy policy = OverflowPolicy::DropOldest,
+                           size_t maxMessages = DEFAULT_MAX_MESSAGES,
+                           size_t maxBytes = DEFAULT_MAX_BYTES,
+                           std::chrono::milliseconds backpressureTimeout = DEFAULT_BACKPRESSURE_TIMEOUT);
+
+    OutboundQueue(const OutboundQueue&) = delete;
+    OutboundQueue& operator=(const OutboundQueue&) = delete;
+
+    // Queues a message (a shared handle, so one buffer can sit in many queues)
+    PushResult Push(PooledBuffer message);
+
+    // Moves every queued message to the end of `messages`, waiting up to `timeout` for the
+    // first one. Returns false once the queue is closed and empty.
+    bool PopAll(std::vector<PooledBuffer>& messages, std::chrono::milliseconds timeout);
+
+    // Stops accepting messages and wakes the consumer and any blocked producers.
+    // Messages already queued can still be drained.
+    void Close();
+    bool IsClosed() const;
+
+    size_t GetDepth() const;
+    size_t GetDepthBytes() const;
+    OverflowPolicy GetPolicy() const { return m_policy; }
+    Stats GetStats() const;
+
+private:
+    bool HasRoomFor(size_t bytes) const;
+    void PopFront();
+
+    const OverflowPolicy m_policy;
+    const size_t m_maxMessages;
+    const size_t m_maxBytes;
+    const std::chrono::milliseconds m_backpressureTimeout;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<PooledBuffer> m_messages;
+    bool m_closed = false;
+    Stats m_stats;
+};
+
+#endif // OUTBOUND_QUEUE_H
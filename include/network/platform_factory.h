@@ -3,6 +3,7 @@
 
 #include "tcp_socket.h"
 #include "udp_socket.h"
+#include "socket_poller.h"
 #include <memory>
 
 // Abstract factory interface for creating platform-specific socket implementations
@@ -17,6 +18,14 @@ public:
     // Create UDP socket implementation
     virtual std::unique_ptr<IUdpSocket> CreateUdpSocket() = 0;
     
+    // Create a readiness poller for event-driven servers; null if the platform has none
+    virtual std::unique_ptr<ISocketPoller> CreateSocketPoller() { return nullptr; }
+
+    // Sockets and listeners created from now on count their I/O into new stats from `group`, and
+    // the listeners do the same for the connections they accept; null turns that off.
+    // Returns false if the platform sockets keep no stats.
+    virtual bool SetStatsGroup(std::shared_ptr<SocketStatsGroup> /*group*/) { return false; }
+    
     // Static method to create the appropriate platform factory
     static std::unique_ptr<INetworkSocketFactory> CreatePlatformFactory();
 };
@@ -0,0 +1,173 @@
+#ifndef RELIABLE_CHANNEL_H
+#define RELIABLE_CHANNEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Reliable message channel between two peers over datagrams, such as one IUdpSocket peer.
+// The channel does no I/O of its own: it hands finished datagrams to a send function and is fed
+// the peer's datagrams through Receive, so one socket can serve many channels.
+//
+// Messages are split into fragments that fit the MTU. Every datagram carries a packet sequence
+// number, a cumulative ack and a selective-ack bitmap of the packets received beyond it. Lost
+// packets are resent when three later packets are acked (fast retransmit) or when their
+// retransmission timeout expires. The timeout comes from smoothed RTT estimates (RFC 6298). A
+// congestion window in packets grows with slow start and additive increase and halves on loss.
+// Messages are delivered exactly once, either in send order (Ordered) or as soon as they are
+// complete (Unordered), so a lost packet holds back only the ordered messages behind it.
+//
+// Call Update every UPDATE_INTERVAL or so to run timers and delayed acks. All methods are
+// thread-safe. The send function runs with the channel's lock held and must not call back into
+// the channel; Receive's message callback runs without it.
+class ReliableChannel {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Transmits one datagram to the peer; returns false if it could not be sent
+    using SendFunction = std::function<bool(std::span<const std::byte>)>;
+    using MessageCallback = std::function<void(std::span<const std::byte>)>;
+
+    enum class Delivery {
+        Ordered,    // After every earlier ordered message
+        Unordered   // As soon as all its fragments arrive
+    };
+
+    enum class ReceiveResult {
+        Processed,      // A channel datagram from the current peer
+        PeerRestarted,  // The peer started a new session; all earlier state was discarded first
+        Stale,          // From an earlier or not yet started peer session; ignored
+        Malformed       // Not a channel datagram, or data past the receive limits; dropped
+    };
+
+    struct Stats {
+        uint64_t packetsSent = 0;       // Every datagram sent, including acks and retransmissions
+        uint64_t retransmissions = 0;
+        uint64_t timeouts = 0;          // Retransmission timeouts
+        uint64_t packetsReceived = 0;
+        uint64_t duplicates = 0;
+        uint64_t staleDatagrams = 0;    // Other-session datagrams that did not start a new session
+        uint64_t messagesDelivered = 0;
+        size_t bufferedBytes = 0;       // Held for reassembly or waiting for in-order delivery
+        std::chrono::microseconds smoothedRtt{0};
+        std::chrono::microseconds retransmitTimeout{0};
+        double congestionWindow = 0;    // In packets
+        size_t packetsInFlight = 0;
+        size_t packetsQueued = 0;       // Waiting for the congestion window
+    };
+
+    static constexpr size_t DEFAULT_MTU = 1200;
+    static constexpr size_t MIN_MTU = 128;
+    static constexpr size_t MAX_MESSAGE_SIZE = 1024 * 1024;
+    // Received data held at once; datagrams that would exceed it are dropped unacknowledged
+    static constexpr size_t MAX_BUFFERED_BYTES = 4 * MAX_MESSAGE_SIZE;
+    static constexpr std::chrono::milliseconds UPDATE_INTERVAL{10};
+
+    explicit ReliableChannel(SendFunction send, size_t mtu = DEFAULT_MTU, Clock::time_point now = Clock::now());
+
+    ReliableChannel(const ReliableChannel&) = delete;
+    ReliableChannel& operator=(const ReliableChannel&) = delete;
+
+    // True if the datagram starts like a channel datagram, for sockets that also carry plain traffic
+    static bool IsChannelDatagram(std::span<const std::byte> datagram);
+
+    // Queues a message and sends as much as the congestion window allows. Returns false if the
+    // message is larger than MAX_MESSAGE_SIZE or too much is already queued.
+    bool Send(std::span<const std::byte> message, Delivery delivery = Delivery::Ordered,
+              Clock::time_point now = Clock::now());
+
+    // Processes one datagram from the peer and passes every message it completes to onMessage
+    ReceiveResult Receive(std::span<const std::byte> datagram, const MessageCallback& onMessage,
+                          Clock::time_point now = Clock::now());
+
+    // Resends packets whose timeout expired and sends acks that are due
+    void Update(Clock::time_point now = Clock::now());
+
+    // Sent messages not yet acknowledged in full, counted in packets
+    size_t GetUnackedCount() const;
+    Clock::time_point GetLastReceiveTime() const;
+    size_t GetMtu() const { return m_mtu; }
+    Stats GetStats() const;
+
+private:
+    struct Packet {
+        uint64_t seq = 0;
+        uint8_t flags = 0;
+        uint32_t message = 0;
+        uint16_t fragmentIndex = 0;
+        uint16_t fragmentCount = 1;
+        std::vector<std::byte> payload;
+        Clock::time_point sentAt;
+        uint64_t sendOrder = 0;         // Transmission counter value of the latest send
+        bool acked = false;
+        bool retransmitted = false;
+    };
+
+    struct Reassembly {
+        std::vector<std::vector<std::byte>> fragments;
+        std::vector<bool> present;
+        size_t received = 0;
+    };
+
+    void Reset(Clock::time_point now);
+    void Transmit(Packet& packet, Clock::time_point now);
+    void SendAck();
+    void SendQueued(Clock::time_point now);
+    void OnAck(uint64_t ack, std::span<const uint32_t> sack, Clock::time_point now);
+    bool MarkAcked(Packet& packet);
+    void OnCongestion(uint64_t seq);
+    void UpdateRtt(Clock::duration sample);
+    bool OnData(Packet&& packet, std::vector<std::vector<std::byte>>& completed, bool& ackNow);
+    void Deliver(bool ordered, uint64_t message, std::vector<std::byte> data,
+                 std::vector<std::vector<std::byte>>& completed);
+    void WriteHeader(std::vector<std::byte>& out, uint8_t flags);
+    Clock::duration RetransmitTimeout() const;
+
+    const SendFunction m_send;
+    const size_t m_mtu;
+    const size_t m_fragmentSize;
+    const uint32_t m_session;
+
+    mutable std::mutex m_mutex;
+    Stats m_stats;
+    uint32_t m_peerSession = 0;
+    Clock::time_point m_lastReceive;
+    std::vector<std::byte> m_scratch;
+
+    // Sending side
+    uint64_t m_nextSeq = 0;
+    uint64_t m_sendBase = 0;                // Oldest unacked sequence number
+    std::deque<Packet> m_inFlight;          // Sequence numbers m_sendBase onward
+    std::deque<Packet> m_sendQueue;         // Not yet given a sequence number
+    uint64_t m_nextOrderedSend = 0;
+    uint64_t m_nextUnorderedSend = 0;
+    uint64_t m_sendOrder = 0;
+    uint64_t m_largestAckedOrder = 0;
+    uint64_t m_recoveryStart = 0;           // Losses below this belong to the last congestion event
+    double m_congestionWindow;
+    double m_slowStartThreshold;
+    bool m_hasRtt = false;
+    Clock::duration m_smoothedRtt{0};
+    Clock::duration m_rttVariance{0};
+    unsigned m_backoff = 0;
+
+    // Receiving side
+    uint64_t m_receiveNext = 0;             // Every packet below it has arrived
+    std::deque<bool> m_receivedAhead;       // Index i: packet m_receiveNext + i arrived
+    bool m_ackPending = false;
+    unsigned m_unackedPackets = 0;
+    Clock::time_point m_ackDeadline;
+    std::map<std::pair<bool, uint64_t>, Reassembly> m_reassembly;
+    std::map<uint64_t, std::vector<std::byte>> m_readyOrdered;   // Complete, waiting for their turn
+    uint64_t m_nextOrderedDelivery = 0;
+    uint64_t m_unorderedReference = 0;      // One past the highest unordered message seen
+    size_t m_bufferedBytes = 0;             // Counted against MAX_BUFFERED_BYTES
+};
+
+#endif // RELIABLE_CHANNEL_H
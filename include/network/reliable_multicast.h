@@ -0,0 +1,190 @@
+#ifndef RELIABLE_MULTICAST_H
+#define RELIABLE_MULTICAST_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <span>
+#include <vector>
+
+// NACK-based reliable multicast in the spirit of PGM (RFC 3208): one sender multicasts each
+// message once and many receivers ask only for what they missed.
+//
+// The sender numbers its messages and keeps the latest ones in a bounded retransmit window.
+// Every datagram it sends carries the window's trailing edge, and while idle it multicasts
+// heartbeats with the next sequence number, soon after the last message and then less often,
+// so receivers notice a lost tail and what can no longer be repaired. A receiver that sees a hole waits a
+// random backoff, then unicasts a NACK for the missing ranges to the sender. The sender multicasts
+// a NACK confirmation (NCF) for the ranges and then the repairs. Every other receiver missing the
+// same messages hears the NCF and holds its own NACK back, and the sender answers repeated NACKs
+// for a message only once per repair holdoff. The sender therefore sends about one NCF and one
+// repair per lost message, however many receivers lost it.
+//
+// Like ReliableChannel, both ends are sans-I/O: they hand datagrams to send functions and are fed
+// what arrives. Messages must fit in one datagram. Receivers deliver in sequence order and skip
+// messages that the sender's window no longer holds or that stay unrepaired after
+// MAX_NACK_ATTEMPTS. Call Update every UPDATE_INTERVAL or so. All methods are thread-safe.
+// Send functions run with the lock held; message callbacks run without it.
+namespace ReliableMulticast {
+    using Clock = std::chrono::steady_clock;
+    // Transmits one datagram (to the group, or for receivers' NACKs to the sender)
+    using SendFunction = std::function<bool(std::span<const std::byte>)>;
+    using MessageCallback = std::function<void(uint64_t sequence, std::span<const std::byte> message)>;
+
+    constexpr size_t DEFAULT_MTU = 1400;
+    constexpr size_t HEADER_SIZE = 24;
+    constexpr size_t DEFAULT_WINDOW = 4096;                 // Messages kept for repair
+    // Missing messages a receiver tracks; a larger jump gives up on everything before it
+    constexpr size_t MAX_TRACKED = 65536;
+    constexpr std::chrono::milliseconds UPDATE_INTERVAL{5};
+    constexpr std::chrono::milliseconds MIN_HEARTBEAT_INTERVAL{10};  // After the last message
+    constexpr std::chrono::milliseconds MAX_HEARTBEAT_INTERVAL{500};
+    constexpr std::chrono::milliseconds REPAIR_HOLDOFF{20};     // Per message, at the sender
+    constexpr std::chrono::milliseconds NACK_BACKOFF{10};       // Upper bound of the random backoff
+    constexpr std::chrono::milliseconds NACK_REPEAT{50};        // Without an NCF
+    constexpr std::chrono::milliseconds REPAIR_WAIT{100};       // After an NCF
+    constexpr unsigned MAX_NACK_ATTEMPTS = 8;
+
+    // True if the datagram starts like one of this protocol's
+    bool IsMulticastDatagram(std::span<const std::byte> datagram);
+}
+
+class MulticastSender {
+public:
+    using Clock = ReliableMulticast::Clock;
+
+    struct Stats {
+        uint64_t messagesSent = 0;
+        uint64_t repairsSent = 0;
+        uint64_t confirmationsSent = 0;     // NCFs
+        uint64_t heartbeatsSent = 0;
+        uint64_t nacksReceived = 0;
+        uint64_t nacksSuppressed = 0;       // Requests answered by a recent repair
+        uint64_t nacksTooLate = 0;          // Requests for messages already out of the window
+    };
+
+    explicit MulticastSender(ReliableMulticast::SendFunction sendToGroup,
+                             size_t window = ReliableMulticast::DEFAULT_WINDOW,
+                             size_t mtu = ReliableMulticast::DEFAULT_MTU,
+                             Clock::time_point now = Clock::now());
+
+    MulticastSender(const MulticastSender&) = delete;
+    MulticastSender& operator=(const MulticastSender&) = delete;
+
+    // Multicasts the message; returns false if it does not fit in one datagram
+    bool Send(std::span<const std::byte> message, Clock::time_point now = Clock::now());
+
+    // Handles a datagram unicast to the sender (a receiver's NACK); false if it is not one
+    bool Receive(std::span<const std::byte> datagram, Clock::time_point now = Clock::now());
+
+    // Sends the heartbeat when due
+    void Update(Clock::time_point now = Clock::now());
+
+    uint64_t GetNextSequence() const;
+    size_t GetMaxMessageSize() const { return m_mtu - ReliableMulticast::HEADER_SIZE; }
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        std::vector<std::byte> message;
+        Clock::time_point lastRepair;
+        bool repaired = false;
+    };
+
+    void SendHeartbeat(Clock::time_point now);
+    void SendConfirmations(const std::vector<uint64_t>& sequences);
+
+    const ReliableMulticast::SendFunction m_send;
+    const size_t m_window;
+    const size_t m_mtu;
+    const uint32_t m_session;
+
+    mutable std::mutex m_mutex;
+    Stats m_stats;
+    uint64_t m_nextSequence = 0;
+    std::deque<Entry> m_entries;        // Sequence numbers m_trail onward
+    uint64_t m_trail = 0;
+    Clock::time_point m_lastSend;
+    Clock::duration m_heartbeatDelay;
+    std::vector<std::byte> m_scratch;
+};
+
+class MulticastReceiver {
+public:
+    using Clock = ReliableMulticast::Clock;
+
+    struct Stats {
+        uint64_t messagesDelivered = 0;
+        uint64_t messagesRepaired = 0;      // Missing messages that arrived as repairs
+        uint64_t messagesLost = 0;          // Skipped as unrecoverable
+        uint64_t duplicates = 0;
+        uint64_t nacksSent = 0;
+        uint64_t nacksSuppressed = 0;       // Held back because of another receiver's NACK
+        size_t missing = 0;
+    };
+
+    // sendToSender unicasts NACKs to the sender, typically to the source address of its datagrams
+    explicit MulticastReceiver(ReliableMulticast::SendFunction sendToSender,
+                               uint32_t seed = std::random_device{}());
+
+    MulticastReceiver(const MulticastReceiver&) = delete;
+    MulticastReceiver& operator=(const MulticastReceiver&) = delete;
+
+    // Processes one datagram from the group and passes every message it makes deliverable to
+    // onMessage, in sequence order. Returns false if the datagram is not one of the protocol's.
+    bool Receive(std::span<const std::byte> datagram, const ReliableMulticast::MessageCallback& onMessage,
+                 Clock::time_point now = Clock::now());
+
+    // Sends NACKs that are due, and passes on messages freed by giving up on others
+    void Update(const ReliableMulticast::MessageCallback& onMessage, Clock::time_point now = Clock::now());
+
+    uint64_t GetNextSequence() const;
+    Stats GetStats() const;
+
+private:
+    enum class NackState {
+        Backoff,        // Waiting out the random backoff before the first NACK
+        Requested,      // NACKed; repeat if no NCF arrives
+        Confirmed       // The sender confirmed; waiting for the repair
+    };
+
+    struct Missing {
+        NackState state = NackState::Backoff;
+        Clock::time_point deadline;
+        unsigned attempts = 0;
+    };
+
+    using Delivery = std::vector<std::pair<uint64_t, std::vector<std::byte>>>;
+
+    void Reset(uint32_t session, uint64_t start);
+    void Announce(uint64_t next, Clock::time_point now);
+    void OnData(uint64_t sequence, std::span<const std::byte> message, bool repair);
+    void OnConfirm(uint64_t first, uint64_t end, Clock::time_point now);
+    void GiveUpBefore(uint64_t trail);
+    void SkipTo(uint64_t sequence);
+    void SendNacks(Clock::time_point now);
+    void Collect();
+
+    const ReliableMulticast::SendFunction m_send;
+
+    mutable std::mutex m_mutex;
+    Stats m_stats;
+    std::mt19937 m_random;
+    bool m_hasSession = false;
+    uint32_t m_session = 0;
+    uint64_t m_expected = 0;                // Next sequence number to deliver
+    uint64_t m_horizon = 0;                 // One past the highest sequence number announced
+    std::map<uint64_t, std::vector<std::byte>> m_held;     // Arrived beyond a hole
+    std::map<uint64_t, Missing> m_missing;
+    std::set<uint64_t> m_lost;              // Given up, not yet passed by delivery
+    Delivery m_ready;                       // Deliverable, handed on once the lock is released
+    std::vector<std::byte> m_scratch;
+};
+
+#endif // RELIABLE_MULTICAST_H
@@ -0,0 +1,207 @@
+#ifndef SHARDED_REGISTRY_H
+#define SHARDED_REGISTRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Concurrent map of shared values split into independently locked shards, built for
+// registries that are read far more often than they change (e.g. connected clients).
+// Lookups take one shard's lock in shared mode. Inserts and removes lock one shard
+// exclusively, so joins and leaves on different shards proceed in parallel. ForEach walks an
+// immutable per-shard snapshot that is rebuilt lazily after a write: the lock is held only to
+// grab the snapshot, never while the callback runs. Callbacks may therefore call back into the
+// registry, and values inserted or removed during a walk may or may not be visited.
+// Values are held by shared_ptr, so an entry stays alive for whoever still holds it after removal.
+// Map is the per-shard table; FlatHashMap suits small keys such as AddressKey.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+          typename Map = std::unordered_map<Key, std::shared_ptr<Value>, Hash, KeyEqual>>
+class ShardedRegistry {
+public:
+    using ValuePtr = std::shared_ptr<Value>;
+    using Entry = std::pair<Key, ValuePtr>;
+
+    // Counters summed over all shards
+    struct Stats {
+        size_t size = 0;                // Entries currently registered
+        uint64_t writes = 0;            // Successful inserts and removes
+        uint64_t snapshotRebuilds = 0;  // Shard snapshots rebuilt for ForEach after a write
+        uint64_t contendedLocks = 0;    // Lock acquisitions that had to wait for another thread
+    };
+
+    static constexpr size_t DEFAULT_SHARD_COUNT = 64;
+
+    explicit ShardedRegistry(size_t shardCount = DEFAULT_SHARD_COUNT, Hash hash = Hash())
+        : m_hash(hash),
+          m_shardCount(shardCount > 0 ? shardCount : 1),
+          m_shards(std::make_unique<Shard[]>(m_shardCount)) {}
+
+    ShardedRegistry(const ShardedRegistry&) = delete;
+    ShardedRegistry& operator=(const ShardedRegistry&) = delete;
+
+    // Adds the value unless the key is already registered
+    bool Insert(const Key& key, ValuePtr value) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock<std::shared_mutex> lock = LockExclusive(shard);
+        if (!shard.entries.emplace(key, std::move(value)).second)
+            return false;
+
+        shard.snapshot.reset();
+        ++shard.writes;
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Removes the key and returns its value, or nullptr if it was not registered
+    ValuePtr Remove(const Key& key) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock<std::shared_mutex> lock = LockExclusive(shard);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end())
+            return nullptr;
+
+        ValuePtr value = std::move(it->second);
+        shard.entries.erase(it);
+        shard.snapshot.reset();
+        ++shard.writes;
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    // Removes the key only while it still maps to `expected`, so a stale remover cannot take out
+    // an entry that has since been re-registered under the same key
+    bool Remove(const Key& key, const ValuePtr& expected) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock<std::shared_mutex> lock = LockExclusive(shard);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end() || it->second != expected)
+            return false;
+
+        shard.entries.erase(it);
+        shard.snapshot.reset();
+        ++shard.writes;
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    ValuePtr Find(const Key& key) const {
+        const Shard& shard = ShardFor(key);
+        std::shared_lock<std::shared_mutex> lock = LockShared(shard);
+        auto it = shard.entries.find(key);
+        return it != shard.entries.end() ? it->second : nullptr;
+    }
+
+    // Calls function(const Key&, const ValuePtr&) for every entry, shard by shard, without
+    // holding any lock during the calls
+    template <typename Function>
+    void ForEach(Function&& function) const {
+        for (size_t i = 0; i < m_shardCount; ++i) {
+            Snapshot snapshot = GetSnapshot(m_shards[i]);
+            for (const Entry& entry : *snapshot) {
+                function(entry.first, entry.second);
+            }
+        }
+    }
+
+    // Removes every entry and returns them
+    std::vector<Entry> RemoveAll() {
+        std::vector<Entry> removed;
+        for (size_t i = 0; i < m_shardCount; ++i) {
+            Shard& shard = m_shards[i];
+            std::unique_lock<std::shared_mutex> lock = LockExclusive(shard);
+            for (auto& [key, value] : shard.entries) {
+                removed.emplace_back(key, std::move(value));
+            }
+            shard.writes += shard.entries.size();
+            m_size.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+            shard.entries.clear();
+            shard.snapshot.reset();
+        }
+        return removed;
+    }
+
+    size_t Size() const { return m_size.load(std::memory_order_relaxed); }
+    size_t GetShardCount() const { return m_shardCount; }
+
+    Stats GetStats() const {
+        Stats stats;
+        stats.size = Size();
+        for (size_t i = 0; i < m_shardCount; ++i) {
+            const Shard& shard = m_shards[i];
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                stats.writes += shard.writes;
+                stats.snapshotRebuilds += shard.snapshotRebuilds;
+            }
+            stats.contendedLocks += shard.contendedLocks.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    using Snapshot = std::shared_ptr<const std::vector<Entry>>;
+
+    // Each shard on its own cache lines so that threads working on different shards do not
+    // invalidate each other's lock and counters
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        Map entries;
+        mutable Snapshot snapshot;                          // Null after a write until ForEach rebuilds it
+        mutable uint64_t snapshotRebuilds = 0;              // Guarded by mutex
+        uint64_t writes = 0;                                // Guarded by mutex
+        mutable std::atomic<uint64_t> contendedLocks{0};
+    };
+
+    Shard& ShardFor(const Key& key) { return m_shards[m_hash(key) % m_shardCount]; }
+    const Shard& ShardFor(const Key& key) const { return m_shards[m_hash(key) % m_shardCount]; }
+
+    // Lock helpers that count the acquisitions that could not proceed at once
+    static std::unique_lock<std::shared_mutex> LockExclusive(const Shard& shard) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            shard.contendedLocks.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+        return lock;
+    }
+
+    static std::shared_lock<std::shared_mutex> LockShared(const Shard& shard) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            shard.contendedLocks.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+        return lock;
+    }
+
+    static Snapshot GetSnapshot(const Shard& shard) {
+        {
+            std::shared_lock<std::shared_mutex> lock = LockShared(shard);
+            if (shard.snapshot)
+                return shard.snapshot;
+        }
+
+        // First walk since a write: rebuild unless another reader got there first
+        std::unique_lock<std::shared_mutex> lock = LockExclusive(shard);
+        if (!shard.snapshot) {
+            auto entries = std::make_shared<std::vector<Entry>>(shard.entries.begin(), shard.entries.end());
+            shard.snapshot = std::move(entries);
+            ++shard.snapshotRebuilds;
+        }
+        return shard.snapshot;
+    }
+
+    Hash m_hash;
+    const size_t m_shardCount;
+    std::unique_ptr<Shard[]> m_shards;
+    std::atomic<size_t> m_size{0};
+};
+
+#endif // SHARDED_REGISTRY_H
@@ -0,0 +1,347 @@
+#ifndef SOCKET_OBSERVER_H
+#define SOCKET_OBSERVER_H
+
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "platform_factory.h"
+
+// One intercepted socket call, as seen by an observer. BeforeIo sees the call's arguments and
+// AfterIo also sees its result; for receives, `payload` is empty before the call and holds the
+// bytes received after it.
+struct SocketIoEvent {
+    enum class Operation { Connect, Accept, Send, Receive, SendTo, ReceiveFrom, Close };
+
+    Operation operation = Operation::Send;
+    std::span<const std::byte> payload{};                       // Single-buffer sends and receives
+    std::span<const std::span<const std::byte>> buffers{};      // SendVectored
+    std::span<const AddressKey> destinations{};                 // SendToMany
+    const NetworkAddress* peer = nullptr;                       // Connect, SendTo and ReceiveFrom peers
+    const AddressKey* peerKey = nullptr;                        // ... when given as a packed key
+    long long result = 0;               // Bytes, destinations reached, or 1/0 for Connect and Accept; -1 on error
+    std::chrono::nanoseconds duration{0};                       // Time spent in the wrapped call
+};
+
+// Observer policy with no-op hooks; derive and override the ones you need (tracing, metrics,
+// fault injection, capture). Hooks run on the calling thread, inside the socket call.
+//
+// Decorators also accept any other class with these two member functions. A concrete class
+// that is not derived from this one is called directly, so its hooks can be inlined away.
+class ISocketObserver {
+public:
+    virtual ~ISocketObserver() = default;
+
+    // Called before the wrapped call. Returning false skips the call: the socket returns
+    // event.result instead (a bool operation fails when it is 0 or less), and AfterIo still runs.
+    virtual bool BeforeIo(const ISocketBase& /*socket*/, SocketIoEvent& /*event*/) { return true; }
+    // Called after the wrapped call, or after a skipped one. errno is restored afterwards.
+    virtual void AfterIo(const ISocketBase& /*socket*/, const SocketIoEvent& /*event*/) {}
+};
+
+// Helper functions
+namespace SocketObserverDetail {
+    // Runs `call` between the observer's hooks and returns its result, or the observer's
+    template <typename Observer, typename Call>
+    long long Observe(Observer& observer, const ISocketBase& socket, SocketIoEvent& event, Call&& call) {
+        const auto start = std::chrono::steady_clock::now();
+        if (observer.BeforeIo(socket, event)) {
+            event.result = call();
+        }
+        event.duration = std::chrono::steady_clock::now() - start;
+
+        const int savedErrno = errno;
+        observer.AfterIo(socket, event);
+        errno = savedErrno;
+        return event.result;
+    }
+
+    inline std::span<const std::byte> Received(std::span<const std::byte> buffer, long long result) {
+        return result > 0 ? buffer.first(static_cast<size_t>(result)) : std::span<const std::byte>();
+    }
+}
+
+// Decorators that run an observer around the calls of the socket they own and forward
+// everything else unchanged. A socket that is not wrapped pays nothing. Wrapped sockets still
+// work with the platform's pollers (see ISocketBase::GetUnderlyingSocket) and socket options.
+
+template <typename Observer = ISocketObserver>
+class ObservedTcpSocket : public ITcpSocket {
+public:
+    ObservedTcpSocket(std::unique_ptr<ITcpSocket> socket, std::shared_ptr<Observer> observer)
+        : m_socket(std::move(socket)), m_observer(std::move(observer)) {}
+
+    ITcpSocket& GetWrapped() { return *m_socket; }
+
+    // Observed calls
+    bool Connect(const NetworkAddress& remoteAddress) override {
+        SocketIoEvent event{SocketIoEvent::Operation::Connect};
+        event.peer = &remoteAddress;
+        return Observe(event, [&] { return m_socket->Connect(remoteAddress) ? 1 : 0; }) > 0;
+    }
+    int Send(const std::vector<std::byte>& data) override {
+        return Send(std::span<const std::byte>(data));
+    }
+    int Send(std::span<const std::byte> data) override {
+        SocketIoEvent event{SocketIoEvent::Operation::Send};
+        event.payload = data;
+        return static_cast<int>(Observe(event, [&] { return m_socket->Send(data); }));
+    }
+    int SendVectored(std::span<const std::span<const std::byte>> buffers) override {
+        SocketIoEvent event{SocketIoEvent::Operation::Send};
+        event.buffers = buffers;
+        return static_cast<int>(Observe(event, [&] { return m_socket->SendVectored(buffers); }));
+    }
+    int Receive(std::vector<std::byte>& buffer) override {
+        SocketIoEvent event{SocketIoEvent::Operation::Receive};
+        return static_cast<int>(Observe(event, [&] {
+            long long result = m_socket->Receive(buffer);
+            event.payload = SocketObserverDetail::Received(buffer, result);
+            return result;
+        }));
+    }
+    int Receive(std::span<std::byte> buffer) override {
+        SocketIoEvent event{SocketIoEvent::Operation::Receive};
+        return static_cast<int>(Observe(event, [&] {
+            long long result = m_socket->Receive(buffer);
+            event.payload = SocketObserverDetail::Received(buffer, result);
+            return result;
+        }));
+    }
+    void Close() override {
+        SocketIoEvent event{SocketIoEvent::Operation::Close};
+        Observe(event, [&] { m_socket->Close(); return 0LL; });
+    }
+
+    // Forwarded calls
+    bool Bind(const NetworkAddress& localAddress) override { return m_socket->Bind(localAddress); }
+    NetworkAddress GetLocalAddress() const override { return m_socket->GetLocalAddress(); }
+    NetworkAddress GetRemoteAddress() const override { return m_socket->GetRemoteAddress(); }
+    bool IsValid() const override { return m_socket->IsValid(); }
+    bool WaitForDataWithTimeout(int timeoutMs) override { return m_socket->WaitForDataWithTimeout(timeoutMs); }
+    bool SetConnectTimeout(int timeoutMs) override { return m_socket->SetConnectTimeout(timeoutMs); }
+    bool Shutdown() override { return m_socket->Shutdown(); }
+    bool SetNoDelay(bool enable) override { return m_socket->SetNoDelay(enable); }
+    bool GetTcpInfo(TcpInfo& info) override { return m_socket->GetTcpInfo(info); }
+    bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) override {
+        return m_socket->SetSocketOption(level, optionName, optionValue, optionLen);
+    }
+    bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override {
+        return m_socket->GetSocketOption(level, optionName, optionValue, optionLen);
+    }
+    bool SetNonBlocking(bool enable) override { return m_socket->SetNonBlocking(enable); }
+    bool EnableStats(std::shared_ptr<SocketStats> stats) override { return m_socket->EnableStats(std::move(stats)); }
+    std::shared_ptr<SocketStats> GetStats() const override { return m_socket->GetStats(); }
+    const ISocketBase& GetUnderlyingSocket() const override { return m_socket->GetUnderlyingSocket(); }
+
+private:
+    template <typename Call>
+    long long Observe(SocketIoEvent& event, Call&& call) {
+        return SocketObserverDetail::Observe(*m_observer, *this, event, std::forward<Call>(call));
+    }
+
+    std::unique_ptr<ITcpSocket> m_socket;
+    std::shared_ptr<Observer> m_observer;
+};
+
+// Accepted connections are wrapped with the listener's observer
+template <typename Observer = ISocketObserver>
+class ObservedTcpListener : public ITcpListener {
+public:
+    ObservedTcpListener(std::unique_ptr<ITcpListener> listener, std::shared_ptr<Observer> observer)
+        : m_listener(std::move(listener)), m_observer(std::move(observer)) {}
+
+    ITcpListener& GetWrapped() { return *m_listener; }
+
+    // Observed calls
+    std::unique_ptr<IConnectionOrientedSocket> Accept() override {
+        std::unique_ptr<ITcpSocket> accepted;
+        SocketIoEvent event{SocketIoEvent::Operation::Accept};
+        SocketObserverDetail::Observe(*m_observer, *this, event, [&] {
+            accepted = m_listener->AcceptTcp();
+            return accepted ? 1LL : 0LL;
+        });
+        if (!accepted || event.result <= 0)
+            return nullptr;
+        return std::make_unique<ObservedTcpSocket<Observer>>(std::move(accepted), m_observer);
+    }
+    void Close() override {
+        SocketIoEvent event{SocketIoEvent::Operation::Close};
+        SocketObserverDetail::Observe(*m_observer, *this, event, [&] { m_listener->Close(); return 0LL; });
+    }
+
+    // Forwarded calls
+    bool Listen(int backlog) override { return m_listener->Listen(backlog); }
+    bool Bind(const NetworkAddress& localAddress) override { return m_listener->Bind(localAddress); }
+    NetworkAddress GetLocalAddress() const override { return m_listener->GetLocalAddress(); }
+    bool IsValid() const override { return m_listener->IsValid(); }
+    bool WaitForDataWithTimeout(int timeoutMs) override { return m_listener->WaitForDataWithTimeout(timeoutMs); }
+    bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) override {
+        return m_listener->SetSocketOption(level, optionName, optionValue, optionLen);
+    }
+    bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override {
+        return m_listener->GetSocketOption(level, optionName, optionValue, optionLen);
+    }
+    bool SetNonBlocking(bool enable) override { return m_listener->SetNonBlocking(enable); }
+    bool EnableStats(std::shared_ptr<SocketStats> stats) override { return m_listener->EnableStats(std::move(stats)); }
+    std::shared_ptr<SocketStats> GetStats() const override { return m_listener->GetStats(); }
+    bool SetStatsGroup(std::shared_ptr<SocketStatsGroup> group) override { return m_listener->SetStatsGroup(std::move(group)); }
+    const ISocketBase& GetUnderlyingSocket() const override { return m_listener->GetUnderlyingSocket(); }
+
+private:
+    std::unique_ptr<ITcpListener> m_listener;
+    std::shared_ptr<Observer> m_observer;
+};
+
+template <typename Observer = ISocketObserver>
+class ObservedUdpSocket : public IUdpSocket {
+public:
+    ObservedUdpSocket(std::unique_ptr<IUdpSocket> socket, std::shared_ptr<Observer> observer)
+        : m_socket(std::move(socket)), m_observer(std::move(observer)) {}
+
+    IUdpSocket& GetWrapped() { return *m_socket; }
+
+    // Observed calls
+    int SendTo(const std::vector<std::byte>& data, const NetworkAddress& remoteAddress) override {
+        return SendTo(std::span<const std::byte>(data), remoteAddress);
+    }
+    int SendTo(std::span<const std::byte> data, const NetworkAddress& remoteAddress) override {
+        SocketIoEvent event{SocketIoEvent::Operation::SendTo};
+        event.payload = data;
+        event.peer = &remoteAddress;
+        return static_cast<int>(Observe(event, [&] { return m_socket->SendTo(data, remoteAddress); }));
+    }
+    int SendTo(std::span<const std::byte> data, const AddressKey& remoteKey) override {
+        SocketIoEvent event{SocketIoEvent::Operation::SendTo};
+        event.payload = data;
+        event.peerKey = &remoteKey;
+        return static_cast<int>(Observe(event, [&] { return m_socket->SendTo(data, remoteKey); }));
+    }
+    int SendToAt(std::span<const std::byte> data, const AddressKey& remoteKey,
+                 std::chrono::steady_clock::time_point launchTime) override {
+        SocketIoEvent event{SocketIoEvent::Operation::SendTo};
+        event.payload = data;
+        event.peerKey = &remoteKey;
+        return static_cast<int>(Observe(event, [&] { return m_socket->SendToAt(data, remoteKey, launchTime); }));
+    }
+    // One event for the whole batch; results are filled only when the call is not skipped
+    size_t SendToMany(std::span<const std::byte> data, std::span<const AddressKey> destinations,
+                      std::span<int> results = {}) override {
+        SocketIoEvent event{SocketIoEvent::Operation::SendTo};
+        event.payload = data;
+        event.destinations = destinations;
+        long long delivered = Observe(event, [&] {
+            return static_cast<long long>(m_socket->SendToMany(data, destinations, results));
+        });
+        return delivered > 0 ? static_cast<size_t>(delivered) : 0;
+    }
+    int ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress& remoteAddress) override {
+        SocketIoEvent event{SocketIoEvent::Operation::ReceiveFrom};
+        return static_cast<int>(Observe(event, [&] {
+            long long result = m_socket->ReceiveFrom(buffer, remoteAddress);
+            event.payload = SocketObserverDetail::Received(buffer, result);
+            event.peer = &remoteAddress;
+            return result;
+        }));
+    }
+    int ReceiveFrom(std::span<std::byte> buffer, NetworkAddress& remoteAddress) override {
+        SocketIoEvent event{SocketIoEvent::Operation::ReceiveFrom};
+        return static_cast<int>(Observe(event, [&] {
+            long long result = m_socket->ReceiveFrom(buffer, remoteAddress);
+            event.payload = SocketObserverDetail::Received(buffer, result);
+            event.peer = &remoteAddress;
+            return result;
+        }));
+    }
+    int ReceiveFrom(std::span<std::byte> buffer, AddressKey& remoteKey) override {
+        SocketIoEvent event{SocketIoEvent::Operation::ReceiveFrom};
+        return static_cast<int>(Observe(event, [&] {
+            long long result = m_socket->ReceiveFrom(buffer, remoteKey);
+            event.payload = SocketObserverDetail::Received(buffer, result);
+            event.peerKey = &remoteKey;
+            return result;
+        }));
+    }
+    void Close() override {
+        SocketIoEvent event{SocketIoEvent::Operation::Close};
+        Observe(event, [&] { m_socket->Close(); return 0LL; });
+    }
+
+    // Forwarded calls
+    bool Bind(const NetworkAddress& localAddress) override { return m_socket->Bind(localAddress); }
+    NetworkAddress GetLocalAddress() const override { return m_socket->GetLocalAddress(); }
+    bool IsValid() const override { return m_socket->IsValid(); }
+    bool WaitForDataWithTimeout(int timeoutMs) override { return m_socket->WaitForDataWithTimeout(timeoutMs); }
+    bool SetBroadcast(bool enable) override { return m_socket->SetBroadcast(enable); }
+    bool JoinMulticastGroup(const NetworkAddress& groupAddress) override {
+        return m_socket->JoinMulticastGroup(groupAddress);
+    }
+    bool LeaveMulticastGroup(const NetworkAddress& groupAddress) override {
+        return m_socket->LeaveMulticastGroup(groupAddress);
+    }
+    bool JoinMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) override {
+        return m_socket->JoinMulticastGroup(groupAddress, interfaceAddress);
+    }
+    bool LeaveMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) override {
+        return m_socket->LeaveMulticastGroup(groupAddress, interfaceAddress);
+    }
+    bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) override {
+        return m_socket->SetSocketOption(level, optionName, optionValue, optionLen);
+    }
+    bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override {
+        return m_socket->GetSocketOption(level, optionName, optionValue, optionLen);
+    }
+    bool SetNonBlocking(bool enable) override { return m_socket->SetNonBlocking(enable); }
+    bool EnableStats(std::shared_ptr<SocketStats> stats) override { return m_socket->EnableStats(std::move(stats)); }
+    std::shared_ptr<SocketStats> GetStats() const override { return m_socket->GetStats(); }
+    const ISocketBase& GetUnderlyingSocket() const override { return m_socket->GetUnderlyingSocket(); }
+
+private:
+    template <typename Call>
+    long long Observe(SocketIoEvent& event, Call&& call) {
+        return SocketObserverDetail::Observe(*m_observer, *this, event, std::forward<Call>(call));
+    }
+
+    std::unique_ptr<IUdpSocket> m_socket;
+    std::shared_ptr<Observer> m_observer;
+};
+
+// Factory that wraps every socket and listener it creates from `factory` with one observer.
+// Code written against INetworkSocketFactory picks up tracing or fault injection by being handed
+// this factory instead; `factory` must outlive it.
+template <typename Observer = ISocketObserver>
+class ObservedSocketFactory : public INetworkSocketFactory {
+public:
+    ObservedSocketFactory(INetworkSocketFactory& factory, std::shared_ptr<Observer> observer)
+        : m_factory(factory), m_observer(std::move(observer)) {}
+
+    std::unique_ptr<ITcpSocket> CreateTcpSocket() override {
+        auto socket = m_factory.CreateTcpSocket();
+        if (!socket)
+            return nullptr;
+        return std::make_unique<ObservedTcpSocket<Observer>>(std::move(socket), m_observer);
+    }
+    std::unique_ptr<ITcpListener> CreateTcpListener() override {
+        auto listener = m_factory.CreateTcpListener();
+        if (!listener)
+            return nullptr;
+        return std::make_unique<ObservedTcpListener<Observer>>(std::move(listener), m_observer);
+    }
+    std::unique_ptr<IUdpSocket> CreateUdpSocket() override {
+        auto socket = m_factory.CreateUdpSocket();
+        if (!socket)
+            return nullptr;
+        return std::make_unique<ObservedUdpSocket<Observer>>(std::move(socket), m_observer);
+    }
+    std::unique_ptr<ISocketPoller> CreateSocketPoller() override { return m_factory.CreateSocketPoller(); }
+    bool SetStatsGroup(std::shared_ptr<SocketStatsGroup> group) override { return m_factory.SetStatsGroup(std::move(group)); }
+
+private:
+    INetworkSocketFactory& m_factory;
+    std::shared_ptr<Observer> m_observer;
+};
+
+#endif // SOCKET_OBSERVER_H
@@ -2,11 +2,42 @@
 #define SOCKET_OPTIONS_H
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 // Forward declaration of the base socket interface
 class ISocketBase;
 
+// Connection state the kernel keeps for a TCP socket (Linux TCP_INFO, macOS TCP_CONNECTION_INFO).
+// Fields the platform or kernel version does not report are left at zero. Segment counts are in
+// units of mss; rates are bytes per second.
+struct TcpInfo {
+    uint8_t state = 0;                                  // The platform's TCP state number
+    std::chrono::microseconds rtt{0};                   // Smoothed round-trip time
+    std::chrono::microseconds rttVariance{0};
+    std::chrono::microseconds minRtt{0};
+    std::chrono::microseconds retransmitTimeout{0};
+    uint32_t mss = 0;                                   // Sender's maximum segment size
+    uint32_t congestionWindow = 0;                      // Segments
+    uint32_t slowStartThreshold = 0;                    // Segments; very large until the first loss
+    uint32_t peerReceiveWindow = 0;                     // Bytes the peer advertised
+    uint32_t unackedSegments = 0;
+    uint32_t lostSegments = 0;
+    uint32_t retransmits = 0;                           // Segments retransmitted over the connection's life
+    uint64_t bytesInFlight = 0;                         // Sent and neither acked nor presumed lost
+    uint64_t notSentBytes = 0;                          // Queued in the send buffer, not yet sent
+    uint64_t bytesSent = 0;
+    uint64_t bytesRetransmitted = 0;
+    uint64_t bytesAcked = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t pacingRate = 0;
+    uint64_t deliveryRate = 0;                          // Most recent goodput sample
+    bool deliveryRateAppLimited = false;                // The sample was limited by the application, not the network
+    std::chrono::microseconds busyTime{0};              // Time spent with data outstanding
+    std::chrono::microseconds receiveWindowLimitedTime{0};  // ... of which the peer's window was the limit
+    std::chrono::microseconds sendBufferLimitedTime{0};     // ... of which our send buffer was the limit
+};
+
 namespace SocketOptions {
 
 // SOL_SOCKET level options
@@ -117,6 +148,25 @@ bool SetReceiveLowWatermark(ISocketBase* socket, int bytes);
  */
 bool SetSendLowWatermark(ISocketBase* socket, int bytes);
 
+// IPPROTO_IP level options
+// ------------------------
+
+/**
+ * Selects the interface outgoing multicast datagrams leave on
+ * @param socket The socket to set the option on
+ * @param interfaceAddress IPv4 address of the interface
+ * @return Whether the operation was successful
+ */
+bool SetMulticastInterface(ISocketBase* socket, const std::string& interfaceAddress);
+
+/**
+ * Sets how many router hops outgoing multicast datagrams may cross
+ * @param socket The socket to set the option on
+ * @param ttl Time to live; 1 keeps datagrams on the local network
+ * @return Whether the operation was successful
+ */
+bool SetMulticastTtl(ISocketBase* socket, int ttl);
+
 // Socket information retrieval functions
 // ------------------------------------
 
@@ -144,6 +194,15 @@ bool GetType(ISocketBase* socket, int& type);
  */
 bool GetAcceptConn(ISocketBase* socket, bool& isListening);
 
+/**
+ * Reads the kernel's view of a connected TCP socket: RTT, congestion window, losses and
+ * retransmits, bytes in flight, pacing and delivery rate, and what limited sending
+ * @param socket The TCP socket to get the information from
+ * @param info Output parameter to store the decoded information
+ * @return Whether the operation was successful (false for non-TCP sockets and on Windows)
+ */
+bool GetTcpInfo(ISocketBase* socket, TcpInfo& info);
+
 // Platform-specific options
 // ------------------------
 
@@ -163,6 +222,25 @@ bool BindToDevice(ISocketBase* socket, const std::string& interfaceName);
  */
 bool SetPriority(ISocketBase* socket, int priority);
 
+/**
+ * Caps the socket's transmit rate (Linux SO_MAX_PACING_RATE). TCP paces itself to the cap;
+ * for other sockets it takes effect where the fq qdisc is installed on the outgoing interface.
+ * Elsewhere use a TokenBucket.
+ * @param socket The socket to set the option on
+ * @param bytesPerSecond Maximum rate in bytes per second, or 0 to remove the cap
+ * @return Whether the operation was successful (false where the option does not exist)
+ */
+bool SetMaxPacingRate(ISocketBase* socket, uint64_t bytesPerSecond);
+
+/**
+ * Lets datagrams carry a launch time on the monotonic clock (Linux SO_TXTIME), which
+ * IConnectionlessSocket::SendToAt then attaches. The fq and etf qdiscs hold each datagram until
+ * its launch time; other qdiscs send at once. The kernel keeps the option for the socket's lifetime.
+ * @param socket The socket to set the option on
+ * @return Whether the operation was successful (false where the option does not exist)
+ */
+bool EnableTxTime(ISocketBase* socket);
+
 // Raw buffer operations (using the char* specializations)
 // -----------------------------------------------------
 
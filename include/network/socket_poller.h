@@ -0,0 +1,50 @@
+#ifndef SOCKET_POLLER_H
+#define SOCKET_POLLER_H
+
+#include <cstdint>
+#include <span>
+
+#include "network.h"
+
+// Readiness notification for many sockets from one thread: epoll on Linux, poll on other
+// Unix platforms and WSAPoll on Windows. Sockets are registered with the events of interest
+// and a caller-chosen token, which Wait hands back for every socket that became ready.
+// Notification is level-triggered. The poller does not own the sockets; remove a socket
+// before closing it. Add/Modify/Remove/Wait are meant to be called from the thread that
+// runs the loop; Wakeup may be called from any thread.
+class ISocketPoller {
+public:
+    // Event bits for Add/Modify and for Ready::events
+    enum Event : uint32_t {
+        Readable = 1u << 0,     // Data (or a pending connection) can be read
+        Writable = 1u << 1,     // Send buffer space is available
+        Closed = 1u << 2        // Hang-up or error; always reported, need not be requested
+    };
+
+    // Reserved for the poller's own wakeup channel; not a valid socket token
+    static constexpr uint64_t WAKEUP_TOKEN = UINT64_MAX;
+
+    struct Ready {
+        uint64_t token;
+        uint32_t events;
+    };
+
+    virtual ~ISocketPoller() = default;
+
+    virtual bool Add(ISocketBase& socket, uint32_t events, uint64_t token) = 0;
+    virtual bool Modify(ISocketBase& socket, uint32_t events, uint64_t token) = 0;
+    virtual bool Remove(ISocketBase& socket) = 0;
+
+    // Waits up to timeoutMs (-1 waits indefinitely) and fills `ready` with the sockets that
+    // became ready. Returns the number of entries filled, 0 on timeout or Wakeup, -1 on error.
+    virtual int Wait(std::span<Ready> ready, int timeoutMs) = 0;
+
+    // Makes the current or next Wait return early
+    virtual void Wakeup() = 0;
+
+    // Whether the last failed socket call on this thread only failed because a non-blocking
+    // socket was not ready (EAGAIN/EWOULDBLOCK, WSAEWOULDBLOCK)
+    static bool LastCallWouldBlock();
+};
+
+#endif // SOCKET_POLLER_H
@@ -0,0 +1,114 @@
+#ifndef SOCKET_STATS_H
+#define SOCKET_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// I/O counters for one socket, attached with ISocketBase::EnableStats. Each send and receive
+// call records its bytes, whether it moved less than asked (a short read or write), would-block
+// and error results, and the call's duration and size in log2-bucketed histograms.
+//
+// Recording is a handful of relaxed atomic adds plus two clock reads per call, and the send
+// and receive sides sit on separate cache lines, so a reader thread and a writer thread on the
+// same socket do not contend. Sockets without stats skip all of it, clock reads included.
+// All methods are thread-safe; a snapshot taken during I/O may be mid-update across counters.
+class SocketStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Direction { Send, Receive };
+
+    // Bucket 0 counts zeros; bucket i counts values in [2^(i-1), 2^i). The last bucket also
+    // takes everything larger (above about 1 s or 1 GiB).
+    static constexpr size_t HISTOGRAM_BUCKETS = 32;
+
+    struct Histogram {
+        std::array<uint64_t, HISTOGRAM_BUCKETS> buckets{};
+
+        uint64_t GetCount() const;
+        // Upper bound of the bucket holding the given fraction (0..1) of the samples, or 0 if empty
+        uint64_t GetPercentile(double fraction) const;
+
+        static size_t BucketFor(uint64_t value);
+        // Largest value counted in the bucket
+        static uint64_t BucketUpperBound(size_t bucket);
+    };
+
+    struct Counters {
+        uint64_t calls = 0;
+        uint64_t bytes = 0;
+        uint64_t shortTransfers = 0;    // Succeeded with fewer bytes than asked for
+        uint64_t wouldBlock = 0;        // EAGAIN/EWOULDBLOCK on a non-blocking socket
+        uint64_t errors = 0;
+        Histogram durationNs;
+        Histogram bytesPerCall;         // Successful calls only
+
+        Counters& operator+=(const Counters& other);
+    };
+
+    struct Snapshot {
+        Counters send;
+        Counters receive;
+
+        Snapshot& operator+=(const Snapshot& other);
+    };
+
+    SocketStats() = default;
+    SocketStats(const SocketStats&) = delete;
+    SocketStats& operator=(const SocketStats&) = delete;
+
+    // One I/O call that asked to move `requested` bytes and returned `result` (negative on
+    // failure, with wouldBlock telling EAGAIN apart from real errors)
+    void Record(Direction direction, size_t requested, long long result, bool wouldBlock,
+                Clock::duration elapsed);
+
+    Snapshot GetSnapshot() const;
+
+private:
+    struct alignas(64) AtomicCounters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> shortTransfers{0};
+        std::atomic<uint64_t> wouldBlock{0};
+        std::atomic<uint64_t> errors{0};
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> durationNs{};
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> bytesPerCall{};
+
+        void Load(Counters& counters) const;
+    };
+
+    AtomicCounters m_send;
+    AtomicCounters m_receive;
+};
+
+// Aggregates the stats of many sockets, e.g. everything a factory creates or a listener
+// accepts. Sockets record only into their own SocketStats; the group sums them when asked, so
+// adding a socket to a group costs nothing per call. Totals of sockets that have since been
+// destroyed are folded in and kept. All methods are thread-safe.
+class SocketStatsGroup {
+public:
+    // New stats counted in this group, to pass to ISocketBase::EnableStats
+    std::shared_ptr<SocketStats> Create();
+
+    SocketStats::Snapshot GetSnapshot() const;
+
+    // Sockets whose stats are still in use
+    size_t GetSocketCount() const;
+
+private:
+    // Folds stats that only the group still holds into m_closed
+    void Prune() const;
+
+    mutable std::mutex m_mutex;
+    mutable std::vector<std::shared_ptr<SocketStats>> m_members;
+    mutable SocketStats::Snapshot m_closed;
+    size_t m_pruneAt = 64;
+};
+
+#endif // SOCKET_STATS_H
@@ -2,12 +2,55 @@
 #define TCP_SOCKET_H
 
 #include "network.h"
+#include "mirrored_ring_buffer.h"
+#include "socket_options.h"
 
 // TCP client socket interface
 class ITcpSocket : public IConnectionOrientedSocket {
 public:
     // Example of a TCP-specific option
     virtual bool SetNoDelay(bool enable) = 0;
+
+    // Kernel connection state: RTT, congestion window, retransmits, delivery rate and so on.
+    // Returns false where the platform does not expose it (see SocketOptions::GetTcpInfo).
+    virtual bool GetTcpInfo(TcpInfo& info) {
+        return SocketOptions::GetTcpInfo(this, info);
+    }
+
+    // Helper method to read stream data straight into the free space of a ring buffer.
+    // Returns the bytes read (also committed to the ring), 0 on orderly shutdown,
+    // or -1 on error or when the ring has no free space left.
+    virtual int ReceiveInto(MirroredRingBuffer& ring) {
+        std::span<std::byte> space = ring.WritableSpan();
+        if (space.empty())
+            return -1;
+
+        int bytesRead = Receive(space);
+        if (bytesRead > 0) {
+            ring.Commit(static_cast<size_t>(bytesRead));
+        }
+        return bytesRead;
+    }
+
+    // Gather-write: sends the buffers in order as one stream with a single call where the
+    // platform supports it (sendmsg/WSASend). Returns the total bytes sent, which may stop
+    // part-way through a buffer, or -1 on error.
+    virtual int SendVectored(std::span<const std::span<const std::byte>> buffers) {
+        int totalSent = 0;
+        for (std::span<const std::byte> buffer : buffers) {
+            if (buffer.empty())
+                continue;
+
+            int bytesSent = Send(buffer);
+            if (bytesSent <= 0)
+                return totalSent > 0 ? totalSent : bytesSent;
+
+            totalSent += bytesSent;
+            if (static_cast<size_t>(bytesSent) < buffer.size())
+                break;
+        }
+        return totalSent;
+    }
 };
 
 // TCP server socket interface
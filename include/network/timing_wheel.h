@@ -0,0 +1,91 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Hierarchical timing wheel for large numbers of coarse timers, such as per-connection idle
+// deadlines. Time advances in fixed ticks driven by a monotonic clock: the owner calls Advance
+// with the current time, typically once per tick from one thread. Schedule, Cancel and Rearm
+// are O(1). Timers live in intrusive lists on four wheel levels (256 one-tick slots, then
+// three levels of 64 slots), and a timer moves down a level only when its slot comes up.
+// Delays beyond the wheel's range (2^26 ticks) are parked on the top level and re-placed as it turns.
+// All methods are thread-safe. Callbacks run on the thread calling Advance without the wheel's
+// lock held, so they may schedule, cancel or re-arm timers themselves. A timer cancelled while
+// its callback is about to run may still fire once.
+class TimingWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+
+    // Never returned by Schedule
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    static constexpr std::chrono::milliseconds DEFAULT_TICK{100};
+
+    explicit TimingWheel(std::chrono::milliseconds tick = DEFAULT_TICK, Clock::time_point start = Clock::now());
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // Runs the callback once `delay` has passed, counted from the last Advance and rounded up to
+    // whole ticks (at least one)
+    TimerId Schedule(std::chrono::milliseconds delay, Callback callback);
+
+    // Returns false if the timer already fired or was cancelled
+    bool Cancel(TimerId id);
+
+    // Moves a pending timer's deadline to `delay` from the last Advance; false if it is no longer pending
+    bool Rearm(TimerId id, std::chrono::milliseconds delay);
+
+    // Advances the wheel to `now` and runs every callback that came due. Returns the number run.
+    size_t Advance(Clock::time_point now = Clock::now());
+
+    std::chrono::milliseconds GetTick() const { return m_tick; }
+    uint64_t GetCurrentTick() const;
+    size_t GetPendingCount() const;
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr unsigned LEVELS = 4;
+    static constexpr unsigned LEVEL0_BITS = 8;
+    static constexpr unsigned LEVEL_BITS = 6;
+    static constexpr size_t SLOT_COUNT = (1u << LEVEL0_BITS) + (LEVELS - 1) * (1u << LEVEL_BITS);
+    static constexpr uint64_t MAX_DELAY_TICKS = (uint64_t{1} << (LEVEL0_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+
+    struct Node {
+        uint64_t expiry = 0;        // Absolute tick at which the timer fires
+        Callback callback;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;        // Next free node while on the free list
+        uint32_t slot = NIL;        // Slot holding the node; NIL while free
+        uint32_t generation = 0;    // Bumped on release so stale ids are rejected
+    };
+
+    uint64_t TicksFor(std::chrono::milliseconds delay) const;
+    uint32_t NodeFor(TimerId id) const;
+    void Link(uint32_t index);
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    bool Cascade(unsigned level);
+    void CollectDue(std::vector<Callback>& due);
+
+    const std::chrono::milliseconds m_tick;
+    const Clock::time_point m_start;
+
+    mutable std::mutex m_mutex;
+    uint64_t m_currentTick = 0;
+    std::vector<Node> m_nodes;
+    uint32_t m_freeList = NIL;
+    size_t m_pending = 0;
+    size_t m_level0Count = 0;   // Pending timers on the one-tick level
+    std::array<uint32_t, SLOT_COUNT> m_slots;
+};
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,74 @@
+#ifndef TOKEN_BUCKET_H
+#define TOKEN_BUCKET_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Userspace transmit pacer that limits a sender to a rate in bytes per second, packets per
+// second, or both. Each limit is a token bucket holding up to its burst; a send takes its bytes
+// (and one packet) from the buckets and may leave once both can cover it. The buckets are kept
+// as theoretical arrival times (GCRA), so nothing needs to refill them on a timer.
+//
+// Reserve never refuses a send: it books it and returns when it may leave, so callers either
+// sleep until then (Wait) or hand the time to the kernel as a launch time (SendToAt on a socket
+// with SO_TXTIME enabled). This is the portable fallback for SocketOptions::SetMaxPacingRate,
+// which only paces where the kernel's fq qdisc (or TCP's own pacing) applies.
+// All methods are thread-safe.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // A zero rate leaves that dimension unlimited. A zero burst allows one packet of
+    // DEFAULT_BURST_BYTES, or one packet, at a time.
+    struct Rate {
+        uint64_t bytesPerSecond = 0;
+        uint64_t packetsPerSecond = 0;
+        size_t burstBytes = 0;
+        size_t burstPackets = 0;
+    };
+
+    static constexpr size_t DEFAULT_BURST_BYTES = 1500;
+
+    explicit TokenBucket(Rate rate, Clock::time_point now = Clock::now());
+
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+
+    // Books a send of `bytes` and returns the earliest time it may leave (`now` if at once)
+    Clock::time_point Reserve(size_t bytes, Clock::time_point now = Clock::now());
+
+    // Books the send only if it may leave at once
+    bool TryConsume(size_t bytes, Clock::time_point now = Clock::now());
+
+    // Books the send and sleeps until it may leave
+    void Wait(size_t bytes);
+
+    // Takes effect for the next send; what is already booked keeps its time
+    void SetRate(Rate rate);
+    Rate GetRate() const;
+
+private:
+    // One limit as a GCRA schedule: each unit takes `interval` of the theoretical arrival time, and
+    // sends may run ahead of it by up to `burst` units
+    struct Limit {
+        bool enabled = false;
+        double interval = 0;                // Nanoseconds per byte or per packet
+        double burst = 0;
+        Clock::time_point theoreticalArrival;
+    };
+
+    static void Configure(Limit& limit, uint64_t perSecond, size_t burst, size_t defaultBurst);
+    static Clock::time_point EarliestStart(const Limit& limit, double units, Clock::time_point now);
+    static void Book(Limit& limit, double units, Clock::time_point start);
+    Clock::time_point EarliestStart(size_t bytes, Clock::time_point now) const;
+    void Book(size_t bytes, Clock::time_point start);
+
+    mutable std::mutex m_mutex;
+    Rate m_rate;
+    Limit m_bytes;
+    Limit m_packets;
+};
+
+#endif // TOKEN_BUCKET_H
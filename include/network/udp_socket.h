@@ -11,6 +11,16 @@ public:
     virtual bool SetBroadcast(bool enable) = 0;
     virtual bool JoinMulticastGroup(const NetworkAddress& groupAddress) = 0;
     virtual bool LeaveMulticastGroup(const NetworkAddress& groupAddress) = 0;
+
+    // Membership on one interface, named by its IPv4 address, instead of the one the routing
+    // table picks; an empty interfaceAddress behaves like the overloads above. Feeds published
+    // redundantly on two networks join each group on its own interface.
+    virtual bool JoinMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) {
+        return interfaceAddress.empty() && JoinMulticastGroup(groupAddress);
+    }
+    virtual bool LeaveMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) {
+        return interfaceAddress.empty() && LeaveMulticastGroup(groupAddress);
+    }
 };
 
 // Factory for creating UDP sockets
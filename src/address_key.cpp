@@ -0,0 +1,36 @@
+#include "network/network.h"
+
+#include <charconv>
+
+bool AddressKey::FromNetworkAddress(const NetworkAddress& address, AddressKey& key) {
+    const char* position = address.ipAddress.data();
+    const char* end = position + address.ipAddress.size();
+
+    uint32_t ipv4 = 0;
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet > 0) {
+            if (position == end || *position != '.')
+                return false;
+            ++position;
+        }
+
+        unsigned value = 0;
+        auto [next, error] = std::from_chars(position, end, value);
+        if (error != std::errc() || next == position || next - position > 3 || value > 255)
+            return false;
+        ipv4 = (ipv4 << 8) | value;
+        position = next;
+    }
+    if (position != end)
+        return false;
+
+    key = AddressKey(ipv4, address.port);
+    return true;
+}
+
+NetworkAddress AddressKey::ToNetworkAddress() const {
+    const uint32_t ipv4 = GetIPv4();
+    std::string text = std::to_string(ipv4 >> 24) + "." + std::to_string((ipv4 >> 16) & 0xFF) + "." +
+                       std::to_string((ipv4 >> 8) & 0xFF) + "." + std::to_string(ipv4 & 0xFF);
+    return NetworkAddress(text, GetPort());
+}
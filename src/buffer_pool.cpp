@@ -0,0 +1,335 @@
+#include "network/buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace BufferPoolDetail {
+
+    // Shared state of a pool. Thread caches hold it weakly so blocks cached by a thread
+    // can still be handed back (or freed) after the owning BufferPool is gone.
+    struct PoolCore : std::enable_shared_from_this<PoolCore> {
+        uint64_t id;
+        size_t blockSize;
+        size_t threadCacheBlocks;
+
+        std::mutex mutex;
+        std::vector<BlockHeader*> freeList;
+
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> inUse{0};
+        std::atomic<uint64_t> highWater{0};
+        std::atomic<uint64_t> allocated{0};
+
+        PoolCore(uint64_t poolId, size_t size, size_t cacheBlocks)
+            : id(poolId), blockSize(size), threadCacheBlocks(cacheBlocks) {}
+
+        ~PoolCore();
+    };
+
+} // namespace BufferPoolDetail
+
+using BufferPoolDetail::BlockHeader;
+using BufferPoolDetail::PoolCore;
+
+// Helper functions
+namespace {
+    std::atomic<uint64_t> nextPoolId{1};
+
+    BlockHeader* AllocateBlock(PoolCore* core, size_t capacity) {
+        void* memory = ::operator new(sizeof(BlockHeader) + capacity);
+        BlockHeader* block = new (memory) BlockHeader;
+        block->refCount.store(0, std::memory_order_relaxed);
+        block->core = core;
+        block->capacity = capacity;
+        return block;
+    }
+
+    BlockHeader* AllocateBlock(PoolCore* core) {
+        return AllocateBlock(core, core->blockSize);
+    }
+
+    void FreeBlock(BlockHeader* block) {
+        block->~BlockHeader();
+        ::operator delete(static_cast<void*>(block));
+    }
+
+    // Blocks cached by one thread for one pool
+    struct ThreadCacheEntry {
+        uint64_t poolId;
+        std::weak_ptr<PoolCore> core;
+        std::vector<BlockHeader*> blocks;
+    };
+
+    // Per-thread slab cache. On thread exit cached blocks go back to their pool's shared list,
+    // or are freed if the pool no longer exists.
+    class ThreadCache {
+    public:
+        ~ThreadCache() {
+            for (auto& entry : m_entries) {
+                ReturnToPool(entry);
+            }
+        }
+
+        std::vector<BlockHeader*>& Blocks(PoolCore* core) {
+            if (m_last < m_entries.size() && m_entries[m_last].poolId == core->id) {
+                return m_entries[m_last].blocks;
+            }
+            for (size_t i = 0; i < m_entries.size(); ++i) {
+                if (m_entries[i].poolId == core->id) {
+                    m_last = i;
+                    return m_entries[i].blocks;
+                }
+            }
+
+            // First use of this pool on this thread: drop entries of pools that were destroyed
+            for (size_t i = 0; i < m_entries.size();) {
+                if (m_entries[i].core.expired()) {
+                    ReturnToPool(m_entries[i]);
+                    if (i + 1 != m_entries.size()) {
+                        m_entries[i] = std::move(m_entries.back());
+                    }
+                    m_entries.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+
+            m_entries.push_back(ThreadCacheEntry{core->id, core->weak_from_this(), {}});
+            m_entries.back().blocks.reserve(core->threadCacheBlocks);
+            m_last = m_entries.size() - 1;
+            return m_entries.back().blocks;
+        }
+
+    private:
+        static void ReturnToPool(ThreadCacheEntry& entry) {
+            if (auto core = entry.core.lock()) {
+                std::lock_guard<std::mutex> lock(core->mutex);
+                core->freeList.insert(core->freeList.end(), entry.blocks.begin(), entry.blocks.end());
+            } else {
+                for (BlockHeader* block : entry.blocks) {
+                    FreeBlock(block);
+                }
+            }
+            entry.blocks.clear();
+        }
+
+        std::vector<ThreadCacheEntry> m_entries;
+        size_t m_last = 0;
+    };
+
+    thread_local ThreadCache threadCache;
+
+    // Moves up to half a thread cache worth of blocks from the shared list into the local cache
+    void RefillFromShared(PoolCore* core, std::vector<BlockHeader*>& cached) {
+        std::lock_guard<std::mutex> lock(core->mutex);
+        size_t count = std::min(core->freeList.size(), std::max<size_t>(1, core->threadCacheBlocks / 2));
+        cached.insert(cached.end(), core->freeList.end() - count, core->freeList.end());
+        core->freeList.resize(core->freeList.size() - count);
+    }
+
+    // Moves the older half of a full local cache to the shared list
+    void SpillToShared(PoolCore* core, std::vector<BlockHeader*>& cached) {
+        size_t count = cached.size() / 2;
+        std::lock_guard<std::mutex> lock(core->mutex);
+        core->freeList.insert(core->freeList.end(), cached.begin(), cached.begin() + count);
+        cached.erase(cached.begin(), cached.begin() + count);
+    }
+
+    void ReleaseBlock(BlockHeader* block) {
+        PoolCore* core = block->core;
+        core->inUse.fetch_sub(1, std::memory_order_relaxed);
+
+        // Oversized blocks are one-offs and never enter the caches
+        if (block->capacity != core->blockSize) {
+            core->allocated.fetch_sub(1, std::memory_order_relaxed);
+            FreeBlock(block);
+            return;
+        }
+
+        auto& cached = threadCache.Blocks(core);
+        if (cached.size() >= core->threadCacheBlocks) {
+            if (core->threadCacheBlocks == 0) {
+                std::lock_guard<std::mutex> lock(core->mutex);
+                core->freeList.push_back(block);
+                return;
+            }
+            SpillToShared(core, cached);
+        }
+        cached.push_back(block);
+    }
+}
+
+BufferPoolDetail::PoolCore::~PoolCore() {
+    for (BlockHeader* block : freeList) {
+        FreeBlock(block);
+    }
+}
+
+// PooledBuffer Implementation
+PooledBuffer::PooledBuffer(const PooledBuffer& other) noexcept
+    : m_block(other.m_block), m_offset(other.m_offset), m_size(other.m_size), m_capacity(other.m_capacity) {
+    if (m_block) {
+        m_block->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+    : m_block(other.m_block), m_offset(other.m_offset), m_size(other.m_size), m_capacity(other.m_capacity) {
+    other.m_block = nullptr;
+    other.m_offset = 0;
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+PooledBuffer& PooledBuffer::operator=(const PooledBuffer& other) noexcept {
+    if (this != &other) {
+        PooledBuffer copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        m_block = other.m_block;
+        m_offset = other.m_offset;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_block = nullptr;
+        other.m_offset = 0;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+    return *this;
+}
+
+PooledBuffer::~PooledBuffer() {
+    Reset();
+}
+
+void PooledBuffer::Resize(size_t size) noexcept {
+    m_size = std::min(size, Capacity());
+}
+
+PooledBuffer PooledBuffer::Slice(size_t offset, size_t length) const noexcept {
+    PooledBuffer slice(*this);
+    offset = std::min(offset, m_size);
+    slice.m_offset = m_offset + offset;
+    slice.m_size = std::min(length, m_size - offset);
+    // The slice may rewrite its own bytes but not grow into its siblings' or the parent's
+    slice.m_capacity = slice.m_size;
+    return slice;
+}
+
+void PooledBuffer::Reset() noexcept {
+    if (m_block) {
+        if (m_block->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ReleaseBlock(m_block);
+        }
+        m_block = nullptr;
+    }
+    m_offset = 0;
+    m_size = 0;
+    m_capacity = 0;
+}
+
+// BufferPool Implementation
+BufferPool::BufferPool(size_t blockSize, size_t threadCacheBlocks)
+    : m_core(std::make_shared<PoolCore>(nextPoolId.fetch_add(1, std::memory_order_relaxed),
+                                        std::max<size_t>(blockSize, 1), threadCacheBlocks)) {
+}
+
+BufferPool::~BufferPool() = default;
+
+PooledBuffer BufferPool::Acquire() {
+    PoolCore* core = m_core.get();
+    auto& cached = threadCache.Blocks(core);
+    if (cached.empty()) {
+        RefillFromShared(core, cached);
+    }
+
+    BlockHeader* block;
+    if (!cached.empty()) {
+        block = cached.back();
+        cached.pop_back();
+        core->hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        block = AllocateBlock(core);
+        core->misses.fetch_add(1, std::memory_order_relaxed);
+        core->allocated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return Track(block);
+}
+
+PooledBuffer BufferPool::Acquire(size_t minCapacity) {
+    if (minCapacity <= m_core->blockSize)
+        return Acquire();
+
+    PoolCore* core = m_core.get();
+    core->misses.fetch_add(1, std::memory_order_relaxed);
+    core->allocated.fetch_add(1, std::memory_order_relaxed);
+    return Track(AllocateBlock(core, minCapacity));
+}
+
+PooledBuffer BufferPool::AcquireCopy(std::initializer_list<std::span<const std::byte>> parts) {
+    size_t total = 0;
+    for (std::span<const std::byte> part : parts) {
+        total += part.size();
+    }
+
+    PooledBuffer buffer = Acquire(total);
+    std::byte* out = buffer.Data();
+    for (std::span<const std::byte> part : parts) {
+        if (!part.empty()) {
+            std::memcpy(out, part.data(), part.size());
+            out += part.size();
+        }
+    }
+    buffer.Resize(total);
+    return buffer;
+}
+
+PooledBuffer BufferPool::Track(BlockHeader* block) {
+    PoolCore* core = m_core.get();
+    block->refCount.store(1, std::memory_order_relaxed);
+
+    uint64_t inUse = core->inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint64_t highWater = core->highWater.load(std::memory_order_relaxed);
+    while (inUse > highWater &&
+           !core->highWater.compare_exchange_weak(highWater, inUse, std::memory_order_relaxed)) {
+    }
+
+    return PooledBuffer(block);
+}
+
+void BufferPool::Reserve(size_t blockCount) {
+    std::vector<BlockHeader*> blocks;
+    blocks.reserve(blockCount);
+    for (size_t i = 0; i < blockCount; ++i) {
+        blocks.push_back(AllocateBlock(m_core.get()));
+    }
+    m_core->allocated.fetch_add(blockCount, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_core->mutex);
+    m_core->freeList.insert(m_core->freeList.end(), blocks.begin(), blocks.end());
+}
+
+size_t BufferPool::GetBlockSize() const {
+    return m_core->blockSize;
+}
+
+BufferPool::Stats BufferPool::GetStats() const {
+    Stats stats;
+    stats.hits = m_core->hits.load(std::memory_order_relaxed);
+    stats.misses = m_core->misses.load(std::memory_order_relaxed);
+    stats.inUse = m_core->inUse.load(std::memory_order_relaxed);
+    stats.highWater = m_core->highWater.load(std::memory_order_relaxed);
+    stats.allocated = m_core->allocated.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,162 @@
+#include "network/buffered_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+// Helper functions
+namespace {
+    // Segments handed to one SendVectored call
+    constexpr size_t MAX_BATCH_SEGMENTS = 64;
+}
+
+BufferedWriter::BufferedWriter(ITcpSocket& socket, BufferPool& pool, size_t flushThreshold,
+                               std::chrono::microseconds maxDelay)
+    : m_socket(socket),
+      m_pool(pool),
+      m_flushThreshold(std::max<size_t>(flushThreshold, 1)),
+      m_maxDelay(maxDelay) {
+}
+
+bool BufferedWriter::Write(std::span<const std::byte> data) {
+    if (data.empty())
+        return true;
+
+    NotePending(data.size());
+
+    while (!data.empty()) {
+        if (!m_tailAppendable || m_segments.back().Size() == m_segments.back().Capacity()) {
+            m_segments.push_back(m_pool.Acquire());
+            m_tailAppendable = true;
+        }
+
+        PooledBuffer& tail = m_segments.back();
+        size_t chunk = std::min(data.size(), tail.Capacity() - tail.Size());
+        std::memcpy(tail.Data() + tail.Size(), data.data(), chunk);
+        tail.Resize(tail.Size() + chunk);
+        data = data.subspan(chunk);
+    }
+
+    return FlushIfOverThreshold();
+}
+
+bool BufferedWriter::Write(const PooledBuffer& buffer) {
+    if (buffer.Empty())
+        return true;
+
+    NotePending(buffer.Size());
+    m_segments.push_back(buffer);
+    // The block is shared with other writers, so later copies must not go into it
+    m_tailAppendable = false;
+
+    return FlushIfOverThreshold();
+}
+
+int BufferedWriter::Flush() {
+    if (m_pendingBytes == 0)
+        return 0;
+
+    ++m_stats.flushes;
+    int totalSent = 0;
+    while (!m_segments.empty()) {
+        std::span<const std::byte> batch[MAX_BATCH_SEGMENTS];
+        size_t count = std::min(m_segments.size(), MAX_BATCH_SEGMENTS);
+        for (size_t i = 0; i < count; ++i) {
+            batch[i] = m_segments[i].Span();
+        }
+        batch[0] = batch[0].subspan(m_headOffset);
+
+        int bytesSent = m_socket.SendVectored(std::span<const std::span<const std::byte>>(batch, count));
+        ++m_stats.sendCalls;
+        if (bytesSent <= 0) {
+            m_stalled = true;
+            return totalSent > 0 ? totalSent : -1;     // Progress so far counts; the caller retries later
+        }
+
+        // Drop fully sent segments and remember how far into the next one we got
+        size_t remaining = static_cast<size_t>(bytesSent);
+        while (remaining > 0) {
+            size_t headSize = m_segments.front().Size() - m_headOffset;
+            if (remaining < headSize) {
+                m_headOffset += remaining;
+                break;
+            }
+            remaining -= headSize;
+            m_segments.pop_front();
+            m_headOffset = 0;
+        }
+
+        m_pendingBytes -= static_cast<size_t>(bytesSent);
+        m_stats.bytesSent += static_cast<uint64_t>(bytesSent);
+        totalSent += bytesSent;
+    }
+
+    m_tailAppendable = false;
+    m_stalled = false;
+    return totalSent;
+}
+
+int BufferedWriter::FlushIfDue(Clock::time_point now) {
+    if (now < GetFlushDeadline())
+        return 0;
+    return Flush();
+}
+
+BufferedWriter::Clock::time_point BufferedWriter::GetFlushDeadline() const {
+    if (m_pendingBytes == 0 || m_stalled || m_maxDelay <= std::chrono::microseconds::zero())
+        return Clock::time_point::max();
+    return m_oldestPending + m_maxDelay;
+}
+
+int BufferedWriter::DrainFrom(OutboundQueue& queue, std::chrono::milliseconds timeout) {
+    const uint64_t sentBefore = m_stats.bytesSent;
+    // The last failed flush and its errno, including threshold flushes inside Write, so a hard
+    // error is still reported after a later FlushIfDue has nothing to do
+    int failure = 0;
+    int failureErrno = 0;
+    auto noteResult = [&](int result) {
+        if (result < 0) {
+            failure = result;
+            failureErrno = errno;
+        }
+    };
+
+    if (m_stalled) {
+        noteResult(Flush());
+        timeout = std::chrono::milliseconds(0);
+    }
+
+    if (!m_stalled) {
+        queue.PopAll(m_drained, timeout);
+        for (const PooledBuffer& message : m_drained) {
+            if (!Write(message)) {
+                noteResult(-1);
+            }
+        }
+        m_drained.clear();
+        noteResult(m_maxDelay > std::chrono::microseconds::zero() ? FlushIfDue() : Flush());
+    }
+
+    // Threshold flushes inside Write count too
+    int totalSent = static_cast<int>(m_stats.bytesSent - sentBefore);
+    if (totalSent > 0)
+        return totalSent;
+    if (failure < 0) {
+        errno = failureErrno;
+    }
+    return failure;
+}
+
+bool BufferedWriter::FlushIfOverThreshold() {
+    if (m_pendingBytes < m_flushThreshold)
+        return true;
+    return Flush() >= 0;
+}
+
+void BufferedWriter::NotePending(size_t bytes) {
+    if (m_pendingBytes == 0) {
+        m_oldestPending = Clock::now();
+    }
+    m_pendingBytes += bytes;
+    m_stats.bytesQueued += bytes;
+}
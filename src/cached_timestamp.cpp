@@ -0,0 +1,27 @@
+#include "network/cached_timestamp.h"
+
+#include <utility>
+
+CachedTimestamp::CachedTimestamp(std::string format)
+    : m_format(std::move(format)) {
+}
+
+CachedTimestamp::Text CachedTimestamp::Now() {
+    return At(std::time(nullptr));
+}
+
+CachedTimestamp::Text CachedTimestamp::At(std::time_t second) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (second != m_cachedSecond) {
+        std::tm local = {};
+#ifdef _WIN32
+        localtime_s(&local, &second);
+#else
+        localtime_r(&second, &local);
+#endif
+        m_cached.size = std::strftime(m_cached.data, MAX_LENGTH, m_format.c_str(), &local);
+        m_cachedSecond = second;
+        m_formatCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return m_cached;
+}
@@ -0,0 +1,265 @@
+#include "network/connection_pool.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "network/socket_options.h"
+
+// ConnectionPool::Lease
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : m_pool(other.m_pool),
+      m_endpoint(other.m_endpoint),
+      m_socket(std::move(other.m_socket)) {
+    other.m_pool = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_pool = other.m_pool;
+        m_endpoint = other.m_endpoint;
+        m_socket = std::move(other.m_socket);
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    Release();
+}
+
+void ConnectionPool::Lease::Discard() {
+    if (m_pool && m_socket) {
+        m_pool->m_discarded.fetch_add(1, std::memory_order_relaxed);
+        m_pool->Return(m_endpoint, std::move(m_socket), false);
+    }
+    m_pool = nullptr;
+}
+
+void ConnectionPool::Lease::Release() {
+    if (m_pool && m_socket) {
+        m_pool->Return(m_endpoint, std::move(m_socket), true);
+    }
+    m_pool = nullptr;
+}
+
+// ConnectionPool
+
+ConnectionPool::ConnectionPool(INetworkSocketFactory& factory)
+    : ConnectionPool(factory, Config()) {}
+
+ConnectionPool::ConnectionPool(INetworkSocketFactory& factory, Config config)
+    : m_factory(factory),
+      m_config(config),
+      m_shardCount(std::max<size_t>(config.shardCount, 1)),
+      m_shards(std::make_unique<Shard[]>(m_shardCount)) {}
+
+ConnectionPool::~ConnectionPool() {
+    Clear();
+}
+
+ConnectionPool::Lease ConnectionPool::Checkout(const NetworkAddress& endpoint) {
+    AddressKey key;
+    if (!AddressKey::FromNetworkAddress(endpoint, key)) {
+        m_connectFailures.fetch_add(1, std::memory_order_relaxed);
+        return Lease();
+    }
+    Shard& shard = ShardFor(key);
+
+    while (true) {
+        Idle idle;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Host& host = shard.hosts[key];
+            if (host.idle.empty()) {
+                if (host.open >= m_config.maxPerHost) {
+                    m_limitReached.fetch_add(1, std::memory_order_relaxed);
+                    // Don't leave an empty entry behind for a refused host
+                    if (host.open == 0) {
+                        shard.hosts.erase(key);
+                    }
+                    return Lease();
+                }
+                // Reserve the slot before connecting so concurrent checkouts respect the limit
+                ++host.open;
+                m_open.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                idle = std::move(host.idle.back());
+                host.idle.pop_back();
+                m_idle.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (!idle.socket) {
+            std::unique_ptr<ITcpSocket> socket = Connect(key);
+            if (!socket) {
+                Forget(key);
+                return Lease();
+            }
+            return Lease(this, key, std::move(socket));
+        }
+
+        if (Clock::now() - idle.since < m_config.idleTimeout && IsUsable(*idle.socket)) {
+            m_reused.fetch_add(1, std::memory_order_relaxed);
+            return Lease(this, key, std::move(idle.socket));
+        }
+
+        // Dead or expired: drop it and try the next one
+        m_staleClosed.fetch_add(1, std::memory_order_relaxed);
+        idle.socket->Close();
+        Forget(key);
+    }
+}
+
+size_t ConnectionPool::WarmUp(const NetworkAddress& endpoint, size_t count) {
+    AddressKey key;
+    if (!AddressKey::FromNetworkAddress(endpoint, key))
+        return 0;
+    Shard& shard = ShardFor(key);
+    count = std::min(count, m_config.maxIdlePerHost);
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Host& host = shard.hosts[key];
+            if (host.idle.size() >= count || host.open >= m_config.maxPerHost) {
+                const size_t idle = host.idle.size();
+                if (host.open == 0) {
+                    shard.hosts.erase(key);
+                }
+                return idle;
+            }
+            ++host.open;
+            m_open.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<ITcpSocket> socket = Connect(key);
+        if (!socket) {
+            Forget(key);
+            return GetIdleCount(endpoint);
+        }
+        Return(key, std::move(socket), true);
+    }
+}
+
+size_t ConnectionPool::EvictIdle(Clock::time_point now) {
+    size_t closed = CloseIdle(now - m_config.idleTimeout);
+    m_evicted.fetch_add(closed, std::memory_order_relaxed);
+    return closed;
+}
+
+void ConnectionPool::Clear() {
+    CloseIdle(Clock::time_point::max());
+}
+
+size_t ConnectionPool::GetIdleCount(const NetworkAddress& endpoint) const {
+    AddressKey key;
+    if (!AddressKey::FromNetworkAddress(endpoint, key))
+        return 0;
+    const Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.hosts.find(key);
+    return it != shard.hosts.end() ? it->second.idle.size() : 0;
+}
+
+ConnectionPool::Stats ConnectionPool::GetStats() const {
+    Stats stats;
+    stats.reused = m_reused.load(std::memory_order_relaxed);
+    stats.connected = m_connected.load(std::memory_order_relaxed);
+    stats.connectFailures = m_connectFailures.load(std::memory_order_relaxed);
+    stats.limitReached = m_limitReached.load(std::memory_order_relaxed);
+    stats.staleClosed = m_staleClosed.load(std::memory_order_relaxed);
+    stats.evicted = m_evicted.load(std::memory_order_relaxed);
+    stats.discarded = m_discarded.load(std::memory_order_relaxed);
+    stats.open = m_open.load(std::memory_order_relaxed);
+    stats.idle = m_idle.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::unique_ptr<ITcpSocket> ConnectionPool::Connect(const AddressKey& endpoint) {
+    std::unique_ptr<ITcpSocket> socket = m_factory.CreateTcpSocket();
+    if (!socket || !socket->IsValid() ||
+        !socket->SetConnectTimeout(m_config.connectTimeoutMs) ||
+        !socket->Connect(endpoint.ToNetworkAddress())) {
+        m_connectFailures.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    if (m_config.noDelay) {
+        socket->SetNoDelay(true);
+    }
+    m_connected.fetch_add(1, std::memory_order_relaxed);
+    return socket;
+}
+
+void ConnectionPool::Return(const AddressKey& endpoint, std::unique_ptr<ITcpSocket> socket, bool reusable) {
+    if (reusable && socket->IsValid()) {
+        Shard& shard = ShardFor(endpoint);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Host& host = shard.hosts[endpoint];
+        if (host.idle.size() < m_config.maxIdlePerHost) {
+            host.idle.push_back(Idle{std::move(socket), Clock::now()});
+            m_idle.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    socket->Close();
+    Forget(endpoint);
+}
+
+// One of the endpoint's connections was closed
+void ConnectionPool::Forget(const AddressKey& endpoint) {
+    Shard& shard = ShardFor(endpoint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.hosts.find(endpoint);
+    if (it == shard.hosts.end())
+        return;
+
+    Host& host = it->second;
+    --host.open;
+    m_open.fetch_sub(1, std::memory_order_relaxed);
+    if (host.open == 0) {
+        shard.hosts.erase(it);
+    }
+}
+
+// Closes idle connections returned at or before `olderThan`. The sockets are closed after each
+// shard's lock is released.
+size_t ConnectionPool::CloseIdle(Clock::time_point olderThan) {
+    size_t closed = 0;
+    for (size_t i = 0; i < m_shardCount; ++i) {
+        Shard& shard = m_shards[i];
+        std::vector<Idle> expired;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.hosts.begin(); it != shard.hosts.end();) {
+                Host& host = it->second;
+                // Idle lists are ordered by return time, oldest first
+                auto end = std::find_if(host.idle.begin(), host.idle.end(),
+                                        [olderThan](const Idle& idle) { return idle.since > olderThan; });
+                const size_t count = static_cast<size_t>(end - host.idle.begin());
+                std::move(host.idle.begin(), end, std::back_inserter(expired));
+                host.idle.erase(host.idle.begin(), end);
+                host.open -= count;
+                m_open.fetch_sub(count, std::memory_order_relaxed);
+                m_idle.fetch_sub(count, std::memory_order_relaxed);
+                it = host.open == 0 ? shard.hosts.erase(it) : std::next(it);
+            }
+        }
+        for (Idle& idle : expired) {
+            idle.socket->Close();
+        }
+        closed += expired.size();
+    }
+    return closed;
+}
+
+// An idle connection should have nothing to read: readiness means the peer closed it (or reset
+// it) or sent something nobody asked for. Either way it cannot carry a new request.
+bool ConnectionPool::IsUsable(ITcpSocket& socket) {
+    int error = 0;
+    return socket.IsValid() &&
+           SocketOptions::GetError(&socket, error) && error == 0 &&
+           !socket.WaitForDataWithTimeout(0);
+}
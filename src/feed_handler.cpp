@@ -0,0 +1,353 @@
+#include "network/feed_handler.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Helper functions
+namespace {
+    constexpr size_t SEQUENCE_OFFSET = 10;
+    constexpr size_t COUNT_OFFSET = 18;
+    constexpr size_t LENGTH_SIZE = 2;
+
+    // Datagrams processed per line before Poll looks at the other one again
+    constexpr size_t MAX_DRAIN_BATCH = 256;
+
+    void PutU16(std::vector<std::byte>& out, uint16_t value) {
+        out.push_back(std::byte(value >> 8));
+        out.push_back(std::byte(value));
+    }
+
+    void PutU64(std::vector<std::byte>& out, uint64_t value) {
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(std::byte(value >> shift));
+        }
+    }
+
+    uint16_t GetU16(const std::byte* data) {
+        return static_cast<uint16_t>((std::to_integer<uint16_t>(data[0]) << 8) | std::to_integer<uint16_t>(data[1]));
+    }
+
+    uint64_t GetU64(const std::byte* data) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value = (value << 8) | std::to_integer<uint64_t>(data[i]);
+        }
+        return value;
+    }
+
+    bool IsMulticast(const NetworkAddress& address) {
+        AddressKey key;
+        if (!AddressKey::FromNetworkAddress(address, key))
+            return false;
+        return (key.GetIPv4() >> 28) == 0xE;    // 224.0.0.0/4
+    }
+}
+
+// FeedArbiter
+
+FeedArbiter::FeedArbiter(MessageCallback onMessage, GapCallback onGap, Clock::duration gapTimeout)
+    : m_onMessage(std::move(onMessage)),
+      m_onGap(std::move(onGap)),
+      m_gapTimeout(gapTimeout) {}
+
+bool FeedArbiter::Process(std::span<const std::byte> packet, Line line, Clock::time_point now) {
+    if (packet.size() < HEADER_SIZE) {
+        ++m_stats.malformed;
+        return false;
+    }
+
+    const std::byte* data = packet.data();
+    const uint64_t first = GetU64(data + SEQUENCE_OFFSET);
+    uint16_t count = GetU16(data + COUNT_OFFSET);
+    if (count == END_OF_SESSION) {
+        count = 0;
+    }
+
+    if (!m_hasSession) {
+        std::memcpy(m_session, data, SESSION_SIZE);
+        m_hasSession = true;
+        m_expected = first;
+        m_horizon = first;
+    } else if (std::memcmp(m_session, data, SESSION_SIZE) != 0) {
+        ++m_stats.malformed;
+        return false;
+    }
+    ++m_stats.packets[static_cast<size_t>(line)];
+
+    // The slower line mostly repeats what the faster one delivered: skip it without parsing
+    if (first + count <= m_expected) {
+        m_stats.duplicates += count;
+        Update(now);
+        return true;
+    }
+
+    size_t offset = HEADER_SIZE;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (packet.size() - offset < LENGTH_SIZE) {
+            ++m_stats.malformed;
+            return false;
+        }
+        const size_t length = GetU16(data + offset);
+        offset += LENGTH_SIZE;
+        if (packet.size() - offset < length) {
+            ++m_stats.malformed;
+            return false;
+        }
+        OnMessage(first + i, packet.subspan(offset, length), line, now);
+        offset += length;
+    }
+
+    Announce(first + count, now);
+    Update(now);
+    return true;
+}
+
+void FeedArbiter::Update(Clock::time_point now) {
+    while (m_gapOpen && now - m_gapOpened >= m_gapTimeout) {
+        GiveUp(now);
+    }
+}
+
+void FeedArbiter::Reset() {
+    m_hasSession = false;
+    m_expected = 0;
+    m_horizon = 0;
+    m_held.clear();
+    m_gapOpen = false;
+}
+
+void FeedArbiter::EncodePacket(std::vector<std::byte>& out, std::string_view session, uint64_t firstSequence,
+                               std::span<const std::span<const std::byte>> messages) {
+    for (size_t i = 0; i < SESSION_SIZE; ++i) {
+        out.push_back(std::byte(i < session.size() ? session[i] : ' '));
+    }
+    PutU64(out, firstSequence);
+    PutU16(out, static_cast<uint16_t>(messages.size()));
+    for (std::span<const std::byte> message : messages) {
+        PutU16(out, static_cast<uint16_t>(message.size()));
+        out.insert(out.end(), message.begin(), message.end());
+    }
+}
+
+void FeedArbiter::OnMessage(uint64_t sequence, std::span<const std::byte> message, Line line, Clock::time_point now) {
+    if (sequence < m_expected) {
+        ++m_stats.duplicates;
+        return;
+    }
+
+    if (sequence == m_expected) {
+        ++m_stats.messagesWon[static_cast<size_t>(line)];
+        Deliver(sequence, message);
+        ++m_expected;
+        if (m_gapOpen) {
+            AfterAdvance(now);
+        }
+        return;
+    }
+
+    // Beyond a gap: hold a copy until the gap is filled or given up
+    if (m_held.count(sequence)) {
+        ++m_stats.duplicates;
+        return;
+    }
+    if (m_held.size() >= MAX_HELD_MESSAGES && m_gapOpen) {
+        GiveUp(now);
+        OnMessage(sequence, message, line, now);
+        return;
+    }
+    ++m_stats.messagesWon[static_cast<size_t>(line)];
+    m_held.emplace(sequence, Held{std::vector<std::byte>(message.begin(), message.end()), now});
+    if (!m_gapOpen) {
+        OpenGap(now);
+    }
+}
+
+void FeedArbiter::Deliver(uint64_t sequence, std::span<const std::byte> message) {
+    ++m_stats.messagesDelivered;
+    if (m_onMessage) {
+        m_onMessage(sequence, message);
+    }
+}
+
+// Sequence numbers below `next` were published, so any of them not yet seen are missing
+void FeedArbiter::Announce(uint64_t next, Clock::time_point now) {
+    m_horizon = std::max(m_horizon, next);
+    if (!m_gapOpen && m_expected < m_horizon) {
+        OpenGap(now);
+    }
+}
+
+void FeedArbiter::OpenGap(Clock::time_point opened) {
+    m_gapOpen = true;
+    m_gapFirst = m_expected;
+    m_gapOpened = opened;
+}
+
+// A message filled the front of the open gap. Once nothing is missing before the first held
+// message (or the horizon), the gap is recovered.
+void FeedArbiter::AfterAdvance(Clock::time_point now) {
+    const uint64_t holeEnd = m_held.empty() ? m_horizon : m_held.begin()->first;
+    if (m_expected < holeEnd)
+        return;
+
+    m_gapOpen = false;
+    ++m_stats.gapsRecovered;
+    if (m_onGap) {
+        m_onGap(Gap{m_gapFirst, m_expected - m_gapFirst, now - m_gapOpened, GapResolution::Recovered});
+    }
+    DeliverHeld();
+    ReopenIfMissing(now);
+}
+
+void FeedArbiter::DeliverHeld() {
+    while (!m_held.empty() && m_held.begin()->first == m_expected) {
+        auto entry = m_held.begin();
+        Deliver(entry->first, entry->second.message);
+        m_held.erase(entry);
+        ++m_expected;
+    }
+}
+
+// Skips what is still missing before the first held message and delivers from there
+void FeedArbiter::GiveUp(Clock::time_point now) {
+    const uint64_t holeEnd = m_held.empty() ? m_horizon : m_held.begin()->first;
+    const uint64_t missing = holeEnd - m_expected;
+
+    m_gapOpen = false;
+    ++m_stats.gapsLost;
+    m_stats.messagesLost += missing;
+    if (m_onGap) {
+        m_onGap(Gap{m_expected, missing, now - m_gapOpened, GapResolution::Lost});
+    }
+    m_expected = holeEnd;
+    DeliverHeld();
+    ReopenIfMissing(now);
+}
+
+// A further hole behind the one just closed counts from when its first later message arrived
+void FeedArbiter::ReopenIfMissing(Clock::time_point now) {
+    if (m_expected < m_horizon) {
+        OpenGap(m_held.empty() ? now : std::min(now, m_held.begin()->second.arrived));
+    }
+}
+
+// FeedHandler
+
+FeedHandler::FeedHandler(FeedArbiter::MessageCallback onMessage, FeedArbiter::GapCallback onGap,
+                         Clock::duration gapTimeout)
+    : m_arbiter(std::move(onMessage), std::move(onGap), gapTimeout),
+      m_buffer(MAX_DATAGRAM_SIZE) {}
+
+FeedHandler::~FeedHandler() {
+    Close();
+}
+
+bool FeedHandler::Open(INetworkSocketFactory& factory, const LineConfig& lineA, const LineConfig& lineB) {
+    Close();
+    m_poller = factory.CreateSocketPoller();
+    if (!m_poller) {
+        return false;
+    }
+
+    const LineConfig* configs[2] = {&lineA, &lineB};
+    for (size_t i = 0; i < 2; ++i) {
+        const LineConfig& config = *configs[i];
+        if (i == 1 && config.group.ipAddress.empty())
+            break;
+
+        auto socket = factory.CreateUdpSocket();
+        if (!socket || !socket->IsValid()) {
+            Close();
+            return false;
+        }
+
+        bool ready;
+        if (IsMulticast(config.group)) {
+#ifdef _WIN32
+            // Windows cannot bind to a group address; membership does the filtering
+            ready = socket->Bind(NetworkAddress("0.0.0.0", config.group.port));
+#else
+            // Bound to the group, the socket only sees that group's datagrams even when the
+            // other line uses the same port
+            ready = socket->Bind(config.group);
+#endif
+            ready = ready && socket->JoinMulticastGroup(config.group, config.interfaceAddress);
+        } else {
+            ready = socket->Bind(config.group);
+        }
+
+        if (!ready || !socket->SetNonBlocking(true) ||
+            !m_poller->Add(*socket, ISocketPoller::Readable, i)) {
+            Close();
+            return false;
+        }
+        m_sockets[i] = std::move(socket);
+    }
+    // Armed here rather than in Run, so a Stop that comes before Run starts is not lost
+    m_running = true;
+    return true;
+}
+
+int FeedHandler::Poll(int timeoutMs) {
+    if (!m_poller || !m_sockets[0])
+        return -1;
+
+    ISocketPoller::Ready ready[2];
+    int count = m_poller->Wait(ready, timeoutMs);
+    size_t processed = 0;
+    for (int i = 0; i < count; ++i) {
+        if (ready[i].token < 2) {
+            processed += Drain(static_cast<Line>(ready[i].token));
+        }
+    }
+
+    // Gaps time out even while both lines are quiet
+    m_arbiter.Update();
+    return static_cast<int>(processed);
+}
+
+void FeedHandler::Run(int pollTimeoutMs) {
+    while (m_running) {
+        if (Poll(pollTimeoutMs) < 0)
+            break;
+    }
+}
+
+void FeedHandler::Stop() {
+    m_running = false;
+    if (m_poller) {
+        m_poller->Wakeup();
+    }
+}
+
+void FeedHandler::Close() {
+    for (auto& socket : m_sockets) {
+        if (socket && m_poller) {
+            m_poller->Remove(*socket);
+        }
+        socket.reset();
+    }
+    m_poller.reset();
+}
+
+NetworkAddress FeedHandler::GetLocalAddress(Line line) const {
+    const auto& socket = m_sockets[static_cast<size_t>(line)];
+    return socket ? socket->GetLocalAddress() : NetworkAddress();
+}
+
+size_t FeedHandler::Drain(Line line) {
+    IUdpSocket& socket = *m_sockets[static_cast<size_t>(line)];
+    std::span<std::byte> buffer(m_buffer);
+    AddressKey sender;
+    size_t processed = 0;
+
+    while (processed < MAX_DRAIN_BATCH) {
+        int bytesRead = socket.ReceiveFrom(buffer, sender);
+        if (bytesRead <= 0)
+            break;
+        m_arbiter.Process(std::span<const std::byte>(m_buffer.data(), static_cast<size_t>(bytesRead)), line,
+                          Clock::now());
+        ++processed;
+    }
+    return processed;
+}
@@ -0,0 +1,148 @@
+#include "network/framed_connection.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Helper functions
+namespace {
+    enum class PrefixResult { Complete, Incomplete, Invalid };
+
+    PrefixResult DecodeFixedU32(std::span<const std::byte> data, uint32_t& length, size_t& prefixSize) {
+        if (data.size() < 4)
+            return PrefixResult::Incomplete;
+
+        length = (std::to_integer<uint32_t>(data[0]) << 24) |
+                 (std::to_integer<uint32_t>(data[1]) << 16) |
+                 (std::to_integer<uint32_t>(data[2]) << 8) |
+                 std::to_integer<uint32_t>(data[3]);
+        prefixSize = 4;
+        return PrefixResult::Complete;
+    }
+
+    PrefixResult DecodeVarint(std::span<const std::byte> data, uint32_t& length, size_t& prefixSize) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < FramedConnection::MAX_PREFIX_SIZE; ++i) {
+            if (i >= data.size())
+                return PrefixResult::Incomplete;
+
+            uint8_t byte = std::to_integer<uint8_t>(data[i]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0) {
+                if (value > UINT32_MAX)
+                    return PrefixResult::Invalid;
+                length = static_cast<uint32_t>(value);
+                prefixSize = i + 1;
+                return PrefixResult::Complete;
+            }
+        }
+        return PrefixResult::Invalid;
+    }
+
+    size_t EncodePrefix(FramedConnection::PrefixFormat format, uint32_t length, std::byte* out) {
+        if (format == FramedConnection::PrefixFormat::FixedU32) {
+            out[0] = std::byte(length >> 24);
+            out[1] = std::byte(length >> 16);
+            out[2] = std::byte(length >> 8);
+            out[3] = std::byte(length);
+            return 4;
+        }
+
+        size_t size = 0;
+        do {
+            uint8_t byte = length & 0x7F;
+            length >>= 7;
+            out[size++] = std::byte(length != 0 ? (byte | 0x80) : byte);
+        } while (length != 0);
+        return size;
+    }
+}
+
+FramedConnection::FramedConnection(ITcpSocket& socket, PrefixFormat format, size_t maxFrameSize)
+    : m_socket(socket),
+      m_format(format),
+      m_maxFrameSize(std::min<size_t>(maxFrameSize, UINT32_MAX)),
+      // The ring must be able to hold the largest frame plus its prefix contiguously
+      m_receiveBuffer(std::max(m_maxFrameSize + MAX_PREFIX_SIZE, MirroredRingBuffer::DEFAULT_CAPACITY)) {
+}
+
+FramedConnection::ReadStatus FramedConnection::NextFrame(std::span<const std::byte>& frame) {
+    // Release the frame handed out by the previous call
+    m_receiveBuffer.Consume(m_pendingConsume);
+    m_pendingConsume = 0;
+
+    std::span<const std::byte> readable = m_receiveBuffer.ReadableSpan();
+    uint32_t length = 0;
+    size_t prefixSize = 0;
+    PrefixResult result = (m_format == PrefixFormat::FixedU32)
+        ? DecodeFixedU32(readable, length, prefixSize)
+        : DecodeVarint(readable, length, prefixSize);
+
+    if (result == PrefixResult::Invalid || (result == PrefixResult::Complete && length > m_maxFrameSize))
+        return ReadStatus::FrameTooLarge;
+    if (result == PrefixResult::Incomplete || readable.size() - prefixSize < length)
+        return ReadStatus::NeedMoreData;
+
+    frame = readable.subspan(prefixSize, length);
+    m_pendingConsume = prefixSize + length;
+    return ReadStatus::Frame;
+}
+
+FramedConnection::ReadStatus FramedConnection::ReadFrame(std::span<const std::byte>& frame) {
+    ReadStatus status = NextFrame(frame);
+    if (status != ReadStatus::NeedMoreData)
+        return status;
+
+    int bytesRead = m_socket.ReceiveInto(m_receiveBuffer);
+    if (bytesRead == 0)
+        return ReadStatus::Closed;
+    if (bytesRead < 0)
+        return ReadStatus::Error;
+
+    return NextFrame(frame);
+}
+
+bool FramedConnection::QueueFrame(std::span<const std::byte> payload) {
+    if (payload.size() > m_maxFrameSize)
+        return false;
+
+    // Drop the already-sent prefix of the batch before growing it
+    if (m_outgoingSent == m_outgoing.size()) {
+        m_outgoing.clear();
+        m_outgoingSent = 0;
+    }
+
+    std::byte prefix[MAX_PREFIX_SIZE];
+    size_t prefixSize = EncodePrefix(m_format, static_cast<uint32_t>(payload.size()), prefix);
+
+    size_t offset = m_outgoing.size();
+    m_outgoing.resize(offset + prefixSize + payload.size());
+    std::memcpy(m_outgoing.data() + offset, prefix, prefixSize);
+    if (!payload.empty()) {
+        std::memcpy(m_outgoing.data() + offset + prefixSize, payload.data(), payload.size());
+    }
+    return true;
+}
+
+int FramedConnection::Flush() {
+    int totalSent = 0;
+    while (m_outgoingSent < m_outgoing.size()) {
+        std::span<const std::byte> pending(m_outgoing.data() + m_outgoingSent, m_outgoing.size() - m_outgoingSent);
+        int bytesSent = m_socket.Send(pending);
+        if (bytesSent <= 0)
+            return totalSent > 0 ? totalSent : bytesSent;     // Progress so far counts; the caller retries later
+
+        m_outgoingSent += static_cast<size_t>(bytesSent);
+        totalSent += bytesSent;
+    }
+
+    // Keep the capacity for the next batch
+    m_outgoing.clear();
+    m_outgoingSent = 0;
+    return totalSent;
+}
+
+int FramedConnection::SendFrame(std::span<const std::byte> payload) {
+    if (!QueueFrame(payload))
+        return -1;
+    return Flush();
+}
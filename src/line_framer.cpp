@@ -0,0 +1,74 @@
+#include "network/line_framer.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+    #define LINE_FRAMER_HAS_SSE2 1
+    #include <emmintrin.h>
+    // AVX2 is compiled per function and selected at runtime, so the library still runs on older CPUs
+    #if defined(__GNUC__) || defined(__clang__)
+        #define LINE_FRAMER_HAS_AVX2 1
+        #include <immintrin.h>
+    #endif
+#endif
+
+// Helper functions
+namespace {
+    using FindNewlineFunction = size_t (*)(const char*, size_t);
+
+    size_t FindNewlineScalar(const char* data, size_t size) {
+        const void* found = std::memchr(data, '\n', size);
+        return found ? static_cast<size_t>(static_cast<const char*>(found) - data) : size;
+    }
+
+    #ifdef LINE_FRAMER_HAS_SSE2
+    size_t FindNewlineSse2(const char* data, size_t size) {
+        const __m128i newline = _mm_set1_epi8('\n');
+        size_t offset = 0;
+        for (; offset + 16 <= size; offset += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+            if (mask != 0) {
+                return offset + std::countr_zero(mask);
+            }
+        }
+        return offset + FindNewlineScalar(data + offset, size - offset);
+    }
+    #endif
+
+    #ifdef LINE_FRAMER_HAS_AVX2
+    __attribute__((target("avx2")))
+    size_t FindNewlineAvx2(const char* data, size_t size) {
+        const __m256i newline = _mm256_set1_epi8('\n');
+        size_t offset = 0;
+        for (; offset + 32 <= size; offset += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+            if (mask != 0) {
+                return offset + std::countr_zero(mask);
+            }
+        }
+        return offset + FindNewlineSse2(data + offset, size - offset);
+    }
+    #endif
+
+    FindNewlineFunction SelectFindNewline() {
+        #ifdef LINE_FRAMER_HAS_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            return FindNewlineAvx2;
+        }
+        #endif
+        #ifdef LINE_FRAMER_HAS_SSE2
+        return FindNewlineSse2;
+        #else
+        return FindNewlineScalar;
+        #endif
+    }
+}
+
+size_t LineFramer::FindNewline(const char* data, size_t size) {
+    // Resolved once, on first use, so it is safe to call during static initialization
+    static const FindNewlineFunction findNewline = SelectFindNewline();
+    return findNewline(data, size);
+}
@@ -0,0 +1,199 @@
+#include "network/metrics.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+// Helper functions
+namespace {
+    void AppendNumber(std::string& out, double value) {
+        if (std::isnan(value)) {
+            out += "NaN";
+        } else if (std::isinf(value)) {
+            out += value > 0 ? "+Inf" : "-Inf";
+        } else {
+            char text[32];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            out.append(text, result.ptr);
+        }
+    }
+
+    void AppendNumber(std::string& out, uint64_t value) {
+        char text[24];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        out.append(text, result.ptr);
+    }
+
+    // name{labels} or name{labels,extra}, without braces when both are empty
+    void AppendSeriesName(std::string& out, const std::string& name, const char* suffix,
+                          const std::string& labels, const std::string& extra = "") {
+        out += name;
+        out += suffix;
+        if (labels.empty() && extra.empty())
+            return;
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra.empty()) {
+            out += ',';
+        }
+        out += extra;
+        out += '}';
+    }
+
+    // HELP text escapes backslashes and newlines
+    void AppendHelp(std::string& out, const std::string& help) {
+        for (char c : help) {
+            if (c == '\\') {
+                out += "\\\\";
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+// MetricsRegistry::Histogram
+
+MetricsRegistry::Histogram::Histogram(std::vector<double> upperBounds)
+    : m_upperBounds(std::move(upperBounds)),
+      m_counts(std::make_unique<std::atomic<uint64_t>[]>(m_upperBounds.size() + 1)) {}
+
+void MetricsRegistry::Histogram::Observe(double value) {
+    // Bucket lists are short, so a linear scan beats a binary search
+    size_t bucket = 0;
+    while (bucket < m_upperBounds.size() && value > m_upperBounds[bucket]) {
+        ++bucket;
+    }
+    m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> MetricsRegistry::Histogram::GetBucketCounts() const {
+    std::vector<uint64_t> counts(m_upperBounds.size() + 1);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+uint64_t MetricsRegistry::Histogram::GetCount() const {
+    uint64_t count = 0;
+    for (size_t i = 0; i <= m_upperBounds.size(); ++i) {
+        count += m_counts[i].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+// MetricsRegistry
+
+MetricsRegistry::Counter& MetricsRegistry::AddCounter(const std::string& name, const std::string& help,
+                                                      const std::string& labels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Series& series = AddSeries(name, help, Type::Counter, labels);
+    series.counter = std::make_unique<Counter>();
+    return *series.counter;
+}
+
+MetricsRegistry::Gauge& MetricsRegistry::AddGauge(const std::string& name, const std::string& help,
+                                                  const std::string& labels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Series& series = AddSeries(name, help, Type::Gauge, labels);
+    series.gauge = std::make_unique<Gauge>();
+    return *series.gauge;
+}
+
+void MetricsRegistry::AddGaugeFunction(const std::string& name, const std::string& help, GaugeFunction function,
+                                       const std::string& labels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    AddSeries(name, help, Type::Gauge, labels).function = std::move(function);
+}
+
+MetricsRegistry::Histogram& MetricsRegistry::AddHistogram(const std::string& name, const std::string& help,
+                                                          std::vector<double> upperBounds,
+                                                          const std::string& labels) {
+    std::sort(upperBounds.begin(), upperBounds.end());
+    upperBounds.erase(std::unique(upperBounds.begin(), upperBounds.end()), upperBounds.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Series& series = AddSeries(name, help, Type::Histogram, labels);
+    series.histogram = std::make_unique<Histogram>(std::move(upperBounds));
+    return *series.histogram;
+}
+
+void MetricsRegistry::Render(std::string& out) const {
+    static const char* const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Family& family : m_families) {
+        out += "# HELP ";
+        out += family.name;
+        out += ' ';
+        AppendHelp(out, family.help);
+        out += "\n# TYPE ";
+        out += family.name;
+        out += ' ';
+        out += TYPE_NAMES[static_cast<int>(family.type)];
+        out += '\n';
+
+        for (const Series& series : family.series) {
+            if (series.counter) {
+                AppendSeriesName(out, family.name, "", series.labels);
+                out += ' ';
+                AppendNumber(out, series.counter->Get());
+                out += '\n';
+            } else if (series.gauge || series.function) {
+                AppendSeriesName(out, family.name, "", series.labels);
+                out += ' ';
+                AppendNumber(out, series.gauge ? series.gauge->Get() : series.function());
+                out += '\n';
+            } else if (series.histogram) {
+                // Buckets are cumulative in the exposition format; the total count is the +Inf bucket
+                const std::vector<double>& bounds = series.histogram->GetUpperBounds();
+                std::vector<uint64_t> counts = series.histogram->GetBucketCounts();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < counts.size(); ++i) {
+                    cumulative += counts[i];
+                    std::string le = "le=\"";
+                    AppendNumber(le, i < bounds.size() ? bounds[i] : INFINITY);
+                    le += '"';
+                    AppendSeriesName(out, family.name, "_bucket", series.labels, le);
+                    out += ' ';
+                    AppendNumber(out, cumulative);
+                    out += '\n';
+                }
+                AppendSeriesName(out, family.name, "_sum", series.labels);
+                out += ' ';
+                AppendNumber(out, series.histogram->GetSum());
+                out += '\n';
+                AppendSeriesName(out, family.name, "_count", series.labels);
+                out += ' ';
+                AppendNumber(out, cumulative);
+                out += '\n';
+            }
+        }
+    }
+}
+
+std::vector<double> MetricsRegistry::ExponentialBuckets(double start, double factor, size_t count) {
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    for (double bound = start; bounds.size() < count; bound *= factor) {
+        bounds.push_back(bound);
+    }
+    return bounds;
+}
+
+// Appends a series to the family of that name, creating the family on first use
+MetricsRegistry::Series& MetricsRegistry::AddSeries(const std::string& name, const std::string& help, Type type,
+                                                    const std::string& labels) {
+    auto it = std::find_if(m_families.begin(), m_families.end(),
+                           [&](const Family& family) { return family.name == name && family.type == type; });
+    if (it == m_families.end()) {
+        m_families.push_back(Family{name, help, type, {}});
+        it = std::prev(m_families.end());
+    }
+    it->series.push_back(Series{labels, nullptr, nullptr, nullptr, nullptr});
+    return it->series.back();
+}
@@ -0,0 +1,260 @@
+#include "network/metrics_endpoint.h"
+
+#include <string_view>
+#include <vector>
+
+// Helper functions
+namespace {
+    // The listener's token; connections are numbered from 1
+    constexpr uint64_t LISTENER_TOKEN = 0;
+
+    // Wait timeout, so that expired requests are closed even when nothing else happens
+    constexpr int POLL_INTERVAL_MS = 100;
+
+    constexpr size_t MAX_READY_EVENTS = 32;
+
+    constexpr std::string_view CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+    std::string StatusResponse(std::string_view status, std::string_view body) {
+        std::string response = "HTTP/1.1 ";
+        response += status;
+        response += "\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: ";
+        response += std::to_string(body.size());
+        response += "\r\nConnection: close\r\n\r\n";
+        response += body;
+        return response;
+    }
+}
+
+MetricsEndpoint::MetricsEndpoint(INetworkSocketFactory& factory, const MetricsRegistry& registry)
+    : m_factory(factory), m_registry(registry) {}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    Stop();
+}
+
+bool MetricsEndpoint::Start(const NetworkAddress& address) {
+    if (m_running || m_thread.joinable())
+        return false;
+
+    m_listener = m_factory.CreateTcpListener();
+    m_poller = m_factory.CreateSocketPoller();
+    if (!m_listener || !m_poller || !m_listener->IsValid())
+        return false;
+
+    if (!m_listener->Bind(address) ||
+        !m_listener->Listen(static_cast<int>(MAX_CONNECTIONS)) ||
+        !m_listener->SetNonBlocking(true) ||
+        !m_poller->Add(*m_listener, ISocketPoller::Readable, LISTENER_TOKEN)) {
+        m_listener.reset();
+        m_poller.reset();
+        return false;
+    }
+    m_localAddress = m_listener->GetLocalAddress();
+    m_acceptPaused = false;
+
+    m_running = true;
+    m_thread = std::thread(&MetricsEndpoint::Run, this);
+    return true;
+}
+
+void MetricsEndpoint::Stop() {
+    m_running = false;
+    if (m_poller) {
+        m_poller->Wakeup();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_listener) {
+        m_listener->Close();
+    }
+    m_listener.reset();
+    m_poller.reset();
+}
+
+NetworkAddress MetricsEndpoint::GetLocalAddress() const {
+    return m_localAddress;
+}
+
+void MetricsEndpoint::Run() {
+    std::vector<ISocketPoller::Ready> ready(MAX_READY_EVENTS);
+    while (m_running) {
+        int count = m_poller->Wait(std::span<ISocketPoller::Ready>(ready), POLL_INTERVAL_MS);
+        if (count < 0)
+            break;
+
+        for (int i = 0; i < count; ++i) {
+            const uint64_t token = ready[i].token;
+            if (token == LISTENER_TOKEN) {
+                AcceptPending();
+                continue;
+            }
+
+            auto it = m_connections.find(token);
+            if (it == m_connections.end())
+                continue;
+
+            Connection& connection = it->second;
+            bool open;
+            if (connection.response.empty()) {
+                open = (ready[i].events & (ISocketPoller::Readable | ISocketPoller::Closed)) &&
+                       ReadRequest(token, connection);
+            } else {
+                open = WriteResponse(connection);
+            }
+            if (!open) {
+                CloseConnection(token);
+            }
+        }
+        const Clock::time_point now = Clock::now();
+        CloseExpired(now);
+        if (m_acceptPaused && now >= m_acceptResume) {
+            ResumeAccepting(now);
+        }
+    }
+
+    while (!m_connections.empty()) {
+        CloseConnection(m_connections.begin()->first);
+    }
+}
+
+void MetricsEndpoint::AcceptPending() {
+    while (true) {
+        std::unique_ptr<ITcpSocket> socket = m_listener->AcceptTcp();
+        if (!socket) {
+            // The listener is level-triggered, so a failing accept (e.g. EMFILE with the
+            // connection still queued) would wake the loop again at once; sit it out instead
+            if (!ISocketPoller::LastCallWouldBlock() && m_poller->Remove(*m_listener)) {
+                m_acceptPaused = true;
+                m_acceptResume = Clock::now() + ACCEPT_BACKOFF;
+            }
+            return;
+        }
+
+        if (m_connections.size() >= MAX_CONNECTIONS || !socket->SetNonBlocking(true)) {
+            socket->Close();
+            continue;
+        }
+
+        const uint64_t token = m_nextToken++;
+        if (!m_poller->Add(*socket, ISocketPoller::Readable, token)) {
+            socket->Close();
+            continue;
+        }
+        Connection& connection = m_connections[token];
+        connection.socket = std::move(socket);
+        connection.deadline = Clock::now() + REQUEST_TIMEOUT;
+    }
+}
+
+void MetricsEndpoint::ResumeAccepting(Clock::time_point now) {
+    if (m_poller->Add(*m_listener, ISocketPoller::Readable, LISTENER_TOKEN)) {
+        m_acceptPaused = false;
+    } else {
+        m_acceptResume = now + ACCEPT_BACKOFF;
+    }
+}
+
+bool MetricsEndpoint::ReadRequest(uint64_t token, Connection& connection) {
+    char buffer[2048];
+    bool peerClosed = false;
+    while (true) {
+        int bytesRead = connection.socket->Receive(std::span<std::byte>(reinterpret_cast<std::byte*>(buffer), sizeof(buffer)));
+        if (bytesRead == 0) {
+            // A scraper may half-close after its request; it still wants the answer
+            peerClosed = true;
+            break;
+        }
+        if (bytesRead < 0) {
+            if (!ISocketPoller::LastCallWouldBlock())
+                return false;
+            break;
+        }
+        connection.request.append(buffer, static_cast<size_t>(bytesRead));
+        if (connection.request.size() > MAX_REQUEST_SIZE)
+            return false;
+    }
+
+    // Only the request line matters; the headers just have to end
+    if (connection.request.find("\r\n\r\n") == std::string::npos &&
+        connection.request.find("\n\n") == std::string::npos)
+        return !peerClosed;
+
+    BuildResponse(connection);
+    if (!m_poller->Modify(*connection.socket, ISocketPoller::Writable, token))
+        return false;
+    return WriteResponse(connection);
+}
+
+bool MetricsEndpoint::WriteResponse(Connection& connection) {
+    while (connection.sent < connection.response.size()) {
+        std::string_view rest = std::string_view(connection.response).substr(connection.sent);
+        int bytesSent = connection.socket->Send(std::span<const std::byte>(reinterpret_cast<const std::byte*>(rest.data()), rest.size()));
+        if (bytesSent < 0)
+            return ISocketPoller::LastCallWouldBlock();
+        connection.sent += static_cast<size_t>(bytesSent);
+    }
+    return false;   // Done: the connection closes
+}
+
+void MetricsEndpoint::BuildResponse(Connection& connection) {
+    std::string_view request = connection.request;
+    std::string_view requestLine = request.substr(0, request.find_first_of("\r\n"));
+    const size_t methodEnd = requestLine.find(' ');
+    const size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+    if (methodEnd == std::string_view::npos || targetEnd == std::string_view::npos) {
+        connection.response = StatusResponse("400 Bad Request", "Bad request\n");
+        return;
+    }
+
+    std::string_view method = requestLine.substr(0, methodEnd);
+    std::string_view target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    target = target.substr(0, target.find('?'));
+    if (target != "/metrics") {
+        connection.response = StatusResponse("404 Not Found", "Metrics are served at /metrics\n");
+        return;
+    }
+    if (method != "GET" && method != "HEAD") {
+        connection.response = StatusResponse("405 Method Not Allowed", "Use GET\n");
+        return;
+    }
+
+    std::string body;
+    body.reserve(m_lastBodySize + m_lastBodySize / 4);
+    m_registry.Render(body);
+    m_lastBodySize = body.size();
+    m_scrapes.fetch_add(1, std::memory_order_relaxed);
+
+    std::string& response = connection.response;
+    response.reserve(body.size() + 160);
+    response = "HTTP/1.1 200 OK\r\nContent-Type: ";
+    response += CONTENT_TYPE;
+    response += "\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    if (method == "GET") {
+        response += body;
+    }
+}
+
+void MetricsEndpoint::CloseConnection(uint64_t token) {
+    auto it = m_connections.find(token);
+    if (it == m_connections.end())
+        return;
+    m_poller->Remove(*it->second.socket);
+    it->second.socket->Close();
+    m_connections.erase(it);
+}
+
+void MetricsEndpoint::CloseExpired(Clock::time_point now) {
+    std::vector<uint64_t> expired;
+    for (const auto& [token, connection] : m_connections) {
+        if (now >= connection.deadline) {
+            expired.push_back(token);
+        }
+    }
+    for (uint64_t token : expired) {
+        CloseConnection(token);
+    }
+}
@@ -0,0 +1,187 @@
+#include "network/mirrored_ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/types.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <atomic>
+    #include <string>
+#endif
+
+// Helper functions
+namespace {
+    size_t RoundUp(size_t value, size_t granularity) {
+        return ((std::max<size_t>(value, 1) + granularity - 1) / granularity) * granularity;
+    }
+
+    #ifndef _WIN32
+    // Anonymous shared-memory file backing both halves of the mapping
+    int CreateBackingFile(size_t size) {
+        int fd = -1;
+        #if defined(__linux__)
+        fd = memfd_create("network-ring", MFD_CLOEXEC);
+        #endif
+        if (fd == -1) {
+            // memfd_create is Linux-only: fall back to a POSIX shared memory object that is unlinked right away
+            static std::atomic<unsigned> counter{0};
+            std::string name = "/network-ring-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+            fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (fd != -1) {
+                shm_unlink(name.c_str());
+            }
+        }
+        if (fd != -1 && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+    #endif
+}
+
+MirroredRingBuffer::MirroredRingBuffer(size_t minCapacity) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t capacity = RoundUp(minCapacity, info.dwAllocationGranularity);
+
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<unsigned long long>(capacity) >> 32),
+                                        static_cast<DWORD>(capacity & 0xFFFFFFFFu), nullptr);
+    if (mapping == nullptr)
+        return;
+
+    // Find a free 2x region, release it and map both views into it.
+    // Another thread may grab the range in between, so retry a few times.
+    for (int attempt = 0; attempt < 16 && m_base == nullptr; ++attempt) {
+        void* region = VirtualAlloc(nullptr, capacity * 2, MEM_RESERVE, PAGE_NOACCESS);
+        if (region == nullptr)
+            break;
+        VirtualFree(region, 0, MEM_RELEASE);
+
+        void* first = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity, region);
+        if (first == nullptr)
+            continue;
+        void* second = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity,
+                                       static_cast<char*>(region) + capacity);
+        if (second == nullptr) {
+            UnmapViewOfFile(first);
+            continue;
+        }
+        m_base = static_cast<std::byte*>(first);
+    }
+
+    if (m_base == nullptr) {
+        CloseHandle(mapping);
+        return;
+    }
+    m_mapping = mapping;
+    m_capacity = capacity;
+#else
+    long pageSize = sysconf(_SC_PAGESIZE);
+    size_t capacity = RoundUp(minCapacity, pageSize > 0 ? static_cast<size_t>(pageSize) : 4096);
+
+    int fd = CreateBackingFile(capacity);
+    if (fd == -1)
+        return;
+
+    // Reserve 2x address space, then map the same file over both halves
+    void* region = mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        close(fd);
+        return;
+    }
+
+    std::byte* base = static_cast<std::byte*>(region);
+    bool mapped =
+        mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+        mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+
+    // The mappings keep the memory alive; the descriptor is no longer needed
+    close(fd);
+
+    if (!mapped) {
+        munmap(region, capacity * 2);
+        return;
+    }
+    m_base = base;
+    m_capacity = capacity;
+#endif
+}
+
+MirroredRingBuffer::~MirroredRingBuffer() {
+    Release();
+}
+
+MirroredRingBuffer::MirroredRingBuffer(MirroredRingBuffer&& other) noexcept
+    : m_base(std::exchange(other.m_base, nullptr)),
+      m_capacity(std::exchange(other.m_capacity, 0)),
+      m_head(std::exchange(other.m_head, 0)),
+      m_tail(std::exchange(other.m_tail, 0))
+#ifdef _WIN32
+      , m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif
+{
+}
+
+MirroredRingBuffer& MirroredRingBuffer::operator=(MirroredRingBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_base = std::exchange(other.m_base, nullptr);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_head = std::exchange(other.m_head, 0);
+        m_tail = std::exchange(other.m_tail, 0);
+#ifdef _WIN32
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MirroredRingBuffer::Release() {
+    if (m_base == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_base + m_capacity);
+    UnmapViewOfFile(m_base);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_mapping = nullptr;
+#else
+    munmap(m_base, m_capacity * 2);
+#endif
+    m_base = nullptr;
+    m_capacity = 0;
+    m_head = m_tail = 0;
+}
+
+void MirroredRingBuffer::Commit(size_t bytes) {
+    m_tail += std::min(bytes, Available());
+}
+
+void MirroredRingBuffer::Consume(size_t bytes) {
+    m_head += std::min(bytes, Size());
+    // Keep the read offset inside the first mapping; the write offset follows it
+    if (m_head >= m_capacity) {
+        m_head -= m_capacity;
+        m_tail -= m_capacity;
+    }
+}
+
+bool MirroredRingBuffer::Write(std::span<const std::byte> data) {
+    if (data.size() > Available())
+        return false;
+
+    if (!data.empty()) {
+        std::memcpy(m_base + m_tail, data.data(), data.size());
+        m_tail += data.size();
+    }
+    return true;
+}
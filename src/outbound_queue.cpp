@@ -0,0 +1,118 @@
+#include "network/outbound_queue.h"
+
+#include <algorithm>
+#include <iterator>
+
+OutboundQueue::OutboundQueue(OverflowPolicy policy, size_t maxMessages, size_t maxBytes,
+                             std::chrono::milliseconds backpressureTimeout)
+    : m_policy(policy),
+      m_maxMessages(std::max<size_t>(maxMessages, 1)),
+      m_maxBytes(maxBytes),
+      m_backpressureTimeout(backpressureTimeout) {
+}
+
+OutboundQueue::PushResult OutboundQueue::Push(PooledBuffer message) {
+    const size_t size = message.Size();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_closed)
+        return PushResult::Closed;
+
+    PushResult result = PushResult::Queued;
+    if (!HasRoomFor(size)) {
+        switch (m_policy) {
+        case OverflowPolicy::DropOldest:
+            while (!HasRoomFor(size)) {
+                PopFront();
+                ++m_stats.dropped;
+            }
+            result = PushResult::DroppedOldest;
+            break;
+
+        case OverflowPolicy::Disconnect:
+            ++m_stats.rejected;
+            m_closed = true;
+            m_notEmpty.notify_all();
+            m_notFull.notify_all();
+            return PushResult::Overflowed;
+
+        case OverflowPolicy::Backpressure:
+            if (!m_notFull.wait_for(lock, m_backpressureTimeout,
+                                    [this, size]() { return m_closed || HasRoomFor(size); })) {
+                ++m_stats.rejected;
+                return PushResult::Rejected;
+            }
+            if (m_closed)
+                return PushResult::Closed;
+            break;
+        }
+    }
+
+    m_messages.push_back(std::move(message));
+    m_stats.depthBytes += size;
+    m_stats.depth = m_messages.size();
+    m_stats.highWater = std::max(m_stats.highWater, m_stats.depth);
+    ++m_stats.enqueued;
+
+    lock.unlock();
+    m_notEmpty.notify_one();
+    return result;
+}
+
+bool OutboundQueue::PopAll(std::vector<PooledBuffer>& messages, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait_for(lock, timeout, [this]() { return m_closed || !m_messages.empty(); });
+
+    if (m_messages.empty())
+        return !m_closed;
+
+    messages.reserve(messages.size() + m_messages.size());
+    std::move(m_messages.begin(), m_messages.end(), std::back_inserter(messages));
+    m_messages.clear();
+    m_stats.depth = 0;
+    m_stats.depthBytes = 0;
+
+    lock.unlock();
+    m_notFull.notify_all();
+    return true;
+}
+
+void OutboundQueue::Close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+}
+
+bool OutboundQueue::IsClosed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_closed;
+}
+
+size_t OutboundQueue::GetDepth() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats.depth;
+}
+
+size_t OutboundQueue::GetDepthBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats.depthBytes;
+}
+
+OutboundQueue::Stats OutboundQueue::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+bool OutboundQueue::HasRoomFor(size_t bytes) const {
+    if (m_messages.empty())
+        return true;
+    return m_messages.size() < m_maxMessages && m_stats.depthBytes + bytes <= m_maxBytes;
+}
+
+void OutboundQueue::PopFront() {
+    m_stats.depthBytes -= m_messages.front().Size();
+    m_messages.pop_front();
+    m_stats.depth = m_messages.size();
+}
@@ -0,0 +1,595 @@
+#include "network/reliable_channel.h"
+
+#include <algorithm>
+#include <random>
+
+// Helper functions
+namespace {
+    // Datagram layout, all integers in network byte order:
+    //   u8 magic, u8 version, u8 flags, u8 sack words, u32 session, u32 cumulative ack,
+    //   u32 sack[sack words], and for data packets
+    //   u32 sequence, u32 message number, u16 fragment index, u16 fragment count, payload
+    // Bit b of sack word w acks packet ack + 1 + 32w + b.
+    constexpr uint8_t MAGIC = 0xFF;     // Never the first byte of UTF-8 text
+    constexpr uint8_t VERSION = 1;
+    constexpr uint8_t FLAG_DATA = 0x01;
+    constexpr uint8_t FLAG_ORDERED = 0x02;
+    constexpr size_t BASE_HEADER_SIZE = 12;
+    constexpr size_t DATA_HEADER_SIZE = 12;
+    constexpr size_t MAX_SACK_WORDS = 8;
+    constexpr size_t MAX_HEADER_SIZE = BASE_HEADER_SIZE + MAX_SACK_WORDS * 4 + DATA_HEADER_SIZE;
+
+    // Packets accepted beyond the cumulative ack: exactly what the sack bitmap can describe
+    constexpr uint64_t RECEIVE_WINDOW = MAX_SACK_WORDS * 32;
+
+    // Fragments of the largest message at the smallest MTU
+    constexpr size_t MAX_FRAGMENTS = ReliableChannel::MAX_MESSAGE_SIZE / (ReliableChannel::MIN_MTU - MAX_HEADER_SIZE) + 1;
+    // Bookkeeping charged per fragment slot of a message being reassembled
+    constexpr size_t FRAGMENT_SLOT_SIZE = sizeof(std::vector<std::byte>) + 1;
+
+    constexpr double INITIAL_WINDOW = 10;
+    constexpr double MIN_WINDOW = 2;
+    constexpr double MAX_WINDOW = static_cast<double>(RECEIVE_WINDOW);
+    constexpr size_t MAX_QUEUED_PACKETS = 8192;
+    constexpr uint64_t REORDER_THRESHOLD = 3;
+    constexpr unsigned MAX_BACKOFF = 6;
+
+    constexpr std::chrono::milliseconds INITIAL_RTO(200);
+    constexpr std::chrono::milliseconds MIN_RTO(20);
+    constexpr std::chrono::milliseconds MAX_RTO(2000);
+    constexpr std::chrono::milliseconds ACK_DELAY(5);
+
+    void PutU16(std::vector<std::byte>& out, uint16_t value) {
+        out.push_back(std::byte(value >> 8));
+        out.push_back(std::byte(value));
+    }
+
+    void PutU32(std::vector<std::byte>& out, uint32_t value) {
+        out.push_back(std::byte(value >> 24));
+        out.push_back(std::byte(value >> 16));
+        out.push_back(std::byte(value >> 8));
+        out.push_back(std::byte(value));
+    }
+
+    uint16_t GetU16(std::span<const std::byte> data, size_t offset) {
+        return static_cast<uint16_t>((std::to_integer<uint16_t>(data[offset]) << 8) |
+                                     std::to_integer<uint16_t>(data[offset + 1]));
+    }
+
+    uint32_t GetU32(std::span<const std::byte> data, size_t offset) {
+        return (std::to_integer<uint32_t>(data[offset]) << 24) |
+               (std::to_integer<uint32_t>(data[offset + 1]) << 16) |
+               (std::to_integer<uint32_t>(data[offset + 2]) << 8) |
+               std::to_integer<uint32_t>(data[offset + 3]);
+    }
+
+    // Recovers a 64-bit counter from its low 32 bits as the value closest to `reference`
+    uint64_t Expand(uint32_t wire, uint64_t reference) {
+        constexpr uint64_t SPAN = uint64_t{1} << 32;
+        uint64_t candidate = (reference & ~(SPAN - 1)) | wire;
+        if (candidate + SPAN / 2 < reference) {
+            candidate += SPAN;
+        } else if (candidate > reference + SPAN / 2 && candidate >= SPAN) {
+            candidate -= SPAN;
+        }
+        return candidate;
+    }
+
+    uint32_t NewSession() {
+        std::random_device device;
+        std::mt19937 random(device() ^ static_cast<uint32_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count()));
+        uint32_t session = 0;
+        while (session == 0) {
+            session = random();
+        }
+        return session;
+    }
+}
+
+ReliableChannel::ReliableChannel(SendFunction send, size_t mtu, Clock::time_point now)
+    : m_send(std::move(send)),
+      m_mtu(std::max(mtu, MIN_MTU)),
+      m_fragmentSize(m_mtu - MAX_HEADER_SIZE),
+      m_session(NewSession()),
+      m_lastReceive(now),
+      m_congestionWindow(INITIAL_WINDOW),
+      m_slowStartThreshold(MAX_WINDOW) {
+    m_scratch.reserve(m_mtu);
+}
+
+bool ReliableChannel::IsChannelDatagram(std::span<const std::byte> datagram) {
+    return datagram.size() >= BASE_HEADER_SIZE &&
+           std::to_integer<uint8_t>(datagram[0]) == MAGIC &&
+           std::to_integer<uint8_t>(datagram[1]) == VERSION;
+}
+
+bool ReliableChannel::Send(std::span<const std::byte> message, Delivery delivery, Clock::time_point now) {
+    if (message.size() > MAX_MESSAGE_SIZE)
+        return false;
+
+    const size_t fragmentCount = std::max<size_t>(1, (message.size() + m_fragmentSize - 1) / m_fragmentSize);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_sendQueue.size() + fragmentCount > MAX_QUEUED_PACKETS)
+        return false;
+
+    const bool ordered = delivery == Delivery::Ordered;
+    const uint64_t number = ordered ? m_nextOrderedSend++ : m_nextUnorderedSend++;
+    for (size_t i = 0; i < fragmentCount; ++i) {
+        Packet packet;
+        packet.flags = ordered ? FLAG_ORDERED : 0;
+        packet.message = static_cast<uint32_t>(number);
+        packet.fragmentIndex = static_cast<uint16_t>(i);
+        packet.fragmentCount = static_cast<uint16_t>(fragmentCount);
+        const size_t offset = i * m_fragmentSize;
+        std::span<const std::byte> fragment = message.subspan(offset, std::min(m_fragmentSize, message.size() - offset));
+        packet.payload.assign(fragment.begin(), fragment.end());
+        m_sendQueue.push_back(std::move(packet));
+    }
+
+    SendQueued(now);
+    return true;
+}
+
+ReliableChannel::ReceiveResult ReliableChannel::Receive(std::span<const std::byte> datagram,
+                                                        const MessageCallback& onMessage,
+                                                        Clock::time_point now) {
+    if (!IsChannelDatagram(datagram))
+        return ReceiveResult::Malformed;
+
+    const uint8_t flags = std::to_integer<uint8_t>(datagram[2]);
+    const size_t sackWords = std::to_integer<uint8_t>(datagram[3]);
+    const bool isData = (flags & FLAG_DATA) != 0;
+    const size_t headerSize = BASE_HEADER_SIZE + sackWords * 4 + (isData ? DATA_HEADER_SIZE : 0);
+    if (sackWords > MAX_SACK_WORDS || datagram.size() < headerSize)
+        return ReceiveResult::Malformed;
+
+    const uint32_t session = GetU32(datagram, 4);
+    const uint32_t wireAck = GetU32(datagram, 8);
+    uint32_t sack[MAX_SACK_WORDS] = {};
+    for (size_t i = 0; i < sackWords; ++i) {
+        sack[i] = GetU32(datagram, BASE_HEADER_SIZE + i * 4);
+    }
+    if (session == 0)
+        return ReceiveResult::Malformed;
+
+    Packet packet;
+    uint32_t wireSeq = 0;
+    if (isData) {
+        const size_t offset = BASE_HEADER_SIZE + sackWords * 4;
+        wireSeq = GetU32(datagram, offset);
+        packet.flags = flags & FLAG_ORDERED;
+        packet.message = GetU32(datagram, offset + 4);
+        packet.fragmentIndex = GetU16(datagram, offset + 8);
+        packet.fragmentCount = GetU16(datagram, offset + 10);
+        if (packet.fragmentCount == 0 || packet.fragmentCount > MAX_FRAGMENTS ||
+            packet.fragmentIndex >= packet.fragmentCount)
+            return ReceiveResult::Malformed;
+        packet.payload.assign(datagram.begin() + headerSize, datagram.end());
+    }
+
+    std::vector<std::vector<std::byte>> completed;
+    ReceiveResult result = ReceiveResult::Processed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_peerSession != session) {
+            if (m_peerSession != 0) {
+                // Only the first packet of a new stream proves a restart; anything else from
+                // another session is a late datagram from the old one (or an early one from the
+                // new one, which will be resent) and must not wipe the current session
+                if (!isData || wireSeq != 0 || packet.fragmentIndex != 0) {
+                    ++m_stats.staleDatagrams;
+                    return ReceiveResult::Stale;
+                }
+                Reset(now);
+                result = ReceiveResult::PeerRestarted;
+            }
+            m_peerSession = session;
+        }
+
+        const bool wasPending = m_ackPending;
+        bool ackNow = false;
+        if (isData) {
+            packet.seq = Expand(wireSeq, m_receiveNext);
+            if (!OnData(std::move(packet), completed, ackNow))
+                return ReceiveResult::Malformed;
+        }
+        m_lastReceive = now;
+        ++m_stats.packetsReceived;
+        OnAck(Expand(wireAck, m_nextSeq), std::span<const uint32_t>(sack, sackWords), now);
+
+        // New data piggybacks the ack; otherwise send it now or within the ack delay
+        SendQueued(now);
+        if (m_ackPending && ackNow) {
+            SendAck();
+        } else if (m_ackPending && !wasPending) {
+            m_ackDeadline = now + ACK_DELAY;
+        }
+        m_stats.messagesDelivered += completed.size();
+    }
+
+    for (const std::vector<std::byte>& message : completed) {
+        onMessage(message);
+    }
+    return result;
+}
+
+void ReliableChannel::Update(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Resend expired packets, at most a window's worth per call
+    const Clock::duration timeout = RetransmitTimeout();
+    size_t budget = std::max<size_t>(1, static_cast<size_t>(m_congestionWindow));
+    bool backOff = false;
+    bool oldest = true;
+    for (Packet& packet : m_inFlight) {
+        if (budget == 0)
+            break;
+        if (packet.acked)
+            continue;
+        const bool isOldest = oldest;
+        oldest = false;
+        if (now - packet.sentAt < timeout)
+            continue;
+
+        // As with RFC 6298's single timer on the oldest outstanding packet, every expiry of that
+        // packet backs the timer off, so a packet that keeps timing out (e.g. the peer is gone)
+        // is resent at doubling intervals. Only the first expiry of a flight collapses the window.
+        backOff = backOff || isOldest;
+        if (packet.seq >= m_recoveryStart) {
+            ++m_stats.timeouts;
+            m_slowStartThreshold = std::max(m_congestionWindow / 2, MIN_WINDOW);
+            m_congestionWindow = MIN_WINDOW;
+            m_recoveryStart = m_nextSeq;
+            backOff = true;
+        }
+        packet.retransmitted = true;
+        ++m_stats.retransmissions;
+        Transmit(packet, now);
+        --budget;
+    }
+    if (backOff) {
+        m_backoff = std::min(m_backoff + 1, MAX_BACKOFF);
+    }
+
+    SendQueued(now);
+    if (m_ackPending && now >= m_ackDeadline) {
+        SendAck();
+    }
+}
+
+size_t ReliableChannel::GetUnackedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = m_sendQueue.size();
+    for (const Packet& packet : m_inFlight) {
+        count += packet.acked ? 0 : 1;
+    }
+    return count;
+}
+
+ReliableChannel::Clock::time_point ReliableChannel::GetLastReceiveTime() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastReceive;
+}
+
+ReliableChannel::Stats ReliableChannel::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.smoothedRtt = std::chrono::duration_cast<std::chrono::microseconds>(m_smoothedRtt);
+    stats.retransmitTimeout = std::chrono::duration_cast<std::chrono::microseconds>(RetransmitTimeout());
+    stats.congestionWindow = m_congestionWindow;
+    stats.packetsInFlight = 0;
+    for (const Packet& packet : m_inFlight) {
+        stats.packetsInFlight += packet.acked ? 0 : 1;
+    }
+    stats.packetsQueued = m_sendQueue.size();
+    stats.bufferedBytes = m_bufferedBytes;
+    return stats;
+}
+
+// Forgets everything about the previous peer session; statistics are kept
+void ReliableChannel::Reset(Clock::time_point now) {
+    m_lastReceive = now;
+    m_nextSeq = 0;
+    m_sendBase = 0;
+    m_inFlight.clear();
+    m_sendQueue.clear();
+    m_nextOrderedSend = 0;
+    m_nextUnorderedSend = 0;
+    m_largestAckedOrder = 0;
+    m_recoveryStart = 0;
+    m_congestionWindow = INITIAL_WINDOW;
+    m_slowStartThreshold = MAX_WINDOW;
+    m_hasRtt = false;
+    m_smoothedRtt = Clock::duration::zero();
+    m_rttVariance = Clock::duration::zero();
+    m_backoff = 0;
+
+    m_receiveNext = 0;
+    m_receivedAhead.clear();
+    m_ackPending = false;
+    m_unackedPackets = 0;
+    m_reassembly.clear();
+    m_readyOrdered.clear();
+    m_nextOrderedDelivery = 0;
+    m_unorderedReference = 0;
+    m_bufferedBytes = 0;
+}
+
+void ReliableChannel::WriteHeader(std::vector<std::byte>& out, uint8_t flags) {
+    // Sack words up to the last packet received beyond the cumulative ack
+    uint32_t sack[MAX_SACK_WORDS] = {};
+    size_t sackWords = 0;
+    for (size_t i = 1; i < m_receivedAhead.size() && i <= RECEIVE_WINDOW; ++i) {
+        if (m_receivedAhead[i]) {
+            sack[(i - 1) / 32] |= uint32_t{1} << ((i - 1) % 32);
+            sackWords = (i - 1) / 32 + 1;
+        }
+    }
+
+    out.push_back(std::byte(MAGIC));
+    out.push_back(std::byte(VERSION));
+    out.push_back(std::byte(flags));
+    out.push_back(std::byte(sackWords));
+    PutU32(out, m_session);
+    PutU32(out, static_cast<uint32_t>(m_receiveNext));
+    for (size_t i = 0; i < sackWords; ++i) {
+        PutU32(out, sack[i]);
+    }
+    m_ackPending = false;
+    m_unackedPackets = 0;
+}
+
+void ReliableChannel::Transmit(Packet& packet, Clock::time_point now) {
+    m_scratch.clear();
+    WriteHeader(m_scratch, FLAG_DATA | packet.flags);
+    PutU32(m_scratch, static_cast<uint32_t>(packet.seq));
+    PutU32(m_scratch, packet.message);
+    PutU16(m_scratch, packet.fragmentIndex);
+    PutU16(m_scratch, packet.fragmentCount);
+    m_scratch.insert(m_scratch.end(), packet.payload.begin(), packet.payload.end());
+
+    // A failed send is handled like a lost packet
+    m_send(m_scratch);
+    packet.sentAt = now;
+    packet.sendOrder = ++m_sendOrder;
+    ++m_stats.packetsSent;
+}
+
+void ReliableChannel::SendAck() {
+    m_scratch.clear();
+    WriteHeader(m_scratch, 0);
+    m_send(m_scratch);
+    ++m_stats.packetsSent;
+}
+
+void ReliableChannel::SendQueued(Clock::time_point now) {
+    while (!m_sendQueue.empty() &&
+           static_cast<double>(m_nextSeq - m_sendBase) + 1 <= std::min(m_congestionWindow, MAX_WINDOW)) {
+        m_inFlight.push_back(std::move(m_sendQueue.front()));
+        m_sendQueue.pop_front();
+        m_inFlight.back().seq = m_nextSeq++;
+        Transmit(m_inFlight.back(), now);
+    }
+}
+
+void ReliableChannel::OnAck(uint64_t ack, std::span<const uint32_t> sack, Clock::time_point now) {
+    // An ack for packets never sent belongs to an older session of ours; ignore it
+    if (ack > m_nextSeq)
+        return;
+
+    const Packet* rttSample = nullptr;
+    bool progress = false;
+    auto acknowledge = [&](uint64_t seq) {
+        Packet& packet = m_inFlight[seq - m_sendBase];
+        if (!MarkAcked(packet))
+            return;
+        progress = true;
+        if (!packet.retransmitted && (!rttSample || packet.seq > rttSample->seq)) {
+            rttSample = &packet;
+        }
+    };
+    for (uint64_t seq = m_sendBase; seq < ack; ++seq) {
+        acknowledge(seq);
+    }
+    for (size_t word = 0; word < sack.size(); ++word) {
+        for (unsigned bit = 0; bit < 32; ++bit) {
+            uint64_t seq = ack + 1 + word * 32 + bit;
+            if ((sack[word] >> bit) & 1u && seq >= m_sendBase && seq < m_nextSeq) {
+                acknowledge(seq);
+            }
+        }
+    }
+
+    // Karn's rule: only packets sent once give an unambiguous sample
+    if (rttSample) {
+        UpdateRtt(now - rttSample->sentAt);
+    }
+    // The peer is alive and taking data, so the timer stops backing off even when every
+    // acked packet was a retransmission and gave no sample
+    if (progress) {
+        m_backoff = 0;
+    }
+
+    while (!m_inFlight.empty() && m_inFlight.front().acked) {
+        m_inFlight.pop_front();
+        ++m_sendBase;
+    }
+
+    // A packet is lost once packets sent REORDER_THRESHOLD transmissions after it were acked
+    for (Packet& packet : m_inFlight) {
+        if (!packet.acked && packet.sendOrder + REORDER_THRESHOLD <= m_largestAckedOrder) {
+            OnCongestion(packet.seq);
+            packet.retransmitted = true;
+            ++m_stats.retransmissions;
+            Transmit(packet, now);
+        }
+    }
+}
+
+bool ReliableChannel::MarkAcked(Packet& packet) {
+    if (packet.acked)
+        return false;
+
+    packet.acked = true;
+    m_largestAckedOrder = std::max(m_largestAckedOrder, packet.sendOrder);
+
+    // Slow start below the threshold, then about one packet per window of acks
+    if (m_congestionWindow < m_slowStartThreshold) {
+        m_congestionWindow += 1;
+    } else {
+        m_congestionWindow += 1 / m_congestionWindow;
+    }
+    m_congestionWindow = std::min(m_congestionWindow, MAX_WINDOW);
+    return true;
+}
+
+// Halves the window once per flight: losses of packets sent before the last reduction are
+// part of the same event
+void ReliableChannel::OnCongestion(uint64_t seq) {
+    if (seq < m_recoveryStart)
+        return;
+    m_slowStartThreshold = std::max(m_congestionWindow / 2, MIN_WINDOW);
+    m_congestionWindow = m_slowStartThreshold;
+    m_recoveryStart = m_nextSeq;
+}
+
+void ReliableChannel::UpdateRtt(Clock::duration sample) {
+    if (!m_hasRtt) {
+        m_smoothedRtt = sample;
+        m_rttVariance = sample / 2;
+        m_hasRtt = true;
+        return;
+    }
+    Clock::duration error = m_smoothedRtt > sample ? m_smoothedRtt - sample : sample - m_smoothedRtt;
+    m_rttVariance = (m_rttVariance * 3 + error) / 4;
+    m_smoothedRtt = (m_smoothedRtt * 7 + sample) / 8;
+}
+
+ReliableChannel::Clock::duration ReliableChannel::RetransmitTimeout() const {
+    Clock::duration timeout = INITIAL_RTO;
+    if (m_hasRtt) {
+        timeout = m_smoothedRtt + std::max<Clock::duration>(std::chrono::milliseconds(1), m_rttVariance * 4);
+    }
+    timeout = std::clamp<Clock::duration>(timeout, MIN_RTO, MAX_RTO);
+    return std::min<Clock::duration>(timeout * (1u << m_backoff), MAX_RTO);
+}
+
+// Returns false, leaving the packet unrecorded, if it breaks the receive limits
+bool ReliableChannel::OnData(Packet&& packet, std::vector<std::vector<std::byte>>& completed, bool& ackNow) {
+    // A duplicate means our ack was lost or late; repeat it right away
+    if (packet.seq < m_receiveNext) {
+        ++m_stats.duplicates;
+        m_ackPending = true;
+        ackNow = true;
+        return true;
+    }
+    const uint64_t index = packet.seq - m_receiveNext;
+    if (index > RECEIVE_WINDOW)
+        return true;
+    if (index < m_receivedAhead.size() && m_receivedAhead[index]) {
+        ++m_stats.duplicates;
+        m_ackPending = true;
+        ackNow = true;
+        return true;
+    }
+
+    // Messages are numbered in send order and every message still incomplete or waiting has a
+    // packet in the receive window, so a peer never runs more than a window of messages ahead
+    const bool ordered = (packet.flags & FLAG_ORDERED) != 0;
+    const uint64_t reference = ordered ? m_nextOrderedDelivery : m_unorderedReference;
+    const uint64_t number = Expand(packet.message, reference);
+    if ((ordered && number < m_nextOrderedDelivery) || number > reference + RECEIVE_WINDOW)
+        return false;
+
+    // Anything kept past this call is charged against the buffer limit before it is accepted
+    size_t charge = 0;
+    auto pending = m_reassembly.find({ordered, number});
+    if (packet.fragmentCount > 1) {
+        charge = packet.payload.size();
+        if (pending == m_reassembly.end()) {
+            if (m_reassembly.size() > RECEIVE_WINDOW)
+                return false;
+            charge += packet.fragmentCount * FRAGMENT_SLOT_SIZE;
+        } else if (pending->second.fragments.size() != packet.fragmentCount ||
+                   pending->second.present[packet.fragmentIndex]) {
+            return false;
+        }
+    } else if (ordered && number > m_nextOrderedDelivery) {
+        charge = packet.payload.size();
+    }
+    if (m_bufferedBytes + charge > MAX_BUFFERED_BYTES)
+        return false;
+
+    if (m_receivedAhead.size() <= index) {
+        m_receivedAhead.resize(index + 1, false);
+    }
+    m_receivedAhead[index] = true;
+    while (!m_receivedAhead.empty() && m_receivedAhead.front()) {
+        m_receivedAhead.pop_front();
+        ++m_receiveNext;
+    }
+
+    // Ack every second packet, and at once while there is a gap so the sender sees the loss
+    m_ackPending = true;
+    ++m_unackedPackets;
+    if (index != 0 || !m_receivedAhead.empty() || m_unackedPackets >= 2) {
+        ackNow = true;
+    }
+
+    if (!ordered) {
+        m_unorderedReference = std::max(m_unorderedReference, number + 1);
+    }
+
+    if (packet.fragmentCount == 1) {
+        Deliver(ordered, number, std::move(packet.payload), completed);
+        return true;
+    }
+
+    if (pending == m_reassembly.end()) {
+        pending = m_reassembly.emplace(std::make_pair(ordered, number), Reassembly()).first;
+        pending->second.fragments.resize(packet.fragmentCount);
+        pending->second.present.resize(packet.fragmentCount, false);
+    }
+    Reassembly& reassembly = pending->second;
+    m_bufferedBytes += charge;
+    reassembly.present[packet.fragmentIndex] = true;
+    reassembly.fragments[packet.fragmentIndex] = std::move(packet.payload);
+    if (++reassembly.received < packet.fragmentCount)
+        return true;
+
+    std::vector<std::byte> message;
+    for (const std::vector<std::byte>& fragment : reassembly.fragments) {
+        message.insert(message.end(), fragment.begin(), fragment.end());
+    }
+    m_bufferedBytes -= message.size() + reassembly.fragments.size() * FRAGMENT_SLOT_SIZE;
+    m_reassembly.erase(pending);
+    Deliver(ordered, number, std::move(message), completed);
+    return true;
+}
+
+void ReliableChannel::Deliver(bool ordered, uint64_t message, std::vector<std::byte> data,
+                              std::vector<std::vector<std::byte>>& completed) {
+    if (!ordered) {
+        completed.push_back(std::move(data));
+        return;
+    }
+    if (message < m_nextOrderedDelivery)
+        return;
+    if (message > m_nextOrderedDelivery) {
+        m_bufferedBytes += data.size();
+        m_readyOrdered.emplace(message, std::move(data));
+        return;
+    }
+
+    completed.push_back(std::move(data));
+    ++m_nextOrderedDelivery;
+    for (auto next = m_readyOrdered.begin();
+         next != m_readyOrdered.end() && next->first == m_nextOrderedDelivery;
+         next = m_readyOrdered.erase(next)) {
+        m_bufferedBytes -= next->second.size();
+        completed.push_back(std::move(next->second));
+        ++m_nextOrderedDelivery;
+    }
+}
@@ -0,0 +1,444 @@
+#include "network/reliable_multicast.h"
+
+#include <algorithm>
+
+using namespace ReliableMulticast;
+
+// Helper functions
+namespace {
+    // Datagram layout, all integers in network byte order:
+    //   u8 magic, u8 version, u8 type, u8 reserved, u32 session, u64 sequence, u64 trail
+    // followed by the message for DATA and RDATA, or by (u64 first, u32 count) ranges for NACK
+    // and NCF. `sequence` is the message's number, or for SPM the next one to be sent. `trail`
+    // is the oldest message the sender can still repair.
+    constexpr uint8_t MAGIC = 0xFE;     // Never the first byte of UTF-8 text
+    constexpr uint8_t VERSION = 1;
+    constexpr size_t RANGE_SIZE = 12;
+
+    enum class Type : uint8_t {
+        Data = 1,       // Original transmission
+        Repair = 2,     // RDATA: a retransmission
+        Heartbeat = 3,  // SPM: window edges while idle
+        Nack = 4,       // Receiver to sender
+        Confirm = 5     // NCF: the sender heard a NACK for these ranges
+    };
+
+    struct Header {
+        Type type;
+        uint32_t session;
+        uint64_t sequence;
+        uint64_t trail;
+    };
+
+    void PutU32(std::vector<std::byte>& out, uint32_t value) {
+        out.push_back(std::byte(value >> 24));
+        out.push_back(std::byte(value >> 16));
+        out.push_back(std::byte(value >> 8));
+        out.push_back(std::byte(value));
+    }
+
+    void PutU64(std::vector<std::byte>& out, uint64_t value) {
+        PutU32(out, static_cast<uint32_t>(value >> 32));
+        PutU32(out, static_cast<uint32_t>(value));
+    }
+
+    uint32_t GetU32(std::span<const std::byte> data, size_t offset) {
+        return (std::to_integer<uint32_t>(data[offset]) << 24) |
+               (std::to_integer<uint32_t>(data[offset + 1]) << 16) |
+               (std::to_integer<uint32_t>(data[offset + 2]) << 8) |
+               std::to_integer<uint32_t>(data[offset + 3]);
+    }
+
+    uint64_t GetU64(std::span<const std::byte> data, size_t offset) {
+        return (uint64_t{GetU32(data, offset)} << 32) | GetU32(data, offset + 4);
+    }
+
+    void PutHeader(std::vector<std::byte>& out, Type type, uint32_t session, uint64_t sequence, uint64_t trail) {
+        out.clear();
+        out.push_back(std::byte{MAGIC});
+        out.push_back(std::byte{VERSION});
+        out.push_back(std::byte(type));
+        out.push_back(std::byte{0});
+        PutU32(out, session);
+        PutU64(out, sequence);
+        PutU64(out, trail);
+    }
+
+    bool ParseHeader(std::span<const std::byte> datagram, Header& header) {
+        if (!IsMulticastDatagram(datagram))
+            return false;
+        const uint8_t type = std::to_integer<uint8_t>(datagram[2]);
+        if (type < static_cast<uint8_t>(Type::Data) || type > static_cast<uint8_t>(Type::Confirm))
+            return false;
+        header.type = static_cast<Type>(type);
+        header.session = GetU32(datagram, 4);
+        header.sequence = GetU64(datagram, 8);
+        header.trail = GetU64(datagram, 16);
+        return true;
+    }
+
+    // Sends the sequence numbers, which must be ascending, as NACK or NCF ranges, as many per
+    // datagram as the MTU allows
+    void SendRanges(const SendFunction& send, std::vector<std::byte>& scratch, size_t mtu, Type type,
+                    uint32_t session, uint64_t trail, const std::vector<uint64_t>& sequences) {
+        const size_t maxRanges = std::max<size_t>(1, (mtu - HEADER_SIZE) / RANGE_SIZE);
+        size_t i = 0;
+        while (i < sequences.size()) {
+            PutHeader(scratch, type, session, 0, trail);
+            for (size_t ranges = 0; ranges < maxRanges && i < sequences.size(); ++ranges) {
+                const uint64_t first = sequences[i];
+                uint32_t count = 1;
+                while (i + count < sequences.size() && sequences[i + count] == first + count && count < UINT32_MAX) {
+                    ++count;
+                }
+                PutU64(scratch, first);
+                PutU32(scratch, count);
+                i += count;
+            }
+            send(scratch);
+        }
+    }
+
+    uint32_t NewSession() {
+        std::random_device device;
+        std::mt19937 random(device() ^ static_cast<uint32_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count()));
+        uint32_t session = 0;
+        while (session == 0) {
+            session = random();
+        }
+        return session;
+    }
+}
+
+bool ReliableMulticast::IsMulticastDatagram(std::span<const std::byte> datagram) {
+    return datagram.size() >= HEADER_SIZE &&
+           std::to_integer<uint8_t>(datagram[0]) == MAGIC &&
+           std::to_integer<uint8_t>(datagram[1]) == VERSION;
+}
+
+// MulticastSender
+
+MulticastSender::MulticastSender(SendFunction sendToGroup, size_t window, size_t mtu, Clock::time_point now)
+    : m_send(std::move(sendToGroup)),
+      m_window(std::max<size_t>(window, 1)),
+      m_mtu(std::max(mtu, HEADER_SIZE + RANGE_SIZE)),
+      m_session(NewSession()),
+      m_lastSend(now),
+      m_heartbeatDelay(MIN_HEARTBEAT_INTERVAL) {
+    m_scratch.reserve(m_mtu);
+}
+
+bool MulticastSender::Send(std::span<const std::byte> message, Clock::time_point now) {
+    if (message.size() > GetMaxMessageSize())
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint64_t sequence = m_nextSequence++;
+    m_entries.push_back(Entry{std::vector<std::byte>(message.begin(), message.end()), now, false});
+    if (m_entries.size() > m_window) {
+        m_entries.pop_front();
+        ++m_trail;
+    }
+
+    PutHeader(m_scratch, Type::Data, m_session, sequence, m_trail);
+    m_scratch.insert(m_scratch.end(), message.begin(), message.end());
+    m_send(m_scratch);
+    ++m_stats.messagesSent;
+    m_lastSend = now;
+    m_heartbeatDelay = MIN_HEARTBEAT_INTERVAL;
+    return true;
+}
+
+bool MulticastSender::Receive(std::span<const std::byte> datagram, Clock::time_point now) {
+    Header header;
+    if (!ParseHeader(datagram, header) || header.type != Type::Nack || header.session != m_session)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.nacksReceived;
+
+    // Each message is repaired at most once per holdoff, however many receivers ask for it
+    std::vector<uint64_t> repairs;
+    bool tooLate = false;
+    for (size_t offset = HEADER_SIZE; offset + RANGE_SIZE <= datagram.size(); offset += RANGE_SIZE) {
+        const uint64_t first = GetU64(datagram, offset);
+        const uint64_t end = first + GetU32(datagram, offset + 8);
+        tooLate = tooLate || first < m_trail;
+        for (uint64_t sequence = std::max(first, m_trail); sequence < std::min(end, m_nextSequence); ++sequence) {
+            Entry& entry = m_entries[sequence - m_trail];
+            if (entry.repaired && now - entry.lastRepair < REPAIR_HOLDOFF) {
+                ++m_stats.nacksSuppressed;
+                continue;
+            }
+            entry.repaired = true;
+            entry.lastRepair = now;
+            repairs.push_back(sequence);
+        }
+    }
+    std::sort(repairs.begin(), repairs.end());
+    repairs.erase(std::unique(repairs.begin(), repairs.end()), repairs.end());
+
+    // The NCF goes first so that receivers still backing off hold their NACKs for the repairs
+    if (!repairs.empty()) {
+        SendConfirmations(repairs);
+    }
+    for (uint64_t sequence : repairs) {
+        const Entry& entry = m_entries[sequence - m_trail];
+        PutHeader(m_scratch, Type::Repair, m_session, sequence, m_trail);
+        m_scratch.insert(m_scratch.end(), entry.message.begin(), entry.message.end());
+        m_send(m_scratch);
+        ++m_stats.repairsSent;
+    }
+
+    // Whoever asked for messages already out of the window learns the trail and gives up on them
+    if (tooLate) {
+        ++m_stats.nacksTooLate;
+        if (repairs.empty()) {
+            SendHeartbeat(now);
+        }
+    }
+    return true;
+}
+
+void MulticastSender::Update(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (now - m_lastSend >= m_heartbeatDelay) {
+        SendHeartbeat(now);
+        m_heartbeatDelay = std::min<Clock::duration>(m_heartbeatDelay * 2, MAX_HEARTBEAT_INTERVAL);
+    }
+}
+
+uint64_t MulticastSender::GetNextSequence() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nextSequence;
+}
+
+MulticastSender::Stats MulticastSender::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void MulticastSender::SendHeartbeat(Clock::time_point now) {
+    PutHeader(m_scratch, Type::Heartbeat, m_session, m_nextSequence, m_trail);
+    m_send(m_scratch);
+    ++m_stats.heartbeatsSent;
+    m_lastSend = now;
+}
+
+void MulticastSender::SendConfirmations(const std::vector<uint64_t>& sequences) {
+    SendRanges([this](std::span<const std::byte> datagram) {
+        ++m_stats.confirmationsSent;
+        return m_send(datagram);
+    }, m_scratch, m_mtu, Type::Confirm, m_session, m_trail, sequences);
+}
+
+// MulticastReceiver
+
+MulticastReceiver::MulticastReceiver(SendFunction sendToSender, uint32_t seed)
+    : m_send(std::move(sendToSender)),
+      m_random(seed) {
+    m_scratch.reserve(DEFAULT_MTU);
+}
+
+bool MulticastReceiver::Receive(std::span<const std::byte> datagram, const MessageCallback& onMessage,
+                                Clock::time_point now) {
+    Header header;
+    if (!ParseHeader(datagram, header) || header.type == Type::Nack)
+        return false;
+
+    Delivery ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Lock onto the sender at its next original message or heartbeat; a new session means
+        // the sender restarted
+        if (!m_hasSession || header.session != m_session) {
+            if (header.type != Type::Data && header.type != Type::Heartbeat)
+                return true;
+            Reset(header.session, header.sequence);
+        }
+
+        GiveUpBefore(header.trail);
+        switch (header.type) {
+        case Type::Data:
+        case Type::Repair:
+            Announce(header.sequence + 1, now);
+            OnData(header.sequence, datagram.subspan(HEADER_SIZE), header.type == Type::Repair);
+            break;
+        case Type::Heartbeat:
+            Announce(header.sequence, now);
+            break;
+        case Type::Confirm:
+            for (size_t offset = HEADER_SIZE; offset + RANGE_SIZE <= datagram.size(); offset += RANGE_SIZE) {
+                const uint64_t first = GetU64(datagram, offset);
+                OnConfirm(first, first + GetU32(datagram, offset + 8), now);
+            }
+            break;
+        case Type::Nack:
+            break;
+        }
+
+        Collect();
+        ready.swap(m_ready);
+    }
+
+    for (const auto& [sequence, message] : ready) {
+        onMessage(sequence, message);
+    }
+    return true;
+}
+
+void MulticastReceiver::Update(const MessageCallback& onMessage, Clock::time_point now) {
+    Delivery ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SendNacks(now);
+        Collect();
+        ready.swap(m_ready);
+    }
+
+    for (const auto& [sequence, message] : ready) {
+        onMessage(sequence, message);
+    }
+}
+
+uint64_t MulticastReceiver::GetNextSequence() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_expected;
+}
+
+MulticastReceiver::Stats MulticastReceiver::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.missing = m_missing.size();
+    return stats;
+}
+
+void MulticastReceiver::Reset(uint32_t session, uint64_t start) {
+    m_hasSession = true;
+    m_session = session;
+    m_expected = start;
+    m_horizon = start;
+    m_held.clear();
+    m_missing.clear();
+    m_lost.clear();
+}
+
+// Sequence numbers below `next` were sent, so any of them not yet seen are missing. A hole found
+// by one datagram gets one backoff, so its NACK names it as a single range.
+void MulticastReceiver::Announce(uint64_t next, Clock::time_point now) {
+    if (next <= m_horizon)
+        return;
+    if (next - m_expected > MAX_TRACKED) {
+        SkipTo(next - MAX_TRACKED);
+    }
+
+    std::uniform_int_distribution<Clock::rep> backoff(0, std::chrono::duration_cast<Clock::duration>(NACK_BACKOFF).count());
+    const Clock::time_point deadline = now + Clock::duration(backoff(m_random));
+    for (uint64_t sequence = m_horizon; sequence < next; ++sequence) {
+        m_missing.emplace(sequence, Missing{NackState::Backoff, deadline, 0});
+    }
+    m_horizon = next;
+}
+
+void MulticastReceiver::OnData(uint64_t sequence, std::span<const std::byte> message, bool repair) {
+    auto missing = m_missing.find(sequence);
+    if (missing != m_missing.end()) {
+        m_missing.erase(missing);
+        if (repair) {
+            ++m_stats.messagesRepaired;
+        }
+    } else if (m_lost.erase(sequence)) {
+        // Repaired after all, just before delivery would have skipped it
+        ++m_stats.messagesRepaired;
+    } else {
+        ++m_stats.duplicates;
+        return;
+    }
+    m_held.emplace(sequence, std::vector<std::byte>(message.begin(), message.end()));
+}
+
+// Another receiver asked for these: wait for the repair instead of asking as well
+void MulticastReceiver::OnConfirm(uint64_t first, uint64_t end, Clock::time_point now) {
+    for (auto it = m_missing.lower_bound(first); it != m_missing.end() && it->first < end; ++it) {
+        Missing& missing = it->second;
+        if (missing.state == NackState::Backoff) {
+            ++m_stats.nacksSuppressed;
+        }
+        missing.state = NackState::Confirmed;
+        missing.deadline = now + REPAIR_WAIT;
+    }
+}
+
+// The sender can no longer repair anything before its trail
+void MulticastReceiver::GiveUpBefore(uint64_t trail) {
+    if (trail > m_horizon) {
+        SkipTo(trail);
+        return;
+    }
+    while (!m_missing.empty() && m_missing.begin()->first < trail) {
+        m_lost.insert(m_missing.begin()->first);
+        m_missing.erase(m_missing.begin());
+    }
+}
+
+// Gives up on everything missing, delivers what is held, and moves the horizon (and with it the
+// next sequence number to deliver) up to `sequence`, counting the messages never seen as lost
+void MulticastReceiver::SkipTo(uint64_t sequence) {
+    for (const auto& entry : m_missing) {
+        m_lost.insert(entry.first);
+    }
+    m_missing.clear();
+    Collect();
+    if (sequence > m_horizon) {
+        m_stats.messagesLost += sequence - m_horizon;
+        m_expected = sequence;
+        m_horizon = sequence;
+    }
+}
+
+void MulticastReceiver::SendNacks(Clock::time_point now) {
+    std::vector<uint64_t> due;
+    for (auto it = m_missing.begin(); it != m_missing.end();) {
+        Missing& missing = it->second;
+        if (now < missing.deadline) {
+            ++it;
+            continue;
+        }
+        if (missing.attempts >= MAX_NACK_ATTEMPTS) {
+            m_lost.insert(it->first);
+            it = m_missing.erase(it);
+            continue;
+        }
+        ++missing.attempts;
+        missing.state = NackState::Requested;
+        missing.deadline = now + NACK_REPEAT;
+        due.push_back(it->first);
+        ++it;
+    }
+
+    if (!due.empty()) {
+        SendRanges([this](std::span<const std::byte> datagram) {
+            ++m_stats.nacksSent;
+            return m_send(datagram);
+        }, m_scratch, DEFAULT_MTU, Type::Nack, m_session, 0, due);
+    }
+}
+
+// Moves what can be delivered in order to m_ready, skipping messages given up on
+void MulticastReceiver::Collect() {
+    while (m_expected < m_horizon) {
+        auto held = m_held.find(m_expected);
+        if (held != m_held.end()) {
+            m_ready.emplace_back(m_expected, std::move(held->second));
+            m_held.erase(held);
+            ++m_stats.messagesDelivered;
+        } else if (m_lost.erase(m_expected)) {
+            ++m_stats.messagesLost;
+        } else {
+            break;
+        }
+        ++m_expected;
+    }
+}
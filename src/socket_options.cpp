@@ -15,6 +15,11 @@
     #include <arpa/inet.h>
     #include <fcntl.h>
     #include <cstring> // For memset
+    #include <cstddef> // For offsetof
+    #include <ctime>
+    #ifdef __linux__
+    #include <linux/net_tstamp.h>
+    #endif
 #endif
 
 namespace SocketOptions {
@@ -44,6 +49,84 @@ namespace {
         return len;
     }
     #endif
+
+    #ifdef __linux__
+    // The kernel's struct tcp_info. glibc's copy stops at tcpi_total_retrans and <linux/tcp.h>
+    // clashes with <netinet/tcp.h>, so the layout is spelled out here. The kernel only ever
+    // appends fields and copies as much as both sides know, so older kernels leave the tail zero.
+    struct LinuxTcpInfo {
+        uint8_t state;
+        uint8_t caState;
+        uint8_t retransmits;
+        uint8_t probes;
+        uint8_t backoff;
+        uint8_t options;
+        uint8_t windowScales;
+        uint8_t deliveryRateAppLimited : 1, fastOpenClientFail : 2;
+
+        uint32_t rto;
+        uint32_t ato;
+        uint32_t sendMss;
+        uint32_t receiveMss;
+
+        uint32_t unacked;
+        uint32_t sacked;
+        uint32_t lost;
+        uint32_t retrans;
+        uint32_t fackets;
+
+        uint32_t lastDataSent;
+        uint32_t lastAckSent;
+        uint32_t lastDataReceived;
+        uint32_t lastAckReceived;
+
+        uint32_t pmtu;
+        uint32_t receiveSlowStartThreshold;
+        uint32_t rtt;
+        uint32_t rttVariance;
+        uint32_t sendSlowStartThreshold;
+        uint32_t sendCongestionWindow;
+        uint32_t advertisedMss;
+        uint32_t reordering;
+
+        uint32_t receiveRtt;
+        uint32_t receiveSpace;
+
+        uint32_t totalRetransmits;
+
+        uint64_t pacingRate;
+        uint64_t maxPacingRate;
+        uint64_t bytesAcked;
+        uint64_t bytesReceived;
+        uint32_t segmentsOut;
+        uint32_t segmentsIn;
+
+        uint32_t notSentBytes;
+        uint32_t minRtt;
+        uint32_t dataSegmentsIn;
+        uint32_t dataSegmentsOut;
+
+        uint64_t deliveryRate;
+
+        uint64_t busyTime;
+        uint64_t receiveWindowLimited;
+        uint64_t sendBufferLimited;
+
+        uint32_t delivered;
+        uint32_t deliveredCe;
+
+        uint64_t bytesSent;
+        uint64_t bytesRetransmitted;
+        uint32_t dsackDups;
+        uint32_t reorderSeen;
+
+        uint32_t receiveOutOfOrderPackets;
+
+        uint32_t sendWindow;
+    };
+    static_assert(offsetof(LinuxTcpInfo, deliveryRate) == 160 && sizeof(LinuxTcpInfo) == 232,
+                  "LinuxTcpInfo must match the kernel's struct tcp_info");
+    #endif
 }
 
 // SOL_SOCKET level options implementation
@@ -163,6 +246,21 @@ bool SetSendLowWatermark(ISocketBase* socket, int bytes) {
     return SocketUtils::SetSocketOption<int>(socket, SOL_SOCKET, SO_SNDLOWAT, bytes);
 }
 
+// IPPROTO_IP level options implementation
+bool SetMulticastInterface(ISocketBase* socket, const std::string& interfaceAddress) {
+    if (!socket) return false;
+
+    in_addr address = {};
+    if (inet_pton(AF_INET, interfaceAddress.c_str(), &address) != 1) return false;
+    return SocketUtils::SetSocketOption<in_addr>(socket, IPPROTO_IP, IP_MULTICAST_IF, address);
+}
+
+bool SetMulticastTtl(ISocketBase* socket, int ttl) {
+    if (!socket) return false;
+
+    return SocketUtils::SetSocketOption<int>(socket, IPPROTO_IP, IP_MULTICAST_TTL, ttl);
+}
+
 bool GetError(ISocketBase* socket, int& errorCode) {
     if (!socket) return false;
 
@@ -184,6 +282,73 @@ bool GetAcceptConn(ISocketBase* socket, bool& isListening) {
     return success;
 }
 
+bool GetTcpInfo(ISocketBase* socket, TcpInfo& info) {
+    if (!socket) return false;
+
+    using std::chrono::microseconds;
+    info = TcpInfo();
+
+    #if defined(__linux__)
+    LinuxTcpInfo raw = {};
+    socklen_t len = sizeof(raw);
+    if (!SocketUtils::GetSocketOptionBuffer(socket, IPPROTO_TCP, TCP_INFO, reinterpret_cast<char*>(&raw), len))
+        return false;
+
+    info.state = raw.state;
+    info.rtt = microseconds(raw.rtt);
+    info.rttVariance = microseconds(raw.rttVariance);
+    info.minRtt = microseconds(raw.minRtt);
+    info.retransmitTimeout = microseconds(raw.rto);
+    info.mss = raw.sendMss;
+    info.congestionWindow = raw.sendCongestionWindow;
+    info.slowStartThreshold = raw.sendSlowStartThreshold;
+    info.peerReceiveWindow = raw.sendWindow;
+    info.unackedSegments = raw.unacked;
+    info.lostSegments = raw.lost;
+    info.retransmits = raw.totalRetransmits;
+    // The kernel's tcp_packets_in_flight(): sent, less what was sacked or is presumed lost, plus retransmissions
+    uint32_t leftNetwork = raw.sacked + raw.lost;
+    uint32_t segmentsInFlight = (raw.unacked > leftNetwork ? raw.unacked - leftNetwork : 0) + raw.retrans;
+    info.bytesInFlight = static_cast<uint64_t>(segmentsInFlight) * raw.sendMss;
+    info.notSentBytes = raw.notSentBytes;
+    info.bytesSent = raw.bytesSent;
+    info.bytesRetransmitted = raw.bytesRetransmitted;
+    info.bytesAcked = raw.bytesAcked;
+    info.bytesReceived = raw.bytesReceived;
+    info.pacingRate = raw.pacingRate == ~uint64_t{0} ? 0 : raw.pacingRate;
+    info.deliveryRate = raw.deliveryRate;
+    info.deliveryRateAppLimited = raw.deliveryRateAppLimited != 0;
+    info.busyTime = microseconds(raw.busyTime);
+    info.receiveWindowLimitedTime = microseconds(raw.receiveWindowLimited);
+    info.sendBufferLimitedTime = microseconds(raw.sendBufferLimited);
+    return true;
+    #elif defined(__APPLE__)
+    tcp_connection_info raw = {};
+    socklen_t len = sizeof(raw);
+    if (!SocketUtils::GetSocketOptionBuffer(socket, IPPROTO_TCP, TCP_CONNECTION_INFO, reinterpret_cast<char*>(&raw), len))
+        return false;
+
+    // Darwin reports times in milliseconds and has no rate or limit accounting
+    using std::chrono::milliseconds;
+    info.state = raw.tcpi_state;
+    info.rtt = std::chrono::duration_cast<microseconds>(milliseconds(raw.tcpi_srtt));
+    info.rttVariance = std::chrono::duration_cast<microseconds>(milliseconds(raw.tcpi_rttvar));
+    info.retransmitTimeout = std::chrono::duration_cast<microseconds>(milliseconds(raw.tcpi_rto));
+    info.mss = raw.tcpi_maxseg;
+    info.congestionWindow = raw.tcpi_maxseg ? raw.tcpi_snd_cwnd / raw.tcpi_maxseg : 0;
+    info.slowStartThreshold = raw.tcpi_maxseg ? raw.tcpi_snd_ssthresh / raw.tcpi_maxseg : 0;
+    info.peerReceiveWindow = raw.tcpi_snd_wnd;
+    info.retransmits = static_cast<uint32_t>(raw.tcpi_txretransmitpackets);
+    info.notSentBytes = raw.tcpi_snd_sbbytes;
+    info.bytesSent = raw.tcpi_txbytes;
+    info.bytesRetransmitted = raw.tcpi_txretransmitbytes;
+    info.bytesReceived = raw.tcpi_rxbytes;
+    return true;
+    #else
+    return false; // Windows exposes this through WSAIoctl(SIO_TCP_INFO), not a socket option
+    #endif
+}
+
 bool BindToDevice(ISocketBase* socket, const std::string& interfaceName) {
     if (!socket) return false;
 
@@ -208,6 +373,31 @@ bool SetPriority(ISocketBase* socket, int priority) {
     #endif
 }
 
+bool SetMaxPacingRate(ISocketBase* socket, uint64_t bytesPerSecond) {
+    if (!socket) return false;
+
+    #ifdef __linux__
+    // The kernel reads a 64-bit rate when given one; all ones means unlimited
+    uint64_t rate = bytesPerSecond == 0 ? ~uint64_t{0} : bytesPerSecond;
+    return SocketUtils::SetSocketOption<uint64_t>(socket, SOL_SOCKET, SO_MAX_PACING_RATE, rate);
+    #else
+    (void)bytesPerSecond; // Avoid unused parameter warning
+    return false; // Only Linux paces sockets in the kernel
+    #endif
+}
+
+bool EnableTxTime(ISocketBase* socket) {
+    if (!socket) return false;
+
+    #ifdef __linux__
+    sock_txtime txtime = {};
+    txtime.clockid = CLOCK_MONOTONIC;   // The clock behind std::chrono::steady_clock
+    return SocketUtils::SetSocketOption<sock_txtime>(socket, SOL_SOCKET, SO_TXTIME, txtime);
+    #else
+    return false; // SO_TXTIME is Linux-only
+    #endif
+}
+
 // Raw buffer operations implementation
 bool SetRawOption(ISocketBase* socket, int level, int optionName, const char* buffer, size_t bufferSize) {
     if (!socket || !buffer) return false;
@@ -0,0 +1,154 @@
+#include "network/socket_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+// Helper functions
+namespace {
+    void Add(SocketStats::Histogram& into, const SocketStats::Histogram& from) {
+        for (size_t i = 0; i < SocketStats::HISTOGRAM_BUCKETS; ++i) {
+            into.buckets[i] += from.buckets[i];
+        }
+    }
+}
+
+// SocketStats::Histogram
+
+uint64_t SocketStats::Histogram::GetCount() const {
+    uint64_t count = 0;
+    for (uint64_t bucket : buckets) {
+        count += bucket;
+    }
+    return count;
+}
+
+uint64_t SocketStats::Histogram::GetPercentile(double fraction) const {
+    const uint64_t count = GetCount();
+    if (count == 0)
+        return 0;
+
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= target)
+            return BucketUpperBound(i);
+    }
+    return BucketUpperBound(HISTOGRAM_BUCKETS - 1);
+}
+
+size_t SocketStats::Histogram::BucketFor(uint64_t value) {
+    return std::min<size_t>(static_cast<size_t>(std::bit_width(value)), HISTOGRAM_BUCKETS - 1);
+}
+
+uint64_t SocketStats::Histogram::BucketUpperBound(size_t bucket) {
+    if (bucket >= HISTOGRAM_BUCKETS - 1)
+        return std::numeric_limits<uint64_t>::max();
+    return (uint64_t{1} << bucket) - 1;
+}
+
+// SocketStats::Counters / Snapshot
+
+SocketStats::Counters& SocketStats::Counters::operator+=(const Counters& other) {
+    calls += other.calls;
+    bytes += other.bytes;
+    shortTransfers += other.shortTransfers;
+    wouldBlock += other.wouldBlock;
+    errors += other.errors;
+    Add(durationNs, other.durationNs);
+    Add(bytesPerCall, other.bytesPerCall);
+    return *this;
+}
+
+SocketStats::Snapshot& SocketStats::Snapshot::operator+=(const Snapshot& other) {
+    send += other.send;
+    receive += other.receive;
+    return *this;
+}
+
+// SocketStats
+
+void SocketStats::Record(Direction direction, size_t requested, long long result, bool wouldBlock,
+                         Clock::duration elapsed) {
+    AtomicCounters& counters = direction == Direction::Send ? m_send : m_receive;
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    counters.calls.fetch_add(1, relaxed);
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    counters.durationNs[Histogram::BucketFor(ns > 0 ? static_cast<uint64_t>(ns) : 0)].fetch_add(1, relaxed);
+
+    if (result < 0) {
+        (wouldBlock ? counters.wouldBlock : counters.errors).fetch_add(1, relaxed);
+        return;
+    }
+
+    const uint64_t bytes = static_cast<uint64_t>(result);
+    counters.bytes.fetch_add(bytes, relaxed);
+    counters.bytesPerCall[Histogram::BucketFor(bytes)].fetch_add(1, relaxed);
+    if (bytes < requested) {
+        counters.shortTransfers.fetch_add(1, relaxed);
+    }
+}
+
+SocketStats::Snapshot SocketStats::GetSnapshot() const {
+    Snapshot snapshot;
+    m_send.Load(snapshot.send);
+    m_receive.Load(snapshot.receive);
+    return snapshot;
+}
+
+void SocketStats::AtomicCounters::Load(Counters& counters) const {
+    constexpr auto relaxed = std::memory_order_relaxed;
+    counters.calls = calls.load(relaxed);
+    counters.bytes = bytes.load(relaxed);
+    counters.shortTransfers = shortTransfers.load(relaxed);
+    counters.wouldBlock = wouldBlock.load(relaxed);
+    counters.errors = errors.load(relaxed);
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        counters.durationNs.buckets[i] = durationNs[i].load(relaxed);
+        counters.bytesPerCall.buckets[i] = bytesPerCall[i].load(relaxed);
+    }
+}
+
+// SocketStatsGroup
+
+std::shared_ptr<SocketStats> SocketStatsGroup::Create() {
+    auto stats = std::make_shared<SocketStats>();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Pruning whenever the list doubles keeps servers with many short connections from growing
+    // it without bound, at amortised constant cost per socket
+    if (m_members.size() >= m_pruneAt) {
+        Prune();
+        m_pruneAt = std::max<size_t>(64, m_members.size() * 2);
+    }
+    m_members.push_back(stats);
+    return stats;
+}
+
+SocketStats::Snapshot SocketStatsGroup::GetSnapshot() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Prune();
+    SocketStats::Snapshot total = m_closed;
+    for (const auto& member : m_members) {
+        total += member->GetSnapshot();
+    }
+    return total;
+}
+
+size_t SocketStatsGroup::GetSocketCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Prune();
+    return m_members.size();
+}
+
+void SocketStatsGroup::Prune() const {
+    auto closed = std::stable_partition(m_members.begin(), m_members.end(),
+                                        [](const auto& member) { return member.use_count() > 1; });
+    for (auto it = closed; it != m_members.end(); ++it) {
+        m_closed += (*it)->GetSnapshot();
+    }
+    m_members.erase(closed, m_members.end());
+}
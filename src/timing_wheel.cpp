@@ -0,0 +1,227 @@
+#include "network/timing_wheel.h"
+
+#include <algorithm>
+#include <utility>
+
+// Helper functions
+namespace {
+    constexpr uint64_t LEVEL0_SIZE = 256;
+    constexpr uint64_t LEVEL_SIZE = 64;
+
+    // Bit position of a level's slot number within an absolute tick
+    constexpr unsigned LevelShift(unsigned level) {
+        return level == 0 ? 0 : 8 + (level - 1) * 6;
+    }
+}
+
+TimingWheel::TimingWheel(std::chrono::milliseconds tick, Clock::time_point start)
+    : m_tick(std::max(tick, std::chrono::milliseconds(1))),
+      m_start(start) {
+    m_slots.fill(NIL);
+}
+
+TimingWheel::TimerId TimingWheel::Schedule(std::chrono::milliseconds delay, Callback callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    uint32_t index;
+    if (m_freeList != NIL) {
+        index = m_freeList;
+        m_freeList = m_nodes[index].next;
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[index];
+    node.expiry = m_currentTick + TicksFor(delay);
+    node.callback = std::move(callback);
+    Link(index);
+    ++m_pending;
+    return (static_cast<TimerId>(node.generation) << 32) | (index + 1);
+}
+
+bool TimingWheel::Cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = NodeFor(id);
+    if (index == NIL)
+        return false;
+
+    Unlink(index);
+    Release(index);
+    return true;
+}
+
+bool TimingWheel::Rearm(TimerId id, std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = NodeFor(id);
+    if (index == NIL)
+        return false;
+
+    Unlink(index);
+    m_nodes[index].expiry = m_currentTick + TicksFor(delay);
+    Link(index);
+    return true;
+}
+
+size_t TimingWheel::Advance(Clock::time_point now) {
+    std::vector<Callback> due;
+    size_t fired = 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (now <= m_start)
+        return 0;
+    const uint64_t target = static_cast<uint64_t>((now - m_start) / m_tick);
+
+    while (m_currentTick < target) {
+        if (m_pending == 0) {
+            m_currentTick = target;
+            break;
+        }
+        // Nothing due on the innermost level: skip straight to the end of its turn
+        if (m_level0Count == 0) {
+            m_currentTick = std::min(target - 1, m_currentTick | (LEVEL0_SIZE - 1));
+        }
+        ++m_currentTick;
+
+        // Entering a new turn of a level pulls the next slot of the level above down, and so on up
+        for (unsigned level = 1; level < LEVELS; ++level) {
+            if (!Cascade(level))
+                break;
+        }
+        CollectDue(due);
+        if (due.empty())
+            continue;
+
+        // Run each tick's callbacks before the next tick, so timers they schedule count from it
+        lock.unlock();
+        for (Callback& callback : due) {
+            callback();
+        }
+        fired += due.size();
+        due.clear();
+        lock.lock();
+    }
+    return fired;
+}
+
+uint64_t TimingWheel::GetCurrentTick() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_currentTick;
+}
+
+size_t TimingWheel::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending;
+}
+
+uint64_t TimingWheel::TicksFor(std::chrono::milliseconds delay) const {
+    if (delay <= m_tick)
+        return 1;
+    return static_cast<uint64_t>((delay + m_tick - std::chrono::milliseconds(1)) / m_tick);
+}
+
+uint32_t TimingWheel::NodeFor(TimerId id) const {
+    uint64_t slotNumber = id & UINT32_MAX;
+    if (slotNumber == 0 || slotNumber > m_nodes.size())
+        return NIL;
+
+    uint32_t index = static_cast<uint32_t>(slotNumber - 1);
+    const Node& node = m_nodes[index];
+    if (node.slot == NIL || node.generation != static_cast<uint32_t>(id >> 32))
+        return NIL;
+    return index;
+}
+
+void TimingWheel::Link(uint32_t index) {
+    Node& node = m_nodes[index];
+    uint64_t expiry = std::max(node.expiry, m_currentTick);
+    uint64_t delta = expiry - m_currentTick;
+
+    // Beyond the top level's reach: park in its farthest slot and re-place when that comes up
+    if (delta > MAX_DELAY_TICKS) {
+        expiry = m_currentTick + MAX_DELAY_TICKS;
+        delta = MAX_DELAY_TICKS;
+    }
+
+    uint32_t slot;
+    if (delta < LEVEL0_SIZE) {
+        slot = static_cast<uint32_t>(expiry & (LEVEL0_SIZE - 1));
+    } else {
+        unsigned level = 1;
+        while (level < LEVELS - 1 && delta >= (uint64_t{1} << LevelShift(level + 1))) {
+            ++level;
+        }
+        slot = static_cast<uint32_t>(LEVEL0_SIZE + (level - 1) * LEVEL_SIZE +
+                                     ((expiry >> LevelShift(level)) & (LEVEL_SIZE - 1)));
+    }
+
+    if (slot < LEVEL0_SIZE) {
+        ++m_level0Count;
+    }
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = m_slots[slot];
+    if (node.next != NIL) {
+        m_nodes[node.next].prev = index;
+    }
+    m_slots[slot] = index;
+}
+
+void TimingWheel::Unlink(uint32_t index) {
+    Node& node = m_nodes[index];
+    if (node.prev != NIL) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_slots[node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.prev = NIL;
+    node.next = NIL;
+    if (node.slot < LEVEL0_SIZE) {
+        --m_level0Count;
+    }
+}
+
+void TimingWheel::Release(uint32_t index) {
+    Node& node = m_nodes[index];
+    node.callback = nullptr;
+    node.slot = NIL;
+    ++node.generation;
+    node.next = m_freeList;
+    m_freeList = index;
+    --m_pending;
+}
+
+// Re-places the timers of the level's current slot if the tick starts a new turn of the level
+// below it. Returns true if the level itself wrapped, so the level above must cascade too.
+bool TimingWheel::Cascade(unsigned level) {
+    const unsigned shift = LevelShift(level);
+    if ((m_currentTick & ((uint64_t{1} << shift) - 1)) != 0)
+        return false;
+
+    const uint64_t slotNumber = (m_currentTick >> shift) & (LEVEL_SIZE - 1);
+    const size_t slot = LEVEL0_SIZE + (level - 1) * LEVEL_SIZE + slotNumber;
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = NIL;
+    while (index != NIL) {
+        uint32_t next = m_nodes[index].next;
+        Link(index);
+        index = next;
+    }
+    return slotNumber == 0;
+}
+
+void TimingWheel::CollectDue(std::vector<Callback>& due) {
+    const size_t slot = static_cast<size_t>(m_currentTick & (LEVEL0_SIZE - 1));
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = NIL;
+    while (index != NIL) {
+        uint32_t next = m_nodes[index].next;
+        due.push_back(std::move(m_nodes[index].callback));
+        Release(index);
+        --m_level0Count;
+        index = next;
+    }
+}
@@ -0,0 +1,85 @@
+#include "network/token_bucket.h"
+
+#include <algorithm>
+#include <thread>
+
+// Helper functions
+namespace {
+    TokenBucket::Clock::duration Nanoseconds(double count) {
+        return std::chrono::duration_cast<TokenBucket::Clock::duration>(
+            std::chrono::duration<double, std::nano>(count));
+    }
+}
+
+TokenBucket::TokenBucket(Rate rate, Clock::time_point now) {
+    m_bytes.theoreticalArrival = now;
+    m_packets.theoreticalArrival = now;
+    SetRate(rate);
+}
+
+TokenBucket::Clock::time_point TokenBucket::Reserve(size_t bytes, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Clock::time_point start = EarliestStart(bytes, now);
+    Book(bytes, start);
+    return start;
+}
+
+bool TokenBucket::TryConsume(size_t bytes, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (EarliestStart(bytes, now) > now)
+        return false;
+
+    Book(bytes, now);
+    return true;
+}
+
+void TokenBucket::Wait(size_t bytes) {
+    Clock::time_point start = Reserve(bytes);
+    if (start > Clock::now()) {
+        std::this_thread::sleep_until(start);
+    }
+}
+
+void TokenBucket::SetRate(Rate rate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rate = rate;
+    Configure(m_bytes, rate.bytesPerSecond, rate.burstBytes, DEFAULT_BURST_BYTES);
+    Configure(m_packets, rate.packetsPerSecond, rate.burstPackets, 1);
+}
+
+TokenBucket::Rate TokenBucket::GetRate() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rate;
+}
+
+void TokenBucket::Configure(Limit& limit, uint64_t perSecond, size_t burst, size_t defaultBurst) {
+    limit.enabled = perSecond > 0;
+    limit.interval = limit.enabled ? 1e9 / static_cast<double>(perSecond) : 0;
+    limit.burst = static_cast<double>(burst > 0 ? burst : defaultBurst);
+}
+
+// The send fits once the bucket holds its units, i.e. once the schedule is no more than
+// (burst - units) ahead. A send larger than the burst waits for a full bucket and overdraws it.
+TokenBucket::Clock::time_point TokenBucket::EarliestStart(const Limit& limit, double units, Clock::time_point now) {
+    if (!limit.enabled)
+        return now;
+
+    double slack = std::max(limit.burst - units, 0.0);
+    return std::max(now, limit.theoreticalArrival - Nanoseconds(slack * limit.interval));
+}
+
+void TokenBucket::Book(Limit& limit, double units, Clock::time_point start) {
+    if (!limit.enabled)
+        return;
+
+    limit.theoreticalArrival = std::max(limit.theoreticalArrival, start) + Nanoseconds(units * limit.interval);
+}
+
+TokenBucket::Clock::time_point TokenBucket::EarliestStart(size_t bytes, Clock::time_point now) const {
+    return std::max(EarliestStart(m_bytes, static_cast<double>(bytes), now), EarliestStart(m_packets, 1, now));
+}
+
+void TokenBucket::Book(size_t bytes, Clock::time_point start) {
+    Book(m_bytes, static_cast<double>(bytes), start);
+    Book(m_packets, 1, start);
+}
@@ -6,8 +6,14 @@
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <stdexcept>
@@ -19,6 +25,15 @@
 
 // Helper functions
 namespace {
+    // Maximum number of bytes read by the vector-based Receive/ReceiveFrom overloads
+    constexpr size_t DEFAULT_RECEIVE_SIZE = 4096;
+
+    // Buffers passed to one sendmsg call (well below IOV_MAX on every supported platform)
+    constexpr size_t MAX_SEND_BUFFERS = 64;
+
+    // Datagrams passed to one sendmmsg call (the kernel's UIO_MAXIOV limit)
+    constexpr size_t MAX_SEND_DATAGRAMS = 1024;
+
     // Convert NetworkAddress to sockaddr_in
     sockaddr_in CreateSockAddr(const NetworkAddress& address) {
         sockaddr_in result = {};
@@ -28,6 +43,27 @@ namespace {
         return result;
     }
 
+    // Convert a packed IPv4 key to sockaddr_in without going through text
+    sockaddr_in CreateSockAddr(const AddressKey& key) {
+        sockaddr_in result = {};
+        result.sin_family = AF_INET;
+        result.sin_port = htons(key.GetPort());
+        result.sin_addr.s_addr = htonl(key.GetIPv4());
+        return result;
+    }
+
+    // Group and interface for IP_ADD_MEMBERSHIP/IP_DROP_MEMBERSHIP; an empty interface lets the
+    // kernel choose one
+    bool CreateMembership(const NetworkAddress& group, const std::string& interfaceAddress, ip_mreq& mreq) {
+        if (inet_pton(AF_INET, group.ipAddress.c_str(), &mreq.imr_multiaddr) != 1)
+            return false;
+        if (interfaceAddress.empty()) {
+            mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+            return true;
+        }
+        return inet_pton(AF_INET, interfaceAddress.c_str(), &mreq.imr_interface) == 1;
+    }
+
     // Convert sockaddr_in to NetworkAddress
     NetworkAddress CreateNetworkAddress(const sockaddr_in& sockAddr) {
         char ipStr[INET_ADDRSTRLEN];
@@ -35,6 +71,56 @@ namespace {
         return NetworkAddress(ipStr, ntohs(sockAddr.sin_port));
     }
 
+    // Readiness events fetched by one epoll_wait call
+    constexpr size_t MAX_POLL_EVENTS = 256;
+
+    // Set or clear O_NONBLOCK on a descriptor
+    bool SetFdNonBlocking(int socketFd, bool enable) {
+        if (socketFd == -1)
+            return false;
+
+        int flags = fcntl(socketFd, F_GETFL, 0);
+        if (flags == -1)
+            return false;
+
+        flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+        return (fcntl(socketFd, F_SETFL, flags) == 0);
+    }
+
+    // Descriptor of a socket created by the Unix factory (possibly wrapped by decorators), or -1
+    // for any other implementation
+    int GetNativeHandle(const ISocketBase& wrapped) {
+        const ISocketBase& socket = wrapped.GetUnderlyingSocket();
+        if (auto* tcpSocket = dynamic_cast<const UnixTcpSocket*>(&socket))
+            return tcpSocket->GetNativeHandle();
+        if (auto* tcpListener = dynamic_cast<const UnixTcpListener*>(&socket))
+            return tcpListener->GetNativeHandle();
+        if (auto* udpSocket = dynamic_cast<const UnixUdpSocket*>(&socket))
+            return udpSocket->GetNativeHandle();
+        return -1;
+    }
+
+    // Records one send or receive system call that began at `start`, leaving errno as the call set it
+    void RecordCall(SocketStats& stats, SocketStats::Direction direction, size_t requested,
+                    long long result, SocketStats::Clock::time_point start) {
+        const int savedErrno = errno;
+        const bool wouldBlock = result < 0 && (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK);
+        stats.Record(direction, requested, result, wouldBlock, SocketStats::Clock::now() - start);
+        errno = savedErrno;
+    }
+
+    // Runs one system call, timed into `stats` if the socket has them; without stats the clock
+    // is not read at all
+    template <typename Call>
+    auto CountedCall(SocketStats* stats, SocketStats::Direction direction, size_t requested, Call&& call) {
+        if (!stats)
+            return call();
+        const auto start = SocketStats::Clock::now();
+        auto result = call();
+        RecordCall(*stats, direction, requested, result, start);
+        return result;
+    }
+
     // Get socket address
     bool GetSockAddr(int socketFd, sockaddr_in& address, bool local) {
         sockaddr_in addr = {};
@@ -169,25 +255,63 @@ bool UnixTcpSocket::Connect(const NetworkAddress& remoteAddress) {
 }
 
 int UnixTcpSocket::Send(const std::vector<std::byte>& data) {
+    return Send(std::span<const std::byte>(data));
+}
+
+int UnixTcpSocket::Receive(std::vector<std::byte>& buffer) {
+    // Receive straight into the caller's vector; once its capacity is warm this does not allocate
+    const size_t originalSize = buffer.size();
+    buffer.resize(std::max(originalSize, DEFAULT_RECEIVE_SIZE));
+    
+    int bytesRead = Receive(std::span<std::byte>(buffer.data(), DEFAULT_RECEIVE_SIZE));
+    buffer.resize(bytesRead > 0 ? static_cast<size_t>(bytesRead) : originalSize);
+    
+    return bytesRead;
+}
+
+int UnixTcpSocket::Send(std::span<const std::byte> data) {
     if (m_socketFd == -1 || !m_isConnected)
         return -1;
 
-    return send(m_socketFd, reinterpret_cast<const char*>(data.data()), data.size(), 0);
+    return CountedCall(m_stats.get(), SocketStats::Direction::Send, data.size(), [&] {
+        return send(m_socketFd, reinterpret_cast<const char*>(data.data()), data.size(), 0);
+    });
 }
 
-int UnixTcpSocket::Receive(std::vector<std::byte>& buffer) {
+int UnixTcpSocket::SendVectored(std::span<const std::span<const std::byte>> buffers) {
     if (m_socketFd == -1 || !m_isConnected)
         return -1;
 
-    const int bufferSize = 4096;
-    std::vector<std::byte> tempBuffer(bufferSize);
-    
-    int bytesRead = recv(m_socketFd, reinterpret_cast<char*>(tempBuffer.data()), bufferSize, 0);
-    if (bytesRead > 0) {
-        buffer.assign(tempBuffer.begin(), tempBuffer.begin() + bytesRead);
+    iovec iov[MAX_SEND_BUFFERS];
+    size_t count = 0;
+    size_t total = 0;
+    for (std::span<const std::byte> buffer : buffers) {
+        if (count == MAX_SEND_BUFFERS)
+            break;
+        if (buffer.empty())
+            continue;
+        iov[count].iov_base = const_cast<std::byte*>(buffer.data());
+        iov[count].iov_len = buffer.size();
+        total += buffer.size();
+        ++count;
     }
-    
-    return bytesRead;
+    if (count == 0)
+        return 0;
+
+    msghdr message = {};
+    message.msg_iov = iov;
+    message.msg_iovlen = count;
+    return static_cast<int>(CountedCall(m_stats.get(), SocketStats::Direction::Send, total,
+                                        [&] { return sendmsg(m_socketFd, &message, 0); }));
+}
+
+int UnixTcpSocket::Receive(std::span<std::byte> buffer) {
+    if (m_socketFd == -1 || !m_isConnected)
+        return -1;
+
+    return CountedCall(m_stats.get(), SocketStats::Direction::Receive, buffer.size(), [&] {
+        return recv(m_socketFd, reinterpret_cast<char*>(buffer.data()), buffer.size(), 0);
+    });
 }
 
 NetworkAddress UnixTcpSocket::GetRemoteAddress() const {
@@ -238,6 +362,19 @@ bool UnixTcpSocket::GetSocketOption(int level, int optionName, void* optionValue
     return (getsockopt(m_socketFd, level, optionName, optionValue, optionLen) == 0);
 }
 
+bool UnixTcpSocket::SetNonBlocking(bool enable) {
+    return SetFdNonBlocking(m_socketFd, enable);
+}
+
+bool UnixTcpSocket::Shutdown() {
+    return m_socketFd != -1 && shutdown(m_socketFd, SHUT_RDWR) == 0;
+}
+
+bool UnixTcpSocket::EnableStats(std::shared_ptr<SocketStats> stats) {
+    m_stats = std::move(stats);
+    return true;
+}
+
 // UnixTcpListener Implementation
 UnixTcpListener::UnixTcpListener() 
     : m_socketFd(-1) {
@@ -299,7 +436,11 @@ std::unique_ptr<IConnectionOrientedSocket> UnixTcpListener::Accept() {
     if (clientSocket == -1)
         return nullptr;
 
-    return std::make_unique<UnixTcpSocket>(clientSocket);
+    auto connection = std::make_unique<UnixTcpSocket>(clientSocket);
+    if (m_statsGroup) {
+        connection->EnableStats(m_statsGroup->Create());
+    }
+    return connection;
 }
 
 bool UnixTcpListener::WaitForDataWithTimeout(int timeoutMs) {
@@ -320,6 +461,15 @@ bool UnixTcpListener::GetSocketOption(int level, int optionName, void* optionVal
     return (getsockopt(m_socketFd, level, optionName, optionValue, optionLen) == 0);
 }
 
+bool UnixTcpListener::SetNonBlocking(bool enable) {
+    return SetFdNonBlocking(m_socketFd, enable);
+}
+
+bool UnixTcpListener::SetStatsGroup(std::shared_ptr<SocketStatsGroup> group) {
+    m_statsGroup = std::move(group);
+    return true;
+}
+
 // UnixUdpSocket Implementation
 UnixUdpSocket::UnixUdpSocket() 
     : m_socketFd(-1) {
@@ -364,35 +514,180 @@ bool UnixUdpSocket::IsValid() const {
 }
 
 int UnixUdpSocket::SendTo(const std::vector<std::byte>& data, const NetworkAddress& remoteAddress) {
+    return SendTo(std::span<const std::byte>(data), remoteAddress);
+}
+
+int UnixUdpSocket::ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress& remoteAddress) {
+    // Receive straight into the caller's vector; once its capacity is warm this does not allocate
+    const size_t originalSize = buffer.size();
+    buffer.resize(std::max(originalSize, DEFAULT_RECEIVE_SIZE));
+    
+    int bytesRead = ReceiveFrom(std::span<std::byte>(buffer.data(), DEFAULT_RECEIVE_SIZE), remoteAddress);
+    buffer.resize(bytesRead > 0 ? static_cast<size_t>(bytesRead) : originalSize);
+    
+    return bytesRead;
+}
+
+int UnixUdpSocket::SendTo(std::span<const std::byte> data, const NetworkAddress& remoteAddress) {
     if (m_socketFd == -1)
         return -1;
 
     sockaddr_in addr = CreateSockAddr(remoteAddress);
-    return sendto(m_socketFd, reinterpret_cast<const char*>(data.data()), data.size(), 0,
-                 reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    return CountedCall(m_stats.get(), SocketStats::Direction::Send, data.size(), [&] {
+        return sendto(m_socketFd, reinterpret_cast<const char*>(data.data()), data.size(), 0,
+                      reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    });
 }
 
-int UnixUdpSocket::ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress& remoteAddress) {
+int UnixUdpSocket::ReceiveFrom(std::span<std::byte> buffer, NetworkAddress& remoteAddress) {
     if (m_socketFd == -1)
         return -1;
 
-    const int bufferSize = 4096;
-    std::vector<std::byte> tempBuffer(bufferSize);
-    
     sockaddr_in fromAddr = {};
     socklen_t fromLen = sizeof(fromAddr);
     
-    int bytesRead = recvfrom(m_socketFd, reinterpret_cast<char*>(tempBuffer.data()), bufferSize, 0,
-                           reinterpret_cast<sockaddr*>(&fromAddr), &fromLen);
+    int bytesRead = CountedCall(m_stats.get(), SocketStats::Direction::Receive, buffer.size(), [&] {
+        return recvfrom(m_socketFd, reinterpret_cast<char*>(buffer.data()), buffer.size(), 0,
+                        reinterpret_cast<sockaddr*>(&fromAddr), &fromLen);
+    });
     
     if (bytesRead > 0) {
-        buffer.assign(tempBuffer.begin(), tempBuffer.begin() + bytesRead);
         remoteAddress = CreateNetworkAddress(fromAddr);
     }
     
     return bytesRead;
 }
 
+int UnixUdpSocket::SendTo(std::span<const std::byte> data, const AddressKey& remoteKey) {
+    if (m_socketFd == -1)
+        return -1;
+
+    sockaddr_in addr = CreateSockAddr(remoteKey);
+    return CountedCall(m_stats.get(), SocketStats::Direction::Send, data.size(), [&] {
+        return sendto(m_socketFd, reinterpret_cast<const char*>(data.data()), data.size(), 0,
+                      reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    });
+}
+
+int UnixUdpSocket::ReceiveFrom(std::span<std::byte> buffer, AddressKey& remoteKey) {
+    if (m_socketFd == -1)
+        return -1;
+
+    sockaddr_in fromAddr = {};
+    socklen_t fromLen = sizeof(fromAddr);
+    
+    int bytesRead = CountedCall(m_stats.get(), SocketStats::Direction::Receive, buffer.size(), [&] {
+        return recvfrom(m_socketFd, reinterpret_cast<char*>(buffer.data()), buffer.size(), 0,
+                        reinterpret_cast<sockaddr*>(&fromAddr), &fromLen);
+    });
+    
+    if (bytesRead > 0) {
+        remoteKey = AddressKey(ntohl(fromAddr.sin_addr.s_addr), ntohs(fromAddr.sin_port));
+    }
+    
+    return bytesRead;
+}
+
+size_t UnixUdpSocket::SendToMany(std::span<const std::byte> data, std::span<const AddressKey> destinations,
+                                 std::span<int> results) {
+#ifdef __linux__
+    if (m_socketFd == -1) {
+        std::fill(results.begin(), results.end(), -1);
+        return 0;
+    }
+
+    // Every message shares the one payload iovec; only the destination differs. The headers are
+    // reused across calls on the same thread.
+    iovec payload = {const_cast<std::byte*>(data.data()), data.size()};
+    thread_local std::vector<mmsghdr> messages;
+    thread_local std::vector<sockaddr_in> addresses;
+    size_t delivered = 0;
+
+    for (size_t offset = 0; offset < destinations.size(); offset += MAX_SEND_DATAGRAMS) {
+        const size_t count = std::min(destinations.size() - offset, MAX_SEND_DATAGRAMS);
+        messages.assign(count, mmsghdr{});
+        addresses.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            addresses[i] = CreateSockAddr(destinations[offset + i]);
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &payload;
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // sendmmsg stops at the first datagram that fails and reports the ones before it; the
+        // failing one then errors on its own in the next call, is recorded and skipped
+        size_t done = 0;
+        while (done < count) {
+            const auto start = m_stats ? SocketStats::Clock::now() : SocketStats::Clock::time_point();
+            int sent = sendmmsg(m_socketFd, messages.data() + done, static_cast<unsigned>(count - done), 0);
+            if (m_stats) {
+                long long bytes = sent < 0 ? -1 : 0;
+                for (int i = 0; i < sent; ++i) {
+                    bytes += messages[done + i].msg_len;
+                }
+                RecordCall(*m_stats, SocketStats::Direction::Send, (count - done) * data.size(), bytes, start);
+            }
+            if (sent > 0) {
+                for (int i = 0; i < sent; ++i) {
+                    if (!results.empty()) {
+                        results[offset + done + i] = static_cast<int>(messages[done + i].msg_len);
+                    }
+                }
+                delivered += static_cast<size_t>(sent);
+                done += static_cast<size_t>(sent);
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (!results.empty()) {
+                    results[offset + done] = -1;
+                }
+                ++done;
+            }
+        }
+    }
+    return delivered;
+#else
+    return IConnectionlessSocket::SendToMany(data, destinations, results);
+#endif
+}
+
+int UnixUdpSocket::SendToAt(std::span<const std::byte> data, const AddressKey& remoteKey,
+                            std::chrono::steady_clock::time_point launchTime) {
+#ifdef __linux__
+    if (!m_txTime)
+        return IConnectionlessSocket::SendToAt(data, remoteKey, launchTime);
+    if (m_socketFd == -1)
+        return -1;
+
+    // steady_clock is CLOCK_MONOTONIC, the clock EnableTxTime selected for this socket
+    sockaddr_in addr = CreateSockAddr(remoteKey);
+    iovec payload = {const_cast<std::byte*>(data.data()), data.size()};
+    uint64_t launchNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(launchTime.time_since_epoch()).count());
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(launchNs))] = {};
+
+    msghdr message = {};
+    message.msg_name = &addr;
+    message.msg_namelen = sizeof(addr);
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_TXTIME;
+    header->cmsg_len = CMSG_LEN(sizeof(launchNs));
+    std::memcpy(CMSG_DATA(header), &launchNs, sizeof(launchNs));
+
+    return static_cast<int>(CountedCall(m_stats.get(), SocketStats::Direction::Send, data.size(),
+                                        [&] { return sendmsg(m_socketFd, &message, 0); }));
+#else
+    return IConnectionlessSocket::SendToAt(data, remoteKey, launchTime);
+#endif
+}
+
 bool UnixUdpSocket::SetBroadcast(bool enable) {
     if (m_socketFd == -1)
         return false;
@@ -403,25 +698,33 @@ bool UnixUdpSocket::SetBroadcast(bool enable) {
 }
 
 bool UnixUdpSocket::JoinMulticastGroup(const NetworkAddress& groupAddress) {
+    return JoinMulticastGroup(groupAddress, "");
+}
+
+bool UnixUdpSocket::LeaveMulticastGroup(const NetworkAddress& groupAddress) {
+    return LeaveMulticastGroup(groupAddress, "");
+}
+
+bool UnixUdpSocket::JoinMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) {
     if (m_socketFd == -1)
         return false;
 
     ip_mreq mreq = {};
-    inet_pton(AF_INET, groupAddress.ipAddress.c_str(), &(mreq.imr_multiaddr));
-    mreq.imr_interface.s_addr = INADDR_ANY;
-    
+    if (!CreateMembership(groupAddress, interfaceAddress, mreq))
+        return false;
+
     return (setsockopt(m_socketFd, IPPROTO_IP, IP_ADD_MEMBERSHIP,
                      &mreq, sizeof(mreq)) == 0);
 }
 
-bool UnixUdpSocket::LeaveMulticastGroup(const NetworkAddress& groupAddress) {
+bool UnixUdpSocket::LeaveMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) {
     if (m_socketFd == -1)
         return false;
 
     ip_mreq mreq = {};
-    inet_pton(AF_INET, groupAddress.ipAddress.c_str(), &(mreq.imr_multiaddr));
-    mreq.imr_interface.s_addr = INADDR_ANY;
-    
+    if (!CreateMembership(groupAddress, interfaceAddress, mreq))
+        return false;
+
     return (setsockopt(m_socketFd, IPPROTO_IP, IP_DROP_MEMBERSHIP,
                      &mreq, sizeof(mreq)) == 0);
 }
@@ -434,7 +737,14 @@ bool UnixUdpSocket::SetSocketOption(int level, int optionName, const void* optio
     if (m_socketFd == -1)
         return false;
 
-    return (setsockopt(m_socketFd, level, optionName, optionValue, optionLen) == 0);
+    if (setsockopt(m_socketFd, level, optionName, optionValue, optionLen) != 0)
+        return false;
+#ifdef __linux__
+    if (level == SOL_SOCKET && optionName == SO_TXTIME) {
+        m_txTime = true;
+    }
+#endif
+    return true;
 }
 
 bool UnixUdpSocket::GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const {
@@ -444,6 +754,262 @@ bool UnixUdpSocket::GetSocketOption(int level, int optionName, void* optionValue
     return (getsockopt(m_socketFd, level, optionName, optionValue, optionLen) == 0);
 }
 
+bool UnixUdpSocket::SetNonBlocking(bool enable) {
+    return SetFdNonBlocking(m_socketFd, enable);
+}
+
+bool UnixUdpSocket::EnableStats(std::shared_ptr<SocketStats> stats) {
+    m_stats = std::move(stats);
+    return true;
+}
+
+// UnixSocketPoller Implementation
+bool ISocketPoller::LastCallWouldBlock() {
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+#ifdef __linux__
+
+namespace {
+    uint32_t ToEpollEvents(uint32_t events) {
+        uint32_t result = 0;
+        if (events & ISocketPoller::Readable)
+            result |= EPOLLIN;
+        if (events & ISocketPoller::Writable)
+            result |= EPOLLOUT;
+        return result;  // EPOLLHUP and EPOLLERR are always reported
+    }
+
+    uint32_t FromEpollEvents(uint32_t events) {
+        uint32_t result = 0;
+        if (events & EPOLLIN)
+            result |= ISocketPoller::Readable;
+        if (events & EPOLLOUT)
+            result |= ISocketPoller::Writable;
+        if (events & (EPOLLHUP | EPOLLERR))
+            result |= ISocketPoller::Closed;
+        return result;
+    }
+}
+
+UnixSocketPoller::UnixSocketPoller()
+    : m_epollFd(-1), m_wakeupFd(-1) {
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd == -1 || m_wakeupFd == -1)
+        return;
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKEUP_TOKEN;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeupFd, &event) != 0) {
+        close(m_wakeupFd);
+        m_wakeupFd = -1;
+    }
+}
+
+UnixSocketPoller::~UnixSocketPoller() {
+    if (m_wakeupFd != -1)
+        close(m_wakeupFd);
+    if (m_epollFd != -1)
+        close(m_epollFd);
+}
+
+bool UnixSocketPoller::IsValid() const {
+    return m_epollFd != -1 && m_wakeupFd != -1;
+}
+
+bool UnixSocketPoller::Add(ISocketBase& socket, uint32_t events, uint64_t token) {
+    int socketFd = GetNativeHandle(socket);
+    if (socketFd == -1 || token == WAKEUP_TOKEN)
+        return false;
+
+    epoll_event event = {};
+    event.events = ToEpollEvents(events);
+    event.data.u64 = token;
+    return (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, socketFd, &event) == 0);
+}
+
+bool UnixSocketPoller::Modify(ISocketBase& socket, uint32_t events, uint64_t token) {
+    int socketFd = GetNativeHandle(socket);
+    if (socketFd == -1 || token == WAKEUP_TOKEN)
+        return false;
+
+    epoll_event event = {};
+    event.events = ToEpollEvents(events);
+    event.data.u64 = token;
+    return (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, socketFd, &event) == 0);
+}
+
+bool UnixSocketPoller::Remove(ISocketBase& socket) {
+    int socketFd = GetNativeHandle(socket);
+    if (socketFd == -1)
+        return false;
+
+    return (epoll_ctl(m_epollFd, EPOLL_CTL_DEL, socketFd, nullptr) == 0);
+}
+
+int UnixSocketPoller::Wait(std::span<Ready> ready, int timeoutMs) {
+    if (!IsValid() || ready.empty())
+        return -1;
+
+    epoll_event events[MAX_POLL_EVENTS];
+    int maxEvents = static_cast<int>(std::min(ready.size(), MAX_POLL_EVENTS));
+    int count = epoll_wait(m_epollFd, events, maxEvents, timeoutMs);
+    if (count < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    int filled = 0;
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.u64 == WAKEUP_TOKEN) {
+            DrainWakeup();
+            continue;
+        }
+        ready[filled++] = Ready{events[i].data.u64, FromEpollEvents(events[i].events)};
+    }
+    return filled;
+}
+
+void UnixSocketPoller::Wakeup() {
+    uint64_t one = 1;
+    // A full counter already guarantees a wakeup, so the result can be ignored
+    ssize_t written = write(m_wakeupFd, &one, sizeof(one));
+    (void)written;
+}
+
+void UnixSocketPoller::DrainWakeup() {
+    uint64_t count = 0;
+    ssize_t bytesRead = read(m_wakeupFd, &count, sizeof(count));
+    (void)bytesRead;
+}
+
+#else
+
+namespace {
+    short ToPollEvents(uint32_t events) {
+        short result = 0;
+        if (events & ISocketPoller::Readable)
+            result |= POLLIN;
+        if (events & ISocketPoller::Writable)
+            result |= POLLOUT;
+        return result;  // POLLHUP, POLLERR and POLLNVAL are always reported
+    }
+
+    uint32_t FromPollEvents(short events) {
+        uint32_t result = 0;
+        if (events & POLLIN)
+            result |= ISocketPoller::Readable;
+        if (events & POLLOUT)
+            result |= ISocketPoller::Writable;
+        if (events & (POLLHUP | POLLERR | POLLNVAL))
+            result |= ISocketPoller::Closed;
+        return result;
+    }
+}
+
+UnixSocketPoller::UnixSocketPoller()
+    : m_wakeupPipe{-1, -1} {
+    if (pipe(m_wakeupPipe) != 0) {
+        m_wakeupPipe[0] = m_wakeupPipe[1] = -1;
+        return;
+    }
+    SetFdNonBlocking(m_wakeupPipe[0], true);
+    SetFdNonBlocking(m_wakeupPipe[1], true);
+}
+
+UnixSocketPoller::~UnixSocketPoller() {
+    for (int fd : m_wakeupPipe) {
+        if (fd != -1)
+            close(fd);
+    }
+}
+
+bool UnixSocketPoller::IsValid() const {
+    return m_wakeupPipe[0] != -1;
+}
+
+bool UnixSocketPoller::Add(ISocketBase& socket, uint32_t events, uint64_t token) {
+    int socketFd = GetNativeHandle(socket);
+    if (socketFd == -1 || token == WAKEUP_TOKEN)
+        return false;
+
+    auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                           [socketFd](const Registration& registration) { return registration.fd == socketFd; });
+    if (it != m_registrations.end())
+        return false;
+
+    m_registrations.push_back(Registration{socketFd, events, token});
+    return true;
+}
+
+bool UnixSocketPoller::Modify(ISocketBase& socket, uint32_t events, uint64_t token) {
+    int socketFd = GetNativeHandle(socket);
+    auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                           [socketFd](const Registration& registration) { return registration.fd == socketFd; });
+    if (socketFd == -1 || token == WAKEUP_TOKEN || it == m_registrations.end())
+        return false;
+
+    it->events = events;
+    it->token = token;
+    return true;
+}
+
+bool UnixSocketPoller::Remove(ISocketBase& socket) {
+    int socketFd = GetNativeHandle(socket);
+    auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                           [socketFd](const Registration& registration) { return registration.fd == socketFd; });
+    if (socketFd == -1 || it == m_registrations.end())
+        return false;
+
+    // Order does not matter, so swap with the last entry instead of shifting
+    *it = m_registrations.back();
+    m_registrations.pop_back();
+    return true;
+}
+
+int UnixSocketPoller::Wait(std::span<Ready> ready, int timeoutMs) {
+    if (!IsValid() || ready.empty())
+        return -1;
+
+    // Slot 0 is the wakeup pipe; the rest mirror m_registrations
+    m_pollFds.clear();
+    m_pollFds.push_back(pollfd{m_wakeupPipe[0], POLLIN, 0});
+    for (const Registration& registration : m_registrations) {
+        m_pollFds.push_back(pollfd{registration.fd, ToPollEvents(registration.events), 0});
+    }
+
+    int count = poll(m_pollFds.data(), static_cast<nfds_t>(m_pollFds.size()), timeoutMs);
+    if (count < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    if (m_pollFds[0].revents != 0) {
+        DrainWakeup();
+    }
+
+    int filled = 0;
+    for (size_t i = 1; i < m_pollFds.size() && static_cast<size_t>(filled) < ready.size(); ++i) {
+        if (m_pollFds[i].revents != 0) {
+            ready[filled++] = Ready{m_registrations[i - 1].token, FromPollEvents(m_pollFds[i].revents)};
+        }
+    }
+    return filled;
+}
+
+void UnixSocketPoller::Wakeup() {
+    char signal = 1;
+    // A full pipe already guarantees a wakeup, so the result can be ignored
+    ssize_t written = write(m_wakeupPipe[1], &signal, sizeof(signal));
+    (void)written;
+}
+
+void UnixSocketPoller::DrainWakeup() {
+    char buffer[64];
+    while (read(m_wakeupPipe[0], buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+#endif // __linux__
+
 // UnixNetworkSocketFactory Implementation
 UnixNetworkSocketFactory::UnixNetworkSocketFactory() {
     // Nothing to initialize for Unix sockets
@@ -454,15 +1020,43 @@ UnixNetworkSocketFactory::~UnixNetworkSocketFactory() {
 }
 
 std::unique_ptr<ITcpSocket> UnixNetworkSocketFactory::CreateTcpSocket() {
-    return std::make_unique<UnixTcpSocket>();
+    auto socket = std::make_unique<UnixTcpSocket>();
+    if (auto group = GetStatsGroup()) {
+        socket->EnableStats(group->Create());
+    }
+    return socket;
 }
 
 std::unique_ptr<ITcpListener> UnixNetworkSocketFactory::CreateTcpListener() {
-    return std::make_unique<UnixTcpListener>();
+    auto listener = std::make_unique<UnixTcpListener>();
+    listener->SetStatsGroup(GetStatsGroup());
+    return listener;
 }
 
 std::unique_ptr<IUdpSocket> UnixNetworkSocketFactory::CreateUdpSocket() {
-    return std::make_unique<UnixUdpSocket>();
+    auto socket = std::make_unique<UnixUdpSocket>();
+    if (auto group = GetStatsGroup()) {
+        socket->EnableStats(group->Create());
+    }
+    return socket;
+}
+
+std::unique_ptr<ISocketPoller> UnixNetworkSocketFactory::CreateSocketPoller() {
+    auto poller = std::make_unique<UnixSocketPoller>();
+    if (!poller->IsValid())
+        return nullptr;
+    return poller;
+}
+
+bool UnixNetworkSocketFactory::SetStatsGroup(std::shared_ptr<SocketStatsGroup> group) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statsGroup = std::move(group);
+    return true;
+}
+
+std::shared_ptr<SocketStatsGroup> UnixNetworkSocketFactory::GetStatsGroup() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statsGroup;
 }
 
-#endif // __unix__ || __APPLE__ || __linux__
\ No newline at end of file
+#endif // __unix__ || __APPLE__ || __linux__
@@ -10,16 +10,23 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <atomic>
 #include <cstddef>
+#include <mutex>
+#include <vector>
 #include "network/tcp_socket.h"
 #include "network/udp_socket.h"
 #include "network/platform_factory.h"
+#include "network/socket_poller.h"
+#include "network/socket_stats.h"
 #include "socket_helpers.h"
 
 // Forward declarations
 class UnixTcpSocket;
 class UnixTcpListener;
 class UnixUdpSocket;
+class UnixSocketPoller;
 
 // Unix implementation of TCP socket
 class UnixTcpSocket final : public ITcpSocket {
@@ -38,21 +45,32 @@ public:
     // Generic socket option interface overrides
     bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) override;
     bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override;
+    bool SetNonBlocking(bool enable) override;
+    bool EnableStats(std::shared_ptr<SocketStats> stats) override;
+    std::shared_ptr<SocketStats> GetStats() const override { return m_stats; }
+
+    // Descriptor used to register the socket with UnixSocketPoller
+    int GetNativeHandle() const { return m_socketFd; }
 
     // IConnectionOrientedSocket implementation
     bool Connect(const NetworkAddress& remoteAddress) override;
     int Send(const std::vector<std::byte>& data) override;
     int Receive(std::vector<std::byte>& buffer) override;
+    int Send(std::span<const std::byte> data) override;
+    int Receive(std::span<std::byte> buffer) override;
     NetworkAddress GetRemoteAddress() const override;
     bool SetConnectTimeout(int timeoutMs) override;
+    bool Shutdown() override;
 
     // ITcpSocket implementation
     bool SetNoDelay(bool enable) override;
+    int SendVectored(std::span<const std::span<const std::byte>> buffers) override;
 
 private:
     int m_socketFd;
     bool m_isConnected;
     int m_connectTimeoutMs = -1;
+    std::shared_ptr<SocketStats> m_stats;
 };
 
 // Unix implementation of TCP listener
@@ -71,12 +89,18 @@ public:
     // Generic socket option interface overrides
     bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) override;
     bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override;
+    bool SetNonBlocking(bool enable) override;
+
+    // Descriptor used to register the socket with UnixSocketPoller
+    int GetNativeHandle() const { return m_socketFd; }
 
     bool Listen(int backlog) override;
     std::unique_ptr<IConnectionOrientedSocket> Accept() override;
+    bool SetStatsGroup(std::shared_ptr<SocketStatsGroup> group) override;
 
 private:
     int m_socketFd;
+    std::shared_ptr<SocketStatsGroup> m_statsGroup;
 };
 
 // Unix implementation of UDP socket
@@ -95,18 +119,73 @@ public:
     // Generic socket option interface overrides
     bool SetSocketOption(int level, int optionName, const void* optionValue, socklen_t optionLen) override;
     bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override;
+    bool SetNonBlocking(bool enable) override;
+    bool EnableStats(std::shared_ptr<SocketStats> stats) override;
+    std::shared_ptr<SocketStats> GetStats() const override { return m_stats; }
+
+    // Descriptor used to register the socket with UnixSocketPoller
+    int GetNativeHandle() const { return m_socketFd; }
 
     // IConnectionlessSocket implementation
     int SendTo(const std::vector<std::byte>& data, const NetworkAddress& remoteAddress) override;
     int ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress& remoteAddress) override;
+    int SendTo(std::span<const std::byte> data, const NetworkAddress& remoteAddress) override;
+    int ReceiveFrom(std::span<std::byte> buffer, NetworkAddress& remoteAddress) override;
+    int SendTo(std::span<const std::byte> data, const AddressKey& remoteKey) override;
+    int ReceiveFrom(std::span<std::byte> buffer, AddressKey& remoteKey) override;
+    size_t SendToMany(std::span<const std::byte> data, std::span<const AddressKey> destinations,
+                      std::span<int> results = {}) override;
+    int SendToAt(std::span<const std::byte> data, const AddressKey& remoteKey,
+                 std::chrono::steady_clock::time_point launchTime) override;
 
     // IUdpSocket implementation
     bool SetBroadcast(bool enable) override;
     bool JoinMulticastGroup(const NetworkAddress& groupAddress) override;
     bool LeaveMulticastGroup(const NetworkAddress& groupAddress) override;
+    bool JoinMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) override;
+    bool LeaveMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) override;
 
 private:
     int m_socketFd;
+    // Set once SO_TXTIME is enabled through SetSocketOption, so SendToAt passes launch times on
+    std::atomic<bool> m_txTime{false};
+    std::shared_ptr<SocketStats> m_stats;
+};
+
+// Unix implementation of the socket poller: epoll on Linux, poll() elsewhere
+class UnixSocketPoller final : public ISocketPoller {
+public:
+    UnixSocketPoller();
+    ~UnixSocketPoller() override;
+
+    UnixSocketPoller(const UnixSocketPoller&) = delete;
+    UnixSocketPoller& operator=(const UnixSocketPoller&) = delete;
+
+    bool IsValid() const;
+
+    bool Add(ISocketBase& socket, uint32_t events, uint64_t token) override;
+    bool Modify(ISocketBase& socket, uint32_t events, uint64_t token) override;
+    bool Remove(ISocketBase& socket) override;
+    int Wait(std::span<Ready> ready, int timeoutMs) override;
+    void Wakeup() override;
+
+private:
+    void DrainWakeup();
+
+#ifdef __linux__
+    int m_epollFd;
+    int m_wakeupFd;         // eventfd
+#else
+    struct Registration {
+        int fd;
+        uint32_t events;
+        uint64_t token;
+    };
+
+    int m_wakeupPipe[2];    // Self-pipe: Wakeup writes to [1], Wait polls [0]
+    std::vector<Registration> m_registrations;
+    std::vector<pollfd> m_pollFds;
+#endif
 };
 
 // Unix implementation of the network socket factory
@@ -119,6 +198,14 @@ public:
     std::unique_ptr<ITcpSocket> CreateTcpSocket() override;
     std::unique_ptr<ITcpListener> CreateTcpListener() override;
     std::unique_ptr<IUdpSocket> CreateUdpSocket() override;
+    std::unique_ptr<ISocketPoller> CreateSocketPoller() override;
+    bool SetStatsGroup(std::shared_ptr<SocketStatsGroup> group) override;
+
+private:
+    std::shared_ptr<SocketStatsGroup> GetStatsGroup() const;
+
+    mutable std::mutex m_mutex;
+    std::shared_ptr<SocketStatsGroup> m_statsGroup;
 };
 
 #endif // __unix__ || __APPLE__ || __linux__
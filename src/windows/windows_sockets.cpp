@@ -1,6 +1,7 @@
 #ifdef _WIN32
 
 #include "windows_sockets.h"
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 #include <WinSock2.h>
@@ -11,6 +12,63 @@ typedef int socklen_t;
 
 // Helper functions
 namespace {
+    // Buffers passed to one WSASend call
+    constexpr DWORD MAX_SEND_BUFFERS = 64;
+
+    // Group and interface for IP_ADD_MEMBERSHIP/IP_DROP_MEMBERSHIP; an empty interface lets the
+    // stack choose one
+    bool CreateMembership(const NetworkAddress& group, const std::string& interfaceAddress, ip_mreq& mreq) {
+        if (inet_pton(AF_INET, group.ipAddress.c_str(), &mreq.imr_multiaddr) != 1)
+            return false;
+        if (interfaceAddress.empty()) {
+            mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+            return true;
+        }
+        return inet_pton(AF_INET, interfaceAddress.c_str(), &mreq.imr_interface) == 1;
+    }
+
+    // Set or clear non-blocking mode on a socket
+    bool SetSocketNonBlocking(SOCKET socket, bool enable) {
+        if (socket == INVALID_SOCKET)
+            return false;
+
+        u_long mode = enable ? 1 : 0;
+        return (ioctlsocket(socket, FIONBIO, &mode) == 0);
+    }
+
+    // Handle of a socket created by the Windows factory (possibly wrapped by decorators), or
+    // INVALID_SOCKET for any other implementation
+    SOCKET GetNativeHandle(const ISocketBase& wrapped) {
+        const ISocketBase& socket = wrapped.GetUnderlyingSocket();
+        if (auto* tcpSocket = dynamic_cast<const WindowsTcpSocket*>(&socket))
+            return tcpSocket->GetNativeHandle();
+        if (auto* tcpListener = dynamic_cast<const WindowsTcpListener*>(&socket))
+            return tcpListener->GetNativeHandle();
+        if (auto* udpSocket = dynamic_cast<const WindowsUdpSocket*>(&socket))
+            return udpSocket->GetNativeHandle();
+        return INVALID_SOCKET;
+    }
+
+    SHORT ToPollEvents(uint32_t events) {
+        SHORT result = 0;
+        if (events & ISocketPoller::Readable)
+            result |= POLLRDNORM;
+        if (events & ISocketPoller::Writable)
+            result |= POLLWRNORM;
+        return result;  // POLLHUP, POLLERR and POLLNVAL are always reported
+    }
+
+    uint32_t FromPollEvents(SHORT events) {
+        uint32_t result = 0;
+        if (events & POLLRDNORM)
+            result |= ISocketPoller::Readable;
+        if (events & POLLWRNORM)
+            result |= ISocketPoller::Writable;
+        if (events & (POLLHUP | POLLERR | POLLNVAL))
+            result |= ISocketPoller::Closed;
+        return result;
+    }
+
     // Convert NetworkAddress to sockaddr_in
     sockaddr_in CreateSockAddr(const NetworkAddress& address) {
         sockaddr_in result = {};
@@ -20,6 +78,15 @@ namespace {
         return result;
     }
 
+    // Convert a packed IPv4 key to sockaddr_in without going through text
+    sockaddr_in CreateSockAddr(const AddressKey& key) {
+        sockaddr_in result = {};
+        result.sin_family = AF_INET;
+        result.sin_port = htons(key.GetPort());
+        result.sin_addr.s_addr = htonl(key.GetIPv4());
+        return result;
+    }
+
     // Convert sockaddr_in to NetworkAddress
     NetworkAddress CreateNetworkAddress(const sockaddr_in& sockAddr) {
         char ipStr[INET_ADDRSTRLEN];
@@ -254,6 +321,44 @@ int WindowsTcpSocket::Receive(std::vector<std::byte>& buffer) {
     return bytesRead;
 }
 
+int WindowsTcpSocket::Send(std::span<const std::byte> data) {
+    if (m_socket == INVALID_SOCKET || !m_isConnected)
+        return -1;
+
+    return send(m_socket, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0);
+}
+
+int WindowsTcpSocket::SendVectored(std::span<const std::span<const std::byte>> buffers) {
+    if (m_socket == INVALID_SOCKET || !m_isConnected)
+        return -1;
+
+    WSABUF wsaBuffers[MAX_SEND_BUFFERS];
+    DWORD count = 0;
+    for (std::span<const std::byte> buffer : buffers) {
+        if (count == MAX_SEND_BUFFERS)
+            break;
+        if (buffer.empty())
+            continue;
+        wsaBuffers[count].buf = const_cast<char*>(reinterpret_cast<const char*>(buffer.data()));
+        wsaBuffers[count].len = static_cast<ULONG>(buffer.size());
+        ++count;
+    }
+    if (count == 0)
+        return 0;
+
+    DWORD bytesSent = 0;
+    if (WSASend(m_socket, wsaBuffers, count, &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR)
+        return -1;
+    return static_cast<int>(bytesSent);
+}
+
+int WindowsTcpSocket::Receive(std::span<std::byte> buffer) {
+    if (m_socket == INVALID_SOCKET || !m_isConnected)
+        return -1;
+
+    return recv(m_socket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
+}
+
 NetworkAddress WindowsTcpSocket::GetRemoteAddress() const {
     sockaddr_in addr = {};
     if (m_isConnected && GetSockAddr(m_socket, addr, false)) {
@@ -301,6 +406,14 @@ bool WindowsTcpSocket::GetSocketOption(int level, int optionName, void* optionVa
                       static_cast<char*>(optionValue), reinterpret_cast<int*>(optionLen)) == 0);
 }
 
+bool WindowsTcpSocket::SetNonBlocking(bool enable) {
+    return SetSocketNonBlocking(m_socket, enable);
+}
+
+bool WindowsTcpSocket::Shutdown() {
+    return m_socket != INVALID_SOCKET && shutdown(m_socket, SD_BOTH) == 0;
+}
+
 // WindowsTcpListener Implementation
 WindowsTcpListener::WindowsTcpListener() 
     : m_socket(INVALID_SOCKET) {
@@ -407,6 +520,10 @@ bool WindowsTcpListener::GetSocketOption(int level, int optionName, void* option
                       static_cast<char*>(optionValue), reinterpret_cast<int*>(optionLen)) == 0);
 }
 
+bool WindowsTcpListener::SetNonBlocking(bool enable) {
+    return SetSocketNonBlocking(m_socket, enable);
+}
+
 // WindowsUdpSocket Implementation
 WindowsUdpSocket::WindowsUdpSocket() 
     : m_socket(INVALID_SOCKET) {
@@ -503,6 +620,58 @@ int WindowsUdpSocket::ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress
     return bytesRead;
 }
 
+int WindowsUdpSocket::SendTo(std::span<const std::byte> data, const NetworkAddress& remoteAddress) {
+    if (m_socket == INVALID_SOCKET)
+        return -1;
+
+    sockaddr_in addr = CreateSockAddr(remoteAddress);
+    return sendto(m_socket, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0,
+                 reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+}
+
+int WindowsUdpSocket::ReceiveFrom(std::span<std::byte> buffer, NetworkAddress& remoteAddress) {
+    if (m_socket == INVALID_SOCKET)
+        return -1;
+
+    sockaddr_in fromAddr = {};
+    int fromLen = sizeof(fromAddr);
+    
+    int bytesRead = recvfrom(m_socket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                           reinterpret_cast<sockaddr*>(&fromAddr), &fromLen);
+    
+    if (bytesRead > 0) {
+        remoteAddress = CreateNetworkAddress(fromAddr);
+    }
+    
+    return bytesRead;
+}
+
+int WindowsUdpSocket::SendTo(std::span<const std::byte> data, const AddressKey& remoteKey) {
+    if (m_socket == INVALID_SOCKET)
+        return -1;
+
+    sockaddr_in addr = CreateSockAddr(remoteKey);
+    return sendto(m_socket, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0,
+                 reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+}
+
+int WindowsUdpSocket::ReceiveFrom(std::span<std::byte> buffer, AddressKey& remoteKey) {
+    if (m_socket == INVALID_SOCKET)
+        return -1;
+
+    sockaddr_in fromAddr = {};
+    int fromLen = sizeof(fromAddr);
+    
+    int bytesRead = recvfrom(m_socket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                           reinterpret_cast<sockaddr*>(&fromAddr), &fromLen);
+    
+    if (bytesRead > 0) {
+        remoteKey = AddressKey(ntohl(fromAddr.sin_addr.s_addr), ntohs(fromAddr.sin_port));
+    }
+    
+    return bytesRead;
+}
+
 bool WindowsUdpSocket::SetBroadcast(bool enable) {
     if (m_socket == INVALID_SOCKET)
         return false;
@@ -513,25 +682,33 @@ bool WindowsUdpSocket::SetBroadcast(bool enable) {
 }
 
 bool WindowsUdpSocket::JoinMulticastGroup(const NetworkAddress& groupAddress) {
+    return JoinMulticastGroup(groupAddress, "");
+}
+
+bool WindowsUdpSocket::LeaveMulticastGroup(const NetworkAddress& groupAddress) {
+    return LeaveMulticastGroup(groupAddress, "");
+}
+
+bool WindowsUdpSocket::JoinMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) {
     if (m_socket == INVALID_SOCKET)
         return false;
 
     ip_mreq mreq = {};
-    inet_pton(AF_INET, groupAddress.ipAddress.c_str(), &(mreq.imr_multiaddr));
-    mreq.imr_interface.s_addr = INADDR_ANY;
-    
+    if (!CreateMembership(groupAddress, interfaceAddress, mreq))
+        return false;
+
     return (setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP,
                      reinterpret_cast<char*>(&mreq), sizeof(mreq)) == 0);
 }
 
-bool WindowsUdpSocket::LeaveMulticastGroup(const NetworkAddress& groupAddress) {
+bool WindowsUdpSocket::LeaveMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) {
     if (m_socket == INVALID_SOCKET)
         return false;
 
     ip_mreq mreq = {};
-    inet_pton(AF_INET, groupAddress.ipAddress.c_str(), &(mreq.imr_multiaddr));
-    mreq.imr_interface.s_addr = INADDR_ANY;
-    
+    if (!CreateMembership(groupAddress, interfaceAddress, mreq))
+        return false;
+
     return (setsockopt(m_socket, IPPROTO_IP, IP_DROP_MEMBERSHIP,
                      reinterpret_cast<char*>(&mreq), sizeof(mreq)) == 0);
 }
@@ -556,6 +733,120 @@ bool WindowsUdpSocket::GetSocketOption(int level, int optionName, void* optionVa
                       static_cast<char*>(optionValue), reinterpret_cast<int*>(optionLen)) == 0);
 }
 
+bool WindowsUdpSocket::SetNonBlocking(bool enable) {
+    return SetSocketNonBlocking(m_socket, enable);
+}
+
+// WindowsSocketPoller Implementation
+bool ISocketPoller::LastCallWouldBlock() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+WindowsSocketPoller::WindowsSocketPoller()
+    : m_wakeupSocket(INVALID_SOCKET) {
+    m_wakeupSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_wakeupSocket == INVALID_SOCKET)
+        return;
+
+    // Bind to an ephemeral loopback port and connect to it, so Wakeup can send to itself
+    sockaddr_in addr = CreateSockAddr(NetworkAddress("127.0.0.1", 0));
+    int len = sizeof(addr);
+    if (bind(m_wakeupSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(m_wakeupSocket, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        connect(m_wakeupSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        !SetSocketNonBlocking(m_wakeupSocket, true)) {
+        closesocket(m_wakeupSocket);
+        m_wakeupSocket = INVALID_SOCKET;
+    }
+}
+
+WindowsSocketPoller::~WindowsSocketPoller() {
+    if (m_wakeupSocket != INVALID_SOCKET)
+        closesocket(m_wakeupSocket);
+}
+
+bool WindowsSocketPoller::IsValid() const {
+    return m_wakeupSocket != INVALID_SOCKET;
+}
+
+bool WindowsSocketPoller::Add(ISocketBase& socket, uint32_t events, uint64_t token) {
+    SOCKET handle = GetNativeHandle(socket);
+    if (handle == INVALID_SOCKET || token == WAKEUP_TOKEN)
+        return false;
+
+    auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                           [handle](const Registration& registration) { return registration.socket == handle; });
+    if (it != m_registrations.end())
+        return false;
+
+    m_registrations.push_back(Registration{handle, events, token});
+    return true;
+}
+
+bool WindowsSocketPoller::Modify(ISocketBase& socket, uint32_t events, uint64_t token) {
+    SOCKET handle = GetNativeHandle(socket);
+    auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                           [handle](const Registration& registration) { return registration.socket == handle; });
+    if (handle == INVALID_SOCKET || token == WAKEUP_TOKEN || it == m_registrations.end())
+        return false;
+
+    it->events = events;
+    it->token = token;
+    return true;
+}
+
+bool WindowsSocketPoller::Remove(ISocketBase& socket) {
+    SOCKET handle = GetNativeHandle(socket);
+    auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                           [handle](const Registration& registration) { return registration.socket == handle; });
+    if (handle == INVALID_SOCKET || it == m_registrations.end())
+        return false;
+
+    // Order does not matter, so swap with the last entry instead of shifting
+    *it = m_registrations.back();
+    m_registrations.pop_back();
+    return true;
+}
+
+int WindowsSocketPoller::Wait(std::span<Ready> ready, int timeoutMs) {
+    if (!IsValid() || ready.empty())
+        return -1;
+
+    // Slot 0 is the wakeup socket; the rest mirror m_registrations
+    m_pollFds.clear();
+    m_pollFds.push_back(WSAPOLLFD{m_wakeupSocket, POLLRDNORM, 0});
+    for (const Registration& registration : m_registrations) {
+        m_pollFds.push_back(WSAPOLLFD{registration.socket, ToPollEvents(registration.events), 0});
+    }
+
+    int count = WSAPoll(m_pollFds.data(), static_cast<ULONG>(m_pollFds.size()), timeoutMs);
+    if (count == SOCKET_ERROR)
+        return -1;
+
+    if (m_pollFds[0].revents != 0) {
+        DrainWakeup();
+    }
+
+    int filled = 0;
+    for (size_t i = 1; i < m_pollFds.size() && static_cast<size_t>(filled) < ready.size(); ++i) {
+        if (m_pollFds[i].revents != 0) {
+            ready[filled++] = Ready{m_registrations[i - 1].token, FromPollEvents(m_pollFds[i].revents)};
+        }
+    }
+    return filled;
+}
+
+void WindowsSocketPoller::Wakeup() {
+    char signal = 1;
+    send(m_wakeupSocket, &signal, sizeof(signal), 0);
+}
+
+void WindowsSocketPoller::DrainWakeup() {
+    char buffer[64];
+    while (recv(m_wakeupSocket, buffer, sizeof(buffer), 0) > 0) {
+    }
+}
+
 // WindowsNetworkSocketFactory Implementation
 WindowsNetworkSocketFactory::WindowsNetworkSocketFactory() 
     : m_initialized(false) {
@@ -589,6 +880,16 @@ std::unique_ptr<IUdpSocket> WindowsNetworkSocketFactory::CreateUdpSocket() {
     return std::make_unique<WindowsUdpSocket>();
 }
 
+std::unique_ptr<ISocketPoller> WindowsNetworkSocketFactory::CreateSocketPoller() {
+    if (!m_initialized)
+        return nullptr;
+    
+    auto poller = std::make_unique<WindowsSocketPoller>();
+    if (!poller->IsValid())
+        return nullptr;
+    return poller;
+}
+
 bool WindowsNetworkSocketFactory::InitializeWinsock() {
     WSADATA wsaData;
     return (WSAStartup(MAKEWORD(2, 2), &wsaData) == 0);
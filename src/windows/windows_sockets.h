@@ -7,14 +7,17 @@
 #include <WS2tcpip.h>
 #include <Windows.h>
 #include <cstddef> // For std::byte
+#include <vector>
 #include "network/tcp_socket.h"
 #include "network/udp_socket.h"
 #include "network/platform_factory.h"
+#include "network/socket_poller.h"
 
 // Forward declarations
 class WindowsTcpSocket;
 class WindowsTcpListener;
 class WindowsUdpSocket;
+class WindowsSocketPoller;
 
 // Helper functions namespace
 namespace WindowsSocketHelpers {
@@ -40,15 +43,23 @@ public:
     bool Connect(const NetworkAddress& remoteAddress) override;
     int Send(const std::vector<std::byte>& data) override;
     int Receive(std::vector<std::byte>& buffer) override;
+    int Send(std::span<const std::byte> data) override;
+    int Receive(std::span<std::byte> buffer) override;
     NetworkAddress GetRemoteAddress() const override;
     bool SetConnectTimeout(int timeoutMs) override; 
+    bool Shutdown() override;
 
     // ITcpSocket implementation
     bool SetNoDelay(bool enable) override;
+    int SendVectored(std::span<const std::span<const std::byte>> buffers) override;
     bool WaitForDataWithTimeout(int timeoutMs) override;
 
     // Make GetSocketOption public to match base class
     bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override;
+    bool SetNonBlocking(bool enable) override;
+
+    // Handle used to register the socket with WindowsSocketPoller
+    SOCKET GetNativeHandle() const { return m_socket; }
 
 private:
     SOCKET m_socket;
@@ -74,6 +85,10 @@ public:
 
     // Make GetSocketOption public to match base class
     bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override;
+    bool SetNonBlocking(bool enable) override;
+
+    // Handle used to register the socket with WindowsSocketPoller
+    SOCKET GetNativeHandle() const { return m_socket; }
 
 private:
     SOCKET m_socket;
@@ -95,20 +110,62 @@ public:
     // IConnectionlessSocket implementation
     int SendTo(const std::vector<std::byte>& data, const NetworkAddress& remoteAddress) override;
     int ReceiveFrom(std::vector<std::byte>& buffer, NetworkAddress& remoteAddress) override;
+    int SendTo(std::span<const std::byte> data, const NetworkAddress& remoteAddress) override;
+    int ReceiveFrom(std::span<std::byte> buffer, NetworkAddress& remoteAddress) override;
+    int SendTo(std::span<const std::byte> data, const AddressKey& remoteKey) override;
+    int ReceiveFrom(std::span<std::byte> buffer, AddressKey& remoteKey) override;
 
     // IUdpSocket implementation
     bool SetBroadcast(bool enable) override;
     bool JoinMulticastGroup(const NetworkAddress& groupAddress) override;
     bool LeaveMulticastGroup(const NetworkAddress& groupAddress) override;
+    bool JoinMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) override;
+    bool LeaveMulticastGroup(const NetworkAddress& groupAddress, const std::string& interfaceAddress) override;
     bool WaitForDataWithTimeout(int timeoutMs) override;
 
     // Make GetSocketOption public to match base class
     bool GetSocketOption(int level, int optionName, void* optionValue, socklen_t* optionLen) const override;
+    bool SetNonBlocking(bool enable) override;
+
+    // Handle used to register the socket with WindowsSocketPoller
+    SOCKET GetNativeHandle() const { return m_socket; }
 
 private:
     SOCKET m_socket;
 };
 
+// Windows implementation of the socket poller based on WSAPoll.
+// WSAPoll cannot wait on events, so Wakeup sends a datagram to a loopback UDP socket in the poll set.
+class WindowsSocketPoller final : public ISocketPoller {
+public:
+    WindowsSocketPoller();
+    ~WindowsSocketPoller() override;
+
+    WindowsSocketPoller(const WindowsSocketPoller&) = delete;
+    WindowsSocketPoller& operator=(const WindowsSocketPoller&) = delete;
+
+    bool IsValid() const;
+
+    bool Add(ISocketBase& socket, uint32_t events, uint64_t token) override;
+    bool Modify(ISocketBase& socket, uint32_t events, uint64_t token) override;
+    bool Remove(ISocketBase& socket) override;
+    int Wait(std::span<Ready> ready, int timeoutMs) override;
+    void Wakeup() override;
+
+private:
+    struct Registration {
+        SOCKET socket;
+        uint32_t events;
+        uint64_t token;
+    };
+
+    void DrainWakeup();
+
+    SOCKET m_wakeupSocket;
+    std::vector<Registration> m_registrations;
+    std::vector<WSAPOLLFD> m_pollFds;
+};
+
 // Windows implementation of the network socket factory
 class WindowsNetworkSocketFactory : public INetworkSocketFactory {
 public:
@@ -119,6 +176,7 @@ public:
     std::unique_ptr<ITcpSocket> CreateTcpSocket() override;
     std::unique_ptr<ITcpListener> CreateTcpListener() override;
     std::unique_ptr<IUdpSocket> CreateUdpSocket() override;
+    std::unique_ptr<ISocketPoller> CreateSocketPoller() override;
 
 private:
     bool InitializeWinsock();
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "network/network.h"
+#include "network/platform_factory.h"
+#include "network/udp_socket.h"
+#include "network/byte_utils.h"
+#include "utils/test_utils.h"
+
+using namespace test_utils::timeouts;
+
+TEST(AddressKeyTest, PacksAddressAndPort) {
+    AddressKey key(0xC0A80001, 8085);  // 192.168.0.1
+    EXPECT_EQ(key.packed, (uint64_t{0xC0A80001} << 16) | 8085);
+    EXPECT_EQ(key.GetIPv4(), 0xC0A80001u);
+    EXPECT_EQ(key.GetPort(), 8085);
+
+    NetworkAddress address = key.ToNetworkAddress();
+    EXPECT_EQ(address.ipAddress, "192.168.0.1");
+    EXPECT_EQ(address.port, 8085);
+}
+
+TEST(AddressKeyTest, ParsesDottedQuads) {
+    AddressKey key;
+    ASSERT_TRUE(AddressKey::FromNetworkAddress(NetworkAddress("255.255.255.255", 65535), key));
+    EXPECT_EQ(key.packed, 0xFFFFFFFFFFFFull);
+    ASSERT_TRUE(AddressKey::FromNetworkAddress(NetworkAddress("10.0.0.7", 1), key));
+    EXPECT_EQ(key, AddressKey(0x0A000007, 1));
+    EXPECT_EQ(key.ToNetworkAddress().ipAddress, "10.0.0.7");
+
+    for (const char* invalid : {"", "localhost", "1.2.3", "1.2.3.4.5", "256.0.0.1", "1..2.3", "1.2.3.4 ", "::1", "01234.0.0.1"}) {
+        EXPECT_FALSE(AddressKey::FromNetworkAddress(NetworkAddress(invalid, 80), key)) << invalid;
+    }
+}
+
+TEST(AddressKeyTest, NeighbouringPortsHashApart) {
+    AddressKeyHash hash;
+    std::unordered_set<size_t> lowBits;
+    for (unsigned short port = 40000; port < 40064; ++port) {
+        lowBits.insert(hash(AddressKey(0x7F000001, port)) & 63);
+    }
+    // 64 consecutive ports land on most of 64 buckets rather than a handful
+    EXPECT_GT(lowBits.size(), 32u);
+}
+
+TEST(AddressKeyTest, UdpSocketsSendAndReceiveByKey) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto receiver = factory.CreateUdpSocket();
+    auto sender = factory.CreateUdpSocket();
+    ASSERT_TRUE(receiver->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(sender->Bind(NetworkAddress("127.0.0.1", 0)));
+
+    AddressKey receiverKey;
+    ASSERT_TRUE(AddressKey::FromNetworkAddress(receiver->GetLocalAddress(), receiverKey));
+    ASSERT_EQ(sender->SendTo(NetworkUtils::AsBytes("hello"), receiverKey), 5);
+
+    ASSERT_TRUE(receiver->WaitForDataWithTimeout(LONG_TIMEOUT_MS));
+    std::vector<std::byte> buffer(64);
+    AddressKey senderKey;
+    ASSERT_EQ(receiver->ReceiveFrom(std::span<std::byte>(buffer), senderKey), 5);
+    EXPECT_EQ(senderKey.ToNetworkAddress().ipAddress, "127.0.0.1");
+    EXPECT_EQ(senderKey.GetPort(), sender->GetLocalAddress().port);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+#include <string>
+#include <vector>
+
+#include "network/buffer_pool.h"
+#include "network/byte_utils.h"
+#include "network/platform_factory.h"
+#include "utils/test_utils.h"
+
+// Constants for buffer pool testing
+constexpr size_t TEST_BLOCK_SIZE = 256;
+constexpr size_t TEST_CACHE_BLOCKS = 8;
+
+TEST(BufferPoolTest, AcquireReturnsEmptyBufferWithBlockCapacity) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+    PooledBuffer buffer = pool.Acquire();
+
+    ASSERT_TRUE(buffer);
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_EQ(buffer.Capacity(), TEST_BLOCK_SIZE);
+    EXPECT_EQ(buffer.WritableSpan().size(), TEST_BLOCK_SIZE);
+    EXPECT_EQ(buffer.UseCount(), 1u);
+
+    buffer.Resize(TEST_BLOCK_SIZE * 2);
+    EXPECT_EQ(buffer.Size(), TEST_BLOCK_SIZE) << "Resize must clamp to the block capacity";
+}
+
+TEST(BufferPoolTest, ReleasedBlocksAreReusedWithoutAllocating) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+
+    const std::byte* firstBlock = nullptr;
+    {
+        PooledBuffer buffer = pool.Acquire();
+        firstBlock = buffer.Data();
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        PooledBuffer buffer = pool.Acquire();
+        EXPECT_EQ(buffer.Data(), firstBlock);
+    }
+
+    BufferPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 100u);
+    EXPECT_EQ(stats.inUse, 0u);
+    EXPECT_EQ(stats.highWater, 1u);
+    EXPECT_EQ(stats.allocated, 1u);
+}
+
+TEST(BufferPoolTest, SlicesShareTheBlockWithoutCopying) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+    PooledBuffer buffer = pool.Acquire();
+
+    const char text[] = "hello world";
+    std::memcpy(buffer.Data(), text, sizeof(text) - 1);
+    buffer.Resize(sizeof(text) - 1);
+
+    PooledBuffer world = buffer.Slice(6, 5);
+    EXPECT_EQ(world.Data(), buffer.Data() + 6);
+    EXPECT_EQ(world.Size(), 5u);
+    EXPECT_EQ(std::memcmp(world.Data(), "world", 5), 0);
+    EXPECT_EQ(buffer.UseCount(), 2u);
+
+    // Out-of-range slices are clamped to the parent's contents
+    PooledBuffer tail = buffer.Slice(9, 100);
+    EXPECT_EQ(tail.Size(), 2u);
+    EXPECT_EQ(buffer.UseCount(), 3u);
+
+    // A slice cannot grow into the bytes after it
+    EXPECT_EQ(world.Capacity(), 5u);
+    EXPECT_EQ(world.WritableSpan().size(), 5u);
+    world.Resize(50);
+    EXPECT_EQ(world.Size(), 5u);
+    PooledBuffer hello = buffer.Slice(0, 5);
+    hello.Resize(hello.WritableSpan().size() + 1);
+    EXPECT_EQ(hello.Size(), 5u);
+
+    // The block stays checked out until the last slice is gone
+    buffer.Reset();
+    tail.Reset();
+    hello.Reset();
+    EXPECT_EQ(pool.GetStats().inUse, 1u);
+    EXPECT_EQ(std::memcmp(world.Data(), "world", 5), 0);
+    world.Reset();
+    EXPECT_EQ(pool.GetStats().inUse, 0u);
+}
+
+TEST(BufferPoolTest, HighWaterTracksOutstandingBlocks) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+    pool.Reserve(4);
+    EXPECT_EQ(pool.GetStats().allocated, 4u);
+
+    {
+        std::vector<PooledBuffer> buffers;
+        for (int i = 0; i < 6; ++i) {
+            buffers.push_back(pool.Acquire());
+        }
+        EXPECT_EQ(pool.GetStats().inUse, 6u);
+    }
+
+    BufferPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.highWater, 6u);
+    EXPECT_EQ(stats.inUse, 0u);
+    EXPECT_EQ(stats.hits, 4u);
+    EXPECT_EQ(stats.misses, 2u);
+}
+
+TEST(BufferPoolTest, BuffersCanBeReleasedOnAnotherThread) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+    constexpr int BUFFER_COUNT = 32;
+
+    std::vector<PooledBuffer> buffers;
+    for (int i = 0; i < BUFFER_COUNT; ++i) {
+        buffers.push_back(pool.Acquire());
+    }
+
+    std::thread releaser([&buffers]() {
+        buffers.clear();
+    });
+    releaser.join();
+
+    // Blocks cached by the exited thread went back to the shared list
+    for (int i = 0; i < BUFFER_COUNT; ++i) {
+        buffers.push_back(pool.Acquire());
+    }
+    BufferPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.misses, static_cast<uint64_t>(BUFFER_COUNT));
+    EXPECT_EQ(stats.hits, static_cast<uint64_t>(BUFFER_COUNT));
+}
+
+TEST(BufferPoolTest, OversizedAcquireBypassesTheCache) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+
+    PooledBuffer small = pool.Acquire(TEST_BLOCK_SIZE / 2);
+    EXPECT_EQ(small.Capacity(), TEST_BLOCK_SIZE);
+
+    {
+        PooledBuffer large = pool.Acquire(TEST_BLOCK_SIZE * 3);
+        EXPECT_EQ(large.Capacity(), TEST_BLOCK_SIZE * 3);
+        EXPECT_EQ(pool.GetStats().allocated, 2u);
+    }
+
+    // The oversized block was freed rather than cached
+    BufferPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.allocated, 1u);
+    EXPECT_EQ(stats.inUse, 1u);
+    EXPECT_EQ(pool.Acquire().Capacity(), TEST_BLOCK_SIZE);
+}
+
+TEST(BufferPoolTest, AcquireCopyConcatenatesParts) {
+    BufferPool pool(TEST_BLOCK_SIZE, TEST_CACHE_BLOCKS);
+
+    PooledBuffer message = pool.AcquireCopy({NetworkUtils::AsBytes("[12:00] "),
+                                             NetworkUtils::AsBytes("alice: hi"),
+                                             NetworkUtils::AsBytes("\n")});
+    EXPECT_EQ(NetworkUtils::AsStringView(message.Span()), "[12:00] alice: hi\n");
+
+    // Larger than a block: falls back to a dedicated block
+    std::string large(TEST_BLOCK_SIZE * 2, 'x');
+    PooledBuffer copy = pool.AcquireCopy({NetworkUtils::AsBytes(large)});
+    EXPECT_EQ(NetworkUtils::AsStringView(copy.Span()), large);
+}
+
+TEST(BufferPoolTest, UdpReceiveFillsPooledBufferDirectly) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto receiver = factory.CreateUdpSocket();
+    auto sender = factory.CreateUdpSocket();
+    ASSERT_TRUE(receiver->Bind(NetworkAddress("127.0.0.1", 0)));
+    NetworkAddress receiverAddress = receiver->GetLocalAddress();
+
+    std::vector<std::byte> payload = NetworkUtils::StringToBytes("pooled datagram");
+    ASSERT_EQ(sender->SendTo(payload, receiverAddress), static_cast<int>(payload.size()));
+    ASSERT_TRUE(receiver->WaitForDataWithTimeout(test_utils::timeouts::LONG_TIMEOUT_MS));
+
+    BufferPool pool;
+    PooledBuffer buffer = pool.Acquire();
+    NetworkAddress from;
+    int bytesRead = receiver->ReceiveFrom(buffer.WritableSpan(), from);
+    ASSERT_EQ(bytesRead, static_cast<int>(payload.size()));
+    buffer.Resize(bytesRead);
+
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), buffer.Span().begin()));
+    EXPECT_EQ(from.ipAddress, "127.0.0.1");
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "network/byte_utils.h"
+
+TEST(ByteUtilsTest, RoundTripPreservesAllByteValues) {
+    std::string text;
+    for (int value = 0; value < 256; ++value) {
+        text.push_back(static_cast<char>(value));
+    }
+
+    std::vector<std::byte> bytes = NetworkUtils::StringToBytes(text);
+    ASSERT_EQ(bytes.size(), text.size());
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        EXPECT_EQ(std::to_integer<int>(bytes[i]), i);
+    }
+    EXPECT_EQ(NetworkUtils::BytesToString(bytes), text);
+}
+
+TEST(ByteUtilsTest, EmptyConversions) {
+    EXPECT_TRUE(NetworkUtils::StringToBytes("").empty());
+    EXPECT_TRUE(NetworkUtils::BytesToString(std::vector<std::byte>{}).empty());
+    EXPECT_TRUE(NetworkUtils::AsBytes("").empty());
+    EXPECT_TRUE(NetworkUtils::AsStringView({}).empty());
+}
+
+TEST(ByteUtilsTest, ViewsShareStorage) {
+    std::string text = "Hello, World!";
+    std::span<const std::byte> bytes = NetworkUtils::AsBytes(text);
+    EXPECT_EQ(bytes.size(), text.size());
+    EXPECT_EQ(static_cast<const void*>(bytes.data()), static_cast<const void*>(text.data()));
+
+    std::vector<std::byte> buffer = NetworkUtils::StringToBytes(text);
+    std::string_view view = NetworkUtils::AsStringView(buffer);
+    EXPECT_EQ(view, text);
+    EXPECT_EQ(static_cast<const void*>(view.data()), static_cast<const void*>(buffer.data()));
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/cached_timestamp.h"
+
+// Helper producing the text the way the chat servers used to, through ctime
+static std::string CtimeTimestamp(std::time_t second) {
+    std::string text = std::ctime(&second);
+    if (!text.empty() && text.back() == '\n') {
+        text.pop_back();
+    }
+    return "[" + text + "] ";
+}
+
+TEST(CachedTimestampTest, DefaultFormatMatchesCtime) {
+    CachedTimestamp timestamps;
+    for (std::time_t second : {std::time_t(0), std::time_t(1700000000), std::time_t(1701388800)}) {
+        EXPECT_EQ(timestamps.At(second).View(), CtimeTimestamp(second));
+    }
+}
+
+TEST(CachedTimestampTest, FormatsOncePerSecond) {
+    CachedTimestamp timestamps("%H:%M:%S");
+    const std::time_t second = 1700000000;
+
+    std::string first(timestamps.At(second).View());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(timestamps.At(second).View(), first);
+    }
+    EXPECT_EQ(timestamps.GetFormatCount(), 1u);
+
+    EXPECT_NE(timestamps.At(second + 1).View(), first);
+    EXPECT_EQ(timestamps.GetFormatCount(), 2u);
+}
+
+TEST(CachedTimestampTest, TextIsIndependentOfTheCache) {
+    CachedTimestamp timestamps("%Y");
+    CachedTimestamp::Text old = timestamps.At(0);
+    std::string expected(old.View());
+
+    // Reformatting for another second must not change a copy already handed out
+    timestamps.At(1700000000);
+    EXPECT_EQ(old.View(), expected);
+}
+
+TEST(CachedTimestampTest, ConcurrentCallersSeeConsistentText) {
+    CachedTimestamp timestamps;
+    const std::time_t base = 1700000000;
+
+    // ctime is not thread-safe, so the expected texts are computed up front
+    std::vector<std::string> expected;
+    for (int i = 0; i < 3; ++i) {
+        expected.push_back(CtimeTimestamp(base + i));
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> consistent(4, 1);  // Not vector<bool>: threads write neighbouring elements
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                if (timestamps.At(base + (i % 3)).View() != expected[i % 3]) {
+                    consistent[t] = 0;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int ok : consistent) {
+        EXPECT_TRUE(ok);
+    }
+}
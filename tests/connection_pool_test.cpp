@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/connection_pool.h"
+#include "network/platform_factory.h"
+#include "network/byte_utils.h"
+
+using namespace std::chrono_literals;
+
+// Helper functions
+namespace {
+    // Loopback listener; connections complete in its backlog whether or not they are accepted
+    struct Backend {
+        std::unique_ptr<ITcpListener> listener = NetworkFactorySingleton::GetInstance().CreateTcpListener();
+        NetworkAddress address;
+
+        Backend() {
+            EXPECT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+            EXPECT_TRUE(listener->Listen(64));
+            address = NetworkAddress("127.0.0.1", listener->GetLocalAddress().port);
+        }
+    };
+
+    ConnectionPool::Config SmallConfig(size_t maxPerHost) {
+        ConnectionPool::Config config;
+        config.maxPerHost = maxPerHost;
+        config.maxIdlePerHost = maxPerHost;
+        return config;
+    }
+}
+
+TEST(ConnectionPoolTest, ReusesAReturnedConnection) {
+    Backend backend;
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance());
+
+    ITcpSocket* first;
+    {
+        ConnectionPool::Lease lease = pool.Checkout(backend.address);
+        ASSERT_TRUE(lease);
+        EXPECT_GT(lease->Send(NetworkUtils::AsBytes("ping")), 0);
+        first = lease.Get();
+    }
+    EXPECT_EQ(pool.GetIdleCount(backend.address), 1u);
+
+    ConnectionPool::Lease lease = pool.Checkout(backend.address);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease.Get(), first);
+
+    ConnectionPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.connected, 1u);
+    EXPECT_EQ(stats.reused, 1u);
+    EXPECT_EQ(stats.open, 1u);
+    EXPECT_EQ(stats.idle, 0u);
+}
+
+TEST(ConnectionPoolTest, RefusesCheckoutsBeyondMaxPerHost) {
+    Backend backend;
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance(), SmallConfig(2));
+
+    ConnectionPool::Lease a = pool.Checkout(backend.address);
+    ConnectionPool::Lease b = pool.Checkout(backend.address);
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+    EXPECT_FALSE(pool.Checkout(backend.address));
+    EXPECT_EQ(pool.GetStats().limitReached, 1u);
+
+    a.Release();
+    EXPECT_FALSE(a);
+    EXPECT_TRUE(pool.Checkout(backend.address));
+    EXPECT_EQ(pool.GetStats().connected, 2u);
+}
+
+TEST(ConnectionPoolTest, ReplacesAnIdleConnectionThePeerClosed) {
+    Backend backend;
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance());
+
+    pool.Checkout(backend.address);     // Returned at once
+    auto accepted = backend.listener->AcceptTcp();
+    ASSERT_TRUE(accepted);
+    accepted->Close();
+    std::this_thread::sleep_for(20ms);
+
+    ConnectionPool::Lease lease = pool.Checkout(backend.address);
+    ASSERT_TRUE(lease);
+    ConnectionPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.staleClosed, 1u);
+    EXPECT_EQ(stats.connected, 2u);
+    EXPECT_EQ(stats.reused, 0u);
+    EXPECT_EQ(stats.open, 1u);
+}
+
+TEST(ConnectionPoolTest, DiscardClosesTheConnection) {
+    Backend backend;
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance());
+
+    ConnectionPool::Lease lease = pool.Checkout(backend.address);
+    ASSERT_TRUE(lease);
+    lease.Discard();
+    EXPECT_FALSE(lease);
+
+    ConnectionPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.discarded, 1u);
+    EXPECT_EQ(stats.open, 0u);
+    EXPECT_EQ(pool.GetIdleCount(backend.address), 0u);
+}
+
+TEST(ConnectionPoolTest, WarmsUpAndEvictsIdleConnections) {
+    Backend backend;
+    ConnectionPool::Config config = SmallConfig(4);
+    config.idleTimeout = 1s;
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance(), config);
+
+    EXPECT_EQ(pool.WarmUp(backend.address, 3), 3u);
+    EXPECT_EQ(pool.WarmUp(backend.address, 10), 4u);     // Capped by the per-host limits
+    EXPECT_EQ(pool.GetStats().connected, 4u);
+
+    {
+        ConnectionPool::Lease lease = pool.Checkout(backend.address);
+        EXPECT_TRUE(lease);
+        EXPECT_EQ(pool.GetStats().reused, 1u);
+    }
+
+    EXPECT_EQ(pool.EvictIdle(ConnectionPool::Clock::now()), 0u);
+    EXPECT_EQ(pool.EvictIdle(ConnectionPool::Clock::now() + 2s), 4u);
+    ConnectionPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.evicted, 4u);
+    EXPECT_EQ(stats.open, 0u);
+    EXPECT_EQ(stats.idle, 0u);
+}
+
+TEST(ConnectionPoolTest, ReportsConnectFailures) {
+    NetworkAddress closed;
+    {
+        Backend backend;
+        closed = backend.address;
+    }
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance());
+
+    EXPECT_FALSE(pool.Checkout(closed));
+    EXPECT_FALSE(pool.Checkout(NetworkAddress("localhost", 80)));  // Not a dotted quad
+    ConnectionPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.connectFailures, 2u);
+    EXPECT_EQ(stats.open, 0u);
+}
+
+TEST(ConnectionPoolTest, ConcurrentCheckoutsStayWithinTheLimit) {
+    Backend backends[2];
+    ConnectionPool pool(NetworkFactorySingleton::GetInstance(), SmallConfig(3));
+    std::atomic<int> served{0};
+    std::atomic<int> refused{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 6; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 200; ++i) {
+                ConnectionPool::Lease lease = pool.Checkout(backends[(t + i) % 2].address);
+                (lease ? served : refused)++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ConnectionPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(served + refused, 1200);
+    EXPECT_EQ(stats.limitReached, static_cast<uint64_t>(refused.load()));
+    EXPECT_LE(stats.connected, 6u);
+    EXPECT_EQ(stats.open, stats.idle);
+    EXPECT_EQ(stats.reused + stats.connected, static_cast<uint64_t>(served.load()));
+}
@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/feed_handler.h"
+#include "network/platform_factory.h"
+#include "network/socket_options.h"
+#include "network/byte_utils.h"
+
+using namespace std::chrono_literals;
+using Clock = FeedArbiter::Clock;
+using Line = FeedArbiter::Line;
+
+// Helper functions
+namespace {
+    constexpr const char* SESSION = "TEST000001";
+
+    // MoldUDP64 packet carrying "m<sequence>" for each sequence number in [first, first + count)
+    std::vector<std::byte> Packet(uint64_t first, size_t count, const char* session = SESSION) {
+        std::vector<std::string> texts;
+        for (size_t i = 0; i < count; ++i) {
+            texts.push_back("m" + std::to_string(first + i));
+        }
+        std::vector<std::span<const std::byte>> messages;
+        for (const std::string& text : texts) {
+            messages.push_back(NetworkUtils::AsBytes(text));
+        }
+        std::vector<std::byte> packet;
+        FeedArbiter::EncodePacket(packet, session, first, messages);
+        return packet;
+    }
+
+    std::vector<std::string> Expected(uint64_t first, uint64_t last) {
+        std::vector<std::string> texts;
+        for (uint64_t sequence = first; sequence <= last; ++sequence) {
+            texts.push_back("m" + std::to_string(sequence));
+        }
+        return texts;
+    }
+
+    // Records what an arbiter passes on
+    struct Recorder {
+        std::vector<std::string> messages;
+        std::vector<uint64_t> sequences;
+        std::vector<FeedArbiter::Gap> gaps;
+
+        FeedArbiter::MessageCallback OnMessage() {
+            return [this](uint64_t sequence, std::span<const std::byte> message) {
+                sequences.push_back(sequence);
+                messages.push_back(NetworkUtils::BytesToString(message));
+            };
+        }
+
+        FeedArbiter::GapCallback OnGap() {
+            return [this](const FeedArbiter::Gap& gap) { gaps.push_back(gap); };
+        }
+    };
+}
+
+TEST(FeedArbiterTest, DeliversEachMessageOnceAcrossBothLines) {
+    Recorder recorder;
+    FeedArbiter arbiter(recorder.OnMessage(), recorder.OnGap());
+    auto now = Clock::now();
+
+    for (uint64_t first = 1; first <= 100; first += 10) {
+        ASSERT_TRUE(arbiter.Process(Packet(first, 10), Line::A, now));
+        ASSERT_TRUE(arbiter.Process(Packet(first, 10), Line::B, now));
+    }
+
+    EXPECT_EQ(recorder.messages, Expected(1, 100));
+    EXPECT_TRUE(recorder.gaps.empty());
+    const FeedArbiter::Stats& stats = arbiter.GetStats();
+    EXPECT_EQ(stats.messagesDelivered, 100u);
+    EXPECT_EQ(stats.duplicates, 100u);
+    EXPECT_EQ(stats.messagesWon[0], 100u);
+    EXPECT_EQ(stats.messagesWon[1], 0u);
+    EXPECT_EQ(arbiter.GetNextSequence(), 101u);
+}
+
+TEST(FeedArbiterTest, FillsALossOnOneLineFromTheOther) {
+    Recorder recorder;
+    FeedArbiter arbiter(recorder.OnMessage(), recorder.OnGap(), 10ms);
+    auto now = Clock::now();
+
+    // A loses 11-20; its 21-30 is held until B, 200 us behind, brings 11-20
+    arbiter.Process(Packet(1, 10), Line::A, now);
+    arbiter.Process(Packet(21, 10), Line::A, now + 100us);
+    EXPECT_TRUE(arbiter.HasGap());
+    EXPECT_EQ(arbiter.GetHeldCount(), 10u);
+    EXPECT_EQ(recorder.messages, Expected(1, 10));
+
+    arbiter.Process(Packet(1, 10), Line::B, now + 200us);
+    arbiter.Process(Packet(11, 10), Line::B, now + 300us);
+    arbiter.Process(Packet(21, 10), Line::B, now + 400us);
+
+    EXPECT_EQ(recorder.messages, Expected(1, 30));
+    EXPECT_FALSE(arbiter.HasGap());
+    ASSERT_EQ(recorder.gaps.size(), 1u);
+    EXPECT_EQ(recorder.gaps[0].resolution, FeedArbiter::GapResolution::Recovered);
+    EXPECT_EQ(recorder.gaps[0].firstSequence, 11u);
+    EXPECT_EQ(recorder.gaps[0].count, 10u);
+    EXPECT_EQ(recorder.gaps[0].latency, 200us);
+    EXPECT_EQ(arbiter.GetStats().messagesWon[1], 10u);
+    EXPECT_EQ(arbiter.GetStats().gapsRecovered, 1u);
+}
+
+TEST(FeedArbiterTest, ReportsMessagesLostOnBothLinesAfterTheTimeout) {
+    Recorder recorder;
+    FeedArbiter arbiter(recorder.OnMessage(), recorder.OnGap(), 5ms);
+    auto now = Clock::now();
+
+    arbiter.Process(Packet(1, 5), Line::A, now);
+    arbiter.Process(Packet(9, 4), Line::A, now + 1ms);
+    arbiter.Process(Packet(9, 4), Line::B, now + 2ms);
+    arbiter.Update(now + 5ms);
+    EXPECT_EQ(recorder.messages, Expected(1, 5));
+
+    // Six milliseconds after 9-12 showed the gap, 6-8 are given up and delivery moves on
+    arbiter.Update(now + 6ms);
+    std::vector<std::string> expected = Expected(1, 5);
+    for (const std::string& text : Expected(9, 12)) {
+        expected.push_back(text);
+    }
+    EXPECT_EQ(recorder.messages, expected);
+    ASSERT_EQ(recorder.gaps.size(), 1u);
+    EXPECT_EQ(recorder.gaps[0].resolution, FeedArbiter::GapResolution::Lost);
+    EXPECT_EQ(recorder.gaps[0].firstSequence, 6u);
+    EXPECT_EQ(recorder.gaps[0].count, 3u);
+    EXPECT_EQ(recorder.gaps[0].latency, 5ms);
+    EXPECT_EQ(arbiter.GetStats().messagesLost, 3u);
+
+    // A late copy of a skipped message is a duplicate now
+    arbiter.Process(Packet(6, 3), Line::B, now + 7ms);
+    EXPECT_EQ(recorder.messages.size(), expected.size());
+}
+
+TEST(FeedArbiterTest, HeartbeatsRevealALostTail) {
+    Recorder recorder;
+    FeedArbiter arbiter(recorder.OnMessage(), recorder.OnGap(), 5ms);
+    auto now = Clock::now();
+
+    arbiter.Process(Packet(1, 3), Line::A, now);
+    // 4-6 were lost on A; the heartbeat says 7 is next
+    arbiter.Process(Packet(7, 0), Line::A, now + 1ms);
+    EXPECT_TRUE(arbiter.HasGap());
+
+    arbiter.Process(Packet(4, 3), Line::B, now + 2ms);
+    EXPECT_EQ(recorder.messages, Expected(1, 6));
+    ASSERT_EQ(recorder.gaps.size(), 1u);
+    EXPECT_EQ(recorder.gaps[0].resolution, FeedArbiter::GapResolution::Recovered);
+    EXPECT_EQ(recorder.gaps[0].count, 3u);
+    EXPECT_EQ(recorder.gaps[0].latency, 1ms);
+}
+
+TEST(FeedArbiterTest, UsesOnlyTheNewPartOfOverlappingPackets) {
+    Recorder recorder;
+    FeedArbiter arbiter(recorder.OnMessage(), recorder.OnGap());
+    auto now = Clock::now();
+
+    arbiter.Process(Packet(1, 5), Line::A, now);
+    arbiter.Process(Packet(3, 6), Line::B, now);
+    arbiter.Process(Packet(7, 4), Line::A, now);
+
+    EXPECT_EQ(recorder.messages, Expected(1, 10));
+    EXPECT_EQ(recorder.sequences.back(), 10u);
+    EXPECT_EQ(arbiter.GetStats().messagesWon[1], 3u);
+    EXPECT_EQ(arbiter.GetStats().duplicates, 5u);
+}
+
+TEST(FeedArbiterTest, PassesInOrderMessagesWithoutCopying) {
+    std::vector<std::byte> packet = Packet(1, 3);
+    size_t inside = 0;
+    FeedArbiter arbiter([&](uint64_t, std::span<const std::byte> message) {
+        inside += message.data() >= packet.data() && message.data() + message.size() <= packet.data() + packet.size();
+    });
+
+    arbiter.Process(packet, Line::A);
+    EXPECT_EQ(inside, 3u);
+}
+
+TEST(FeedArbiterTest, RejectsMalformedPacketsAndOtherSessions) {
+    Recorder recorder;
+    FeedArbiter arbiter(recorder.OnMessage(), recorder.OnGap());
+
+    EXPECT_FALSE(arbiter.Process(NetworkUtils::AsBytes("short"), Line::A));
+    ASSERT_TRUE(arbiter.Process(Packet(1, 2), Line::A));
+    EXPECT_FALSE(arbiter.Process(Packet(3, 2, "OTHER00001"), Line::B));
+
+    // A message length running past the end of the datagram
+    std::vector<std::byte> truncated = Packet(3, 2);
+    truncated.resize(truncated.size() - 1);
+    EXPECT_FALSE(arbiter.Process(truncated, Line::A));
+
+    EXPECT_EQ(arbiter.GetStats().malformed, 3u);
+    EXPECT_EQ(recorder.messages.size(), 3u);   // The truncated packet's first message was intact
+
+    arbiter.Reset();
+    EXPECT_TRUE(arbiter.Process(Packet(500, 1, "OTHER00001"), Line::B));
+    EXPECT_EQ(recorder.messages.back(), "m500");
+}
+
+TEST(FeedHandlerTest, ArbitratesTwoMulticastGroupsOverLoopback) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    Recorder recorder;
+    FeedHandler handler(recorder.OnMessage(), recorder.OnGap(), 50ms);
+    FeedHandler::LineConfig lineA{NetworkAddress("239.255.70.1", 0), "127.0.0.1"};
+    FeedHandler::LineConfig lineB{NetworkAddress("239.255.70.2", 0), "127.0.0.1"};
+    if (!handler.Open(factory, lineA, lineB)) {
+        GTEST_SKIP() << "multicast is not available on the loopback interface";
+    }
+    lineA.group.port = handler.GetLocalAddress(Line::A).port;
+    lineB.group.port = handler.GetLocalAddress(Line::B).port;
+
+    auto publisher = factory.CreateUdpSocket();
+    ASSERT_TRUE(SocketOptions::SetMulticastInterface(publisher.get(), "127.0.0.1"));
+
+    // Line A drops every fourth packet; B carries everything
+    for (uint64_t packet = 0; packet < 40; ++packet) {
+        std::vector<std::byte> datagram = Packet(1 + packet * 5, 5);
+        if (packet % 4 != 3) {
+            ASSERT_GT(publisher->SendTo(std::span<const std::byte>(datagram), lineA.group), 0);
+        }
+        ASSERT_GT(publisher->SendTo(std::span<const std::byte>(datagram), lineB.group), 0);
+    }
+
+    for (int i = 0; i < 50 && recorder.messages.size() < 200; ++i) {
+        handler.Poll(20);
+    }
+
+    EXPECT_EQ(recorder.messages, Expected(1, 200));
+    const FeedArbiter::Stats& stats = handler.GetArbiter().GetStats();
+    EXPECT_EQ(stats.packets[0], 30u);
+    EXPECT_EQ(stats.packets[1], 40u);
+    EXPECT_EQ(stats.messagesLost, 0u);
+    EXPECT_EQ(stats.messagesWon[0] + stats.messagesWon[1], 200u);
+}
+
+TEST(FeedHandlerTest, StopBeforeRunIsNotLost) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    Recorder recorder;
+    FeedHandler handler(recorder.OnMessage(), recorder.OnGap(), 50ms);
+    FeedHandler::LineConfig lineA{NetworkAddress("239.255.70.3", 0), "127.0.0.1"};
+    FeedHandler::LineConfig lineB{NetworkAddress("239.255.70.4", 0), "127.0.0.1"};
+    if (!handler.Open(factory, lineA, lineB)) {
+        GTEST_SKIP() << "multicast is not available on the loopback interface";
+    }
+
+    // Would block forever if Run re-armed the flag Stop had already cleared
+    handler.Stop();
+    auto start = std::chrono::steady_clock::now();
+    handler.Run(1000);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "network/flat_hash_map.h"
+#include "network/network.h"
+#include "network/sharded_registry.h"
+
+// Hash that sends every key to the same home slot, so probing and erase shifting do all the work
+struct CollidingHash {
+    size_t operator()(int) const { return 0; }
+};
+
+TEST(FlatHashMapTest, InsertFindErase) {
+    FlatHashMap<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.emplace(1, "one").second);
+    EXPECT_TRUE(map.emplace(2, "two").second);
+    EXPECT_FALSE(map.emplace(1, "uno").second);
+    EXPECT_EQ(map.size(), 2u);
+
+    auto it = map.find(1);
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->second, "one");
+    EXPECT_EQ(map.find(3), map.end());
+    EXPECT_EQ(map.count(2), 1u);
+
+    map.erase(it);
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_EQ(map.erase(2), 1u);
+    EXPECT_EQ(map.erase(2), 0u);
+    EXPECT_TRUE(map.empty());
+
+    map[5] = "five";
+    EXPECT_EQ(map[5], "five");
+}
+
+TEST(FlatHashMapTest, EraseKeepsCollidingRunsReachable) {
+    FlatHashMap<int, int, CollidingHash> map;
+    for (int i = 0; i < 10; ++i) {
+        map.emplace(i, i * 10);
+    }
+
+    // Removing from the middle of one long probe run must not cut off the entries behind it
+    map.erase(0);
+    map.erase(5);
+    for (int i = 0; i < 10; ++i) {
+        auto it = map.find(i);
+        if (i == 0 || i == 5) {
+            EXPECT_EQ(it, map.end());
+        } else {
+            ASSERT_NE(it, map.end()) << i;
+            EXPECT_EQ(it->second, i * 10);
+        }
+    }
+    EXPECT_EQ(map.size(), 8u);
+}
+
+TEST(FlatHashMapTest, GrowsAndIterates) {
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.emplace(i, -i);
+    }
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_GE(map.capacity() * 3, map.size() * 4);
+
+    std::set<int> keys;
+    for (const auto& [key, value] : map) {
+        EXPECT_EQ(value, -key);
+        keys.insert(key);
+    }
+    EXPECT_EQ(keys.size(), 1000u);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.begin(), map.end());
+
+    FlatHashMap<int, int> reserved(5000);
+    size_t capacity = reserved.capacity();
+    for (int i = 0; i < 5000; ++i) {
+        reserved.emplace(i, i);
+    }
+    EXPECT_EQ(reserved.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderChurn) {
+    FlatHashMap<AddressKey, int, AddressKeyHash> map;
+    std::unordered_map<uint64_t, int> reference;
+    std::mt19937 random(42);
+
+    // A small key space keeps the table dense and the probe runs long
+    for (int i = 0; i < 100000; ++i) {
+        AddressKey key(0x0A000000 | (random() % 64), static_cast<unsigned short>(random() % 64));
+        switch (random() % 3) {
+        case 0:
+            EXPECT_EQ(map.emplace(key, i).second, reference.emplace(key.packed, i).second);
+            break;
+        case 1:
+            EXPECT_EQ(map.erase(key), reference.erase(key.packed));
+            break;
+        default: {
+            auto it = map.find(key);
+            auto expected = reference.find(key.packed);
+            ASSERT_EQ(it == map.end(), expected == reference.end());
+            if (it != map.end()) {
+                EXPECT_EQ(it->second, expected->second);
+            }
+        }
+        }
+    }
+    EXPECT_EQ(map.size(), reference.size());
+}
+
+TEST(FlatHashMapTest, ServesAsShardedRegistryMap) {
+    using Map = FlatHashMap<AddressKey, std::shared_ptr<std::string>, AddressKeyHash>;
+    ShardedRegistry<AddressKey, std::string, AddressKeyHash, std::equal_to<AddressKey>, Map> registry(8);
+
+    for (unsigned short port = 1; port <= 500; ++port) {
+        ASSERT_TRUE(registry.Insert(AddressKey(0x7F000001, port), std::make_shared<std::string>(std::to_string(port))));
+    }
+    ASSERT_TRUE(registry.Find(AddressKey(0x7F000001, 250)));
+    EXPECT_EQ(*registry.Find(AddressKey(0x7F000001, 250)), "250");
+    EXPECT_TRUE(registry.Remove(AddressKey(0x7F000001, 250)));
+    EXPECT_FALSE(registry.Find(AddressKey(0x7F000001, 250)));
+
+    size_t visited = 0;
+    registry.ForEach([&](const AddressKey& key, const std::shared_ptr<std::string>& value) {
+        EXPECT_EQ(*value, std::to_string(key.GetPort()));
+        ++visited;
+    });
+    EXPECT_EQ(visited, 499u);
+}
@@ -0,0 +1,222 @@
+#include <cerrno>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/framed_connection.h"
+#include "network/platform_factory.h"
+#include "network/byte_utils.h"
+#include "network/socket_poller.h"
+#include "utils/test_utils.h"
+
+using namespace test_utils::constants;
+using ::testing::_;
+using ::testing::Return;
+
+// Mock TCP socket that also mocks the span-based overloads used by FramedConnection
+class MockFramedTcpSocket final : public ITcpSocket {
+public:
+    MOCK_METHOD(void, Close, (), (override));
+    MOCK_METHOD(bool, Bind, (const NetworkAddress& localAddress), (override));
+    MOCK_METHOD(NetworkAddress, GetLocalAddress, (), (const, override));
+    MOCK_METHOD(bool, IsValid, (), (const, override));
+    MOCK_METHOD(bool, Connect, (const NetworkAddress& remoteAddress), (override));
+    MOCK_METHOD(int, Send, (const std::vector<std::byte>& data), (override));
+    MOCK_METHOD(int, Receive, (std::vector<std::byte>& buffer), (override));
+    MOCK_METHOD(int, Send, (std::span<const std::byte> data), (override));
+    MOCK_METHOD(int, Receive, (std::span<std::byte> buffer), (override));
+    MOCK_METHOD(NetworkAddress, GetRemoteAddress, (), (const, override));
+    MOCK_METHOD(bool, SetNoDelay, (bool enable), (override));
+    MOCK_METHOD(bool, WaitForDataWithTimeout, (int timeoutMs), (override));
+    MOCK_METHOD(bool, SetConnectTimeout, (int timeoutMs), (override));
+    MOCK_METHOD(bool, SetSocketOption, (int level, int optionName, const void* optionValue, socklen_t optionLen), (override));
+    MOCK_METHOD(bool, GetSocketOption, (int level, int optionName, void* optionValue, socklen_t* optionLen), (const, override));
+};
+
+// Fixture with a connected loopback TCP pair
+class FramedConnectionTest : public ::testing::Test {
+protected:
+    std::unique_ptr<ITcpListener> listener;
+    std::unique_ptr<ITcpSocket> client;
+    std::unique_ptr<ITcpSocket> server;
+
+    void SetUp() override {
+        auto& factory = NetworkFactorySingleton::GetInstance();
+        listener = factory.CreateTcpListener();
+        ASSERT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+        ASSERT_TRUE(listener->Listen(SERVER_BACKLOG_SIZE));
+
+        client = factory.CreateTcpSocket();
+        ASSERT_TRUE(client->Connect(listener->GetLocalAddress()));
+        server = listener->AcceptTcp();
+        ASSERT_TRUE(server);
+    }
+
+    // Reads frames until `count` have arrived (or the connection fails)
+    std::vector<std::string> ReadFrames(FramedConnection& connection, size_t count) {
+        std::vector<std::string> frames;
+        std::span<const std::byte> frame;
+        while (frames.size() < count) {
+            auto status = connection.NextFrame(frame);
+            if (status == FramedConnection::ReadStatus::NeedMoreData) {
+                if (!server->WaitForDataWithTimeout(test_utils::timeouts::LONG_TIMEOUT_MS))
+                    break;
+                status = connection.ReadFrame(frame);
+            }
+            if (status == FramedConnection::ReadStatus::Frame) {
+                frames.emplace_back(reinterpret_cast<const char*>(frame.data()), frame.size());
+            } else if (status != FramedConnection::ReadStatus::NeedMoreData) {
+                break;
+            }
+        }
+        return frames;
+    }
+};
+
+TEST_F(FramedConnectionTest, CoalescedFramesAreSplit) {
+    FramedConnection sender(*client);
+    FramedConnection receiver(*server);
+    ASSERT_TRUE(receiver.IsValid());
+
+    ASSERT_TRUE(sender.QueueFrame(NetworkUtils::StringToBytes("first")));
+    ASSERT_TRUE(sender.QueueFrame(NetworkUtils::StringToBytes("")));
+    ASSERT_TRUE(sender.QueueFrame(NetworkUtils::StringToBytes("third frame")));
+    EXPECT_EQ(sender.Flush(), static_cast<int>(3 * 4 + 5 + 0 + 11));
+    EXPECT_EQ(sender.GetPendingBytes(), 0u);
+
+    auto frames = ReadFrames(receiver, 3);
+    ASSERT_EQ(frames.size(), 3u);
+    EXPECT_EQ(frames[0], "first");
+    EXPECT_EQ(frames[1], "");
+    EXPECT_EQ(frames[2], "third frame");
+}
+
+TEST_F(FramedConnectionTest, SplitFrameIsReassembled) {
+    FramedConnection receiver(*server);
+
+    // Prefix for a 10-byte frame, delivered in pieces
+    std::vector<std::byte> part1 = {std::byte{0}, std::byte{0}};
+    std::vector<std::byte> part2 = {std::byte{0}, std::byte{10}, std::byte{'0'}, std::byte{'1'}};
+    std::vector<std::byte> part3 = NetworkUtils::StringToBytes("23456789");
+
+    std::span<const std::byte> frame;
+    for (const auto& part : {part1, part2}) {
+        ASSERT_EQ(client->Send(part), static_cast<int>(part.size()));
+        ASSERT_TRUE(server->WaitForDataWithTimeout(test_utils::timeouts::LONG_TIMEOUT_MS));
+        EXPECT_EQ(receiver.ReadFrame(frame), FramedConnection::ReadStatus::NeedMoreData);
+    }
+
+    ASSERT_EQ(client->Send(part3), static_cast<int>(part3.size()));
+    auto frames = ReadFrames(receiver, 1);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], "0123456789");
+}
+
+TEST_F(FramedConnectionTest, VarintPrefixRoundTrip) {
+    FramedConnection sender(*client, FramedConnection::PrefixFormat::Varint);
+    FramedConnection receiver(*server, FramedConnection::PrefixFormat::Varint);
+
+    // Lengths on both sides of the 1-, 2- and 3-byte varint boundaries
+    std::vector<size_t> lengths = {0, 127, 128, 16383, 16384, 70000};
+    for (size_t length : lengths) {
+        ASSERT_TRUE(sender.QueueFrame(std::vector<std::byte>(length, std::byte{'v'})));
+    }
+    ASSERT_GT(sender.Flush(), 0);
+
+    auto frames = ReadFrames(receiver, lengths.size());
+    ASSERT_EQ(frames.size(), lengths.size());
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        EXPECT_EQ(frames[i].size(), lengths[i]);
+    }
+}
+
+TEST_F(FramedConnectionTest, OversizedFramesAreRejected) {
+    constexpr size_t MAX_FRAME = 16;
+    FramedConnection sender(*client, FramedConnection::PrefixFormat::FixedU32, MAX_FRAME);
+    FramedConnection receiver(*server, FramedConnection::PrefixFormat::FixedU32, MAX_FRAME);
+
+    EXPECT_FALSE(sender.QueueFrame(std::vector<std::byte>(MAX_FRAME + 1)));
+    EXPECT_EQ(sender.GetPendingBytes(), 0u);
+
+    // A peer announcing a 1 MB frame trips the receiver's guard before any payload arrives
+    std::vector<std::byte> prefix = {std::byte{0}, std::byte{0x10}, std::byte{0}, std::byte{0}};
+    ASSERT_EQ(client->Send(prefix), 4);
+    ASSERT_TRUE(server->WaitForDataWithTimeout(test_utils::timeouts::LONG_TIMEOUT_MS));
+    std::span<const std::byte> frame;
+    EXPECT_EQ(receiver.ReadFrame(frame), FramedConnection::ReadStatus::FrameTooLarge);
+}
+
+TEST_F(FramedConnectionTest, ClosedPeerIsReported) {
+    FramedConnection receiver(*server);
+    client->Close();
+
+    ASSERT_TRUE(server->WaitForDataWithTimeout(test_utils::timeouts::LONG_TIMEOUT_MS));
+    std::span<const std::byte> frame;
+    EXPECT_EQ(receiver.ReadFrame(frame), FramedConnection::ReadStatus::Closed);
+}
+
+TEST(FramedConnectionBatchTest, FlushUsesSingleSendForQueuedFrames) {
+    MockFramedTcpSocket socket;
+    FramedConnection connection(socket);
+
+    ASSERT_TRUE(connection.QueueFrame(NetworkUtils::StringToBytes("a")));
+    ASSERT_TRUE(connection.QueueFrame(NetworkUtils::StringToBytes("bb")));
+    ASSERT_TRUE(connection.QueueFrame(NetworkUtils::StringToBytes("ccc")));
+
+    EXPECT_CALL(socket, Send(testing::Matcher<std::span<const std::byte>>(_)))
+        .WillOnce([](std::span<const std::byte> data) { return static_cast<int>(data.size()); });
+    EXPECT_EQ(connection.Flush(), 18);
+}
+
+TEST(FramedConnectionBatchTest, PartialSendsAreResumed) {
+    MockFramedTcpSocket socket;
+    FramedConnection connection(socket);
+    ASSERT_TRUE(connection.QueueFrame(NetworkUtils::StringToBytes("payload")));
+
+    EXPECT_CALL(socket, Send(testing::Matcher<std::span<const std::byte>>(_)))
+        .WillOnce(Return(4))
+        .WillOnce(Return(-1))
+        .WillOnce(Return(-1))
+        .WillOnce([](std::span<const std::byte> data) { return static_cast<int>(data.size()); });
+
+    // The bytes that went out before the failure are still reported
+    EXPECT_EQ(connection.Flush(), 4);
+    EXPECT_EQ(connection.GetPendingBytes(), 7u);
+    EXPECT_EQ(connection.Flush(), -1);
+    EXPECT_EQ(connection.GetPendingBytes(), 7u);
+    EXPECT_EQ(connection.Flush(), 7);
+    EXPECT_EQ(connection.GetPendingBytes(), 0u);
+}
+
+TEST(FramedConnectionBatchTest, WouldBlockAfterPartialSendKeepsProgress) {
+    MockFramedTcpSocket socket;
+    FramedConnection connection(socket);
+    ASSERT_TRUE(connection.QueueFrame(NetworkUtils::StringToBytes("payload")));
+
+    auto wouldBlock = [](std::span<const std::byte>) {
+#ifdef _WIN32
+        WSASetLastError(WSAEWOULDBLOCK);
+#else
+        errno = EAGAIN;
+#endif
+        return -1;
+    };
+    EXPECT_CALL(socket, Send(testing::Matcher<std::span<const std::byte>>(_)))
+        .WillOnce(Return(3))
+        .WillOnce(wouldBlock)
+        .WillOnce(wouldBlock)
+        .WillOnce([](std::span<const std::byte> data) { return static_cast<int>(data.size()); });
+
+    EXPECT_EQ(connection.Flush(), 3);
+    EXPECT_EQ(connection.GetPendingBytes(), 8u);
+
+    // Nothing more fits: the caller sees the failure and can tell it is only a full buffer
+    EXPECT_EQ(connection.Flush(), -1);
+    EXPECT_TRUE(ISocketPoller::LastCallWouldBlock());
+    EXPECT_EQ(connection.GetPendingBytes(), 8u);
+
+    EXPECT_EQ(connection.Flush(), 8);
+    EXPECT_EQ(connection.GetPendingBytes(), 0u);
+}
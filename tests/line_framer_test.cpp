@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "network/line_framer.h"
+#include "network/byte_utils.h"
+
+// Helper to feed a string and collect the emitted lines
+static bool FeedText(LineFramer& framer, const std::string& text, std::vector<std::string>& lines) {
+    std::vector<std::byte> bytes = NetworkUtils::StringToBytes(text);
+    return framer.Feed(bytes, [&lines](std::string_view line) {
+        lines.emplace_back(line);
+    });
+}
+
+TEST(LineFramerTest, FindNewlineMatchesEveryPosition) {
+    // Cover the scalar tail and both 16- and 32-byte vector blocks
+    for (size_t length = 0; length < 100; ++length) {
+        std::string text(length, 'a');
+        EXPECT_EQ(LineFramer::FindNewline(text.data(), text.size()), length);
+
+        for (size_t position = 0; position < length; ++position) {
+            std::string withNewline = text;
+            withNewline[position] = '\n';
+            if (position + 1 < length) {
+                withNewline[length - 1] = '\n';  // A later newline must not win
+            }
+            EXPECT_EQ(LineFramer::FindNewline(withNewline.data(), withNewline.size()), position)
+                << "length " << length << ", position " << position;
+        }
+    }
+}
+
+TEST(LineFramerTest, PipelinedLinesInOneChunk) {
+    LineFramer framer;
+    std::vector<std::string> lines;
+
+    EXPECT_TRUE(FeedText(framer, "alice\n/users\r\nhello there\n", lines));
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "alice");
+    EXPECT_EQ(lines[1], "/users");
+    EXPECT_EQ(lines[2], "hello there");
+    EXPECT_EQ(framer.GetBufferedBytes(), 0u);
+}
+
+TEST(LineFramerTest, PartialLinesAreCarriedAcrossReads) {
+    LineFramer framer;
+    std::vector<std::string> lines;
+
+    EXPECT_TRUE(FeedText(framer, "first li", lines));
+    EXPECT_TRUE(lines.empty());
+    EXPECT_EQ(framer.GetBufferedBytes(), 8u);
+
+    EXPECT_TRUE(FeedText(framer, "ne\r", lines));
+    EXPECT_TRUE(lines.empty());
+
+    EXPECT_TRUE(FeedText(framer, "\nsecond\nthi", lines));
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "first line");
+    EXPECT_EQ(lines[1], "second");
+    EXPECT_EQ(framer.GetBufferedBytes(), 3u);
+}
+
+TEST(LineFramerTest, FinishEmitsUnterminatedLine) {
+    LineFramer framer;
+    std::vector<std::string> lines;
+
+    EXPECT_TRUE(FeedText(framer, "REGISTER:bob", lines));
+    framer.Finish([&lines](std::string_view line) { lines.emplace_back(line); });
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "REGISTER:bob");
+    EXPECT_EQ(framer.GetBufferedBytes(), 0u);
+}
+
+TEST(LineFramerTest, OversizedLinesAreDiscarded) {
+    constexpr size_t MAX_LINE = 8;
+    LineFramer framer(MAX_LINE);
+    std::vector<std::string> lines;
+
+    // Oversized line inside one chunk
+    EXPECT_FALSE(FeedText(framer, "0123456789\nok\n", lines));
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "ok");
+
+    // Oversized line spread over several chunks is skipped up to its newline
+    lines.clear();
+    EXPECT_TRUE(FeedText(framer, "01234", lines));
+    EXPECT_FALSE(FeedText(framer, "56789", lines));
+    EXPECT_TRUE(FeedText(framer, "abcdef", lines));
+    EXPECT_TRUE(FeedText(framer, "\nnext\n", lines));
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "next");
+}
+
+TEST(LineFramerTest, EmptyLinesAreReported) {
+    LineFramer framer;
+    std::vector<std::string> lines;
+
+    EXPECT_TRUE(FeedText(framer, "\n\r\nx\n", lines));
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "");
+    EXPECT_EQ(lines[1], "");
+    EXPECT_EQ(lines[2], "x");
+}
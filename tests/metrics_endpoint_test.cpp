@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/metrics_endpoint.h"
+#include "network/byte_utils.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono_literals;
+
+// Helper functions
+namespace {
+    // Sends a raw request and reads until the endpoint closes the connection
+    std::string Fetch(const NetworkAddress& endpoint, const std::string& request) {
+        auto socket = NetworkFactorySingleton::GetInstance().CreateTcpSocket();
+        if (!socket->Connect(NetworkAddress("127.0.0.1", endpoint.port)))
+            return "";
+        socket->Send(NetworkUtils::AsBytes(request));
+
+        std::string response;
+        std::vector<std::byte> buffer(4096);
+        while (socket->WaitForDataWithTimeout(2000)) {
+            int bytesRead = socket->Receive(std::span<std::byte>(buffer));
+            if (bytesRead <= 0)
+                break;
+            response.append(reinterpret_cast<const char*>(buffer.data()), static_cast<size_t>(bytesRead));
+        }
+        return response;
+    }
+
+#ifndef _WIN32
+    // Raw socket connected to the endpoint, for what the library sockets do not expose
+    int ConnectRaw(const NetworkAddress& endpoint) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(endpoint.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    std::string ReadToEnd(int fd) {
+        std::string response;
+        char buffer[4096];
+        timeval timeout{2, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ssize_t bytesRead;
+        while ((bytesRead = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, static_cast<size_t>(bytesRead));
+        }
+        return response;
+    }
+
+    std::chrono::microseconds ProcessCpuTime() {
+        rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+    }
+#endif
+
+    std::string Body(const std::string& response) {
+        size_t end = response.find("\r\n\r\n");
+        return end == std::string::npos ? "" : response.substr(end + 4);
+    }
+}
+
+TEST(MetricsEndpointTest, ServesTheRegistry) {
+    MetricsRegistry registry;
+    registry.AddCounter("requests_total", "Requests").Increment(42);
+    MetricsEndpoint endpoint(NetworkFactorySingleton::GetInstance(), registry);
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+    EXPECT_TRUE(endpoint.IsRunning());
+    EXPECT_FALSE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+
+    std::string response = Fetch(endpoint.GetLocalAddress(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+
+    std::string body = Body(response);
+    EXPECT_NE(response.find("Content-Length: " + std::to_string(body.size()) + "\r\n"), std::string::npos);
+    EXPECT_NE(body.find("requests_total 42\n"), std::string::npos);
+    EXPECT_EQ(endpoint.GetScrapeCount(), 1u);
+}
+
+TEST(MetricsEndpointTest, RejectsOtherPathsAndMethods) {
+    MetricsRegistry registry;
+    MetricsEndpoint endpoint(NetworkFactorySingleton::GetInstance(), registry);
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+    const NetworkAddress address = endpoint.GetLocalAddress();
+
+    EXPECT_EQ(Fetch(address, "GET / HTTP/1.0\r\n\r\n").rfind("HTTP/1.1 404", 0), 0u);
+    EXPECT_EQ(Fetch(address, "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0), 0u);
+    EXPECT_EQ(Fetch(address, "nonsense\r\n\r\n").rfind("HTTP/1.1 400", 0), 0u);
+    EXPECT_EQ(endpoint.GetScrapeCount(), 0u);
+
+    std::string head = Fetch(address, "HEAD /metrics?x=1 HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(head.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_TRUE(Body(head).empty());
+}
+
+TEST(MetricsEndpointTest, AStalledScraperDoesNotBlockOthers) {
+    MetricsRegistry registry;
+    registry.AddGauge("up", "Up").Set(1);
+    MetricsEndpoint endpoint(NetworkFactorySingleton::GetInstance(), registry);
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+    const NetworkAddress address = endpoint.GetLocalAddress();
+
+    // Connects and sends half a request, then goes quiet
+    auto stalled = NetworkFactorySingleton::GetInstance().CreateTcpSocket();
+    ASSERT_TRUE(stalled->Connect(NetworkAddress("127.0.0.1", address.port)));
+    stalled->Send(NetworkUtils::AsBytes("GET /metr"));
+    std::this_thread::sleep_for(20ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_NE(Body(Fetch(address, "GET /metrics HTTP/1.1\r\n\r\n")).find("up 1\n"), std::string::npos);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST(MetricsEndpointTest, StopsAndRestarts) {
+    MetricsRegistry registry;
+    MetricsEndpoint endpoint(NetworkFactorySingleton::GetInstance(), registry);
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+    endpoint.Stop();
+    EXPECT_FALSE(endpoint.IsRunning());
+
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+    EXPECT_EQ(Fetch(endpoint.GetLocalAddress(), "GET /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 200", 0), 0u);
+}
+
+#ifndef _WIN32
+TEST(MetricsEndpointTest, AnswersAScraperThatHalfCloses) {
+    MetricsRegistry registry;
+    registry.AddGauge("up", "Up").Set(1);
+    MetricsEndpoint endpoint(NetworkFactorySingleton::GetInstance(), registry);
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+
+    int fd = ConnectRaw(endpoint.GetLocalAddress());
+    ASSERT_GE(fd, 0);
+    const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    ASSERT_EQ(::send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    ::shutdown(fd, SHUT_WR);
+
+    std::string response = ReadToEnd(fd);
+    ::close(fd);
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_NE(Body(response).find("up 1\n"), std::string::npos);
+}
+
+TEST(MetricsEndpointTest, BacksOffWhenOutOfDescriptors) {
+    MetricsRegistry registry;
+    MetricsEndpoint endpoint(NetworkFactorySingleton::GetInstance(), registry);
+    ASSERT_TRUE(endpoint.Start(NetworkAddress("127.0.0.1", 0)));
+    const NetworkAddress address = endpoint.GetLocalAddress();
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+
+    // Cap the limit at the lowest free descriptor, so accepting the connection fails with EMFILE
+    rlimit saved{};
+    ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &saved), 0);
+    int lowestFree = ::dup(fd);
+    ASSERT_GE(lowestFree, 0);
+    ::close(lowestFree);
+    rlimit capped = saved;
+    capped.rlim_cur = static_cast<rlim_t>(lowestFree);
+    ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &capped), 0);
+
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(address.port);
+    target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const bool connected = ::connect(fd, reinterpret_cast<sockaddr*>(&target), sizeof(target)) == 0;
+
+    // The pending connection must not keep the serving thread spinning
+    const auto cpuBefore = ProcessCpuTime();
+    std::this_thread::sleep_for(300ms);
+    const auto cpuUsed = ProcessCpuTime() - cpuBefore;
+    ::setrlimit(RLIMIT_NOFILE, &saved);
+    ASSERT_TRUE(connected);
+    EXPECT_LT(cpuUsed, 100ms);
+
+    // Once descriptors are available again the queued connection is served
+    const std::string request = "GET /metrics HTTP/1.1\r\n\r\n";
+    ASSERT_EQ(::send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    EXPECT_EQ(ReadToEnd(fd).rfind("HTTP/1.1 200 OK", 0), 0u);
+    ::close(fd);
+}
+#endif
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/metrics.h"
+
+TEST(MetricsRegistryTest, RendersCountersAndGauges) {
+    MetricsRegistry registry;
+    MetricsRegistry::Counter& received = registry.AddCounter("chat_messages_received_total", "Lines received");
+    MetricsRegistry::Gauge& clients = registry.AddGauge("chat_connected_clients", "Connected clients");
+    registry.AddGaugeFunction("chat_pool_blocks", "Pooled blocks", [] { return 7.0; });
+
+    received.Increment();
+    received.Increment(4);
+    clients.Set(3);
+    clients.Add(-1);
+
+    std::string text;
+    registry.Render(text);
+    EXPECT_EQ(text,
+              "# HELP chat_messages_received_total Lines received\n"
+              "# TYPE chat_messages_received_total counter\n"
+              "chat_messages_received_total 5\n"
+              "# HELP chat_connected_clients Connected clients\n"
+              "# TYPE chat_connected_clients gauge\n"
+              "chat_connected_clients 2\n"
+              "# HELP chat_pool_blocks Pooled blocks\n"
+              "# TYPE chat_pool_blocks gauge\n"
+              "chat_pool_blocks 7\n");
+}
+
+TEST(MetricsRegistryTest, LabelledSeriesShareOneFamily) {
+    MetricsRegistry registry;
+    registry.AddCounter("chat_evictions_total", "Clients evicted", "reason=\"idle\"").Increment(2);
+    registry.AddCounter("chat_evictions_total", "Clients evicted", "reason=\"slow\"").Increment();
+
+    std::string text;
+    registry.Render(text);
+    EXPECT_EQ(text,
+              "# HELP chat_evictions_total Clients evicted\n"
+              "# TYPE chat_evictions_total counter\n"
+              "chat_evictions_total{reason=\"idle\"} 2\n"
+              "chat_evictions_total{reason=\"slow\"} 1\n");
+}
+
+TEST(MetricsRegistryTest, HistogramBucketsAreCumulative) {
+    MetricsRegistry registry;
+    MetricsRegistry::Histogram& latency =
+        registry.AddHistogram("fanout_seconds", "Fan-out time", {0.001, 0.01, 0.1}, "server=\"tcp\"");
+    latency.Observe(0.0005);
+    latency.Observe(0.001);     // Bounds are inclusive
+    latency.Observe(0.05);
+    latency.Observe(3);
+
+    EXPECT_EQ(latency.GetCount(), 4u);
+    EXPECT_EQ(latency.GetBucketCounts(), (std::vector<uint64_t>{2, 0, 1, 1}));
+
+    std::string text;
+    registry.Render(text);
+    EXPECT_EQ(text,
+              "# HELP fanout_seconds Fan-out time\n"
+              "# TYPE fanout_seconds histogram\n"
+              "fanout_seconds_bucket{server=\"tcp\",le=\"0.001\"} 2\n"
+              "fanout_seconds_bucket{server=\"tcp\",le=\"0.01\"} 2\n"
+              "fanout_seconds_bucket{server=\"tcp\",le=\"0.1\"} 3\n"
+              "fanout_seconds_bucket{server=\"tcp\",le=\"+Inf\"} 4\n"
+              "fanout_seconds_sum{server=\"tcp\"} 3.0515\n"
+              "fanout_seconds_count{server=\"tcp\"} 4\n");
+}
+
+TEST(MetricsRegistryTest, ExponentialBuckets) {
+    EXPECT_EQ(MetricsRegistry::ExponentialBuckets(1, 4, 4), (std::vector<double>{1, 4, 16, 64}));
+    EXPECT_TRUE(MetricsRegistry::ExponentialBuckets(1, 2, 0).empty());
+}
+
+TEST(MetricsRegistryTest, UpdatesFromManyThreadsWhileRendering) {
+    MetricsRegistry registry;
+    MetricsRegistry::Counter& counter = registry.AddCounter("events_total", "Events");
+    MetricsRegistry::Histogram& histogram =
+        registry.AddHistogram("event_seconds", "Event time", MetricsRegistry::ExponentialBuckets(1e-6, 10, 6));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.Increment();
+                histogram.Observe(1e-5);
+            }
+        });
+    }
+    std::string text;
+    for (int i = 0; i < 100; ++i) {
+        text.clear();
+        registry.Render(text);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.Get(), 40000u);
+    EXPECT_EQ(histogram.GetCount(), 40000u);
+    EXPECT_NEAR(histogram.GetSum(), 0.4, 1e-9);
+}
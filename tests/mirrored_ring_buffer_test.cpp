@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network/mirrored_ring_buffer.h"
+#include "network/platform_factory.h"
+#include "network/byte_utils.h"
+#include "utils/test_utils.h"
+
+using namespace test_utils::constants;
+
+// Helper to read the ring's readable region as text
+static std::string ReadableText(const MirroredRingBuffer& ring) {
+    auto readable = ring.ReadableSpan();
+    return std::string(reinterpret_cast<const char*>(readable.data()), readable.size());
+}
+
+TEST(MirroredRingBufferTest, CapacityIsRoundedUpToPageSize) {
+    MirroredRingBuffer ring(100);
+    ASSERT_TRUE(ring.IsValid());
+    EXPECT_GE(ring.Capacity(), 100u);
+    EXPECT_EQ(ring.Available(), ring.Capacity());
+    EXPECT_TRUE(ring.Empty());
+}
+
+TEST(MirroredRingBufferTest, SecondHalfAliasesFirstHalf) {
+    MirroredRingBuffer ring(1);
+    ASSERT_TRUE(ring.IsValid());
+
+    // Writing through the writable span lands in both mappings
+    auto space = ring.WritableSpan();
+    space[0] = std::byte{'x'};
+    ring.Commit(1);
+    EXPECT_EQ(ring.ReadableSpan()[0], std::byte{'x'});
+    EXPECT_EQ(*(ring.ReadableSpan().data() + ring.Capacity()), std::byte{'x'});
+}
+
+TEST(MirroredRingBufferTest, MessageStraddlingWrapPointIsContiguous) {
+    MirroredRingBuffer ring(1);
+    ASSERT_TRUE(ring.IsValid());
+    const size_t capacity = ring.Capacity();
+
+    // Move the read/write offsets to just before the end of the first mapping
+    std::vector<std::byte> filler(capacity - 3, std::byte{'.'});
+    ASSERT_TRUE(ring.Write(filler));
+    ring.Consume(filler.size());
+    EXPECT_TRUE(ring.Empty());
+
+    // This message wraps around the physical end of the buffer
+    std::vector<std::byte> message = NetworkUtils::StringToBytes("wrapped message");
+    ASSERT_TRUE(ring.Write(message));
+    EXPECT_EQ(ReadableText(ring), "wrapped message");
+
+    ring.Consume(8);
+    EXPECT_EQ(ReadableText(ring), "message");
+    EXPECT_EQ(ring.Available(), capacity - 7);
+}
+
+TEST(MirroredRingBufferTest, WriteFailsWhenFull) {
+    MirroredRingBuffer ring(1);
+    ASSERT_TRUE(ring.IsValid());
+
+    std::vector<std::byte> data(ring.Capacity(), std::byte{1});
+    EXPECT_TRUE(ring.Write(data));
+    EXPECT_EQ(ring.Available(), 0u);
+    EXPECT_TRUE(ring.WritableSpan().empty());
+    EXPECT_FALSE(ring.Write(NetworkUtils::StringToBytes("x")));
+
+    ring.Clear();
+    EXPECT_TRUE(ring.Empty());
+}
+
+TEST(MirroredRingBufferTest, MoveTransfersOwnership) {
+    MirroredRingBuffer ring(1);
+    ASSERT_TRUE(ring.Write(NetworkUtils::StringToBytes("abc")));
+
+    MirroredRingBuffer moved(std::move(ring));
+    EXPECT_FALSE(ring.IsValid());
+    ASSERT_TRUE(moved.IsValid());
+    EXPECT_EQ(ReadableText(moved), "abc");
+}
+
+TEST(MirroredRingBufferTest, TcpReceiveIntoRing) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto listener = factory.CreateTcpListener();
+    ASSERT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(listener->Listen(SERVER_BACKLOG_SIZE));
+
+    auto client = factory.CreateTcpSocket();
+    ASSERT_TRUE(client->Connect(listener->GetLocalAddress()));
+    auto server = listener->AcceptTcp();
+    ASSERT_TRUE(server);
+
+    MirroredRingBuffer ring(1);
+    ASSERT_TRUE(ring.IsValid());
+
+    // Leave only a few bytes before the wrap point so the received data straddles it
+    std::vector<std::byte> filler(ring.Capacity() - 4);
+    ASSERT_TRUE(ring.Write(filler));
+    ring.Consume(filler.size());
+
+    std::vector<std::byte> message = NetworkUtils::StringToBytes("hello ring");
+    ASSERT_EQ(client->Send(message), static_cast<int>(message.size()));
+
+    size_t received = 0;
+    while (received < message.size()) {
+        ASSERT_TRUE(server->WaitForDataWithTimeout(test_utils::timeouts::LONG_TIMEOUT_MS));
+        int bytesRead = server->ReceiveInto(ring);
+        ASSERT_GT(bytesRead, 0);
+        received += static_cast<size_t>(bytesRead);
+    }
+    EXPECT_EQ(ReadableText(ring), "hello ring");
+}
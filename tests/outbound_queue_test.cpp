@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/outbound_queue.h"
+#include "network/byte_utils.h"
+
+using namespace std::chrono_literals;
+
+// Fixture providing pooled text messages
+class OutboundQueueTest : public ::testing::Test {
+protected:
+    BufferPool pool{256};
+
+    PooledBuffer Message(const std::string& text) {
+        PooledBuffer buffer = pool.Acquire(text.size());
+        std::memcpy(buffer.Data(), text.data(), text.size());
+        buffer.Resize(text.size());
+        return buffer;
+    }
+
+    static std::vector<std::string> Texts(const std::vector<PooledBuffer>& messages) {
+        std::vector<std::string> texts;
+        for (const PooledBuffer& message : messages) {
+            texts.push_back(NetworkUtils::BytesToString(message.Span()));
+        }
+        return texts;
+    }
+};
+
+TEST_F(OutboundQueueTest, PopAllDrainsInOrder) {
+    OutboundQueue queue;
+    EXPECT_EQ(queue.Push(Message("a")), OutboundQueue::PushResult::Queued);
+    EXPECT_EQ(queue.Push(Message("bb")), OutboundQueue::PushResult::Queued);
+    EXPECT_EQ(queue.GetDepth(), 2u);
+    EXPECT_EQ(queue.GetDepthBytes(), 3u);
+
+    std::vector<PooledBuffer> messages;
+    ASSERT_TRUE(queue.PopAll(messages, 0ms));
+    EXPECT_EQ(Texts(messages), (std::vector<std::string>{"a", "bb"}));
+    EXPECT_EQ(queue.GetDepth(), 0u);
+    EXPECT_EQ(queue.GetStats().highWater, 2u);
+}
+
+TEST_F(OutboundQueueTest, DropOldestKeepsNewestMessages) {
+    OutboundQueue queue(OutboundQueue::OverflowPolicy::DropOldest, 3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(queue.Push(Message(std::to_string(i))), OutboundQueue::PushResult::Queued);
+    }
+    EXPECT_EQ(queue.Push(Message("3")), OutboundQueue::PushResult::DroppedOldest);
+
+    std::vector<PooledBuffer> messages;
+    ASSERT_TRUE(queue.PopAll(messages, 0ms));
+    EXPECT_EQ(Texts(messages), (std::vector<std::string>{"1", "2", "3"}));
+    EXPECT_EQ(queue.GetStats().dropped, 1u);
+}
+
+TEST_F(OutboundQueueTest, ByteLimitAppliesButOneMessageAlwaysFits) {
+    OutboundQueue queue(OutboundQueue::OverflowPolicy::DropOldest, 100, 10);
+    EXPECT_EQ(queue.Push(Message(std::string(8, 'x'))), OutboundQueue::PushResult::Queued);
+    EXPECT_EQ(queue.Push(Message(std::string(8, 'y'))), OutboundQueue::PushResult::DroppedOldest);
+    EXPECT_EQ(queue.Push(Message(std::string(50, 'z'))), OutboundQueue::PushResult::DroppedOldest);
+    EXPECT_EQ(queue.GetDepth(), 1u);
+    EXPECT_EQ(queue.GetDepthBytes(), 50u);
+}
+
+TEST_F(OutboundQueueTest, DisconnectPolicyClosesQueue) {
+    OutboundQueue queue(OutboundQueue::OverflowPolicy::Disconnect, 2);
+    queue.Push(Message("a"));
+    queue.Push(Message("b"));
+    EXPECT_EQ(queue.Push(Message("c")), OutboundQueue::PushResult::Overflowed);
+    EXPECT_TRUE(queue.IsClosed());
+    EXPECT_EQ(queue.Push(Message("d")), OutboundQueue::PushResult::Closed);
+
+    // What was queued before the overflow can still be drained
+    std::vector<PooledBuffer> messages;
+    EXPECT_TRUE(queue.PopAll(messages, 0ms));
+    EXPECT_EQ(messages.size(), 2u);
+    EXPECT_FALSE(queue.PopAll(messages, 0ms));
+}
+
+TEST_F(OutboundQueueTest, BackpressureWaitsForConsumer) {
+    OutboundQueue queue(OutboundQueue::OverflowPolicy::Backpressure, 1, OutboundQueue::DEFAULT_MAX_BYTES, 20ms);
+    queue.Push(Message("a"));
+
+    // Nobody drains: the push times out
+    EXPECT_EQ(queue.Push(Message("b")), OutboundQueue::PushResult::Rejected);
+    EXPECT_EQ(queue.GetStats().rejected, 1u);
+
+    // A consumer frees space while the producer waits
+    OutboundQueue slowQueue(OutboundQueue::OverflowPolicy::Backpressure, 1, OutboundQueue::DEFAULT_MAX_BYTES, 5000ms);
+    slowQueue.Push(Message("a"));
+    std::thread consumer([&slowQueue]() {
+        std::this_thread::sleep_for(20ms);
+        std::vector<PooledBuffer> messages;
+        slowQueue.PopAll(messages, 0ms);
+    });
+    EXPECT_EQ(slowQueue.Push(Message("b")), OutboundQueue::PushResult::Queued);
+    consumer.join();
+    EXPECT_EQ(slowQueue.GetDepth(), 1u);
+}
+
+TEST_F(OutboundQueueTest, PopAllWakesOnPushAndClose) {
+    OutboundQueue queue;
+    std::thread producer([this, &queue]() {
+        std::this_thread::sleep_for(10ms);
+        queue.Push(Message("late"));
+        std::this_thread::sleep_for(10ms);
+        queue.Close();
+    });
+
+    std::vector<PooledBuffer> messages;
+    while (queue.PopAll(messages, 1000ms)) {
+    }
+    producer.join();
+    EXPECT_EQ(Texts(messages), (std::vector<std::string>{"late"}));
+}
+
+TEST_F(OutboundQueueTest, SharedMessageInSeveralQueues) {
+    OutboundQueue first;
+    OutboundQueue second;
+    PooledBuffer message = Message("broadcast");
+    first.Push(message);
+    second.Push(message);
+    EXPECT_EQ(message.UseCount(), 3u);
+
+    std::vector<PooledBuffer> drained;
+    first.PopAll(drained, 0ms);
+    second.PopAll(drained, 0ms);
+    ASSERT_EQ(drained.size(), 2u);
+    EXPECT_EQ(drained[0].Data(), drained[1].Data());
+}
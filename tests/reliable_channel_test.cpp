@@ -0,0 +1,394 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "network/byte_utils.h"
+#include "network/reliable_channel.h"
+
+using namespace std::chrono_literals;
+using Clock = ReliableChannel::Clock;
+
+// Two channels joined by a simulated link with a fixed one-way delay, stepped in 1 ms ticks.
+// Each direction can drop datagrams by their index in that direction.
+class SimulatedLink {
+public:
+    using DropRule = std::function<bool(size_t index)>;
+
+    explicit SimulatedLink(std::chrono::milliseconds delay = 10ms, size_t mtu = ReliableChannel::DEFAULT_MTU)
+        : now(Clock::now()), m_delay(delay) {
+        a = MakeChannel(m_toB, m_sentToB, dropToB, mtu);
+        b = MakeChannel(m_toA, m_sentToA, dropToA, mtu);
+    }
+
+    // Replaces side A with a fresh channel, as if the peer process restarted
+    void RestartA(size_t mtu = ReliableChannel::DEFAULT_MTU) {
+        a = MakeChannel(m_toB, m_sentToB, dropToB, mtu);
+    }
+
+    void Run(std::chrono::milliseconds duration) {
+        for (auto end = now + duration; now < end; now += 1ms) {
+            Deliver(m_toA, *a, receivedByA);
+            Deliver(m_toB, *b, receivedByB);
+            a->Update(now);
+            b->Update(now);
+        }
+    }
+
+    std::unique_ptr<ReliableChannel> a;
+    std::unique_ptr<ReliableChannel> b;
+    DropRule dropToA = [](size_t) { return false; };
+    DropRule dropToB = [](size_t) { return false; };
+    std::vector<std::string> receivedByA;
+    std::vector<std::string> receivedByB;
+    std::vector<ReliableChannel::ReceiveResult> resultsAtB;
+    Clock::time_point now;
+
+private:
+    using Queue = std::multimap<Clock::time_point, std::vector<std::byte>>;
+
+    std::unique_ptr<ReliableChannel> MakeChannel(Queue& queue, size_t& sent, DropRule& drop, size_t mtu) {
+        auto send = [this, &queue, &sent, &drop](std::span<const std::byte> datagram) {
+            if (!drop(sent++)) {
+                queue.emplace(now + m_delay, std::vector<std::byte>(datagram.begin(), datagram.end()));
+            }
+            return true;
+        };
+        return std::make_unique<ReliableChannel>(send, mtu, now);
+    }
+
+    void Deliver(Queue& queue, ReliableChannel& channel, std::vector<std::string>& received) {
+        while (!queue.empty() && queue.begin()->first <= now) {
+            std::vector<std::byte> datagram = std::move(queue.begin()->second);
+            queue.erase(queue.begin());
+            auto result = channel.Receive(datagram, [&](std::span<const std::byte> message) {
+                received.push_back(NetworkUtils::BytesToString(message));
+            }, now);
+            if (&channel == b.get()) {
+                resultsAtB.push_back(result);
+            }
+        }
+    }
+
+    std::chrono::milliseconds m_delay;
+    Queue m_toA;
+    Queue m_toB;
+    size_t m_sentToA = 0;
+    size_t m_sentToB = 0;
+};
+
+// Helper functions
+namespace {
+    std::vector<std::string> Numbered(const std::string& prefix, int count) {
+        std::vector<std::string> messages;
+        for (int i = 0; i < count; ++i) {
+            messages.push_back(prefix + std::to_string(i));
+        }
+        return messages;
+    }
+
+    void PutU32(std::vector<std::byte>& out, uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(std::byte(value >> shift));
+        }
+    }
+
+    // Hand-built data datagram with no acks, as a misbehaving peer could send it
+    std::vector<std::byte> DataDatagram(uint32_t seq, uint32_t message, uint16_t index, uint16_t count,
+                                        size_t payloadSize, bool ordered = true) {
+        std::vector<std::byte> datagram = {std::byte(0xFF), std::byte(1), std::byte(ordered ? 0x03 : 0x01), std::byte(0)};
+        PutU32(datagram, 0x5EED);
+        PutU32(datagram, 0);
+        PutU32(datagram, seq);
+        PutU32(datagram, message);
+        datagram.push_back(std::byte(index >> 8));
+        datagram.push_back(std::byte(index));
+        datagram.push_back(std::byte(count >> 8));
+        datagram.push_back(std::byte(count));
+        datagram.resize(datagram.size() + payloadSize, std::byte('x'));
+        return datagram;
+    }
+}
+
+TEST(ReliableChannelTest, DeliversInOrderAndEstimatesRtt) {
+    SimulatedLink link(10ms);
+    std::vector<std::string> messages = Numbered("message ", 100);
+    for (const std::string& message : messages) {
+        ASSERT_TRUE(link.a->Send(NetworkUtils::AsBytes(message), ReliableChannel::Delivery::Ordered, link.now));
+    }
+    link.Run(500ms);
+
+    EXPECT_EQ(link.receivedByB, messages);
+    EXPECT_EQ(link.a->GetUnackedCount(), 0u);
+
+    ReliableChannel::Stats stats = link.a->GetStats();
+    EXPECT_EQ(stats.retransmissions, 0u);
+    // Two 10 ms legs plus at most the receiver's ack delay
+    EXPECT_GE(stats.smoothedRtt, 20ms);
+    EXPECT_LE(stats.smoothedRtt, 27ms);
+    EXPECT_EQ(link.b->GetStats().messagesDelivered, 100u);
+}
+
+TEST(ReliableChannelTest, RecoversFromLossInBothDirections) {
+    SimulatedLink link(5ms);
+    link.dropToB = [](size_t index) { return index % 4 == 1; };
+    link.dropToA = [](size_t index) { return index % 3 == 0; };
+
+    std::vector<std::string> fromA = Numbered("a", 300);
+    std::vector<std::string> fromB = Numbered("b", 300);
+    for (size_t i = 0; i < fromA.size(); ++i) {
+        link.a->Send(NetworkUtils::AsBytes(fromA[i]), ReliableChannel::Delivery::Ordered, link.now);
+        link.b->Send(NetworkUtils::AsBytes(fromB[i]), ReliableChannel::Delivery::Ordered, link.now);
+        link.Run(1ms);
+    }
+    // Timeouts back off while a resent packet stays unacked, so the tail takes a few seconds
+    link.Run(10s);
+
+    // Every message exactly once and in order, despite the loss
+    EXPECT_EQ(link.receivedByB, fromA);
+    EXPECT_EQ(link.receivedByA, fromB);
+    EXPECT_EQ(link.a->GetUnackedCount(), 0u);
+    EXPECT_EQ(link.b->GetUnackedCount(), 0u);
+    EXPECT_GT(link.a->GetStats().retransmissions, 0u);
+}
+
+TEST(ReliableChannelTest, SurvivesHeavyRandomLoss) {
+    for (uint32_t seed = 1; seed <= 10; ++seed) {
+        SimulatedLink link(3ms, 300);
+        auto random = std::make_shared<std::mt19937>(seed);
+        link.dropToB = [random](size_t) { return (*random)() % 100 < 30; };
+        link.dropToA = [random](size_t) { return (*random)() % 100 < 30; };
+
+        std::vector<std::string> ordered;
+        std::multiset<std::string> unordered;
+        for (int i = 0; i < 100; ++i) {
+            std::string message = std::string(static_cast<size_t>(i * 13 % 700), '.') + std::to_string(i);
+            if (i % 3 == 0) {
+                unordered.insert(message);
+                link.a->Send(NetworkUtils::AsBytes(message), ReliableChannel::Delivery::Unordered, link.now);
+            } else {
+                ordered.push_back(message);
+                link.a->Send(NetworkUtils::AsBytes(message), ReliableChannel::Delivery::Ordered, link.now);
+            }
+            link.Run(2ms);
+        }
+        link.Run(30s);
+
+        std::vector<std::string> receivedOrdered;
+        std::multiset<std::string> receivedUnordered;
+        for (const std::string& message : link.receivedByB) {
+            if (unordered.count(message)) {
+                receivedUnordered.insert(message);
+            } else {
+                receivedOrdered.push_back(message);
+            }
+        }
+        EXPECT_EQ(receivedOrdered, ordered) << "seed " << seed;
+        EXPECT_EQ(receivedUnordered, unordered) << "seed " << seed;
+        EXPECT_EQ(link.a->GetUnackedCount(), 0u) << "seed " << seed;
+    }
+}
+
+TEST(ReliableChannelTest, UnorderedMessagesDoNotWaitForGaps) {
+    SimulatedLink link(1ms);
+    link.dropToB = [](size_t index) { return index == 0 || index == 2; };
+
+    link.a->Send(NetworkUtils::AsBytes("u1"), ReliableChannel::Delivery::Unordered, link.now);
+    link.a->Send(NetworkUtils::AsBytes("u2"), ReliableChannel::Delivery::Unordered, link.now);
+    link.a->Send(NetworkUtils::AsBytes("o1"), ReliableChannel::Delivery::Ordered, link.now);
+    link.a->Send(NetworkUtils::AsBytes("o2"), ReliableChannel::Delivery::Ordered, link.now);
+    link.Run(3ms);
+
+    // u1 and o1 were lost: u2 is delivered at once, o2 waits for o1
+    EXPECT_EQ(link.receivedByB, std::vector<std::string>({"u2"}));
+
+    link.Run(500ms);
+    EXPECT_EQ(link.receivedByB, std::vector<std::string>({"u2", "u1", "o1", "o2"}));
+}
+
+TEST(ReliableChannelTest, FragmentsMessagesLargerThanTheMtu) {
+    SimulatedLink link(2ms, 256);
+    link.dropToB = [](size_t index) { return index % 5 == 2; };
+
+    std::string large;
+    for (int i = 0; i < 20000; ++i) {
+        large.push_back(static_cast<char>('a' + i % 26));
+    }
+    ASSERT_TRUE(link.a->Send(NetworkUtils::AsBytes(large), ReliableChannel::Delivery::Ordered, link.now));
+    ASSERT_TRUE(link.a->Send(NetworkUtils::AsBytes("after"), ReliableChannel::Delivery::Ordered, link.now));
+    link.Run(2s);
+
+    ASSERT_EQ(link.receivedByB.size(), 2u);
+    EXPECT_EQ(link.receivedByB[0], large);
+    EXPECT_EQ(link.receivedByB[1], "after");
+
+    std::string tooLarge(ReliableChannel::MAX_MESSAGE_SIZE + 1, 'x');
+    EXPECT_FALSE(link.a->Send(NetworkUtils::AsBytes(tooLarge)));
+}
+
+TEST(ReliableChannelTest, LossHalvesTheCongestionWindow) {
+    SimulatedLink link(5ms);
+    for (const std::string& message : Numbered("warm-up ", 100)) {
+        link.a->Send(NetworkUtils::AsBytes(message), ReliableChannel::Delivery::Ordered, link.now);
+    }
+    link.Run(500ms);
+    const double grown = link.a->GetStats().congestionWindow;
+    EXPECT_GT(grown, 100);
+
+    // One lost packet among later ones is repaired by fast retransmit and halves the window
+    size_t lost = 101;
+    link.dropToB = [lost](size_t index) { return index == lost; };
+    for (const std::string& message : Numbered("next ", 10)) {
+        link.a->Send(NetworkUtils::AsBytes(message), ReliableChannel::Delivery::Ordered, link.now);
+    }
+    link.Run(500ms);
+
+    ReliableChannel::Stats stats = link.a->GetStats();
+    EXPECT_EQ(link.receivedByB.size(), 110u);
+    EXPECT_EQ(stats.retransmissions, 1u);
+    EXPECT_EQ(stats.timeouts, 0u);
+    EXPECT_LT(stats.congestionWindow, grown * 0.6);
+}
+
+TEST(ReliableChannelTest, TimeoutRecoversALostTail) {
+    SimulatedLink link(5ms);
+    link.dropToB = [](size_t index) { return index == 0; };
+
+    link.a->Send(NetworkUtils::AsBytes("only"), ReliableChannel::Delivery::Ordered, link.now);
+    link.Run(100ms);
+    EXPECT_TRUE(link.receivedByB.empty());
+
+    // Nothing follows the lost packet, so only the retransmission timer can repair it
+    link.Run(300ms);
+    EXPECT_EQ(link.receivedByB, std::vector<std::string>({"only"}));
+    EXPECT_EQ(link.a->GetStats().timeouts, 1u);
+}
+
+TEST(ReliableChannelTest, DetectsPeerRestart) {
+    SimulatedLink link(1ms);
+    link.a->Send(NetworkUtils::AsBytes("first"), ReliableChannel::Delivery::Ordered, link.now);
+    link.Run(50ms);
+
+    link.RestartA();
+    link.a->Send(NetworkUtils::AsBytes("again"), ReliableChannel::Delivery::Ordered, link.now);
+    link.Run(50ms);
+
+    EXPECT_EQ(link.receivedByB, std::vector<std::string>({"first", "again"}));
+    EXPECT_EQ(std::count(link.resultsAtB.begin(), link.resultsAtB.end(),
+                         ReliableChannel::ReceiveResult::PeerRestarted), 1);
+}
+
+TEST(ReliableChannelTest, RetransmitTimeoutDoublesWhileUnacked) {
+    std::vector<Clock::time_point> sends;
+    Clock::time_point now = Clock::now();
+    ReliableChannel channel([&](std::span<const std::byte>) {
+        sends.push_back(now);
+        return true;
+    }, ReliableChannel::DEFAULT_MTU, now);
+
+    // The peer never answers, so the same packet keeps timing out
+    channel.Send(NetworkUtils::AsBytes("anyone?"), ReliableChannel::Delivery::Ordered, now);
+    for (int i = 0; i < 4000; ++i) {
+        now += 1ms;
+        channel.Update(now);
+    }
+
+    ASSERT_GE(sends.size(), 5u);
+    for (size_t i = 2; i < 5; ++i) {
+        EXPECT_EQ(sends[i] - sends[i - 1], 2 * (sends[i - 1] - sends[i - 2])) << "resend " << i;
+    }
+    EXPECT_EQ(channel.GetStats().timeouts, 1u);
+}
+
+TEST(ReliableChannelTest, StaleSessionDatagramsAreIgnoredAfterRestart) {
+    Clock::time_point now = Clock::now();
+    std::vector<std::vector<std::byte>> fromOld;
+    std::vector<std::vector<std::byte>> fromNew;
+    auto capture = [](std::vector<std::vector<std::byte>>& out) {
+        return [&out](std::span<const std::byte> datagram) {
+            out.emplace_back(datagram.begin(), datagram.end());
+            return true;
+        };
+    };
+    ReliableChannel oldPeer(capture(fromOld), ReliableChannel::DEFAULT_MTU, now);
+    ReliableChannel newPeer(capture(fromNew), ReliableChannel::DEFAULT_MTU, now);
+    ReliableChannel receiver([](std::span<const std::byte>) { return true; }, ReliableChannel::DEFAULT_MTU, now);
+    std::vector<std::string> received;
+    auto deliver = [&](const std::vector<std::byte>& datagram) {
+        return receiver.Receive(datagram, [&](std::span<const std::byte> message) {
+            received.push_back(NetworkUtils::BytesToString(message));
+        }, now);
+    };
+
+    oldPeer.Send(NetworkUtils::AsBytes("one"), ReliableChannel::Delivery::Ordered, now);
+    oldPeer.Send(NetworkUtils::AsBytes("two"), ReliableChannel::Delivery::Ordered, now);
+    ASSERT_EQ(fromOld.size(), 2u);
+    EXPECT_EQ(deliver(fromOld[0]), ReliableChannel::ReceiveResult::Processed);
+
+    newPeer.Send(NetworkUtils::AsBytes("again"), ReliableChannel::Delivery::Ordered, now);
+    newPeer.Send(NetworkUtils::AsBytes("more"), ReliableChannel::Delivery::Ordered, now);
+    ASSERT_EQ(fromNew.size(), 2u);
+    EXPECT_EQ(deliver(fromNew[0]), ReliableChannel::ReceiveResult::PeerRestarted);
+
+    // The old session's second packet was delayed past the restart
+    EXPECT_EQ(deliver(fromOld[1]), ReliableChannel::ReceiveResult::Stale);
+    EXPECT_EQ(deliver(fromNew[1]), ReliableChannel::ReceiveResult::Processed);
+
+    EXPECT_EQ(received, std::vector<std::string>({"one", "again", "more"}));
+    EXPECT_EQ(receiver.GetStats().staleDatagrams, 1u);
+}
+
+TEST(ReliableChannelTest, RejectsPlainDatagrams) {
+    ReliableChannel channel([](std::span<const std::byte>) { return true; });
+    EXPECT_FALSE(ReliableChannel::IsChannelDatagram(NetworkUtils::AsBytes("HEARTBEAT")));
+    EXPECT_EQ(channel.Receive(NetworkUtils::AsBytes("REGISTER:alice"), [](std::span<const std::byte>) {
+        ADD_FAILURE() << "plain text must not be delivered";
+    }), ReliableChannel::ReceiveResult::Malformed);
+    EXPECT_EQ(channel.GetStats().packetsReceived, 0u);
+}
+
+TEST(ReliableChannelTest, RejectsImpossibleFragmentCounts) {
+    ReliableChannel channel([](std::span<const std::byte>) { return true; });
+    auto ignore = [](std::span<const std::byte>) {};
+    EXPECT_EQ(channel.Receive(DataDatagram(0, 0, 0, 65535, 16), ignore), ReliableChannel::ReceiveResult::Malformed);
+    EXPECT_EQ(channel.Receive(DataDatagram(0, 0, 0, 2, 16), ignore), ReliableChannel::ReceiveResult::Processed);
+    EXPECT_GT(channel.GetStats().bufferedBytes, 0u);
+}
+
+TEST(ReliableChannelTest, FloodOfUnfinishedMessagesStaysBounded) {
+    ReliableChannel channel([](std::span<const std::byte>) { return true; });
+    auto ignore = [](std::span<const std::byte>) { ADD_FAILURE() << "nothing completes"; };
+
+    // Every packet starts a new large message and never finishes it
+    size_t rejected = 0;
+    for (uint32_t seq = 0; seq < 20000; ++seq) {
+        bool ordered = seq % 2 == 0;
+        auto result = channel.Receive(DataDatagram(seq, seq / 2, 0, 10000, 1000, ordered), ignore);
+        rejected += result == ReliableChannel::ReceiveResult::Malformed ? 1 : 0;
+        ASSERT_LE(channel.GetStats().bufferedBytes, ReliableChannel::MAX_BUFFERED_BYTES);
+    }
+    EXPECT_GT(rejected, 0u);
+
+    // Messages far ahead of delivery are refused instead of being parked
+    ReliableChannel fresh([](std::span<const std::byte>) { return true; });
+    EXPECT_EQ(fresh.Receive(DataDatagram(0, 100000, 0, 1, 1000), ignore), ReliableChannel::ReceiveResult::Malformed);
+    EXPECT_EQ(fresh.GetStats().bufferedBytes, 0u);
+}
+
+TEST(ReliableChannelTest, BufferedBytesReturnToZeroAfterDelivery) {
+    SimulatedLink link;
+    link.dropToB = [](size_t index) { return index == 0; };
+    std::string large(20000, 'z');
+    ASSERT_TRUE(link.a->Send(NetworkUtils::AsBytes(large), ReliableChannel::Delivery::Ordered, link.now));
+    ASSERT_TRUE(link.a->Send(NetworkUtils::AsBytes("after"), ReliableChannel::Delivery::Ordered, link.now));
+    link.Run(1000ms);
+
+    EXPECT_EQ(link.receivedByB, std::vector<std::string>({large, "after"}));
+    EXPECT_EQ(link.b->GetStats().bufferedBytes, 0u);
+}
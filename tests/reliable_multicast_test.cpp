@@ -0,0 +1,343 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/reliable_multicast.h"
+#include "network/platform_factory.h"
+#include "network/socket_options.h"
+#include "network/byte_utils.h"
+
+using namespace std::chrono_literals;
+using Clock = ReliableMulticast::Clock;
+
+// Helper functions
+namespace {
+    using Datagram = std::vector<std::byte>;
+
+    std::vector<std::string> Expected(uint64_t first, uint64_t last) {
+        std::vector<std::string> texts;
+        for (uint64_t sequence = first; sequence <= last; ++sequence) {
+            texts.push_back("m" + std::to_string(sequence));
+        }
+        return texts;
+    }
+
+    // One sender and any number of receivers on a simulated group. Datagrams travel when Run
+    // is called; a receiver's drop filter decides which group datagrams it misses.
+    struct Group {
+        struct Member {
+            std::unique_ptr<MulticastReceiver> receiver;
+            std::vector<std::string> messages;
+            std::function<bool(const Datagram&)> drops;
+        };
+
+        std::deque<Datagram> toGroup;
+        std::deque<Datagram> toSender;
+        std::unique_ptr<MulticastSender> sender;
+        std::vector<Member> members;
+        Clock::time_point now = Clock::now();
+
+        explicit Group(size_t receivers, size_t window = ReliableMulticast::DEFAULT_WINDOW) {
+            sender = std::make_unique<MulticastSender>([this](std::span<const std::byte> datagram) {
+                toGroup.emplace_back(datagram.begin(), datagram.end());
+                return true;
+            }, window, ReliableMulticast::DEFAULT_MTU, now);
+            members.resize(receivers);
+            for (size_t i = 0; i < receivers; ++i) {
+                members[i].receiver = std::make_unique<MulticastReceiver>([this](std::span<const std::byte> datagram) {
+                    toSender.emplace_back(datagram.begin(), datagram.end());
+                    return true;
+                }, static_cast<uint32_t>(i + 1));
+            }
+        }
+
+        void Send(uint64_t sequence) {
+            std::string text = "m" + std::to_string(sequence);
+            ASSERT_TRUE(sender->Send(NetworkUtils::AsBytes(text), now));
+        }
+
+        ReliableMulticast::MessageCallback Recorder(Member& member) {
+            return [&member](uint64_t, std::span<const std::byte> message) {
+                member.messages.push_back(NetworkUtils::BytesToString(message));
+            };
+        }
+
+        // Delivers everything in flight, then advances the clock by `step`, `ticks` times
+        void Run(int ticks = 1, Clock::duration step = 1ms) {
+            for (int tick = 0; tick < ticks; ++tick) {
+                while (!toGroup.empty() || !toSender.empty()) {
+                    while (!toGroup.empty()) {
+                        Datagram datagram = std::move(toGroup.front());
+                        toGroup.pop_front();
+                        for (Member& member : members) {
+                            if (!member.drops || !member.drops(datagram)) {
+                                member.receiver->Receive(datagram, Recorder(member), now);
+                            }
+                        }
+                    }
+                    while (!toSender.empty()) {
+                        sender->Receive(toSender.front(), now);
+                        toSender.pop_front();
+                    }
+                }
+                now += step;
+                sender->Update(now);
+                for (Member& member : members) {
+                    member.receiver->Update(Recorder(member), now);
+                }
+            }
+        }
+    };
+
+    // Drops the original transmission of the given sequence number, but not its repair
+    std::function<bool(const Datagram&)> DropData(uint64_t sequence) {
+        return [sequence](const Datagram& datagram) {
+            uint64_t wire = 0;
+            for (size_t i = 8; i < 16; ++i) {
+                wire = (wire << 8) | std::to_integer<uint64_t>(datagram[i]);
+            }
+            return std::to_integer<uint8_t>(datagram[2]) == 1 && wire == sequence;
+        };
+    }
+}
+
+TEST(ReliableMulticastTest, DeliversInOrderWithoutNacks) {
+    Group group(3);
+    for (uint64_t sequence = 0; sequence < 50; ++sequence) {
+        group.Send(sequence);
+    }
+    group.Run(20);
+
+    for (const auto& member : group.members) {
+        EXPECT_EQ(member.messages, Expected(0, 49));
+        EXPECT_EQ(member.receiver->GetStats().nacksSent, 0u);
+        EXPECT_EQ(member.receiver->GetNextSequence(), 50u);
+    }
+    EXPECT_EQ(group.sender->GetStats().messagesSent, 50u);
+    EXPECT_EQ(group.sender->GetStats().repairsSent, 0u);
+}
+
+TEST(ReliableMulticastTest, RepairsALossAfterANack) {
+    Group group(2);
+    group.members[0].drops = DropData(3);
+    for (uint64_t sequence = 0; sequence < 10; ++sequence) {
+        group.Send(sequence);
+    }
+
+    // Holding 4-9 behind the hole until the repair arrives
+    group.Run();
+    EXPECT_EQ(group.members[0].messages, Expected(0, 2));
+    EXPECT_EQ(group.members[1].messages, Expected(0, 9));
+
+    group.Run(20);
+    EXPECT_EQ(group.members[0].messages, Expected(0, 9));
+    EXPECT_EQ(group.members[1].messages, Expected(0, 9));
+
+    MulticastReceiver::Stats stats = group.members[0].receiver->GetStats();
+    EXPECT_EQ(stats.nacksSent, 1u);
+    EXPECT_EQ(stats.messagesRepaired, 1u);
+    EXPECT_EQ(stats.missing, 0u);
+    EXPECT_EQ(group.sender->GetStats().repairsSent, 1u);
+    EXPECT_EQ(group.sender->GetStats().confirmationsSent, 1u);
+    // The receiver that had it sees the repair as a duplicate
+    EXPECT_EQ(group.members[1].receiver->GetStats().duplicates, 1u);
+}
+
+TEST(ReliableMulticastTest, SuppressesNacksAcrossManyReceivers) {
+    constexpr size_t RECEIVERS = 200;
+    Group group(RECEIVERS);
+    for (auto& member : group.members) {
+        member.drops = DropData(5);
+    }
+    for (uint64_t sequence = 0; sequence < 10; ++sequence) {
+        group.Send(sequence);
+    }
+    group.Run(50);
+
+    uint64_t nacks = 0;
+    uint64_t suppressed = 0;
+    for (const auto& member : group.members) {
+        EXPECT_EQ(member.messages, Expected(0, 9));
+        nacks += member.receiver->GetStats().nacksSent;
+        suppressed += member.receiver->GetStats().nacksSuppressed;
+    }
+
+    // Only receivers whose backoff ends before the NCF arrives ask; the sender repairs once
+    MulticastSender::Stats stats = group.sender->GetStats();
+    EXPECT_EQ(stats.repairsSent, 1u);
+    EXPECT_EQ(stats.confirmationsSent, 1u);
+    EXPECT_EQ(nacks + suppressed, RECEIVERS);
+    EXPECT_LT(nacks, RECEIVERS / 4);
+    EXPECT_EQ(stats.nacksReceived, nacks);
+    EXPECT_EQ(stats.nacksSuppressed, nacks - 1);
+}
+
+TEST(ReliableMulticastTest, HeartbeatsRevealALostTail) {
+    Group group(1);
+    group.members[0].drops = DropData(4);
+    for (uint64_t sequence = 0; sequence < 5; ++sequence) {
+        group.Send(sequence);
+    }
+    group.Run();
+    EXPECT_EQ(group.members[0].messages, Expected(0, 3));
+
+    // Nothing follows 4, so only the heartbeat shows it was sent
+    group.Run(40);
+    EXPECT_EQ(group.members[0].messages, Expected(0, 4));
+    EXPECT_GE(group.sender->GetStats().heartbeatsSent, 1u);
+}
+
+TEST(ReliableMulticastTest, SkipsMessagesThatLeftTheWindow) {
+    Group group(1, 4);
+    group.members[0].drops = DropData(1);
+    // By the time 7 is sent the window holds 4-7, so 1 cannot be repaired
+    for (uint64_t sequence = 0; sequence < 8; ++sequence) {
+        group.Send(sequence);
+    }
+    group.Run(20);
+
+    std::vector<std::string> expected = Expected(0, 0);
+    for (const std::string& text : Expected(2, 7)) {
+        expected.push_back(text);
+    }
+    EXPECT_EQ(group.members[0].messages, expected);
+    EXPECT_EQ(group.members[0].receiver->GetStats().messagesLost, 1u);
+    EXPECT_EQ(group.members[0].receiver->GetStats().nacksSent, 0u);
+}
+
+TEST(ReliableMulticastTest, GivesUpWhenTheSenderNeverRepairs) {
+    Group group(1);
+    group.members[0].drops = [](const Datagram& datagram) {
+        return std::to_integer<uint8_t>(datagram[2]) != 1 ||            // Every repair and heartbeat
+               DropData(2)(datagram);
+    };
+    for (uint64_t sequence = 0; sequence < 6; ++sequence) {
+        group.Send(sequence);
+    }
+
+    group.Run(100, 10ms);
+    std::vector<std::string> expected = Expected(0, 1);
+    for (const std::string& text : Expected(3, 5)) {
+        expected.push_back(text);
+    }
+    MulticastReceiver::Stats stats = group.members[0].receiver->GetStats();
+    EXPECT_EQ(group.members[0].messages, expected);
+    EXPECT_EQ(stats.nacksSent, ReliableMulticast::MAX_NACK_ATTEMPTS);
+    EXPECT_EQ(stats.messagesLost, 1u);
+}
+
+TEST(ReliableMulticastTest, RejectsForeignDatagramsAndFollowsARestartedSender) {
+    std::vector<Datagram> sent;
+    auto capture = [&sent](std::span<const std::byte> datagram) {
+        sent.emplace_back(datagram.begin(), datagram.end());
+        return true;
+    };
+    MulticastReceiver receiver([](std::span<const std::byte>) { return true; });
+    std::vector<std::string> messages;
+    auto record = [&messages](uint64_t, std::span<const std::byte> message) {
+        messages.push_back(NetworkUtils::BytesToString(message));
+    };
+
+    EXPECT_FALSE(receiver.Receive(NetworkUtils::AsBytes("plain text datagram, not ours"), record));
+    EXPECT_FALSE(ReliableMulticast::IsMulticastDatagram(NetworkUtils::AsBytes("short")));
+
+    MulticastSender first(capture);
+    EXPECT_FALSE(first.Send(std::vector<std::byte>(first.GetMaxMessageSize() + 1)));
+    ASSERT_TRUE(first.Send(NetworkUtils::AsBytes("a")));
+    ASSERT_TRUE(first.Send(NetworkUtils::AsBytes("b")));
+
+    MulticastSender second(capture);
+    ASSERT_TRUE(second.Send(NetworkUtils::AsBytes("c")));
+
+    for (const Datagram& datagram : sent) {
+        EXPECT_TRUE(receiver.Receive(datagram, record));
+    }
+    EXPECT_EQ(messages, (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(receiver.GetNextSequence(), 1u);
+
+    // The sender only takes NACKs
+    EXPECT_FALSE(second.Receive(sent[0]));
+}
+
+TEST(ReliableMulticastTest, RepairsOverLoopbackMulticast) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    const NetworkAddress group("239.255.71.1", 0);
+
+    auto sender = factory.CreateUdpSocket();
+    ASSERT_TRUE(sender->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(SocketOptions::SetMulticastInterface(sender.get(), "127.0.0.1"));
+    ASSERT_TRUE(sender->SetNonBlocking(true));
+
+    std::unique_ptr<IUdpSocket> sockets[2];
+    NetworkAddress destination = group;
+    for (auto& socket : sockets) {
+        socket = factory.CreateUdpSocket();
+        ASSERT_TRUE(SocketOptions::SetReuseAddr(socket.get(), true));
+#ifdef _WIN32
+        const bool bound = socket->Bind(NetworkAddress("0.0.0.0", destination.port));
+#else
+        const bool bound = socket->Bind(destination);
+#endif
+        if (!bound || !socket->JoinMulticastGroup(destination, "127.0.0.1")) {
+            GTEST_SKIP() << "multicast is not available on the loopback interface";
+        }
+        destination.port = socket->GetLocalAddress().port;
+        ASSERT_TRUE(socket->SetNonBlocking(true));
+    }
+
+    // The first transmission of message 3 is lost on the way to the group
+    bool dropped = false;
+    MulticastSender multicast([&](std::span<const std::byte> datagram) {
+        if (!dropped && datagram.size() == ReliableMulticast::HEADER_SIZE + 2 &&
+            NetworkUtils::BytesToString(datagram.subspan(ReliableMulticast::HEADER_SIZE)) == "m3") {
+            dropped = true;
+            return true;
+        }
+        return sender->SendTo(datagram, destination) > 0;
+    });
+
+    // Each receiver NACKs the address the group's datagrams come from
+    AddressKey source[2];
+    std::unique_ptr<MulticastReceiver> receivers[2];
+    std::vector<std::string> messages[2];
+    for (size_t i = 0; i < 2; ++i) {
+        receivers[i] = std::make_unique<MulticastReceiver>([&, i](std::span<const std::byte> datagram) {
+            return sockets[i]->SendTo(datagram, source[i]) > 0;
+        });
+    }
+
+    for (uint64_t sequence = 0; sequence < 8; ++sequence) {
+        std::string text = "m" + std::to_string(sequence);
+        ASSERT_TRUE(multicast.Send(NetworkUtils::AsBytes(text)));
+    }
+
+    std::vector<std::byte> buffer(2048);
+    for (int round = 0; round < 200 && (messages[0].size() < 8 || messages[1].size() < 8); ++round) {
+        for (size_t i = 0; i < 2; ++i) {
+            auto record = [&messages, i](uint64_t, std::span<const std::byte> message) {
+                messages[i].push_back(NetworkUtils::BytesToString(message));
+            };
+            int bytesRead;
+            while ((bytesRead = sockets[i]->ReceiveFrom(std::span<std::byte>(buffer), source[i])) > 0) {
+                receivers[i]->Receive(std::span<const std::byte>(buffer.data(), static_cast<size_t>(bytesRead)), record);
+            }
+            receivers[i]->Update(record);
+        }
+        AddressKey from;
+        int bytesRead;
+        while ((bytesRead = sender->ReceiveFrom(std::span<std::byte>(buffer), from)) > 0) {
+            multicast.Receive(std::span<const std::byte>(buffer.data(), static_cast<size_t>(bytesRead)));
+        }
+        multicast.Update();
+        std::this_thread::sleep_for(ReliableMulticast::UPDATE_INTERVAL);
+    }
+
+    EXPECT_TRUE(dropped);
+    EXPECT_EQ(messages[0], Expected(0, 7));
+    EXPECT_EQ(messages[1], Expected(0, 7));
+    EXPECT_EQ(multicast.GetStats().repairsSent, 1u);
+}
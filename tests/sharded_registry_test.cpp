@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/sharded_registry.h"
+
+using Registry = ShardedRegistry<int, std::string>;
+
+TEST(ShardedRegistryTest, InsertFindRemove) {
+    Registry registry(4);
+    EXPECT_TRUE(registry.Insert(1, std::make_shared<std::string>("alice")));
+    EXPECT_TRUE(registry.Insert(2, std::make_shared<std::string>("bob")));
+    EXPECT_FALSE(registry.Insert(1, std::make_shared<std::string>("mallory")));
+    EXPECT_EQ(registry.Size(), 2u);
+
+    ASSERT_TRUE(registry.Find(1));
+    EXPECT_EQ(*registry.Find(1), "alice");
+    EXPECT_FALSE(registry.Find(3));
+
+    std::shared_ptr<std::string> removed = registry.Remove(1);
+    ASSERT_TRUE(removed);
+    EXPECT_EQ(*removed, "alice");
+    EXPECT_FALSE(registry.Remove(1));
+    EXPECT_FALSE(registry.Find(1));
+    EXPECT_EQ(registry.Size(), 1u);
+}
+
+TEST(ShardedRegistryTest, RemoveExpectedOnlyMatchingValue) {
+    Registry registry(4);
+    auto first = std::make_shared<std::string>("alice");
+    auto second = std::make_shared<std::string>("alice again");
+    ASSERT_TRUE(registry.Insert(1, first));
+    ASSERT_TRUE(registry.Remove(1, first));
+    ASSERT_TRUE(registry.Insert(1, second));
+
+    // A late removal on behalf of the first value leaves the new owner in place
+    EXPECT_FALSE(registry.Remove(1, first));
+    EXPECT_EQ(registry.Find(1), second);
+    EXPECT_TRUE(registry.Remove(1, second));
+    EXPECT_FALSE(registry.Remove(1, second));
+    EXPECT_EQ(registry.Size(), 0u);
+    EXPECT_EQ(registry.GetStats().writes, 4u);
+}
+
+TEST(ShardedRegistryTest, ForEachVisitsEveryShard) {
+    Registry registry(8);
+    for (int i = 0; i < 100; ++i) {
+        registry.Insert(i, std::make_shared<std::string>(std::to_string(i)));
+    }
+
+    std::set<int> visited;
+    registry.ForEach([&](int key, const std::shared_ptr<std::string>& value) {
+        EXPECT_EQ(*value, std::to_string(key));
+        visited.insert(key);
+    });
+    EXPECT_EQ(visited.size(), 100u);
+}
+
+TEST(ShardedRegistryTest, SnapshotsAreRebuiltOnlyAfterWrites) {
+    Registry registry(1);
+    registry.Insert(1, std::make_shared<std::string>("a"));
+
+    auto countEntries = [&]() {
+        size_t count = 0;
+        registry.ForEach([&](int, const std::shared_ptr<std::string>&) { ++count; });
+        return count;
+    };
+
+    EXPECT_EQ(countEntries(), 1u);
+    EXPECT_EQ(countEntries(), 1u);
+    EXPECT_EQ(registry.GetStats().snapshotRebuilds, 1u);
+
+    registry.Insert(2, std::make_shared<std::string>("b"));
+    EXPECT_EQ(countEntries(), 2u);
+    EXPECT_EQ(registry.GetStats().snapshotRebuilds, 2u);
+    EXPECT_EQ(registry.GetStats().writes, 2u);
+}
+
+TEST(ShardedRegistryTest, CallbackMayModifyTheRegistry) {
+    Registry registry(2);
+    for (int i = 0; i < 10; ++i) {
+        registry.Insert(i, std::make_shared<std::string>("x"));
+    }
+
+    // The walk holds no lock, so removing from inside it does not deadlock
+    registry.ForEach([&](int key, const std::shared_ptr<std::string>& value) {
+        EXPECT_TRUE(value);
+        registry.Remove(key);
+    });
+    EXPECT_EQ(registry.Size(), 0u);
+}
+
+TEST(ShardedRegistryTest, RemoveAllReturnsEveryEntry) {
+    Registry registry(4);
+    for (int i = 0; i < 20; ++i) {
+        registry.Insert(i, std::make_shared<std::string>("x"));
+    }
+
+    std::vector<Registry::Entry> removed = registry.RemoveAll();
+    EXPECT_EQ(removed.size(), 20u);
+    EXPECT_EQ(registry.Size(), 0u);
+
+    size_t visited = 0;
+    registry.ForEach([&](int, const std::shared_ptr<std::string>&) { ++visited; });
+    EXPECT_EQ(visited, 0u);
+}
+
+TEST(ShardedRegistryTest, ConcurrentWritersAndReaders) {
+    ShardedRegistry<int, std::atomic<int>> registry(16);
+    constexpr int WRITERS = 4;
+    constexpr int KEYS_PER_WRITER = 2000;
+    std::atomic<bool> done{false};
+
+    // Readers walk and bump every value they see while writers churn their own key ranges
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                registry.ForEach([](int, const std::shared_ptr<std::atomic<int>>& value) {
+                    value->fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITERS; ++w) {
+        writers.emplace_back([&registry, w]() {
+            for (int i = 0; i < KEYS_PER_WRITER; ++i) {
+                int key = w * KEYS_PER_WRITER + i;
+                EXPECT_TRUE(registry.Insert(key, std::make_shared<std::atomic<int>>(0)));
+                EXPECT_TRUE(registry.Find(key));
+                if (i % 2 == 0) {
+                    EXPECT_TRUE(registry.Remove(key));
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(registry.Size(), static_cast<size_t>(WRITERS * KEYS_PER_WRITER / 2));
+    size_t visited = 0;
+    registry.ForEach([&](int key, const std::shared_ptr<std::atomic<int>>&) {
+        EXPECT_EQ(key % 2, 1);
+        ++visited;
+    });
+    EXPECT_EQ(visited, registry.Size());
+    EXPECT_EQ(registry.GetStats().writes, static_cast<uint64_t>(WRITERS * KEYS_PER_WRITER * 3 / 2));
+}
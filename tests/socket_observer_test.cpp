@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "network/socket_observer.h"
+#include "network/byte_utils.h"
+
+using Operation = SocketIoEvent::Operation;
+
+// Helper functions
+namespace {
+    // Captures every event with a copy of its payload
+    class RecordingObserver : public ISocketObserver {
+    public:
+        struct Record {
+            Operation operation;
+            std::string payload;
+            long long result;
+        };
+
+        void AfterIo(const ISocketBase&, const SocketIoEvent& event) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_records.push_back({event.operation,
+                                 std::string(reinterpret_cast<const char*>(event.payload.data()), event.payload.size()),
+                                 event.result});
+        }
+
+        std::vector<Record> Take() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return std::move(m_records);
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<Record> m_records;
+    };
+
+    // Fails every send without reaching the socket
+    class FailSends : public ISocketObserver {
+    public:
+        bool BeforeIo(const ISocketBase&, SocketIoEvent& event) override {
+            if (event.operation != Operation::Send && event.operation != Operation::SendTo)
+                return true;
+            event.result = -1;
+            errno = ECONNRESET;
+            return false;
+        }
+    };
+
+    // Compile-time policy: not derived from ISocketObserver, so the hooks are called directly
+    struct CountingPolicy {
+        size_t calls = 0;
+        long long bytes = 0;
+
+        bool BeforeIo(const ISocketBase&, SocketIoEvent&) { return true; }
+        void AfterIo(const ISocketBase&, const SocketIoEvent& event) {
+            ++calls;
+            bytes += event.result > 0 ? event.result : 0;
+        }
+    };
+
+    std::string Text(const std::vector<std::byte>& bytes, int count) {
+        return std::string(reinterpret_cast<const char*>(bytes.data()), static_cast<size_t>(std::max(count, 0)));
+    }
+}
+
+TEST(SocketObserverTest, TcpCallsAreObservedWithPayloadsAndResults) {
+    auto observer = std::make_shared<RecordingObserver>();
+    ObservedSocketFactory<> factory(NetworkFactorySingleton::GetInstance(), observer);
+
+    auto listener = factory.CreateTcpListener();
+    ASSERT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(listener->Listen(1));
+    auto client = factory.CreateTcpSocket();
+    ASSERT_TRUE(client->Connect(NetworkAddress("127.0.0.1", listener->GetLocalAddress().port)));
+    auto server = listener->AcceptTcp();
+    ASSERT_NE(server, nullptr);
+
+    ASSERT_EQ(client->Send(NetworkUtils::AsBytes("hello")), 5);
+    std::vector<std::byte> buffer(64);
+    ASSERT_TRUE(server->WaitForDataWithTimeout(2000));
+    int bytesRead = server->Receive(std::span<std::byte>(buffer));
+    EXPECT_EQ(Text(buffer, bytesRead), "hello");
+    client->Close();
+
+    std::vector<RecordingObserver::Record> records = observer->Take();
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[0].operation, Operation::Connect);
+    EXPECT_EQ(records[0].result, 1);
+    EXPECT_EQ(records[1].operation, Operation::Accept);
+    EXPECT_EQ(records[1].result, 1);
+    EXPECT_EQ(records[2].operation, Operation::Send);
+    EXPECT_EQ(records[2].payload, "hello");
+    EXPECT_EQ(records[3].operation, Operation::Receive);
+    EXPECT_EQ(records[3].payload, "hello");
+    EXPECT_EQ(records[3].result, 5);
+    EXPECT_EQ(records[4].operation, Operation::Close);
+}
+
+TEST(SocketObserverTest, ObserverCanInjectFailures) {
+    auto& platform = NetworkFactorySingleton::GetInstance();
+    ObservedSocketFactory<> factory(platform, std::make_shared<FailSends>());
+
+    auto receiver = platform.CreateUdpSocket();
+    ASSERT_TRUE(receiver->Bind(NetworkAddress("127.0.0.1", 0)));
+    auto sender = factory.CreateUdpSocket();
+    ASSERT_TRUE(sender->Bind(NetworkAddress("127.0.0.1", 0)));
+
+    const AddressKey destination(0x7F000001, receiver->GetLocalAddress().port);
+    errno = 0;
+    EXPECT_EQ(sender->SendTo(NetworkUtils::AsBytes("lost"), destination), -1);
+    EXPECT_EQ(errno, ECONNRESET);
+    EXPECT_EQ(sender->SendToMany(NetworkUtils::AsBytes("lost"), std::span<const AddressKey>(&destination, 1)), 0u);
+
+    // Nothing reached the wire
+    EXPECT_FALSE(receiver->WaitForDataWithTimeout(50));
+}
+
+TEST(SocketObserverTest, UdpPeersAreReported) {
+    // Remembers the peer of the last datagram, whichever form it came in
+    struct PeerObserver : ISocketObserver {
+        unsigned short keyPort = 0;
+        unsigned short addressPort = 0;
+        void AfterIo(const ISocketBase&, const SocketIoEvent& event) override {
+            if (event.operation != Operation::ReceiveFrom)
+                return;
+            if (event.peerKey) {
+                keyPort = event.peerKey->GetPort();
+            }
+            if (event.peer) {
+                addressPort = event.peer->port;
+            }
+        }
+    };
+    auto observer = std::make_shared<PeerObserver>();
+    auto& platform = NetworkFactorySingleton::GetInstance();
+    ObservedUdpSocket<> receiver(platform.CreateUdpSocket(), observer);
+    ASSERT_TRUE(receiver.Bind(NetworkAddress("127.0.0.1", 0)));
+    auto sender = platform.CreateUdpSocket();
+    ASSERT_TRUE(sender->Bind(NetworkAddress("127.0.0.1", 0)));
+    const unsigned short senderPort = sender->GetLocalAddress().port;
+    const NetworkAddress destination("127.0.0.1", receiver.GetLocalAddress().port);
+
+    std::vector<std::byte> buffer(16);
+    sender->SendTo(NetworkUtils::AsBytes("one"), destination);
+    ASSERT_TRUE(receiver.WaitForDataWithTimeout(2000));
+    AddressKey fromKey;
+    EXPECT_EQ(receiver.ReceiveFrom(std::span<std::byte>(buffer), fromKey), 3);
+    EXPECT_EQ(observer->keyPort, senderPort);
+
+    sender->SendTo(NetworkUtils::AsBytes("two"), destination);
+    ASSERT_TRUE(receiver.WaitForDataWithTimeout(2000));
+    NetworkAddress fromAddress;
+    EXPECT_EQ(receiver.ReceiveFrom(std::span<std::byte>(buffer), fromAddress), 3);
+    EXPECT_EQ(observer->addressPort, senderPort);
+}
+
+TEST(SocketObserverTest, PollersSeeThroughDecorators) {
+    auto& platform = NetworkFactorySingleton::GetInstance();
+    ObservedSocketFactory<> factory(platform, std::make_shared<ISocketObserver>());
+
+    auto receiver = factory.CreateUdpSocket();
+    ASSERT_TRUE(receiver->Bind(NetworkAddress("127.0.0.1", 0)));
+    auto poller = factory.CreateSocketPoller();
+    ASSERT_TRUE(poller->Add(*receiver, ISocketPoller::Readable, 7));
+
+    auto sender = platform.CreateUdpSocket();
+    sender->SendTo(NetworkUtils::AsBytes("ready"), NetworkAddress("127.0.0.1", receiver->GetLocalAddress().port));
+
+    std::vector<ISocketPoller::Ready> ready(4);
+    ASSERT_EQ(poller->Wait(std::span<ISocketPoller::Ready>(ready), 2000), 1);
+    EXPECT_EQ(ready[0].token, 7u);
+    EXPECT_TRUE(poller->Remove(*receiver));
+}
+
+TEST(SocketObserverTest, CompileTimePolicy) {
+    auto policy = std::make_shared<CountingPolicy>();
+    auto& platform = NetworkFactorySingleton::GetInstance();
+    ObservedUdpSocket<CountingPolicy> socket(platform.CreateUdpSocket(), policy);
+    ASSERT_TRUE(socket.Bind(NetworkAddress("127.0.0.1", 0)));
+
+    const AddressKey self(0x7F000001, socket.GetLocalAddress().port);
+    EXPECT_EQ(socket.SendTo(NetworkUtils::AsBytes("abc"), self), 3);
+    ASSERT_TRUE(socket.WaitForDataWithTimeout(2000));
+    std::vector<std::byte> buffer(16);
+    AddressKey from;
+    EXPECT_EQ(socket.ReceiveFrom(std::span<std::byte>(buffer), from), 3);
+    EXPECT_EQ(from, self);
+
+    EXPECT_EQ(policy->calls, 2u);
+    EXPECT_EQ(policy->bytes, 6);
+}
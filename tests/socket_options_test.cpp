@@ -13,6 +13,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #endif
 
 // Define SO_BINDTODEVICE for platforms that don't have it (macOS)
@@ -329,6 +330,48 @@ TEST_F(SocketOptionsTest, GetAcceptConn) {
     EXPECT_FALSE(SocketOptions::GetAcceptConn(nullptr, isListening));
 }
 
+TEST_F(SocketOptionsTest, GetTcpInfo) {
+    TcpInfo info;
+    #ifdef __linux__
+    // An older kernel that only knows glibc's shorter struct tcp_info
+    EXPECT_CALL(mockSocket, GetSocketOption(IPPROTO_TCP, TCP_INFO, NotNull(), NotNull()))
+        .WillOnce(DoAll(
+            WithArg<2>([](void* val) {
+                tcp_info raw = {};
+                raw.tcpi_rtt = 1500;
+                raw.tcpi_rttvar = 250;
+                raw.tcpi_snd_mss = 1448;
+                raw.tcpi_snd_cwnd = 10;
+                raw.tcpi_unacked = 6;
+                raw.tcpi_sacked = 1;
+                raw.tcpi_lost = 2;
+                raw.tcpi_retrans = 1;
+                raw.tcpi_total_retrans = 9;
+                std::memcpy(val, &raw, sizeof(raw));
+            }),
+            WithArg<3>([](socklen_t* len) { *len = sizeof(tcp_info); }),
+            Return(true)
+        ));
+    ASSERT_TRUE(SocketOptions::GetTcpInfo(&mockSocket, info));
+    EXPECT_EQ(info.rtt, std::chrono::microseconds(1500));
+    EXPECT_EQ(info.rttVariance, std::chrono::microseconds(250));
+    EXPECT_EQ(info.mss, 1448u);
+    EXPECT_EQ(info.congestionWindow, 10u);
+    EXPECT_EQ(info.lostSegments, 2u);
+    EXPECT_EQ(info.retransmits, 9u);
+    EXPECT_EQ(info.bytesInFlight, 4u * 1448);   // 6 unacked - 1 sacked - 2 lost + 1 retransmitted
+    EXPECT_EQ(info.deliveryRate, 0u);           // Beyond what this kernel reported
+
+    EXPECT_CALL(mockSocket, GetSocketOption(IPPROTO_TCP, TCP_INFO, _, _)).WillOnce(Return(false));
+    EXPECT_FALSE(SocketOptions::GetTcpInfo(&mockSocket, info));
+    #elif defined(_WIN32)
+    EXPECT_CALL(mockSocket, GetSocketOption(_, _, _, _)).Times(0);
+    EXPECT_FALSE(SocketOptions::GetTcpInfo(&mockSocket, info));
+    #endif
+
+    EXPECT_FALSE(SocketOptions::GetTcpInfo(nullptr, info));
+}
+
 TEST_F(SocketOptionsTest, BindToDevice) {
     std::string interfaceName = "eth0";
     #if defined(_WIN32) || defined(__APPLE__)
@@ -371,6 +414,67 @@ TEST_F(SocketOptionsTest, SetPriority) {
     EXPECT_FALSE(SocketOptions::SetPriority(nullptr, PRIORITY));
 }
 
+TEST_F(SocketOptionsTest, SetMaxPacingRate) {
+    #ifdef __linux__
+    // A 64-bit rate, with 0 turned into the kernel's "unlimited"
+    EXPECT_CALL(mockSocket, SetSocketOption(SOL_SOCKET, SO_MAX_PACING_RATE, NotNull(), sizeof(uint64_t)))
+        .WillOnce(DoAll(
+            WithArg<2>([](const void* val) { EXPECT_EQ(*static_cast<const uint64_t*>(val), 125000u); }),
+            Return(true)
+        ))
+        .WillOnce(DoAll(
+            WithArg<2>([](const void* val) { EXPECT_EQ(*static_cast<const uint64_t*>(val), ~uint64_t{0}); }),
+            Return(true)
+        ));
+    EXPECT_TRUE(SocketOptions::SetMaxPacingRate(&mockSocket, 125000));
+    EXPECT_TRUE(SocketOptions::SetMaxPacingRate(&mockSocket, 0));
+    #else
+    // Kernel pacing is Linux-only; callers fall back to a TokenBucket
+    EXPECT_CALL(mockSocket, SetSocketOption(_, _, _, _)).Times(0);
+    EXPECT_FALSE(SocketOptions::SetMaxPacingRate(&mockSocket, 125000));
+    #endif
+
+    EXPECT_FALSE(SocketOptions::SetMaxPacingRate(nullptr, 125000));
+}
+
+TEST_F(SocketOptionsTest, SetMulticastInterface) {
+    EXPECT_CALL(mockSocket, SetSocketOption(IPPROTO_IP, IP_MULTICAST_IF, NotNull(), sizeof(in_addr)))
+        .WillOnce(DoAll(
+            WithArg<2>([](const void* val) {
+                EXPECT_EQ(static_cast<const in_addr*>(val)->s_addr, htonl(0x7F000001));
+            }),
+            Return(true)
+        ));
+    EXPECT_TRUE(SocketOptions::SetMulticastInterface(&mockSocket, "127.0.0.1"));
+
+    // Only dotted-quad addresses name an interface
+    EXPECT_FALSE(SocketOptions::SetMulticastInterface(&mockSocket, "eth0"));
+    EXPECT_FALSE(SocketOptions::SetMulticastInterface(nullptr, "127.0.0.1"));
+}
+
+TEST_F(SocketOptionsTest, SetMulticastTtl) {
+    EXPECT_CALL(mockSocket, SetSocketOption(IPPROTO_IP, IP_MULTICAST_TTL, NotNull(), sizeof(int)))
+        .WillOnce(DoAll(
+            WithArg<2>([](const void* val) { EXPECT_EQ(*static_cast<const int*>(val), 4); }),
+            Return(true)
+        ));
+    EXPECT_TRUE(SocketOptions::SetMulticastTtl(&mockSocket, 4));
+    EXPECT_FALSE(SocketOptions::SetMulticastTtl(nullptr, 4));
+}
+
+TEST_F(SocketOptionsTest, EnableTxTime) {
+    #ifdef __linux__
+    EXPECT_CALL(mockSocket, SetSocketOption(SOL_SOCKET, SO_TXTIME, NotNull(), _))
+        .WillOnce(Return(true));
+    EXPECT_TRUE(SocketOptions::EnableTxTime(&mockSocket));
+    #else
+    EXPECT_CALL(mockSocket, SetSocketOption(_, _, _, _)).Times(0);
+    EXPECT_FALSE(SocketOptions::EnableTxTime(&mockSocket));
+    #endif
+
+    EXPECT_FALSE(SocketOptions::EnableTxTime(nullptr));
+}
+
 TEST_F(SocketOptionsTest, SetRawOption) {
     const char* testData = "test-data";
     size_t dataSize = strlen(testData) + 1;  // Include null terminator
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/platform_factory.h"
+#include "network/socket_poller.h"
+#include "network/byte_utils.h"
+#include "utils/test_utils.h"
+
+using namespace test_utils::constants;
+using namespace test_utils::timeouts;
+
+// Fixture with a poller and a connected loopback pair
+class SocketPollerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto& factory = NetworkFactorySingleton::GetInstance();
+        poller = factory.CreateSocketPoller();
+        ASSERT_TRUE(poller);
+
+        listener = factory.CreateTcpListener();
+        ASSERT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+        ASSERT_TRUE(listener->Listen(SERVER_BACKLOG_SIZE));
+
+        client = factory.CreateTcpSocket();
+        ASSERT_TRUE(client->Connect(listener->GetLocalAddress()));
+        server = listener->AcceptTcp();
+        ASSERT_TRUE(server);
+    }
+
+    int WaitOnce(int timeoutMs) {
+        return poller->Wait(std::span<ISocketPoller::Ready>(ready), timeoutMs);
+    }
+
+    std::unique_ptr<ISocketPoller> poller;
+    std::unique_ptr<ITcpListener> listener;
+    std::unique_ptr<ITcpSocket> client;
+    std::unique_ptr<ITcpSocket> server;
+    std::array<ISocketPoller::Ready, 16> ready{};
+};
+
+TEST_F(SocketPollerTest, ReportsReadableWithToken) {
+    ASSERT_TRUE(poller->Add(*server, ISocketPoller::Readable, 42));
+    EXPECT_EQ(WaitOnce(ZERO_TIMEOUT_MS), 0);
+
+    ASSERT_EQ(client->Send(NetworkUtils::AsBytes("ping")), 4);
+    ASSERT_EQ(WaitOnce(LONG_TIMEOUT_MS), 1);
+    EXPECT_EQ(ready[0].token, 42u);
+    EXPECT_TRUE(ready[0].events & ISocketPoller::Readable);
+
+    // Level-triggered: still readable until the data is consumed
+    EXPECT_EQ(WaitOnce(ZERO_TIMEOUT_MS), 1);
+    std::vector<std::byte> buffer(16);
+    EXPECT_EQ(server->Receive(std::span<std::byte>(buffer)), 4);
+    EXPECT_EQ(WaitOnce(ZERO_TIMEOUT_MS), 0);
+}
+
+TEST_F(SocketPollerTest, ModifyAndRemoveChangeInterest) {
+    ASSERT_TRUE(poller->Add(*server, ISocketPoller::Readable, 1));
+    EXPECT_EQ(WaitOnce(ZERO_TIMEOUT_MS), 0);
+
+    // An idle connection is writable as soon as write interest is added
+    ASSERT_TRUE(poller->Modify(*server, ISocketPoller::Readable | ISocketPoller::Writable, 2));
+    ASSERT_EQ(WaitOnce(LONG_TIMEOUT_MS), 1);
+    EXPECT_EQ(ready[0].token, 2u);
+    EXPECT_TRUE(ready[0].events & ISocketPoller::Writable);
+
+    ASSERT_TRUE(poller->Remove(*server));
+    ASSERT_EQ(client->Send(NetworkUtils::AsBytes("ping")), 4);
+    EXPECT_EQ(WaitOnce(SHORT_TIMEOUT_MS), 0);
+    EXPECT_FALSE(poller->Remove(*server));
+}
+
+TEST_F(SocketPollerTest, ListenerIsReadableWithPendingConnection) {
+    ASSERT_TRUE(listener->SetNonBlocking(true));
+    ASSERT_TRUE(poller->Add(*listener, ISocketPoller::Readable, 7));
+
+    auto second = NetworkFactorySingleton::GetInstance().CreateTcpSocket();
+    ASSERT_TRUE(second->Connect(listener->GetLocalAddress()));
+    ASSERT_EQ(WaitOnce(LONG_TIMEOUT_MS), 1);
+    EXPECT_EQ(ready[0].token, 7u);
+
+    EXPECT_TRUE(listener->AcceptTcp());
+    // Nothing else pending: a non-blocking accept fails at once instead of waiting
+    EXPECT_FALSE(listener->AcceptTcp());
+    EXPECT_TRUE(ISocketPoller::LastCallWouldBlock());
+}
+
+TEST_F(SocketPollerTest, PeerCloseIsReported) {
+    ASSERT_TRUE(poller->Add(*server, ISocketPoller::Readable, 3));
+    client->Close();
+
+    ASSERT_EQ(WaitOnce(LONG_TIMEOUT_MS), 1);
+    EXPECT_EQ(ready[0].token, 3u);
+    std::vector<std::byte> buffer(16);
+    EXPECT_EQ(server->Receive(std::span<std::byte>(buffer)), 0);
+}
+
+TEST_F(SocketPollerTest, NonBlockingReceiveWouldBlock) {
+    ASSERT_TRUE(server->SetNonBlocking(true));
+
+    std::vector<std::byte> buffer(16);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(server->Receive(std::span<std::byte>(buffer)), -1);
+    EXPECT_TRUE(ISocketPoller::LastCallWouldBlock());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(SHORT_TIMEOUT_MS));
+}
+
+TEST_F(SocketPollerTest, WakeupInterruptsWait) {
+    ASSERT_TRUE(poller->Add(*server, ISocketPoller::Readable, 1));
+
+    std::thread waker([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(SHORT_TIMEOUT_MS));
+        poller->Wakeup();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(WaitOnce(-1), 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(CONNECTION_TIMEOUT_MS));
+    waker.join();
+
+    // A wakeup before Wait is not lost, and it is consumed by that Wait
+    poller->Wakeup();
+    EXPECT_EQ(WaitOnce(LONG_TIMEOUT_MS), 0);
+    EXPECT_EQ(WaitOnce(ZERO_TIMEOUT_MS), 0);
+}
+
+TEST_F(SocketPollerTest, RejectsReservedToken) {
+    EXPECT_FALSE(poller->Add(*server, ISocketPoller::Readable, ISocketPoller::WAKEUP_TOKEN));
+}
+
+TEST(SocketPollerFactoryTest, FactoriesWithoutPollersStillCompile) {
+    // A factory written before pollers existed only overrides the socket constructors
+    class LegacyFactory : public INetworkSocketFactory {
+    public:
+        std::unique_ptr<ITcpSocket> CreateTcpSocket() override { return nullptr; }
+        std::unique_ptr<ITcpListener> CreateTcpListener() override { return nullptr; }
+        std::unique_ptr<IUdpSocket> CreateUdpSocket() override { return nullptr; }
+    };
+    LegacyFactory factory;
+    EXPECT_EQ(factory.CreateSocketPoller(), nullptr);
+}
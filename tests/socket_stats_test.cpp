@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/platform_factory.h"
+#include "network/socket_stats.h"
+#include "network/byte_utils.h"
+
+using namespace std::chrono_literals;
+
+// Helper functions
+namespace {
+    struct TcpPair {
+        std::unique_ptr<ITcpListener> listener;
+        std::unique_ptr<ITcpSocket> client;
+        std::unique_ptr<ITcpSocket> server;
+
+        explicit TcpPair(INetworkSocketFactory& factory) {
+            listener = factory.CreateTcpListener();
+            EXPECT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+            EXPECT_TRUE(listener->Listen(4));
+            client = factory.CreateTcpSocket();
+            EXPECT_TRUE(client->Connect(NetworkAddress("127.0.0.1", listener->GetLocalAddress().port)));
+            server = listener->AcceptTcp();
+            EXPECT_TRUE(server);
+        }
+    };
+}
+
+TEST(SocketStatsTest, HistogramBucketsArePowersOfTwo) {
+    using Histogram = SocketStats::Histogram;
+    EXPECT_EQ(Histogram::BucketFor(0), 0u);
+    EXPECT_EQ(Histogram::BucketFor(1), 1u);
+    EXPECT_EQ(Histogram::BucketFor(2), 2u);
+    EXPECT_EQ(Histogram::BucketFor(3), 2u);
+    EXPECT_EQ(Histogram::BucketFor(4), 3u);
+    EXPECT_EQ(Histogram::BucketFor(1500), 11u);
+    EXPECT_EQ(Histogram::BucketFor(uint64_t{1} << 40), SocketStats::HISTOGRAM_BUCKETS - 1);
+    EXPECT_EQ(Histogram::BucketUpperBound(11), 2047u);
+
+    Histogram histogram;
+    histogram.buckets[Histogram::BucketFor(100)] = 90;
+    histogram.buckets[Histogram::BucketFor(5000)] = 10;
+    EXPECT_EQ(histogram.GetCount(), 100u);
+    EXPECT_EQ(histogram.GetPercentile(0.5), 127u);
+    EXPECT_EQ(histogram.GetPercentile(0.9), 127u);
+    EXPECT_EQ(histogram.GetPercentile(0.99), 8191u);
+    EXPECT_EQ(Histogram().GetPercentile(0.5), 0u);
+}
+
+TEST(SocketStatsTest, ClassifiesCallResults) {
+    SocketStats stats;
+    stats.Record(SocketStats::Direction::Send, 100, 100, false, 2us);
+    stats.Record(SocketStats::Direction::Send, 100, 40, false, 2us);
+    stats.Record(SocketStats::Direction::Send, 100, -1, true, 1us);
+    stats.Record(SocketStats::Direction::Receive, 4096, -1, false, 1us);
+    stats.Record(SocketStats::Direction::Receive, 4096, 0, false, 1us);   // Orderly shutdown
+
+    SocketStats::Snapshot snapshot = stats.GetSnapshot();
+    EXPECT_EQ(snapshot.send.calls, 3u);
+    EXPECT_EQ(snapshot.send.bytes, 140u);
+    EXPECT_EQ(snapshot.send.shortTransfers, 1u);
+    EXPECT_EQ(snapshot.send.wouldBlock, 1u);
+    EXPECT_EQ(snapshot.send.errors, 0u);
+    EXPECT_EQ(snapshot.send.bytesPerCall.GetCount(), 2u);
+    EXPECT_EQ(snapshot.send.durationNs.GetCount(), 3u);
+    EXPECT_EQ(snapshot.send.durationNs.buckets[SocketStats::Histogram::BucketFor(2000)], 2u);
+
+    EXPECT_EQ(snapshot.receive.calls, 2u);
+    EXPECT_EQ(snapshot.receive.errors, 1u);
+    EXPECT_EQ(snapshot.receive.bytesPerCall.buckets[0], 1u);
+}
+
+TEST(SocketStatsTest, CountsTcpTrafficAndWouldBlock) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    TcpPair pair(factory);
+    ASSERT_TRUE(pair.server);
+    auto stats = std::make_shared<SocketStats>();
+    ASSERT_TRUE(pair.server->EnableStats(stats));
+    EXPECT_EQ(pair.server->GetStats(), stats);
+
+    ASSERT_TRUE(pair.server->SetNonBlocking(true));
+    std::vector<std::byte> buffer(1024);
+    EXPECT_LT(pair.server->Receive(std::span<std::byte>(buffer)), 0);
+    EXPECT_TRUE(ISocketPoller::LastCallWouldBlock());     // errno survives the recording
+
+    EXPECT_EQ(pair.client->Send(NetworkUtils::AsBytes("hello")), 5);
+    ASSERT_TRUE(pair.server->WaitForDataWithTimeout(1000));
+    EXPECT_EQ(pair.server->Receive(std::span<std::byte>(buffer)), 5);
+    EXPECT_EQ(pair.server->Send(NetworkUtils::AsBytes("hi")), 2);
+
+    SocketStats::Snapshot snapshot = stats->GetSnapshot();
+    EXPECT_EQ(snapshot.receive.calls, 2u);
+    EXPECT_EQ(snapshot.receive.wouldBlock, 1u);
+    EXPECT_EQ(snapshot.receive.bytes, 5u);
+    EXPECT_EQ(snapshot.receive.shortTransfers, 1u);
+    EXPECT_EQ(snapshot.send.calls, 1u);
+    EXPECT_EQ(snapshot.send.bytes, 2u);
+    EXPECT_EQ(snapshot.send.shortTransfers, 0u);
+
+    // The client has no stats and counts nothing
+    EXPECT_EQ(pair.client->GetStats(), nullptr);
+}
+
+TEST(SocketStatsTest, CountsUdpTrafficIncludingBatches) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto sender = factory.CreateUdpSocket();
+    auto receiver = factory.CreateUdpSocket();
+    ASSERT_TRUE(sender->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(receiver->Bind(NetworkAddress("127.0.0.1", 0)));
+    auto sendStats = std::make_shared<SocketStats>();
+    auto receiveStats = std::make_shared<SocketStats>();
+    ASSERT_TRUE(sender->EnableStats(sendStats));
+    ASSERT_TRUE(receiver->EnableStats(receiveStats));
+
+    AddressKey destination(0x7F000001, receiver->GetLocalAddress().port);
+    std::vector<AddressKey> destinations(3, destination);
+    EXPECT_EQ(sender->SendTo(NetworkUtils::AsBytes("one"), destination), 3);
+    EXPECT_EQ(sender->SendToMany(NetworkUtils::AsBytes("many"), destinations), 3u);
+
+    std::vector<std::byte> buffer(1500);
+    AddressKey from;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(receiver->WaitForDataWithTimeout(1000));
+        EXPECT_GT(receiver->ReceiveFrom(std::span<std::byte>(buffer), from), 0);
+    }
+
+    SocketStats::Snapshot sent = sendStats->GetSnapshot();
+    EXPECT_EQ(sent.send.bytes, 15u);
+#ifdef __linux__
+    EXPECT_EQ(sent.send.calls, 2u);     // One sendmmsg for the whole batch
+#endif
+    SocketStats::Snapshot received = receiveStats->GetSnapshot();
+    EXPECT_EQ(received.receive.calls, 4u);
+    EXPECT_EQ(received.receive.bytes, 15u);
+    EXPECT_EQ(received.receive.bytesPerCall.GetCount(), 4u);
+}
+
+TEST(SocketStatsTest, ListenerGroupTotalsAcceptedConnections) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto listener = factory.CreateTcpListener();
+    ASSERT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(listener->Listen(4));
+    auto group = std::make_shared<SocketStatsGroup>();
+    ASSERT_TRUE(listener->SetStatsGroup(group));
+    const NetworkAddress address("127.0.0.1", listener->GetLocalAddress().port);
+
+    std::vector<std::unique_ptr<ITcpSocket>> clients;
+    std::vector<std::unique_ptr<ITcpSocket>> accepted;
+    for (int i = 0; i < 3; ++i) {
+        clients.push_back(factory.CreateTcpSocket());
+        ASSERT_TRUE(clients.back()->Connect(address));
+        accepted.push_back(listener->AcceptTcp());
+        ASSERT_TRUE(accepted.back());
+        EXPECT_EQ(accepted.back()->Send(NetworkUtils::AsBytes("welcome")), 7);
+    }
+    EXPECT_EQ(group->GetSocketCount(), 3u);
+    EXPECT_EQ(group->GetSnapshot().send.bytes, 21u);
+
+    // Closed connections leave the group but their traffic stays in the totals
+    accepted.erase(accepted.begin());
+    EXPECT_EQ(group->GetSocketCount(), 2u);
+    EXPECT_EQ(accepted[0]->Send(NetworkUtils::AsBytes("more")), 4);
+    SocketStats::Snapshot snapshot = group->GetSnapshot();
+    EXPECT_EQ(snapshot.send.calls, 4u);
+    EXPECT_EQ(snapshot.send.bytes, 25u);
+}
+
+TEST(SocketStatsTest, FactoryGroupCoversEverySocketItCreates) {
+    std::unique_ptr<INetworkSocketFactory> factory = INetworkSocketFactory::CreatePlatformFactory();
+    auto group = std::make_shared<SocketStatsGroup>();
+    ASSERT_TRUE(factory->SetStatsGroup(group));
+
+    TcpPair pair(*factory);
+    ASSERT_TRUE(pair.server);
+    EXPECT_NE(pair.client->GetStats(), nullptr);
+    EXPECT_NE(pair.server->GetStats(), nullptr);
+    EXPECT_EQ(pair.client->Send(NetworkUtils::AsBytes("ping")), 4);
+    std::vector<std::byte> buffer(16);
+    EXPECT_EQ(pair.server->Receive(std::span<std::byte>(buffer)), 4);
+
+    auto udp = factory->CreateUdpSocket();
+    EXPECT_NE(udp->GetStats(), nullptr);
+    EXPECT_EQ(group->GetSocketCount(), 3u);
+
+    SocketStats::Snapshot snapshot = group->GetSnapshot();
+    EXPECT_EQ(snapshot.send.bytes, 4u);
+    EXPECT_EQ(snapshot.receive.bytes, 4u);
+
+    // Turning it off affects only sockets created afterwards
+    ASSERT_TRUE(factory->SetStatsGroup(nullptr));
+    EXPECT_EQ(factory->CreateTcpSocket()->GetStats(), nullptr);
+    EXPECT_NE(pair.client->GetStats(), nullptr);
+}
+
+TEST(SocketStatsTest, RecordsFromManyThreads) {
+    SocketStats stats;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&stats, t] {
+            const auto direction = t % 2 ? SocketStats::Direction::Send : SocketStats::Direction::Receive;
+            for (int i = 0; i < 10000; ++i) {
+                stats.Record(direction, 64, 64, false, 500ns);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    SocketStats::Snapshot snapshot = stats.GetSnapshot();
+    EXPECT_EQ(snapshot.send.calls, 20000u);
+    EXPECT_EQ(snapshot.receive.bytes, 20000u * 64);
+    EXPECT_EQ(snapshot.receive.durationNs.GetCount(), 20000u);
+}
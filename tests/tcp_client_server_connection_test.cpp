@@ -255,3 +255,50 @@ TEST_F(TcpClientServerConnectionTest, NonBlockingOperation) {
     int bytesReceived = client->Receive(recvBuffer);
     EXPECT_GT(bytesReceived, 0) << "Failed to receive data";
 }
+
+// Shutdown ends the connection for both sides while the descriptor stays open
+TEST(TcpSocketShutdownTest, ShutdownEndsTheConnectionButKeepsTheSocket) {
+    auto& factory = NetworkFactorySingleton::GetInstance();
+    auto listener = factory.CreateTcpListener();
+    ASSERT_TRUE(listener->Bind(NetworkAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(listener->Listen(SERVER_BACKLOG_SIZE));
+    auto client = factory.CreateTcpSocket();
+    ASSERT_TRUE(client->Connect(listener->GetLocalAddress()));
+    auto accepted = listener->AcceptTcp();
+    ASSERT_TRUE(accepted);
+
+    ASSERT_TRUE(accepted->Shutdown());
+    EXPECT_TRUE(accepted->IsValid());
+
+    // The peer sees an orderly close, and a read on the shut socket returns at once
+    std::vector<std::byte> buffer(16);
+    ASSERT_TRUE(client->WaitForDataWithTimeout(2000));
+    EXPECT_EQ(client->Receive(std::span<std::byte>(buffer)), 0);
+    EXPECT_EQ(accepted->Receive(std::span<std::byte>(buffer)), 0);
+}
+
+// Test that the kernel's connection state is readable from a connected socket
+TEST_F(TcpClientServerConnectionTest, TcpInfo) {
+    ASSERT_TRUE(CreateAndStartServer(TCP_INFO_SERVER_PORT)) << "Failed to start TCP server: " << server->getErrorMessage();
+    ASSERT_TRUE(CreateAndConnectClient(server->getServerAddress()));
+
+    // One echoed round trip gives the client an RTT sample and acked bytes
+    std::string testMessage = "Hello, TCP_INFO!";
+    std::vector<std::byte> sendData = NetworkUtils::StringToBytes(testMessage);
+    ASSERT_EQ(client->Send(sendData), static_cast<int>(sendData.size()));
+    ASSERT_TRUE(client->WaitForDataWithTimeout(2000));
+    std::vector<std::byte> recvBuffer;
+    ASSERT_GT(client->Receive(recvBuffer), 0);
+
+    TcpInfo info;
+    #if defined(_WIN32)
+    EXPECT_FALSE(client->GetTcpInfo(info));
+    #else
+    ASSERT_TRUE(client->GetTcpInfo(info));
+    EXPECT_GT(info.rtt.count(), 0);
+    EXPECT_GT(info.mss, 0u);
+    EXPECT_GT(info.congestionWindow, 0u);
+    EXPECT_EQ(info.bytesSent, sendData.size());
+    EXPECT_GE(info.bytesReceived, sendData.size());   // The echo
+    #endif
+}
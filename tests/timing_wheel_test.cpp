@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "network/timing_wheel.h"
+
+using namespace std::chrono_literals;
+
+// Fixture driving a wheel with 10 ms ticks from a fake clock
+class TimingWheelTest : public ::testing::Test {
+protected:
+    static constexpr std::chrono::milliseconds TICK{10};
+
+    TimingWheelTest() : start(TimingWheel::Clock::now()), wheel(TICK, start) {}
+
+    // Advances the wheel to an absolute tick
+    size_t AdvanceTo(uint64_t tick) {
+        return wheel.Advance(start + TICK * static_cast<int64_t>(tick));
+    }
+
+    TimingWheel::Clock::time_point start;
+    TimingWheel wheel;
+};
+
+TEST_F(TimingWheelTest, FiresAtDeadlineNotBefore) {
+    int fired = 0;
+    wheel.Schedule(50ms, [&]() { ++fired; });
+    EXPECT_EQ(wheel.GetPendingCount(), 1u);
+
+    EXPECT_EQ(AdvanceTo(4), 0u);
+    EXPECT_EQ(fired, 0);
+    EXPECT_EQ(AdvanceTo(5), 1u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(wheel.GetPendingCount(), 0u);
+
+    // Delays round up to whole ticks, and never fire on the current tick
+    wheel.Schedule(1ms, [&]() { ++fired; });
+    wheel.Schedule(15ms, [&]() { ++fired; });
+    EXPECT_EQ(AdvanceTo(6), 1u);
+    EXPECT_EQ(AdvanceTo(7), 1u);
+    EXPECT_EQ(fired, 3);
+}
+
+TEST_F(TimingWheelTest, CancelAndRearm) {
+    int fired = 0;
+    TimingWheel::TimerId cancelled = wheel.Schedule(30ms, [&]() { fired += 1; });
+    TimingWheel::TimerId moved = wheel.Schedule(30ms, [&]() { fired += 10; });
+
+    EXPECT_TRUE(wheel.Cancel(cancelled));
+    EXPECT_FALSE(wheel.Cancel(cancelled));
+    EXPECT_TRUE(wheel.Rearm(moved, 100ms));
+
+    EXPECT_EQ(AdvanceTo(9), 0u);
+    EXPECT_EQ(AdvanceTo(10), 1u);
+    EXPECT_EQ(fired, 10);
+
+    // Ids of fired timers are stale, even once their slot is reused
+    EXPECT_FALSE(wheel.Rearm(moved, 10ms));
+    TimingWheel::TimerId reused = wheel.Schedule(10ms, []() {});
+    EXPECT_NE(reused, moved);
+    EXPECT_FALSE(wheel.Cancel(moved));
+    EXPECT_TRUE(wheel.Cancel(reused));
+    EXPECT_FALSE(wheel.Cancel(TimingWheel::INVALID_TIMER));
+}
+
+TEST_F(TimingWheelTest, LongDelaysCascadeDownToTheExactTick) {
+    // One delay per wheel level, plus one beyond the wheel's range
+    const std::vector<uint64_t> delays = {255, 256, 300, 16383, 16384, 20000, (1u << 20) + 7, (1u << 26) + 3};
+    std::map<uint64_t, uint64_t> firedAt;
+    for (uint64_t delay : delays) {
+        wheel.Schedule(TICK * static_cast<int64_t>(delay), [this, &firedAt, delay]() {
+            firedAt[delay] = wheel.GetCurrentTick();
+        });
+    }
+
+    for (uint64_t delay : delays) {
+        AdvanceTo(delay - 1);
+        EXPECT_EQ(firedAt.count(delay), 0u) << "delay " << delay;
+        AdvanceTo(delay);
+        ASSERT_EQ(firedAt.count(delay), 1u) << "delay " << delay;
+        EXPECT_EQ(firedAt[delay], delay);
+    }
+    EXPECT_EQ(wheel.GetPendingCount(), 0u);
+}
+
+TEST_F(TimingWheelTest, CallbacksMayScheduleAndCancel) {
+    int repeats = 0;
+    TimingWheel::TimerId other = wheel.Schedule(50ms, []() { FAIL() << "cancelled timer fired"; });
+
+    // A self-rescheduling timer, as used for periodic work
+    std::function<void()> repeat = [&]() {
+        if (++repeats < 3) {
+            wheel.Schedule(20ms, repeat);
+        }
+        wheel.Cancel(other);
+    };
+    wheel.Schedule(20ms, repeat);
+
+    AdvanceTo(100);
+    EXPECT_EQ(repeats, 3);
+    EXPECT_EQ(wheel.GetPendingCount(), 0u);
+}
+
+TEST_F(TimingWheelTest, MatchesReferenceUnderRandomOperations) {
+    std::mt19937 random(1234);
+    std::map<TimingWheel::TimerId, uint64_t> pending;  // Timer -> deadline tick
+    size_t fired = 0;
+    uint64_t now = 0;
+
+    for (int round = 0; round < 2000; ++round) {
+        // Mix of short and long delays
+        uint64_t delay = 1 + (random() % 4 == 0 ? random() % 40000 : random() % 300);
+        auto id = std::make_shared<TimingWheel::TimerId>();
+        *id = wheel.Schedule(TICK * static_cast<int64_t>(delay), [this, &pending, &fired, id]() {
+            // Every timer fires exactly on its deadline tick, even when Advance jumps ahead
+            auto it = pending.find(*id);
+            ASSERT_NE(it, pending.end());
+            EXPECT_EQ(wheel.GetCurrentTick(), it->second);
+            pending.erase(it);
+            ++fired;
+        });
+        pending[*id] = now + delay;
+
+        if (random() % 5 == 0) {
+            auto victim = std::next(pending.begin(), random() % pending.size());
+            if (random() % 2 == 0) {
+                EXPECT_TRUE(wheel.Cancel(victim->first));
+                pending.erase(victim);
+            } else {
+                uint64_t newDelay = 1 + random() % 5000;
+                EXPECT_TRUE(wheel.Rearm(victim->first, TICK * static_cast<int64_t>(newDelay)));
+                victim->second = now + newDelay;
+            }
+        }
+
+        now += random() % 50;
+        AdvanceTo(now);
+        EXPECT_EQ(wheel.GetPendingCount(), pending.size());
+    }
+
+    AdvanceTo(now + 50000);
+    EXPECT_TRUE(pending.empty());
+    EXPECT_GT(fired, 1000u);
+    EXPECT_EQ(wheel.GetPendingCount(), 0u);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/network.h"
+#include "network/platform_factory.h"
+#include "network/socket_options.h"
+#include "network/token_bucket.h"
+#include "network/udp_socket.h"
+#include "network/byte_utils.h"
+#include "utils/test_utils.h"
+
+using namespace std::chrono_literals;
+using namespace test_utils::timeouts;
+using test_utils::BindLoopback;
+using test_utils::KeyOf;
+using Clock = TokenBucket::Clock;
+
+// Helper functions
+namespace {
+    // Sends `count` numbered datagrams through the pacer and returns how long that took
+    Clock::duration SendPaced(IUdpSocket& sender, const AddressKey& destination, TokenBucket& pacer, int count) {
+        auto start = Clock::now();
+        for (int i = 0; i < count; ++i) {
+            std::string text = "datagram " + std::to_string(i);
+            EXPECT_GT(sender.SendToAt(NetworkUtils::AsBytes(text), destination, pacer.Reserve(text.size())), 0);
+        }
+        return Clock::now() - start;
+    }
+
+    std::vector<std::string> ReceiveAll(IUdpSocket& socket, int count) {
+        std::vector<std::string> received;
+        std::vector<std::byte> buffer(256);
+        while (static_cast<int>(received.size()) < count && socket.WaitForDataWithTimeout(LONG_TIMEOUT_MS)) {
+            AddressKey from;
+            int bytesRead = socket.ReceiveFrom(std::span<std::byte>(buffer), from);
+            if (bytesRead > 0) {
+                received.push_back(NetworkUtils::BytesToString(std::span<const std::byte>(buffer.data(), bytesRead)));
+            }
+        }
+        return received;
+    }
+}
+
+TEST(TokenBucketTest, UnlimitedRateNeverDelays) {
+    auto now = Clock::now();
+    TokenBucket bucket({}, now);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(bucket.Reserve(65000, now), now);
+    }
+}
+
+TEST(TokenBucketTest, BytesPerSecondSpacesSendsAfterTheBurst) {
+    auto now = Clock::now();
+    TokenBucket bucket({.bytesPerSecond = 10000, .burstBytes = 3000}, now);
+
+    // The full bucket covers three 1000-byte sends at once, then each waits 100 ms for its tokens
+    EXPECT_EQ(bucket.Reserve(1000, now), now);
+    EXPECT_EQ(bucket.Reserve(1000, now), now);
+    EXPECT_EQ(bucket.Reserve(1000, now), now);
+    EXPECT_EQ(bucket.Reserve(1000, now), now + 100ms);
+    EXPECT_EQ(bucket.Reserve(1000, now), now + 200ms);
+
+    // Sending on schedule keeps to the rate without building up another burst
+    EXPECT_EQ(bucket.Reserve(1000, now + 300ms), now + 300ms);
+    EXPECT_EQ(bucket.Reserve(1000, now + 300ms), now + 400ms);
+}
+
+TEST(TokenBucketTest, IdleTimeRefillsOnlyUpToTheBurst) {
+    auto now = Clock::now();
+    TokenBucket bucket({.bytesPerSecond = 1000, .burstBytes = 200}, now);
+    bucket.Reserve(200, now);
+
+    // A minute idle refills 200 bytes, not 60000
+    auto later = now + 60s;
+    EXPECT_EQ(bucket.Reserve(100, later), later);
+    EXPECT_EQ(bucket.Reserve(100, later), later);
+    EXPECT_EQ(bucket.Reserve(100, later), later + 100ms);
+}
+
+TEST(TokenBucketTest, PacketsPerSecondLimitsSmallSends) {
+    auto now = Clock::now();
+    TokenBucket bucket({.packetsPerSecond = 50}, now);
+
+    // The default packet burst is one, so every send after the first waits 20 ms
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(bucket.Reserve(10, now), now + i * 20ms);
+    }
+}
+
+TEST(TokenBucketTest, TheStricterLimitWins) {
+    auto now = Clock::now();
+    TokenBucket bucket({.bytesPerSecond = 100000, .packetsPerSecond = 100,
+                        .burstBytes = 100, .burstPackets = 1}, now);
+
+    // Small datagrams are limited by the packet rate (10 ms apart)...
+    EXPECT_EQ(bucket.Reserve(100, now), now);
+    EXPECT_EQ(bucket.Reserve(100, now), now + 10ms);
+
+    // ...large ones by the byte rate (5000 bytes take 50 ms)
+    EXPECT_EQ(bucket.Reserve(5000, now + 20ms), now + 20ms);
+    EXPECT_EQ(bucket.Reserve(100, now + 20ms), now + 70ms);
+}
+
+TEST(TokenBucketTest, SendsLargerThanTheBurstWaitForAFullBucket) {
+    auto now = Clock::now();
+    TokenBucket bucket({.bytesPerSecond = 1000, .burstBytes = 100}, now);
+
+    EXPECT_EQ(bucket.Reserve(500, now), now);
+    EXPECT_EQ(bucket.Reserve(500, now), now + 500ms);
+    EXPECT_EQ(bucket.Reserve(50, now), now + 950ms);
+}
+
+TEST(TokenBucketTest, TryConsumeOnlyBooksWhatMayLeaveNow) {
+    auto now = Clock::now();
+    TokenBucket bucket({.packetsPerSecond = 10}, now);
+
+    EXPECT_TRUE(bucket.TryConsume(1, now));
+    EXPECT_FALSE(bucket.TryConsume(1, now));
+    EXPECT_FALSE(bucket.TryConsume(1, now + 50ms));
+    EXPECT_TRUE(bucket.TryConsume(1, now + 100ms));
+
+    // The refusals booked nothing
+    EXPECT_EQ(bucket.Reserve(1, now + 100ms), now + 200ms);
+}
+
+TEST(TokenBucketTest, SetRateAppliesToLaterSends) {
+    auto now = Clock::now();
+    TokenBucket bucket({.packetsPerSecond = 10}, now);
+    EXPECT_EQ(bucket.Reserve(1, now), now);
+
+    // The send already booked at the old rate still holds the next 100 ms
+    bucket.SetRate({.packetsPerSecond = 100});
+    EXPECT_EQ(bucket.GetRate().packetsPerSecond, 100u);
+    EXPECT_EQ(bucket.Reserve(1, now), now + 100ms);
+    EXPECT_EQ(bucket.Reserve(1, now), now + 110ms);
+
+    bucket.SetRate({});
+    EXPECT_EQ(bucket.Reserve(1, now), now);
+}
+
+TEST(TokenBucketTest, SendToAtPacesDatagramsOverLoopback) {
+    auto sender = BindLoopback();
+    auto receiver = BindLoopback();
+    TokenBucket pacer({.packetsPerSecond = 100});
+
+    // Five datagrams at 100 per second leave over at least 40 ms
+    Clock::duration elapsed = SendPaced(*sender, KeyOf(*receiver), pacer, 5);
+    EXPECT_GE(elapsed, 35ms);
+
+    std::vector<std::string> received = ReceiveAll(*receiver, 5);
+    ASSERT_EQ(received.size(), 5u);
+    EXPECT_EQ(received.front(), "datagram 0");
+    EXPECT_EQ(received.back(), "datagram 4");
+}
+
+#ifdef __linux__
+TEST(TokenBucketTest, SendToAtHandsLaunchTimesToTheKernel) {
+    auto sender = BindLoopback();
+    auto receiver = BindLoopback();
+    ASSERT_TRUE(SocketOptions::EnableTxTime(sender.get()));
+    TokenBucket pacer({.packetsPerSecond = 20});
+
+    // With SO_TXTIME the call never sleeps; the qdisc holds each datagram instead (loopback
+    // normally has none, in which case they leave at once)
+    Clock::duration elapsed = SendPaced(*sender, KeyOf(*receiver), pacer, 5);
+    EXPECT_LT(elapsed, 150ms);
+    EXPECT_EQ(ReceiveAll(*receiver, 5).size(), 5u);
+
+    EXPECT_TRUE(SocketOptions::SetMaxPacingRate(sender.get(), 1000000));
+    EXPECT_TRUE(SocketOptions::SetMaxPacingRate(sender.get(), 0));
+}
+#endif
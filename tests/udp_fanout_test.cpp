@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/network.h"
+#include "network/platform_factory.h"
+#include "network/udp_socket.h"
+#include "network/byte_utils.h"
+#include "utils/test_utils.h"
+
+using namespace test_utils::timeouts;
+using test_utils::BindLoopback;
+using test_utils::KeyOf;
+
+// Helper functions
+namespace {
+    std::string ReceiveText(IUdpSocket& socket) {
+        if (!socket.WaitForDataWithTimeout(LONG_TIMEOUT_MS))
+            return "";
+        std::vector<std::byte> buffer(256);
+        AddressKey from;
+        int bytesRead = socket.ReceiveFrom(std::span<std::byte>(buffer), from);
+        return bytesRead > 0 ? std::string(reinterpret_cast<const char*>(buffer.data()), bytesRead) : "";
+    }
+}
+
+TEST(UdpFanOutTest, SendsThePayloadToEveryDestination) {
+    auto sender = BindLoopback();
+    std::vector<std::unique_ptr<IUdpSocket>> receivers;
+    std::vector<AddressKey> destinations;
+    for (int i = 0; i < 3; ++i) {
+        receivers.push_back(BindLoopback());
+        destinations.push_back(KeyOf(*receivers.back()));
+    }
+
+    std::vector<int> results(destinations.size(), 0);
+    EXPECT_EQ(sender->SendToMany(NetworkUtils::AsBytes("fan-out"), destinations, results), 3u);
+    for (size_t i = 0; i < receivers.size(); ++i) {
+        EXPECT_EQ(results[i], 7);
+        EXPECT_EQ(ReceiveText(*receivers[i]), "fan-out");
+    }
+}
+
+TEST(UdpFanOutTest, ReportsFailuresPerRecipient) {
+    auto sender = BindLoopback();
+    auto first = BindLoopback();
+    auto last = BindLoopback();
+
+    // Sending to the limited broadcast address without SO_BROADCAST is refused, and only that
+    // destination may fail
+    std::vector<AddressKey> destinations = {KeyOf(*first), AddressKey(0xFFFFFFFF, 9), KeyOf(*last)};
+    std::vector<int> results(destinations.size(), 0);
+    EXPECT_EQ(sender->SendToMany(NetworkUtils::AsBytes("ping"), destinations, results), 2u);
+    EXPECT_EQ(results[0], 4);
+    EXPECT_EQ(results[1], -1);
+    EXPECT_EQ(results[2], 4);
+    EXPECT_EQ(ReceiveText(*first), "ping");
+    EXPECT_EQ(ReceiveText(*last), "ping");
+}
+
+TEST(UdpFanOutTest, SplitsLargeFanOutsIntoBatches) {
+    auto sender = BindLoopback();
+    auto receiver = BindLoopback();
+
+    // More destinations than one sendmmsg call takes; the receiver may drop some of them, but
+    // every send is accounted for
+    std::vector<AddressKey> destinations(2500, KeyOf(*receiver));
+    std::vector<int> results(destinations.size(), 0);
+    EXPECT_EQ(sender->SendToMany(NetworkUtils::AsBytes("x"), destinations, results), destinations.size());
+    for (int result : results) {
+        ASSERT_EQ(result, 1);
+    }
+    EXPECT_EQ(ReceiveText(*receiver), "x");
+
+    // Without a results span only the count comes back
+    EXPECT_EQ(sender->SendToMany(NetworkUtils::AsBytes("x"), destinations), destinations.size());
+}
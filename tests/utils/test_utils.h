@@ -13,8 +13,12 @@
 
 // Include Win32 headers in the correct order to avoid conflicts
 #ifdef _WIN32
+#ifndef NOMINMAX
 #define NOMINMAX // Add this line to prevent min/max macro conflicts
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
+#endif
 #include <WinSock2.h>
 #include <Windows.h>
 #endif
@@ -55,6 +59,7 @@ namespace ports {
     constexpr int DEFAULT_TCP_SERVER_PORT = 45000;
     constexpr int MULTI_CONN_SERVER_PORT = 45200;
     constexpr int NON_BLOCKING_SERVER_PORT = 45300;
+    constexpr int TCP_INFO_SERVER_PORT = 45500;
     
     // UDP port numbers
     constexpr int DEFAULT_UDP_SERVER_PORT = 45100;
@@ -67,6 +72,20 @@ namespace constants {
     constexpr int UDP_BUFFER_SIZE = 2048;
 }
 
+// UDP socket bound to an ephemeral loopback port
+inline std::unique_ptr<IUdpSocket> BindLoopback() {
+    auto socket = NetworkFactorySingleton::GetInstance().CreateUdpSocket();
+    EXPECT_TRUE(socket->Bind(NetworkAddress("127.0.0.1", 0)));
+    return socket;
+}
+
+// The address a bound socket can be reached at
+inline AddressKey KeyOf(IUdpSocket& socket) {
+    AddressKey key;
+    EXPECT_TRUE(AddressKey::FromNetworkAddress(socket.GetLocalAddress(), key));
+    return key;
+}
+
 // Utility to implement timeout waiting tests
 template <typename MockSocketT>
 void testBasicWaitForDataWithTimeout(MockSocketT& mockSocket) {